@@ -0,0 +1,220 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "Benchmark.h"
+
+#include <core/Sampler/Interpolation.h>
+#include <core/Version.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+#include <QFile>
+#include <QJsonArray>
+
+QJsonObject BenchmarkResult::toJson() const {
+	QJsonObject json;
+	json.insert( "name", sName );
+	json.insert( "iterations", nIterations );
+	json.insert( "warm_up", nWarmUp );
+	json.insert( "min_ns", fMin );
+	json.insert( "median_ns", fMedian );
+	json.insert( "mean_ns", fMean );
+	json.insert( "p90_ns", fP90 );
+	json.insert( "max_ns", fMax );
+	json.insert( "stddev_ns", fStdDev );
+
+	return json;
+}
+
+BenchmarkResult BenchmarkResult::fromJson( const QJsonObject& json ) {
+	BenchmarkResult result;
+	result.sName = json.value( "name" ).toString();
+	result.nIterations = json.value( "iterations" ).toInt();
+	result.nWarmUp = json.value( "warm_up" ).toInt();
+	result.fMin = json.value( "min_ns" ).toDouble();
+	result.fMedian = json.value( "median_ns" ).toDouble();
+	result.fMean = json.value( "mean_ns" ).toDouble();
+	result.fP90 = json.value( "p90_ns" ).toDouble();
+	result.fMax = json.value( "max_ns" ).toDouble();
+	result.fStdDev = json.value( "stddev_ns" ).toDouble();
+
+	return result;
+}
+
+BenchmarkResult Benchmark::run( const BenchmarkCase& benchmarkCase,
+								int nIterations, int nWarmUp ) {
+	if ( nIterations <= 0 ) {
+		nIterations = benchmarkCase.nIterations;
+	}
+	if ( nWarmUp < 0 ) {
+		nWarmUp = benchmarkCase.nWarmUp;
+	}
+
+	if ( benchmarkCase.setUp ) {
+		benchmarkCase.setUp();
+	}
+
+	std::vector<double> times;
+	times.reserve( nIterations );
+	for ( int ii = 0; ii < nWarmUp + nIterations; ++ii ) {
+		if ( benchmarkCase.prepare ) {
+			benchmarkCase.prepare();
+		}
+
+		// Wall-clock instead of CPU time since some kernels, like the
+		// loading of samples, are distributed over several threads.
+		const auto start = std::chrono::steady_clock::now();
+		benchmarkCase.run();
+		const auto end = std::chrono::steady_clock::now();
+
+		if ( ii >= nWarmUp ) {
+			times.push_back(
+				std::chrono::duration<double, std::nano>( end - start ).count() );
+		}
+	}
+
+	if ( benchmarkCase.tearDown ) {
+		benchmarkCase.tearDown();
+	}
+
+	return computeStatistics( benchmarkCase.sName, std::move( times ), nWarmUp );
+}
+
+BenchmarkResult Benchmark::computeStatistics( const QString& sName,
+											  std::vector<double> times,
+											  int nWarmUp ) {
+	BenchmarkResult result;
+	result.sName = sName;
+	result.nIterations = static_cast<int>( times.size() );
+	result.nWarmUp = nWarmUp;
+	result.fMin = 0;
+	result.fMedian = 0;
+	result.fMean = 0;
+	result.fP90 = 0;
+	result.fMax = 0;
+	result.fStdDev = 0;
+
+	if ( times.empty() ) {
+		return result;
+	}
+
+	std::sort( times.begin(), times.end() );
+	const size_t nSize = times.size();
+
+	result.fMin = times.front();
+	result.fMax = times.back();
+	if ( nSize % 2 == 0 ) {
+		result.fMedian = 0.5 * ( times[ nSize / 2 - 1 ] + times[ nSize / 2 ] );
+	} else {
+		result.fMedian = times[ nSize / 2 ];
+	}
+	// Nearest-rank method
+	const size_t nP90 = static_cast<size_t>(
+		std::ceil( 0.9 * static_cast<double>( nSize ) ) );
+	result.fP90 = times[ std::max( nP90, static_cast<size_t>( 1 ) ) - 1 ];
+
+	result.fMean = std::accumulate( times.begin(), times.end(), 0.0 ) / nSize;
+	double fSquaredError = 0;
+	for ( const auto& fTime : times ) {
+		fSquaredError += ( fTime - result.fMean ) * ( fTime - result.fMean );
+	}
+	result.fStdDev = std::sqrt( fSquaredError / nSize );
+
+	return result;
+}
+
+QJsonDocument Benchmark::toJson( const std::vector<BenchmarkResult>& results ) {
+	QJsonArray benchmarks;
+	for ( const auto& result : results ) {
+		benchmarks.append( result.toJson() );
+	}
+
+	QJsonObject json;
+	json.insert( "version", QString::fromStdString( H2Core::get_version() ) );
+	json.insert( "simd", H2Core::Interpolation::SimdToQString(
+					 H2Core::Interpolation::detectSimd() ) );
+	json.insert( "benchmarks", benchmarks );
+
+	return QJsonDocument( json );
+}
+
+bool Benchmark::loadBaseline( const QString& sPath,
+							  std::map<QString, BenchmarkResult>* pBaseline ) {
+	QFile file( sPath );
+	if ( ! file.open( QIODevice::ReadOnly ) ) {
+		return false;
+	}
+
+	QJsonParseError error;
+	const auto doc = QJsonDocument::fromJson( file.readAll(), &error );
+	if ( error.error != QJsonParseError::NoError || ! doc.isObject() ) {
+		return false;
+	}
+
+	pBaseline->clear();
+	for ( const auto& entry : doc.object().value( "benchmarks" ).toArray() ) {
+		const auto result = BenchmarkResult::fromJson( entry.toObject() );
+		if ( ! result.sName.isEmpty() ) {
+			pBaseline->insert( { result.sName, result } );
+		}
+	}
+
+	return true;
+}
+
+int Benchmark::compare( const std::vector<BenchmarkResult>& results,
+						const std::map<QString, BenchmarkResult>& baseline,
+						double fThreshold, QTextStream& out ) {
+	int nRegressions = 0;
+	for ( const auto& result : results ) {
+		const auto it = baseline.find( result.sName );
+		if ( it == baseline.end() ) {
+			out << QString( "%1: not in baseline" ).arg( result.sName ) << "\n";
+			continue;
+		}
+		if ( it->second.fMedian <= 0 ) {
+			// No relative change can be computed.
+			out << QString( "%1: invalid baseline entry (median %2 ns)" )
+				.arg( result.sName ).arg( it->second.fMedian ) << "\n";
+			continue;
+		}
+
+		const double fChange =
+			100.0 * ( result.fMedian - it->second.fMedian ) / it->second.fMedian;
+		const bool bRegression = fChange > fThreshold;
+		if ( bRegression ) {
+			++nRegressions;
+		}
+
+		out << QString( "%1: median %2 ns, baseline %3 ns (%4%5%)%6" )
+			.arg( result.sName )
+			.arg( result.fMedian, 0, 'f', 0 )
+			.arg( it->second.fMedian, 0, 'f', 0 )
+			.arg( fChange >= 0 ? "+" : "" )
+			.arg( fChange, 0, 'f', 2 )
+			.arg( bRegression ? " REGRESSION" : "" ) << "\n";
+	}
+
+	return nRegressions;
+}
@@ -0,0 +1,116 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2BENCH_BENCHMARK_H
+#define H2BENCH_BENCHMARK_H
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QTextStream>
+
+/** A single kernel measured in isolation by h2bench.
+ *
+ * Only #run is timed. All other callbacks are optional. */
+struct BenchmarkCase {
+	QString sName;
+	/** Called once before the warm-up phase. */
+	std::function<void()> setUp;
+	/** Called before every warm-up and measured iteration. Used to restore
+	 * state altered by #run, like buffers processed in place. */
+	std::function<void()> prepare;
+	/** The kernel itself. */
+	std::function<void()> run;
+	/** Called once after the last iteration. */
+	std::function<void()> tearDown;
+	/** Default number of measured iterations. */
+	int nIterations = 100;
+	/** Default number of iterations run but discarded beforehand to fill the
+	 * caches and let lazy initialization kick in. */
+	int nWarmUp = 10;
+};
+
+/** Wall-clock statistics of all measured iterations of a #BenchmarkCase in
+ * nanoseconds. */
+struct BenchmarkResult {
+	QString sName;
+	int nIterations;
+	int nWarmUp;
+	double fMin;
+	double fMedian;
+	double fMean;
+	/** 90th percentile. */
+	double fP90;
+	double fMax;
+	double fStdDev;
+
+	QJsonObject toJson() const;
+	static BenchmarkResult fromJson( const QJsonObject& json );
+};
+
+/** Runs #BenchmarkCase, writes the results as JSON, and compares them
+ * against a previous run. */
+class Benchmark {
+public:
+	/** Runs all warm-up and measured iterations of @a benchmarkCase.
+	 *
+	 * \param nIterations If positive, overrides the default number of
+	 *   iterations of @a benchmarkCase.
+	 * \param nWarmUp If non-negative, overrides the default number of
+	 *   warm-up iterations of @a benchmarkCase. */
+	static BenchmarkResult run( const BenchmarkCase& benchmarkCase,
+								int nIterations = 0, int nWarmUp = -1 );
+
+	/** \param times Durations of the individual iterations in
+	 *   nanoseconds. */
+	static BenchmarkResult computeStatistics( const QString& sName,
+											  std::vector<double> times,
+											  int nWarmUp );
+
+	static QJsonDocument toJson( const std::vector<BenchmarkResult>& results );
+
+	/** Reads a file previously written by h2bench.
+	 *
+	 * \return `false` in case @a sPath could not be read or parsed. */
+	static bool loadBaseline( const QString& sPath,
+							  std::map<QString, BenchmarkResult>* pBaseline );
+
+	/** Compares the medians of @a results against those of @a baseline and
+	 * reports the relative change of each benchmark to @a out.
+	 *
+	 * Benchmarks not present in @a baseline or whose baseline median is not
+	 * positive are reported but do not count as regression.
+	 *
+	 * \param fThreshold Maximum increase of the median in percent still
+	 *   tolerated.
+	 *
+	 * \return Number of benchmarks which got slower by more than
+	 *   @a fThreshold. */
+	static int compare( const std::vector<BenchmarkResult>& results,
+						const std::map<QString, BenchmarkResult>& baseline,
+						double fThreshold, QTextStream& out );
+};
+
+#endif
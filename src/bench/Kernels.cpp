@@ -0,0 +1,454 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "Kernels.h"
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/AudioEngineTests.h>
+#include <core/AudioEngine/Transport.h>
+#include <core/Basics/Adsr.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Xml.h>
+#include <core/Hydrogen.h>
+#include <core/Preferences/Preferences.h>
+#include <core/Sampler/Interpolation.h>
+#include <core/Sampler/Sampler.h>
+
+#include <cmath>
+#include <memory>
+
+using namespace H2Core;
+
+namespace {
+
+/** Size of a single buffer processed by the kernels working on audio. */
+constexpr int nBufferFrames = 4096;
+/** Size of the synthetic sample used by the resampling kernels. */
+constexpr int nSampleFrames = 1 << 18;
+
+/** Song shared by all kernels requiring one. */
+struct SongFixture {
+	static constexpr int nPatterns = 16;
+	static constexpr int nNotesPerPattern = 768;
+	static constexpr int nColumns = 16;
+
+	std::shared_ptr<Song> pSong;
+
+	/** Creates a song based on the default drumkit in which every pattern is
+	 * densely packed with notes of all instruments and sets it in
+	 * #H2Core::Hydrogen. */
+	std::shared_ptr<Song> get() {
+		if ( pSong != nullptr ) {
+			return pSong;
+		}
+
+		pSong = Song::getEmptySong();
+		auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+		auto pPatternList = pSong->getPatternList();
+		while ( pPatternList->size() < nPatterns ) {
+			pPatternList->add( std::make_shared<Pattern>(
+				QString( "Pattern %1" ).arg( pPatternList->size() + 1 ) ) );
+		}
+
+		for ( const auto& ppPattern : *pPatternList ) {
+			for ( int nn = 0; nn < nNotesPerPattern; ++nn ) {
+				ppPattern->insertNote( std::make_shared<Note>(
+					pInstrumentList->get( nn % pInstrumentList->size() ),
+					nn % ppPattern->getLength(), 0.5 + 0.125 * ( nn % 4 ) ) );
+			}
+		}
+
+		auto pColumns = pSong->getPatternGroupVector();
+		pColumns->clear();
+		for ( int cc = 0; cc < nColumns; ++cc ) {
+			auto pColumn = std::make_shared<PatternList>();
+			pColumn->add( pPatternList->get( cc % pPatternList->size() ) );
+			pColumns->push_back( pColumn );
+		}
+
+		CoreActionController::setSong( pSong );
+		CoreActionController::activateSongMode( false );
+		CoreActionController::activateLoopMode( false );
+		CoreActionController::activateTimeline( false );
+		CoreActionController::selectPattern( 0 );
+
+		return pSong;
+	}
+};
+
+void addResampleCases( std::vector<BenchmarkCase>* pCases ) {
+	const std::vector<Interpolation::InterpolateMode> modes = {
+		Interpolation::InterpolateMode::Linear,
+		Interpolation::InterpolateMode::Cosine,
+		Interpolation::InterpolateMode::Third,
+		Interpolation::InterpolateMode::Cubic,
+		Interpolation::InterpolateMode::Hermite };
+
+	for ( const auto& mode : modes ) {
+		struct Data {
+			std::vector<float> sample_L, sample_R, buffer_L, buffer_R;
+		};
+		auto pData = std::make_shared<Data>();
+
+		BenchmarkCase benchmarkCase;
+		benchmarkCase.sName = QString( "resample/%1" )
+			.arg( Interpolation::ModeToQString( mode ) );
+		benchmarkCase.setUp = [=]() {
+			pData->sample_L.resize( nSampleFrames );
+			pData->sample_R.resize( nSampleFrames );
+			pData->buffer_L.resize( nBufferFrames );
+			pData->buffer_R.resize( nBufferFrames );
+			for ( int ii = 0; ii < nSampleFrames; ++ii ) {
+				pData->sample_L[ ii ] = std::sin( ii * 0.01 );
+				pData->sample_R[ ii ] = std::cos( ii * 0.013 );
+			}
+		};
+		benchmarkCase.run = [=]() {
+			// Resample the whole sample - just like the Sampler does with a
+			// pitched note - to not just measure the cache.
+			const auto kernel = Interpolation::getBlockKernel( mode );
+			const double fStep = 1.0001;
+			for ( double fPos = 1;
+				  fPos + nBufferFrames * fStep + 3 < nSampleFrames;
+				  fPos += nBufferFrames * fStep ) {
+				kernel( pData->sample_L.data(), pData->sample_R.data(),
+						pData->buffer_L.data(), pData->buffer_R.data(),
+						nBufferFrames, fPos, fStep );
+			}
+		};
+		benchmarkCase.tearDown = [=]() {
+			*pData = Data();
+		};
+		benchmarkCase.nIterations = 100;
+		benchmarkCase.nWarmUp = 10;
+		pCases->push_back( benchmarkCase );
+	}
+}
+
+void addAdsrCase( std::vector<BenchmarkCase>* pCases ) {
+	struct Data {
+		std::unique_ptr<ADSR> pAdsr;
+		float buffer_L[ nBufferFrames ];
+		float buffer_R[ nBufferFrames ];
+	};
+	auto pData = std::make_shared<Data>();
+
+	BenchmarkCase benchmarkCase;
+	benchmarkCase.sName = "adsr";
+	benchmarkCase.prepare = [=]() {
+		// The envelope is applied in place and advances its state.
+		pData->pAdsr = std::make_unique<ADSR>(
+			nBufferFrames / 4, nBufferFrames / 4, 0.5, nBufferFrames / 4 );
+		for ( int ii = 0; ii < nBufferFrames; ++ii ) {
+			pData->buffer_L[ ii ] = pData->buffer_R[ ii ] = 1.0;
+		}
+	};
+	benchmarkCase.run = [=]() {
+		pData->pAdsr->applyADSR( pData->buffer_L, pData->buffer_R,
+								 nBufferFrames, 3 * nBufferFrames / 4, 1.0 );
+	};
+	benchmarkCase.nIterations = 1000;
+	benchmarkCase.nWarmUp = 100;
+	pCases->push_back( benchmarkCase );
+}
+
+void addFilterCase( std::vector<BenchmarkCase>* pCases ) {
+	struct Data {
+		std::shared_ptr<Instrument> pInstrument;
+		std::shared_ptr<Note> pNote;
+		float buffer_L[ nBufferFrames ];
+		float buffer_R[ nBufferFrames ];
+	};
+	auto pData = std::make_shared<Data>();
+
+	BenchmarkCase benchmarkCase;
+	benchmarkCase.sName = "note/computeLrValues";
+	benchmarkCase.setUp = [=]() {
+		pData->pInstrument = std::make_shared<Instrument>();
+		pData->pInstrument->setFilterActive( true );
+		pData->pInstrument->setFilterCutoff( 0.4 );
+		pData->pInstrument->setFilterResonance( 0.6 );
+	};
+	benchmarkCase.prepare = [=]() {
+		// Fresh note to start with a clean filter state.
+		pData->pNote = std::make_shared<Note>( pData->pInstrument );
+		for ( int ii = 0; ii < nBufferFrames; ++ii ) {
+			pData->buffer_L[ ii ] = std::sin( ii * 0.01 );
+			pData->buffer_R[ ii ] = std::cos( ii * 0.013 );
+		}
+	};
+	benchmarkCase.run = [=]() {
+		auto pNote = pData->pNote;
+		for ( int ii = 0; ii < nBufferFrames; ++ii ) {
+			pNote->computeLrValues( &pData->buffer_L[ ii ],
+									&pData->buffer_R[ ii ] );
+		}
+	};
+	benchmarkCase.tearDown = [=]() {
+		pData->pNote = nullptr;
+		pData->pInstrument = nullptr;
+	};
+	benchmarkCase.nIterations = 1000;
+	benchmarkCase.nWarmUp = 100;
+	pCases->push_back( benchmarkCase );
+}
+
+void addSamplerCases( std::vector<BenchmarkCase>* pCases,
+					  std::shared_ptr<SongFixture> pFixture ) {
+	for ( const int nVoices : { 8, 32, 128 } ) {
+		BenchmarkCase benchmarkCase;
+		benchmarkCase.sName = QString( "sampler/process/%1voices" ).arg( nVoices );
+		benchmarkCase.setUp = [=]() {
+			pFixture->get();
+			AudioEngineTests::benchmarkSetUp();
+		};
+		benchmarkCase.prepare = [=]() {
+			// Replace all notes which finished rendering in the last
+			// iteration to keep the number of voices constant.
+			auto pSampler = Hydrogen::get_instance()->getAudioEngine()->getSampler();
+			auto pInstrumentList = pFixture->get()->getDrumkit()->getInstruments();
+			int nn = pSampler->getPlayingNotesQueue().size();
+			while ( static_cast<int>( pSampler->getPlayingNotesQueue().size() ) <
+					nVoices ) {
+				auto pInstrument = pInstrumentList->get(
+					nn % pInstrumentList->size() );
+				auto pNote = std::make_shared<Note>(
+					pInstrument, 0, 0.5 + 0.125 * ( nn % 4 ) );
+				if ( ! pSampler->noteOn( pNote ) ) {
+					break;
+				}
+				++nn;
+			}
+		};
+		benchmarkCase.run = []() {
+			Hydrogen::get_instance()->getAudioEngine()->getSampler()->process(
+				Preferences::get_instance()->m_nBufferSize );
+		};
+		benchmarkCase.tearDown = []() {
+			AudioEngineTests::benchmarkTearDown();
+		};
+		benchmarkCase.nIterations = 200;
+		benchmarkCase.nWarmUp = 20;
+		pCases->push_back( benchmarkCase );
+	}
+}
+
+void addNoteQueueCase( std::vector<BenchmarkCase>* pCases,
+					   std::shared_ptr<SongFixture> pFixture ) {
+	BenchmarkCase benchmarkCase;
+	benchmarkCase.sName = "audioEngine/updateNoteQueue";
+	benchmarkCase.setUp = [=]() {
+		pFixture->get();
+		AudioEngineTests::benchmarkSetUp();
+	};
+	benchmarkCase.run = []() {
+		// A single process cycle covers just a couple of ticks.
+		const int nBufferSize = Preferences::get_instance()->m_nBufferSize;
+		for ( int ii = 0; ii < 16; ++ii ) {
+			AudioEngineTests::benchmarkUpdateNoteQueue( nBufferSize );
+		}
+	};
+	benchmarkCase.tearDown = []() {
+		AudioEngineTests::benchmarkTearDown();
+	};
+	benchmarkCase.nIterations = 200;
+	benchmarkCase.nWarmUp = 20;
+	pCases->push_back( benchmarkCase );
+}
+
+void addTransportCases( std::vector<BenchmarkCase>* pCases,
+						std::shared_ptr<SongFixture> pFixture ) {
+	auto run = [=]() {
+		const double fSongLength = static_cast<double>(
+			pFixture->get()->getPatternGroupVector()->size() ) *
+			pFixture->get()->getPatternList()->get( 0 )->getLength();
+		double fTickMismatch;
+		long long nSum = 0;
+		for ( int ii = 0; ii < 1000; ++ii ) {
+			nSum += Transport::computeFrameFromTick(
+				fSongLength * ii / 1000 + 0.25, &fTickMismatch );
+		}
+		// Prevent the compiler from discarding the loop.
+		static volatile long long nSink;
+		nSink = nSum;
+	};
+
+	BenchmarkCase benchmarkCase;
+	benchmarkCase.sName = "transport/computeFrameFromTick";
+	benchmarkCase.setUp = [=]() {
+		pFixture->get();
+	};
+	benchmarkCase.run = run;
+	benchmarkCase.nIterations = 500;
+	benchmarkCase.nWarmUp = 50;
+	pCases->push_back( benchmarkCase );
+
+	BenchmarkCase timelineCase;
+	timelineCase.sName = "transport/computeFrameFromTick/timeline";
+	timelineCase.setUp = [=]() {
+		pFixture->get();
+		CoreActionController::activateSongMode( true );
+		CoreActionController::activateTimeline( true );
+		for ( int cc = 0; cc < SongFixture::nColumns; cc += 2 ) {
+			CoreActionController::addTempoMarker( cc, 100 + 10 * cc );
+		}
+	};
+	timelineCase.run = run;
+	timelineCase.tearDown = []() {
+		for ( int cc = 0; cc < SongFixture::nColumns; cc += 2 ) {
+			CoreActionController::deleteTempoMarker( cc );
+		}
+		CoreActionController::activateTimeline( false );
+		CoreActionController::activateSongMode( false );
+	};
+	timelineCase.nIterations = 500;
+	timelineCase.nWarmUp = 50;
+	pCases->push_back( timelineCase );
+}
+
+void addSongLoadCase( std::vector<BenchmarkCase>* pCases,
+					  std::shared_ptr<SongFixture> pFixture ) {
+	struct Data {
+		QString sPath;
+		std::shared_ptr<Song> pSong;
+	};
+	auto pData = std::make_shared<Data>();
+
+	BenchmarkCase benchmarkCase;
+	benchmarkCase.sName = "xml/songLoad";
+	benchmarkCase.setUp = [=]() {
+		pData->sPath = Filesystem::tmp_file_path( "h2bench.h2song" );
+		pFixture->get()->save( pData->sPath, false, true );
+	};
+	benchmarkCase.prepare = [=]() {
+		// Destroying the previously loaded song is not part of the kernel.
+		pData->pSong = nullptr;
+	};
+	benchmarkCase.run = [=]() {
+		pData->pSong = Song::load( pData->sPath, true );
+	};
+	benchmarkCase.tearDown = [=]() {
+		pData->pSong = nullptr;
+		Filesystem::rm( pData->sPath, false, true );
+	};
+	benchmarkCase.nIterations = 20;
+	benchmarkCase.nWarmUp = 2;
+	pCases->push_back( benchmarkCase );
+}
+
+void addPatternListLoadCases( std::vector<BenchmarkCase>* pCases,
+							  std::shared_ptr<SongFixture> pFixture ) {
+	// The patterns of a song are either read in a single pass - like
+	// Song::load() does - or from the DOM of the whole file.
+	for ( const bool bStreamed : { true, false } ) {
+		struct Data {
+			QString sPath;
+			std::shared_ptr<PatternList> pPatternList;
+		};
+		auto pData = std::make_shared<Data>();
+
+		BenchmarkCase benchmarkCase;
+		benchmarkCase.sName = QString( "xml/patternListLoad/%1" )
+			.arg( bStreamed ? "streamed" : "dom" );
+		benchmarkCase.setUp = [=]() {
+			pData->sPath = Filesystem::tmp_file_path( "h2bench.h2song" );
+			pFixture->get()->save( pData->sPath, false, true );
+		};
+		benchmarkCase.prepare = [=]() {
+			pData->pPatternList = nullptr;
+		};
+		benchmarkCase.run = [=]() {
+			XMLDoc doc;
+			if ( bStreamed ) {
+				doc.read( pData->sPath, "song/patternList",
+						  [&]( XMLStreamReader& reader ) {
+							  pData->pPatternList =
+								  PatternList::loadFrom( reader, true );
+						  }, true );
+			}
+			else if ( doc.read( pData->sPath, true ) ) {
+				pData->pPatternList = PatternList::loadFrom(
+					doc.firstChildElement( "song" ), "", nullptr, true );
+			}
+		};
+		benchmarkCase.tearDown = [=]() {
+			pData->pPatternList = nullptr;
+			Filesystem::rm( pData->sPath, false, true );
+		};
+		benchmarkCase.nIterations = 20;
+		benchmarkCase.nWarmUp = 2;
+		pCases->push_back( benchmarkCase );
+	}
+}
+
+void addDrumkitCase( std::vector<BenchmarkCase>* pCases ) {
+	auto ppDrumkit = std::make_shared<std::shared_ptr<Drumkit>>();
+
+	BenchmarkCase benchmarkCase;
+	benchmarkCase.sName = "drumkit/loadSamples";
+	benchmarkCase.setUp = [=]() {
+		*ppDrumkit = Drumkit::load(
+			Filesystem::drumkit_default_kit(), false, nullptr, true );
+	};
+	benchmarkCase.prepare = [=]() {
+		if ( *ppDrumkit != nullptr ) {
+			( *ppDrumkit )->unloadSamples();
+		}
+	};
+	benchmarkCase.run = [=]() {
+		if ( *ppDrumkit != nullptr ) {
+			( *ppDrumkit )->loadSamples();
+		}
+	};
+	benchmarkCase.tearDown = [=]() {
+		*ppDrumkit = nullptr;
+	};
+	benchmarkCase.nIterations = 10;
+	benchmarkCase.nWarmUp = 1;
+	pCases->push_back( benchmarkCase );
+}
+
+};
+
+std::vector<BenchmarkCase> createBenchmarkCases() {
+	auto pFixture = std::make_shared<SongFixture>();
+
+	std::vector<BenchmarkCase> cases;
+	addResampleCases( &cases );
+	addAdsrCase( &cases );
+	addFilterCase( &cases );
+	addSamplerCases( &cases, pFixture );
+	addNoteQueueCase( &cases, pFixture );
+	addTransportCases( &cases, pFixture );
+	addSongLoadCase( &cases, pFixture );
+	addPatternListLoadCases( &cases, pFixture );
+	addDrumkitCase( &cases );
+
+	return cases;
+}
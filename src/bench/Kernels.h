@@ -0,0 +1,39 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2BENCH_KERNELS_H
+#define H2BENCH_KERNELS_H
+
+#include <vector>
+
+#include "Benchmark.h"
+
+/** Creates all kernels measured by h2bench.
+ *
+ * Requires the #H2Core::Hydrogen singleton to be set up. Drumkits and songs
+ * are only loaded in BenchmarkCase::setUp. This way runs restricted to a
+ * couple of kernels start up fast.
+ *
+ * The returned cases share fixtures and have to be destroyed before
+ * #H2Core::Hydrogen is. */
+std::vector<BenchmarkCase> createBenchmarkCases();
+
+#endif
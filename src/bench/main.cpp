@@ -0,0 +1,225 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/EventQueue.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Hydrogen.h>
+#include <core/Logger.h>
+#include <core/Preferences/Preferences.h>
+#include <core/config.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include "Benchmark.h"
+#include "Kernels.h"
+
+using namespace H2Core;
+
+/** Same setup as the unit tests: system data of the source tree, transient
+ * user data, and the fake audio driver. */
+void setupEnvironment( unsigned nLogLevel, const QString& sLogFilePath,
+					   bool bLogToStdout, const QString& sUserDataFolder )
+{
+	Logger* pLogger = Logger::bootstrap(
+		nLogLevel, sLogFilePath, bLogToStdout, true );
+	Base::bootstrap( pLogger, true );
+	Filesystem::bootstrap(
+		pLogger, QString( CMAKE_SOURCE_DIR ) + "/data/", sUserDataFolder,
+		QString( CMAKE_SOURCE_DIR ) +
+			"/src/tests/data/preferences/current.conf",
+		sLogFilePath );
+
+	Preferences::create_instance();
+	auto pPref = Preferences::get_instance();
+	pPref->m_audioDriver = Preferences::AudioDriver::Fake;
+	pPref->m_midiDriver = Preferences::MidiDriver::LoopBack;
+	pPref->m_nBufferSize = 1024;
+
+	// Use a dedicated OSC port to not cause conflicts with the unit tests
+	// running in parallel.
+	Hydrogen::create_instance( 4564 );
+	Hydrogen::get_instance()->setGUIState( Hydrogen::GUIState::headless );
+	EventQueue::get_instance()->setSilent( true );
+}
+
+int main( int argc, char** argv )
+{
+	QCoreApplication app( argc, argv );
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(
+		"Microbenchmarks of Hydrogen's core. Results are written as JSON." );
+	QCommandLineOption listOption( QStringList() << "l" << "list",
+								   "List all benchmarks and exit" );
+	QCommandLineOption filterOption(
+		QStringList() << "f" << "filter",
+		"Only run benchmarks whose name matches the regular expression",
+		"Regex" );
+	QCommandLineOption iterationsOption(
+		QStringList() << "i" << "iterations",
+		"Number of measured iterations of each benchmark (overrides the default of each benchmark)",
+		"Number" );
+	QCommandLineOption warmUpOption(
+		QStringList() << "w" << "warm-up",
+		"Number of discarded iterations run before measuring (overrides the default of each benchmark)",
+		"Number" );
+	QCommandLineOption outputOption(
+		QStringList() << "o" << "output",
+		"Write the results to a file instead of stdout", "File" );
+	QCommandLineOption baselineOption(
+		QStringList() << "b" << "baseline",
+		"Results of a previous run. Exits with 1 in case the median of a benchmark got slower by more than the threshold",
+		"File" );
+	QCommandLineOption thresholdOption(
+		QStringList() << "t" << "threshold",
+		"Tolerated increase of the median compared to the baseline in percent",
+		"Percent", "10" );
+	QCommandLineOption verboseOption(
+		QStringList() << "V" << "verbose",
+		"Level, if present, may be None, Error, Warning, Info, Debug or 0xHHHH",
+		"Level" );
+	parser.addHelpOption();
+	parser.addOption( listOption );
+	parser.addOption( filterOption );
+	parser.addOption( iterationsOption );
+	parser.addOption( warmUpOption );
+	parser.addOption( outputOption );
+	parser.addOption( baselineOption );
+	parser.addOption( thresholdOption );
+	parser.addOption( verboseOption );
+	parser.process( app );
+
+	QTextStream err( stderr );
+
+	const QRegularExpression filter( parser.value( filterOption ) );
+	if ( ! filter.isValid() ) {
+		err << "Invalid filter: " << filter.errorString() << "\n";
+		return 2;
+	}
+
+	bool bOk = true;
+	const int nIterations = parser.isSet( iterationsOption ) ?
+		parser.value( iterationsOption ).toInt( &bOk ) : 0;
+	if ( ! bOk || ( parser.isSet( iterationsOption ) && nIterations <= 0 ) ) {
+		err << "Invalid number of iterations\n";
+		return 2;
+	}
+	const int nWarmUp = parser.isSet( warmUpOption ) ?
+		parser.value( warmUpOption ).toInt( &bOk ) : -1;
+	if ( ! bOk || ( parser.isSet( warmUpOption ) && nWarmUp < 0 ) ) {
+		err << "Invalid number of warm-up iterations\n";
+		return 2;
+	}
+	const double fThreshold = parser.value( thresholdOption ).toDouble( &bOk );
+	if ( ! bOk || fThreshold < 0 ) {
+		err << "Invalid threshold\n";
+		return 2;
+	}
+
+	unsigned nLogLevel = Logger::Error | Logger::Warning;
+	if ( parser.isSet( verboseOption ) ) {
+		nLogLevel = Logger::parse_log_level(
+			parser.value( verboseOption ).toLocal8Bit() );
+	}
+	// Log messages must not end up in the JSON written to stdout.
+	const QString sLogFilePath = QString( "%1%2h2bench.log" )
+		.arg( QDir::currentPath() ).arg( QDir::separator() );
+
+	// Transient user-level data to ensure no data of the system the
+	// benchmarks are run on does alter the results.
+	QTemporaryDir userDataDir( QDir::tempPath() + "/h2bench-user-data-XXXXX" );
+	setupEnvironment( nLogLevel, sLogFilePath, parser.isSet( outputOption ),
+					  userDataDir.path() );
+
+	int nReturnCode = 0;
+	{
+		std::vector<BenchmarkResult> results;
+		auto cases = createBenchmarkCases();
+		for ( const auto& benchmarkCase : cases ) {
+			if ( ! filter.match( benchmarkCase.sName ).hasMatch() ) {
+				continue;
+			}
+			if ( parser.isSet( listOption ) ) {
+				QTextStream( stdout ) << benchmarkCase.sName << "\n";
+				continue;
+			}
+
+			err << benchmarkCase.sName << "...";
+			err.flush();
+			results.push_back(
+				Benchmark::run( benchmarkCase, nIterations, nWarmUp ) );
+			err << QString( " median %1 ns" )
+				.arg( results.back().fMedian, 0, 'f', 0 ) << "\n";
+			err.flush();
+		}
+
+		if ( ! parser.isSet( listOption ) ) {
+			const auto json = Benchmark::toJson( results ).toJson();
+			if ( parser.isSet( outputOption ) ) {
+				QFile file( parser.value( outputOption ) );
+				if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ||
+					 file.write( json ) != json.size() ) {
+					err << "Unable to write results to ["
+						<< parser.value( outputOption ) << "]\n";
+					nReturnCode = 2;
+				}
+			}
+			else {
+				QTextStream( stdout ) << json;
+			}
+
+			if ( parser.isSet( baselineOption ) ) {
+				std::map<QString, BenchmarkResult> baseline;
+				if ( ! Benchmark::loadBaseline( parser.value( baselineOption ),
+												&baseline ) ) {
+					err << "Unable to read baseline ["
+						<< parser.value( baselineOption ) << "]\n";
+					nReturnCode = 2;
+				}
+				else {
+					const int nRegressions = Benchmark::compare(
+						results, baseline, fThreshold, err );
+					if ( nRegressions > 0 ) {
+						err << QString( "%1 benchmark(s) regressed by more than %2%" )
+							.arg( nRegressions ).arg( fThreshold ) << "\n";
+						if ( nReturnCode == 0 ) {
+							nReturnCode = 1;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	delete Hydrogen::get_instance();
+	delete EventQueue::get_instance();
+	Preferences::get_instance()->replaceInstance( nullptr );
+	Logger::get_instance()->flush();
+	delete Logger::get_instance();
+
+	return nReturnCode;
+}
@@ -49,6 +49,7 @@
 #include <core/H2Exception.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Helpers/Xml.h>
+#include <core/IO/DiskWriterDriver.h>
 #include <core/Hydrogen.h>
 #include <core/Preferences/Preferences.h>
 #include <core/Sampler/Interpolation.h>
@@ -65,12 +66,32 @@ public:
 };
 
 volatile bool quit = false;
+volatile bool dumpStats = false;
 void signal_handler ( int signum )
 {
 	if ( signum == SIGINT ) {
 		std::cout << "Terminate signal caught" << std::endl;
 		quit = true;
 	}
+#ifndef WIN32
+	else if ( signum == SIGUSR1 ) {
+		dumpStats = true;
+	}
+#endif
+}
+
+void show_stats()
+{
+	/* Display timing statistics of the audio engine */
+	auto pAudioEngine = H2Core::Hydrogen::get_instance()->getAudioEngine();
+	std::cout << pAudioEngine->getProfiler()->formatStatistics()
+		.toLocal8Bit().constData() << std::endl;
+
+	auto pAudioDriver = pAudioEngine->getAudioDriver();
+	if ( pAudioDriver != nullptr ) {
+		std::cout << "Driver XRuns: " << pAudioDriver->getXRuns() << std::endl;
+	}
+	std::cout << std::endl;
 }
 
 void show_playlist (uint active )
@@ -207,6 +228,13 @@ int main(int argc, char *argv[])
 			"double", "0.0" );
 		QCommandLineOption outputFileOption(
 			QStringList() << "o" << "outfile", "Output to file (export)", "File" );
+		QCommandLineOption stemsOption(
+			QStringList() << "stems",
+			"In addition to the main mix, export each instrument used in the song into a separate file next to the one provided via -o. All files are rendered in a single pass." );
+		QCommandLineOption seedOption(
+			QStringList() << "seed",
+			"Seed of humanization and note probability while exporting file. Overrides the one stored in the song",
+			"int" );
 		QCommandLineOption interpolationOption(
 			QStringList() << "I" << "interpolation",
 			"Interpolation:\n   - 0 (linear) [default]\n   - 1 (cosine)\n   - 2 (third)\n   - 3 (cubic)\n   - 4 (hermite)",
@@ -238,6 +266,9 @@ int main(int argc, char *argv[])
 		QCommandLineOption logTimestampsOption(
 			QStringList() << "T" << "log-timestamps",
 			"Add timestamps to all log messages" );
+		QCommandLineOption statsOption(
+			QStringList() << "stats",
+			"Print per-stage timing statistics of the audio engine on exit (and on SIGUSR1)" );
 #ifdef H2CORE_HAVE_OSC
 		QCommandLineOption oscPortOption(
 			QStringList() << "O" << "osc-port",
@@ -248,6 +279,7 @@ int main(int argc, char *argv[])
 		parser.addOption( songFileOption );
 		parser.addOption( playlistFileNameOption );
 		parser.addOption( outputFileOption );
+		parser.addOption( stemsOption );
 		parser.addOption( systemDataPathOption );
 		parser.addOption( userDataPathOption );
 		parser.addOption( configFileOption );
@@ -257,12 +289,14 @@ int main(int argc, char *argv[])
 		parser.addOption( kitOption );
 		parser.addOption( kitToDrumkitMapOption );
 		parser.addOption( interpolationOption );
+		parser.addOption( seedOption );
 		parser.addOption( installDrumkitOption );
 		parser.addOption( checkDrumkitOption );
 		parser.addOption( legacyCheckDrumkitOption );
 		parser.addOption( upgradeDrumkitOption );
 		parser.addOption( extractDrumkitOption );
 		parser.addOption( targetOption );
+		parser.addOption( statsOption );
 #ifdef H2CORE_HAVE_OSC
 		parser.addOption( oscPortOption );
 #endif
@@ -292,6 +326,7 @@ int main(int argc, char *argv[])
 		const QString sDrumkitToUpgrade = parser.value( upgradeDrumkitOption );
 		const QString sDrumkitToExtract = parser.value( extractDrumkitOption );
 		const bool bLogTimestamps = parser.isSet( logTimestampsOption );
+		const bool bStats = parser.isSet( statsOption );
 		const QString sTarget = parser.value( targetOption );
 
 		bool bOk;
@@ -322,6 +357,16 @@ int main(int argc, char *argv[])
 			exit( 1 );
 		}
 
+		int nSeed = 0;
+		if ( parser.isSet( seedOption ) ) {
+			nSeed = parser.value( seedOption ).toInt( &bOk );
+			if ( ! bOk ) {
+				std::cerr << "Unable to parse 'seed' option. Please provide an integer value"
+					<< std::endl;
+				exit( 1 );
+			}
+		}
+
 		int nOscPort = -1;
 #ifdef H2CORE_HAVE_OSC
 		const QString sOscPort = parser.value( oscPortOption );
@@ -463,6 +508,11 @@ int main(int argc, char *argv[])
 		EventQueue *pQueue = EventQueue::get_instance();
 
 		signal(SIGINT, signal_handler);
+#ifndef WIN32
+		if ( bStats ) {
+			signal(SIGUSR1, signal_handler);
+		}
+#endif
 
 		// Hydrogen is up and running. Let's handle the requested user action.
 		//
@@ -478,8 +528,16 @@ int main(int argc, char *argv[])
 			for (auto i = 0; i < pInstrumentList->size(); i++) {
 				pInstrumentList->get(i)->setCurrentlyExported( true );
 			}
+			std::map<H2Core::Instrument::Id, QString> stems;
+			if ( parser.isSet( stemsOption ) ) {
+				stems = H2Core::DiskWriterDriver::createStemFileNames(
+					sOutFileName, pSong );
+			}
+			if ( parser.isSet( seedOption ) ) {
+				pSong->setRandomSeed( nSeed );
+			}
 			pHydrogen->startExportSession(nRate, bits, fCompressionLevel);
-			pHydrogen->startExportSong( sOutFileName );
+			pHydrogen->startExportSong( sOutFileName, stems );
 			std::cout << "Export Progress ... ";
 			bExportMode = true;
 		}
@@ -583,6 +641,11 @@ int main(int argc, char *argv[])
 		if ( nReturnCode == -1 || bExportMode ) {
 			// Interactive mode - h2cli is not done yet.
 			while ( ! quit ) {
+				if ( dumpStats ) {
+					dumpStats = false;
+					show_stats();
+				}
+
 				/* FIXME: Someday here will be The Real CLI ;-) */
 				auto pEvent = pQueue->popEvent();
 				if ( pEvent == nullptr ) {
@@ -628,6 +691,10 @@ int main(int argc, char *argv[])
 			}
 		}
 
+		if ( bStats ) {
+			show_stats();
+		}
+
 		if ( pHydrogen->getAudioEngine()->getState() == H2Core::AudioEngine::State::Playing ) {
 			pHydrogen->sequencerStop();
 		}
@@ -103,8 +103,14 @@ AudioEngine::AudioEngine()
 	m_pQueuing = std::make_shared<Transport>( Transport::Type::Queuing );
 
 	m_pSampler = new Sampler;
-
-	srand( time( nullptr ) );
+	m_pNotePool = std::make_shared<NotePool>(
+		NotePool::nNotesPerVoice * Preferences::get_instance()->m_nMaxNotes );
+	m_pProfiler = std::make_shared<AudioEngineProfiler>();
+	m_pRubberbandCache = std::make_shared<RubberbandCache>();
+	m_pRandom = std::make_shared<Random>( Random::createSeed() );
+	m_pLiveNoteQueue = std::make_shared<LiveNoteQueue>();
+	m_cycleStartTimePoint = Clock::now();
+	m_previousCycleStartTimePoint = m_cycleStartTimePoint;
 
 	m_pMetronomeInstrument =
 		Instrument::from( Sample::load( Filesystem::click_file_path() ) );
@@ -125,6 +131,9 @@ AudioEngine::AudioEngine()
 
 AudioEngine::~AudioEngine()
 {
+	// Its workers lock the audio engine.
+	m_pRubberbandCache = nullptr;
+
 	stopAudioDriver( Event::Trigger::Suppress );
 	stopMidiDriver( Event::Trigger::Suppress );
 	if ( getState() != State::Initialized ) {
@@ -162,16 +171,23 @@ Sampler* AudioEngine::getSampler() const
 	return m_pSampler;
 }
 
-void AudioEngine::lock( const char* file, unsigned int line, const char* function )
+// The id of the locking thread is only formatted when actually logged. This
+// way locking does not allocate memory in the audio thread.
+static QString currentThreadId()
 {
-#ifdef H2CORE_HAVE_DEBUG
 	// Is there a more convenient way to convert the thread id to QSTring?
 	std::stringstream tmpStream;
 	tmpStream << std::this_thread::get_id();
+	return QString::fromStdString( tmpStream.str() );
+}
+
+void AudioEngine::lock( const char* file, unsigned int line, const char* function )
+{
+#ifdef H2CORE_HAVE_DEBUG
 	if (__logger->should_log(Logger::Locks)) {
 		__logger->log( Logger::Locks, _class_name(), __FUNCTION__,
 					   QString( "[thread id: %1] : %2 : [line: %3] : %4" )
-					   .arg( QString::fromStdString( tmpStream.str() ) )
+					   .arg( currentThreadId() )
 					   .arg( function ).arg( line ).arg( file ) );
 	}
 #endif
@@ -187,7 +203,7 @@ void AudioEngine::lock( const char* file, unsigned int line, const char* functio
 	if ( __logger->should_log( Logger::Locks ) ) {
 		__logger->log( Logger::Locks, _class_name(), __FUNCTION__,
 					   QString( "[thread id: %1] locked" )
-					   .arg( QString::fromStdString( tmpStream.str() ) ) );
+					   .arg( currentThreadId() ) );
 	}
 #endif
 }
@@ -195,13 +211,10 @@ void AudioEngine::lock( const char* file, unsigned int line, const char* functio
 bool AudioEngine::tryLock( const char* file, unsigned int line, const char* function )
 {
 #ifdef H2CORE_HAVE_DEBUG
-	// Is there a more convenient way to convert the thread id to QSTring?
-	std::stringstream tmpStream;
-	tmpStream << std::this_thread::get_id();
 	if ( __logger->should_log( Logger::Locks ) ) {
 		__logger->log( Logger::Locks, _class_name(), __FUNCTION__,
 					   QString( "[thread id: %1] : %2 : [line: %3] : %4" )
-					   .arg( QString::fromStdString( tmpStream.str() ) )
+					   .arg( currentThreadId() )
 					   .arg( function ).arg( line ).arg( file ) );
 	}
 #endif
@@ -220,7 +233,7 @@ bool AudioEngine::tryLock( const char* file, unsigned int line, const char* func
 	if ( __logger->should_log( Logger::Locks ) ) {
 		__logger->log( Logger::Locks, _class_name(), __FUNCTION__,
 					   QString( "[thread id: %1] locked" )
-					   .arg( QString::fromStdString( tmpStream.str() ) ) );
+					   .arg( currentThreadId() ) );
 	}
 #endif
 
@@ -229,13 +242,11 @@ bool AudioEngine::tryLock( const char* file, unsigned int line, const char* func
 
 bool AudioEngine::tryLockFor( const std::chrono::microseconds& duration, const char* file, unsigned int line, const char* function )
 {
-	std::stringstream tmpStream;
-	tmpStream << std::this_thread::get_id();
 #ifdef H2CORE_HAVE_DEBUG
 	if ( __logger->should_log( Logger::Locks ) ) {
 		__logger->log( Logger::Locks, _class_name(), __FUNCTION__,
 					   QString( "[thread id: %1] : %2 : [line: %3] : %4" )
-					   .arg( QString::fromStdString( tmpStream.str() ) )
+					   .arg( currentThreadId() )
 					   .arg( function ).arg( line ).arg( file ) );
 	}
 #endif
@@ -244,7 +255,7 @@ bool AudioEngine::tryLockFor( const std::chrono::microseconds& duration, const c
 	if ( !res ) {
 		// Lock not obtained
 		AE_WARNINGLOG( QString( "[thread id: %1] : Lock timeout: lock timeout %2:%3:%4, lock held by %5:%6:%7" )
-					   .arg( QString::fromStdString( tmpStream.str() ) )
+					   .arg( currentThreadId() )
 					   .arg( file ).arg( function ).arg( line )
 					   .arg( m_pLocker.file ).arg( m_pLocker.function )
 					   .arg( m_pLocker.line ));
@@ -260,7 +271,7 @@ bool AudioEngine::tryLockFor( const std::chrono::microseconds& duration, const c
 	if ( __logger->should_log( Logger::Locks ) ) {
 		__logger->log( Logger::Locks, _class_name(), __FUNCTION__,
 					   QString( "[thread id: %1] locked" )
-					   .arg( QString::fromStdString( tmpStream.str() ) ) );
+					   .arg( currentThreadId() ) );
 	}
 #endif
 
@@ -277,12 +288,10 @@ void AudioEngine::unlock()
 	m_EngineMutex.unlock();
 
 #ifdef H2CORE_HAVE_DEBUG
-	std::stringstream tmpStream;
-	tmpStream << std::this_thread::get_id();
 	if ( __logger->should_log( Logger::Locks ) ) {
 		__logger->log( Logger::Locks, _class_name(), __FUNCTION__,
 					   QString( "[thread id: %1]" )
-					   .arg( QString::fromStdString( tmpStream.str() ) ) );
+					   .arg( currentThreadId() ) );
 	}
 #endif
 }
@@ -400,6 +409,47 @@ double AudioEngine::computeDoubleTickSize( const int nSampleRate, const float fB
 	return fTickSize;
 }
 
+std::shared_ptr<const TempoMap> AudioEngine::getTempoMap() const
+{
+	return m_tempoMap.load();
+}
+
+void AudioEngine::updateTempoMap()
+{
+	int nSampleRate = 0;
+	if ( m_pAudioDriver != nullptr ) {
+		nSampleRate = m_pAudioDriver->getSampleRate();
+	}
+
+	m_tempoMap.publish( std::make_shared<const TempoMap>(
+		Hydrogen::get_instance()->getSong(), m_fSongSizeInTicks,
+		nSampleRate ) );
+}
+
+void AudioEngine::prefetchTimelineTempi()
+{
+	if ( ! Preferences::get_instance()->getRubberBandBatchMode() ) {
+		return;
+	}
+
+	const auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr || pSong->getTimeline() == nullptr ) {
+		return;
+	}
+
+	std::vector<float> bpms;
+	for ( const auto& ppTempoMarker :
+			  pSong->getTimeline()->getAllTempoMarkers() ) {
+		if ( ppTempoMarker != nullptr ) {
+			bpms.push_back( ppTempoMarker->fBpm );
+		}
+	}
+
+	if ( ! bpms.empty() ) {
+		m_pRubberbandCache->prefetch( bpms );
+	}
+}
+
 float AudioEngine::getElapsedTime() const {
 	
 	const auto pHydrogen = Hydrogen::get_instance();
@@ -975,6 +1025,12 @@ void AudioEngine::clearAudioBuffers( uint32_t nFrames )
 	}
 #endif
 
+	auto pDiskWriterDriver =
+		std::dynamic_pointer_cast<DiskWriterDriver>( m_pAudioDriver );
+	if ( pDiskWriterDriver != nullptr ) {
+		pDiskWriterDriver->clearTrackBuffers( nFrames );
+	}
+
 	m_MutexOutputPointer.unlock();
 
 #ifdef H2CORE_HAVE_LADSPA
@@ -1172,6 +1228,10 @@ void AudioEngine::startAudioDriver( Event::Trigger trigger ) {
 		return;
 	}
 
+	// Buffer size and sample rate might change. Statistics of the previous
+	// driver would be misleading.
+	m_pProfiler->reset();
+
 #ifdef H2CORE_HAVE_JACK
 	auto pJackDriver = std::dynamic_pointer_cast<JackDriver>( m_pMidiDriver );
 	if ( pJackDriver != nullptr &&
@@ -1179,6 +1239,7 @@ void AudioEngine::startAudioDriver( Event::Trigger trigger ) {
 		 pJackDriver->isActive() ) {
 		INFOLOG( "Reusing JACK MIDI driver as audio driver." );
 		m_pAudioDriver = std::static_pointer_cast<AudioDriver>( pJackDriver );
+		updateTempoMap();
 
 		if ( trigger != Event::Trigger::Suppress ) {
 			EventQueue::get_instance()->pushEvent(
@@ -1348,6 +1409,7 @@ void AudioEngine::startMidiDriver( Event::Trigger trigger ) {
 			m_MutexOutputPointer.lock();
 			m_pAudioDriver = pJackDriver;
 			m_MutexOutputPointer.unlock();
+			updateTempoMap();
 			if ( Hydrogen::get_instance()->getSong() != nullptr ) {
 				setState( State::Ready );
 			}
@@ -1597,6 +1659,7 @@ void AudioEngine::handleSongModeChanged( Event::Trigger trigger ) {
 	}
 
 	m_fSongSizeInTicks = pSong->lengthInTicks();
+	updateTempoMap();
 	reset( true, trigger );
 	setNextBpm( pSong->getBpm() );
 }
@@ -1633,7 +1696,7 @@ void AudioEngine::processPlayNotes( unsigned long nframes )
 			float fNoteProbability = pNote->getProbability();
 			if ( fNoteProbability != 1. ) {
 				// Current note is skipped with a certain probability.
-				if ( fNoteProbability < (float) rand() / (float) RAND_MAX ) {
+				if ( fNoteProbability < m_pRandom->getUniform() ) {
 					m_songNoteQueue.pop();
 					pNote->getInstrument()->dequeue( pNote );
 					continue;
@@ -1646,9 +1709,11 @@ void AudioEngine::processPlayNotes( unsigned long nframes )
 			 */
 			auto pNoteInstrument = pNote->getInstrument();
 			if ( pNoteInstrument->isStopNotes() ){
-				auto pOffNote = std::make_shared<Note>( pNoteInstrument );
-				pOffNote->setNoteOff( true );
-				m_pSampler->noteOn( pOffNote );
+				auto pOffNote = m_pNotePool->acquire( pNoteInstrument );
+				if ( pOffNote != nullptr ) {
+					pOffNote->setNoteOff( true );
+					m_pSampler->noteOn( pOffNote );
+				}
 			}
 
 			if ( pNoteInstrument == m_pMetronomeInstrument ) {
@@ -1722,19 +1787,6 @@ void AudioEngine::clearNoteQueues( std::shared_ptr<Instrument> pInstrument )
 		}
 
 	}
-
-	// Notes of MIDI note queue (no instrument enqueued in here).
-	for ( auto it = m_midiNoteQueue.begin(); it != m_midiNoteQueue.end(); ) {
-		auto ppNote = *it;
-		if ( ppNote == nullptr || ppNote->getInstrument() == nullptr ||
-			 ( pInstrument == nullptr ||
-			   ppNote->getInstrument() == pInstrument ) ) {
-			it = m_midiNoteQueue.erase( it );
-		}
-		else {
-			++it;
-		}
-	}
 }
 
 int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
@@ -1753,7 +1805,6 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 	}
 
 	const auto startTimePoint = Clock::now();
-	const auto sDrivers = pAudioEngine->getDriverNames();
 
 	pAudioEngine->clearAudioBuffers( nframes );
 
@@ -1777,10 +1828,18 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 	 * (like shutting down drivers). In such cases, it seems to be ok to interrupt
 	 * audio processing.
 	 */
-	if ( !pAudioEngine->tryLockFor( std::chrono::microseconds( (int)(1000.0*fSlackTime) ),
-							  RIGHT_HERE ) ) {
-		___ERRORLOG( QString( "[%1] Failed to lock audioEngine in allowed %2 ms, missed buffer" )
-					 .arg( sDrivers ).arg( fSlackTime ) );
+	const auto lockStartTimePoint = Clock::now();
+	const bool bLocked = pAudioEngine->tryLockFor(
+		std::chrono::microseconds( (int)(1000.0*fSlackTime) ), RIGHT_HERE );
+	pAudioEngine->m_pProfiler->recordSince(
+		AudioEngineProfiler::Stage::LockWait, lockStartTimePoint );
+	if ( ! bLocked ) {
+		___RT_ERRORLOG( "Failed to lock audioEngine in allowed %1 ms, missed buffer",
+						fSlackTime );
+		pAudioEngine->m_pProfiler->recordMissedCycle(
+			std::chrono::duration<float, std::micro>(
+				Clock::now() - startTimePoint ).count(),
+			pAudioEngine->m_fMaxProcessTime * 1000 );
 
 		if ( pAudioEngine->m_pAudioDriver != nullptr &&
 			 std::dynamic_pointer_cast<DiskWriterDriver>(
@@ -1803,6 +1862,10 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 		return 0;
 	}
 
+	pAudioEngine->m_previousCycleStartTimePoint =
+		pAudioEngine->m_cycleStartTimePoint;
+	pAudioEngine->m_cycleStartTimePoint = startTimePoint;
+
 	auto pHydrogen = Hydrogen::get_instance();
 
 	// Sync transport with server (in case the current audio driver is
@@ -1867,7 +1930,13 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 
 	// always update note queue.. could come from pattern or realtime input
 	// (midi, keyboard)
-	pAudioEngine->updateNoteQueue( nframes );
+	{
+		AudioEngineProfiler::ScopedTimer timer(
+			pAudioEngine->m_pProfiler.get(),
+			AudioEngineProfiler::Stage::UpdateNoteQueue );
+		pAudioEngine->processLiveNotes( nframes );
+		pAudioEngine->updateNoteQueue( nframes );
+	}
 
 	pAudioEngine->processAudio( nframes );
 
@@ -1877,7 +1946,9 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 		if ( pAudioEngine->isEndOfSongReached(
 				 pAudioEngine->m_pPlayhead ) ) {
 
-			___INFOLOG( QString( "[%1] End of song received" ).arg( sDrivers ) );
+			___RT_INFOLOG( "[%1|%2] End of song received",
+						   pAudioEngine->getAudioDriverName(),
+						   pAudioEngine->getMidiDriverName() );
 
 			pAudioEngine->stop();
 			pAudioEngine->stopPlayback();
@@ -1955,21 +2026,27 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 
 	const auto finishTimePoint = Clock::now();
 	pAudioEngine->m_fProcessTime =
-		std::chrono::duration_cast< std::chrono::milliseconds >(
+		std::chrono::duration< float, std::milli >(
 			finishTimePoint - startTimePoint).count();
+	pAudioEngine->m_pProfiler->recordCycle(
+		pAudioEngine->m_fProcessTime * 1000,
+		pAudioEngine->m_fMaxProcessTime * 1000 );
 
 #ifdef CONFIG_DEBUG
 	if ( pAudioEngine->m_fProcessTime > pAudioEngine->m_fMaxProcessTime ) {
-		___WARNINGLOG( "" );
-		___WARNINGLOG( "----XRUN----" );
-		___WARNINGLOG( QString( "[%1] XRUN of %2 msec (%3 > %4)" )
-					   .arg( sDrivers )
-					   .arg( ( pAudioEngine->m_fProcessTime - pAudioEngine->m_fMaxProcessTime ) )
-					   .arg( pAudioEngine->m_fProcessTime )
-					   .arg( pAudioEngine->m_fMaxProcessTime ) );
-		___WARNINGLOG( QString( "Ladspa process time = %1" ).arg( fLadspaTime ) );
-		___WARNINGLOG( "------------" );
-		___WARNINGLOG( "" );
+		___RT_WARNINGLOG( "" );
+		___RT_WARNINGLOG( "----XRUN----" );
+		___RT_WARNINGLOG( "[%1|%2] XRUN of %3 msec (%4 > %5)",
+						  pAudioEngine->getAudioDriverName(),
+						  pAudioEngine->getMidiDriverName(),
+						  pAudioEngine->m_fProcessTime -
+						  pAudioEngine->m_fMaxProcessTime,
+						  pAudioEngine->m_fProcessTime,
+						  pAudioEngine->m_fMaxProcessTime );
+		___RT_WARNINGLOG( "Ladspa process time = %1",
+						  pAudioEngine->m_fLadspaTime );
+		___RT_WARNINGLOG( "------------" );
+		___RT_WARNINGLOG( "" );
 		
 		EventQueue::get_instance()->pushEvent( Event::Type::Xrun, -1 );
 	}
@@ -1987,13 +2064,21 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 		return;
 	}
 
-	processPlayNotes( nFrames );
+	{
+		AudioEngineProfiler::ScopedTimer timer(
+			m_pProfiler.get(), AudioEngineProfiler::Stage::ProcessPlayNotes );
+		processPlayNotes( nFrames );
+	}
 
 	float *pBuffer_L = m_pAudioDriver->getOut_L(),
 		*pBuffer_R = m_pAudioDriver->getOut_R();
 	assert( pBuffer_L != nullptr && pBuffer_R != nullptr );
 
-	getSampler()->process( nFrames );
+	{
+		AudioEngineProfiler::ScopedTimer timer(
+			m_pProfiler.get(), AudioEngineProfiler::Stage::Sampler );
+		getSampler()->process( nFrames );
+	}
 	float* out_L = getSampler()->m_pMainOut_L;
 	float* out_R = getSampler()->m_pMainOut_R;
 	for ( unsigned i = 0; i < nFrames; ++i ) {
@@ -2007,6 +2092,8 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 	for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
 		auto pFX = Effects::get_instance()->getLadspaFX( nFX );
 		if ( pFX != nullptr && pFX->isEnabled() ) {
+			AudioEngineProfiler::ScopedTimer timer(
+				m_pProfiler.get(), AudioEngineProfiler::Stage::LadspaFX, nFX );
 			pFX->processFX( nFrames );
 
 			float *buf_L, *buf_R;
@@ -2034,7 +2121,7 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 
 	const auto ladspaEndTimePoint = Clock::now();
 	m_fLadspaTime =
-		std::chrono::duration_cast< std::chrono::milliseconds >(
+		std::chrono::duration< float, std::milli >(
 			ladspaEndTimePoint - ladspaStartTimePoint).count();
 #else
 	m_fLadspaTime = 0.0;
@@ -2098,6 +2185,10 @@ void AudioEngine::setSong( std::shared_ptr<Song> pNewSong )
 		setupLadspaFX();
 	}
 
+	if ( pNewSong != nullptr ) {
+		updateNotePool( pNewSong->getDrumkit() );
+	}
+
 	float fNextBpm;
 	if ( pNewSong != nullptr ) {
 		fNextBpm = pNewSong->getBpm();
@@ -2107,6 +2198,8 @@ void AudioEngine::setSong( std::shared_ptr<Song> pNewSong )
 		fNextBpm = MIN_BPM;
 		m_fSongSizeInTicks = 4 * H2Core::nTicksPerQuarter;
 	}
+	// Transport positions are computed using the map right below.
+	updateTempoMap();
 	// Reset (among other things) the transport position. This causes
 	// the locate() call below to update the playing patterns.
 	reset( false, Event::Trigger::Suppress );
@@ -2121,6 +2214,7 @@ void AudioEngine::setSong( std::shared_ptr<Song> pNewSong )
 	}
 
 	updateSongSize( Event::Trigger::Suppress );
+	prefetchTimelineTempi();
 }
 
 void AudioEngine::prepare( Event::Trigger trigger ) {
@@ -2138,10 +2232,25 @@ void AudioEngine::prepare( Event::Trigger trigger ) {
 	m_pSampler->stopPlayingNotes();
 	reset( true, trigger );
 	m_fSongSizeInTicks = 4 * H2Core::nTicksPerQuarter;
+	updateTempoMap();
+
+	// Apply changes in the maximum number of notes and release references
+	// to the instruments of the previous song.
+	updateNotePool( nullptr );
 
 	setState( State::Prepared, trigger );
 }
 
+void AudioEngine::updateNotePool( std::shared_ptr<Drumkit> pDrumkit ) {
+	const int nComponents = pDrumkit != nullptr
+		? NotePool::countComponents( pDrumkit )
+		: m_pNotePool->getComponents();
+
+	m_pNotePool->setCapacity(
+		NotePool::nNotesPerVoice * Preferences::get_instance()->m_nMaxNotes,
+		nComponents );
+}
+
 void AudioEngine::updateSongSize( Event::Trigger trigger ) {
 	
 	auto pHydrogen = Hydrogen::get_instance();
@@ -2152,6 +2261,10 @@ void AudioEngine::updateSongSize( Event::Trigger trigger ) {
 		return;
 	}
 
+	// Column lengths might have changed. Has to be done first since all
+	// subsequent calculations rely on it.
+	pHydrogen->updateColumnIndex();
+
 	auto updatePatternSize = []( std::shared_ptr<Transport> pPos ) {
 		if ( pPos->getPlayingPatterns()->size() > 0 ) {
 			// No virtual pattern resolution in here
@@ -2183,6 +2296,7 @@ void AudioEngine::updateSongSize( Event::Trigger trigger ) {
 					Event::Type::SongSizeChanged, 0 );
 			}
 		}
+		updateTempoMap();
 		return;
 	}
 
@@ -2231,7 +2345,9 @@ void AudioEngine::updateSongSize( Event::Trigger trigger ) {
 #endif
 
 	if ( m_fSongSizeInTicks == fNewSongSizeInTicks ) {
-		// Nothing to do
+		// Nothing to do. But the length of individual columns might have
+		// changed nevertheless.
+		updateTempoMap();
 		if ( trigger == Event::Trigger::Force ) {
 			EventQueue::get_instance()->pushEvent(
 				Event::Type::SongSizeChanged, 0 );
@@ -2243,6 +2359,7 @@ void AudioEngine::updateSongSize( Event::Trigger trigger ) {
 				.arg( m_fSongSizeInTicks ).arg( fNewSongSizeInTicks ) );
 
 	m_fSongSizeInTicks = fNewSongSizeInTicks;
+	updateTempoMap();
 
 	auto endOfSongReached = [&](){
 		if ( getState() == State::Playing ) {
@@ -2672,6 +2789,9 @@ void AudioEngine::handleTimelineChange() {
 			 .arg( m_pQueuing->toQString() ) );
 #endif
 
+	updateTempoMap();
+	prefetchTimelineTempi();
+
 	const auto fOldTickSize = m_pPlayhead->getTickSize();
 	updateBpmAndTickSize( m_pPlayhead );
 	updateBpmAndTickSize( m_pQueuing );
@@ -2717,19 +2837,6 @@ void AudioEngine::handleTempoChange() {
 				m_songNoteQueue.push( nnote );
 			}
 		}
-
-		notes.clear();
-		while ( m_midiNoteQueue.size() > 0 ) {
-			notes.push_back( m_midiNoteQueue[ 0 ] );
-			m_midiNoteQueue.pop_front();
-		}
-
-		if ( notes.size() > 0 ) {
-			for ( auto nnote : notes ) {
-				nnote->computeNoteStart();
-				m_midiNoteQueue.push_back( nnote );
-			}
-		}
 	}
 	
 	getSampler()->handleTimelineOrTempoChange();
@@ -2767,34 +2874,6 @@ void AudioEngine::handleSongSizeChange() {
 				m_songNoteQueue.push( ppNote );
 			}
 		}
-
-		notes.clear();
-		while ( m_midiNoteQueue.size() > 0 ) {
-			notes.push_back( m_midiNoteQueue[ 0 ] );
-			m_midiNoteQueue.pop_front();
-		}
-
-		if ( notes.size() > 0 ) {
-			for ( auto ppNote : notes ) {
-
-#if AUDIO_ENGINE_DEBUG
-				AE_DEBUGLOG( QString( "[midi queue] name: %1, pos: %2 -> %3, tick offset: %4, tick offset floored: %5" )
-							 .arg( ppNote->getInstrument() != nullptr ?
-								   ppNote->getInstrument()->getName() :
-								   "nullptr" )
-						  .arg( ppNote->getPosition() )
-						  .arg( std::max( ppNote->getPosition() + nTickOffset,
-										  static_cast<long>(0) ) )
-						  .arg( m_pPlayhead->getTickOffsetSongSize(), 0, 'f' )
-						  .arg( nTickOffset ) );
-#endif
-		
-				ppNote->setPosition( std::max( ppNote->getPosition() + nTickOffset,
-											   static_cast<long>(0) ) );
-				ppNote->computeNoteStart();
-				m_midiNoteQueue.push_back( ppNote );
-			}
-		}
 	}
 	
 	getSampler()->handleSongSizeChange();
@@ -2913,27 +2992,6 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 	long long nLeadLagFactor = computeTickInterval(
 		&fTickStartComp, &fTickEndComp, nIntervalLengthInFrames );
 
-	// MIDI events get put into the `m_songNoteQueue` as well.
-	while ( m_midiNoteQueue.size() > 0 ) {
-		auto pNote = m_midiNoteQueue[0];
-		if ( pNote == nullptr || pNote->getInstrument() == nullptr ) {
-			m_midiNoteQueue.pop_front();
-		}
-		else {
-
-			if ( pNote->getPosition() >
-				 static_cast<int>(coarseGrainTick( fTickEndComp )) ) {
-				break;
-			}
-
-			m_midiNoteQueue.pop_front();
-			pNote->getInstrument()->enqueue( pNote );
-			pNote->computeNoteStart();
-			pNote->humanize();
-			m_songNoteQueue.push( pNote );
-		}
-	}
-
 	// Counting is done without the audio engine rolling. Therefore, triggering
 	// metronome notes have to be handled separately.
 	if ( getState() == State::CountIn ) {
@@ -3005,13 +3063,18 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 			// Since note processing will be done based on m_nRealtimeFrame we
 			// have to use this value when setting the note position. Otherwise,
 			// it will be located in the future or past on tempo changes.
-			auto pMetronomeNote = std::make_shared<Note>(
+			auto pMetronomeNote = m_pNotePool->acquire(
 				m_pMetronomeInstrument,
 				Transport::computeTickFromFrame(
 					m_nRealtimeFrame ),
 				fVelocity,
 				PAN_DEFAULT, // pan
 				LENGTH_ENTIRE_SAMPLE );
+			if ( pMetronomeNote == nullptr ) {
+				// Note pool is exhausted.
+				++m_nCountInMetronomeTicks;
+				continue;
+			}
 
 			if ( m_nCountInMetronomeTicks == 0 ) {
 				pMetronomeNote->setKey( Note::keyFromIntClamp(
@@ -3119,19 +3182,23 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 			// Only trigger the sounds if the user enabled the
 			// metronome.
 			if ( Preferences::get_instance()->m_bUseMetronome ) {
-				auto pMetronomeNote = std::make_shared<Note>(
+				auto pMetronomeNote = m_pNotePool->acquire(
 					m_pMetronomeInstrument, nnTick, fVelocity,
 					PAN_DEFAULT,  // pan
 					LENGTH_ENTIRE_SAMPLE
 				);
-				if ( nMetronomeTickPosition == 0 ) {
-					pMetronomeNote->setKey( Note::keyFromIntClamp(
-						static_cast<int>( Note::KeyDefault ) + 3
-					) );
+				// pMetronomeNote is nullptr in case the note pool is
+				// exhausted.
+				if ( pMetronomeNote != nullptr ) {
+					if ( nMetronomeTickPosition == 0 ) {
+						pMetronomeNote->setKey( Note::keyFromIntClamp(
+							static_cast<int>( Note::KeyDefault ) + 3
+						) );
+					}
+					m_pMetronomeInstrument->enqueue( pMetronomeNote );
+					pMetronomeNote->computeNoteStart();
+					m_songNoteQueue.push( pMetronomeNote );
 				}
-				m_pMetronomeInstrument->enqueue( pMetronomeNote );
-				pMetronomeNote->computeNoteStart();
-				m_songNoteQueue.push( pMetronomeNote );
 			}
 		}
 			
@@ -3170,7 +3237,11 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 					auto pNote = it->second;
 					if ( pNote != nullptr &&
 						 pNote->getInstrument() != nullptr ) {
-						auto pCopiedNote = std::make_shared<Note>( pNote );
+						auto pCopiedNote = m_pNotePool->acquire( pNote );
+						if ( pCopiedNote == nullptr ) {
+							// Note pool is exhausted.
+							continue;
+						}
 
 						// Lead or Lag.
 						// This property is set within the
@@ -3184,7 +3255,7 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 								static_cast<float>(nLeadLagFactor) ));
 						
 						pCopiedNote->setPosition( nnTick );
-						pCopiedNote->humanize();
+						pCopiedNote->humanize( *m_pRandom );
 
 					   /** Swing 16ths
 						* delay the upbeat 16th-notes by a constant
@@ -3237,18 +3308,69 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 	return;
 }
 
-void AudioEngine::noteOn( std::shared_ptr<Note> pNote )
+void AudioEngine::processLiveNotes( uint32_t nFrames )
 {
-	if ( ! ( getState() == State::Playing ||
-			 getState() == State::CountIn ||
-			 getState() == State::Ready ||
-			 getState() == State::Testing ) ) {
-		AE_ERRORLOG( QString( "Error the audio engine is not in unsupported state [%1]" )
-					 .arg( AudioEngine::StateToQString( getState() ) ) );
-		return;
-	}
+	const auto pSong = Hydrogen::get_instance()->getSong();
+	const int nSampleRate = m_pAudioDriver->getSampleRate();
+	const long long nFrame = getCurrentFrame();
+
+	LiveNoteQueue::LiveNote liveNote;
+	while ( m_pLiveNoteQueue->pop( liveNote ) ) {
+		if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+			continue;
+		}
+
+		// The drumkit might have been changed since the note was played.
+		const auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+		if ( ! pInstrumentList->isValidIndex( liveNote.nInstrument ) ) {
+			continue;
+		}
+		auto pInstrument = pInstrumentList->get( liveNote.nInstrument );
+		if ( pInstrument == nullptr || ! pInstrument->hasSamples() ) {
+			continue;
+		}
 
-	m_midiNoteQueue.push_back( pNote );
+		std::shared_ptr<Note> pNote;
+		if ( liveNote.bNoteOff ) {
+			if ( ! m_pSampler->isInstrumentPlaying( pInstrument ) ) {
+				continue;
+			}
+			if ( liveNote.bUseKey ) {
+				m_pSampler->midiKeyboardNoteOff(
+					pInstrument, liveNote.key, liveNote.octave );
+				continue;
+			}
+			pNote = m_pNotePool->acquire( pInstrument );
+			if ( pNote != nullptr ) {
+				pNote->setNoteOff( true );
+			}
+		}
+		else {
+			pNote = m_pNotePool->acquire(
+				pInstrument, 0, liveNote.fVelocity, PAN_DEFAULT );
+			if ( pNote != nullptr && liveNote.bUseKey ) {
+				pNote->setKey( liveNote.key );
+				pNote->setOctave( liveNote.octave );
+			}
+		}
+		if ( pNote == nullptr ) {
+			// Note pool is exhausted.
+			continue;
+		}
+
+		pNote->humanize( *m_pRandom );
+		const int nOffset = LiveNoteQueue::computeFrameOffset(
+			liveNote.timePoint, m_previousCycleStartTimePoint, nSampleRate,
+			static_cast<int>( nFrames ) );
+		// Humanization must neither move the note into the previous nor
+		// beyond the current buffer.
+		pNote->setNoteStart( nFrame + std::clamp(
+			nOffset + pNote->getHumanizeDelay(), 0,
+			static_cast<int>( nFrames ) - 1 ) );
+
+		pInstrument->enqueue( pNote );
+		m_songNoteQueue.push( pNote );
+	}
 }
 
 void AudioEngine::play() {
@@ -3360,6 +3482,18 @@ QString AudioEngine::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( "%1%2m_pSampler: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_pSampler == nullptr ? "nullptr" :
 						   m_pSampler->toQString( sPrefix + s, bShort ) ) )
+			.append( QString( "%1%2m_pNotePool: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_pNotePool == nullptr ? "nullptr" :
+						   m_pNotePool->toQString( sPrefix + s, bShort ) ) )
+			.append( QString( "%1%2m_pProfiler: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_pProfiler == nullptr ? "nullptr" :
+						   m_pProfiler->toQString( sPrefix + s, bShort ) ) )
+			.append( QString( "%1%2m_pRandom: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_pRandom == nullptr ? "nullptr" :
+						   m_pRandom->toQString( sPrefix + s, bShort ) ) )
+			.append( QString( "%1%2m_pLiveNoteQueue: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_pLiveNoteQueue == nullptr ? "nullptr" :
+						   m_pLiveNoteQueue->toQString( sPrefix + s, bShort ) ) )
 			.append( QString( "%1%2m_pAudioDriver: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_pAudioDriver == nullptr ? "nullptr" :
 						   m_pAudioDriver->toQString( sPrefix + s, bShort ) ) )
@@ -3427,13 +3561,7 @@ QString AudioEngine::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( StateToQString( m_nextState ) ) )
 			.append( QString( "%1%2m_songNoteQueue: length = %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_songNoteQueue.size() ) )
-			.append( QString( "%1%2m_midiNoteQueue: [" ).arg( sPrefix ).arg( s ) );
-		for ( const auto& nn : m_midiNoteQueue ) {
-			if ( nn != nullptr ) {
-				sOutput.append( nn->toQString( sPrefix + s, bShort ) ).append( "\n" );
-			}
-		}
-		sOutput.append( QString( "]\n%1%2m_pMetronomeInstrument: %3\n" ).arg( sPrefix ).arg( s )
+			.append( QString( "%1%2m_pMetronomeInstrument: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_pMetronomeInstrument == nullptr ? "nullptr" :
 						   m_pMetronomeInstrument->toQString( sPrefix + s, bShort ) ) )
 			.append( QString( "%1%2m_fNextBpm: %3\n" ).arg( sPrefix ).arg( s )
@@ -3460,6 +3588,18 @@ QString AudioEngine::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( "m_pSampler: %1" )
 					 .arg( m_pSampler == nullptr ? "nullptr" :
 						   m_pSampler->toQString( "", bShort ) ) )
+			.append( QString( ", m_pNotePool: %1" )
+					 .arg( m_pNotePool == nullptr ? "nullptr" :
+						   m_pNotePool->toQString( "", bShort ) ) )
+			.append( QString( ", m_pProfiler: %1" )
+					 .arg( m_pProfiler == nullptr ? "nullptr" :
+						   m_pProfiler->toQString( "", bShort ) ) )
+			.append( QString( ", m_pRandom: %1" )
+					 .arg( m_pRandom == nullptr ? "nullptr" :
+						   m_pRandom->toQString( "", bShort ) ) )
+			.append( QString( ", m_pLiveNoteQueue: %1" )
+					 .arg( m_pLiveNoteQueue == nullptr ? "nullptr" :
+						   m_pLiveNoteQueue->toQString( "", bShort ) ) )
 			.append( QString( ", m_pAudioDriver: %1" )
 					 .arg( m_pAudioDriver == nullptr ? "nullptr" :
 						   m_pAudioDriver->toQString( "", bShort ) ) )
@@ -3527,13 +3667,7 @@ QString AudioEngine::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( StateToQString( m_nextState ) ) )
 			.append( QString( ", m_songNoteQueue: length = %1" )
 					 .arg( m_songNoteQueue.size() ) )
-			.append( ", m_midiNoteQueue: [" );
-		for ( const auto& nn : m_midiNoteQueue ) {
-			if ( nn != nullptr ) {
-				sOutput.append( QString( "[%1], " ).arg( nn->prettyName() ) );
-			}
-		}
-		sOutput.append( QString( "], m_pMetronomeInstrument: %1" )
+			.append( QString( ", m_pMetronomeInstrument: %1" )
 					 .arg( m_pMetronomeInstrument == nullptr ? "nullptr" :
 						   m_pMetronomeInstrument->toQString( sPrefix + s, bShort ) ) )
 			.append( QString( ", m_fNextBpm: %1" )
@@ -3582,86 +3716,73 @@ QString AudioEngine::StateToQString( const State& state ) {
 }
 
 QString AudioEngine::getDriverNames() const {
-	Preferences::AudioDriver audioDriver = Preferences::AudioDriver::Null;
-	QString sMidiDriver( "unknown" );
+	return QString( "%1|%2" )
+		.arg( getAudioDriverName() ).arg( getMidiDriverName() );
+}
 
-	if ( m_pAudioDriver == nullptr ) {
-		audioDriver = Preferences::AudioDriver::None;
+const char* AudioEngine::getAudioDriverName() const {
+	const auto pDriver = m_pAudioDriver.get();
+	if ( pDriver == nullptr ) {
+		return "nullptr";
 	}
-	else if ( std::dynamic_pointer_cast<JackDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::Jack;
+	else if ( dynamic_cast<JackDriver*>( pDriver ) != nullptr ) {
+		return "JACK";
 	}
-	else if ( std::dynamic_pointer_cast<PortAudioDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::PortAudio;
+	else if ( dynamic_cast<PortAudioDriver*>( pDriver ) != nullptr ) {
+		return "PortAudio";
 	}
-	else if ( std::dynamic_pointer_cast<CoreAudioDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::CoreAudio;
+	else if ( dynamic_cast<CoreAudioDriver*>( pDriver ) != nullptr ) {
+		return "CoreAudio";
 	}
-	else if ( std::dynamic_pointer_cast<PulseAudioDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::PulseAudio;
+	else if ( dynamic_cast<PulseAudioDriver*>( pDriver ) != nullptr ) {
+		return "PulseAudio";
 	}
-	else if ( std::dynamic_pointer_cast<OssDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::Oss;
+	else if ( dynamic_cast<OssDriver*>( pDriver ) != nullptr ) {
+		return "OSS";
 	}
-	else if ( std::dynamic_pointer_cast<AlsaAudioDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::Alsa;
+	else if ( dynamic_cast<AlsaAudioDriver*>( pDriver ) != nullptr ) {
+		return "ALSA";
 	}
-	else if ( std::dynamic_pointer_cast<FakeAudioDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::Fake;
+	else if ( dynamic_cast<FakeAudioDriver*>( pDriver ) != nullptr ) {
+		return "Fake";
 	}
-	else if ( std::dynamic_pointer_cast<NullDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::Null;
-	}
-	else if ( std::dynamic_pointer_cast<DiskWriterDriver>( m_pAudioDriver ) !=
-			  nullptr ) {
-		audioDriver = Preferences::AudioDriver::Disk;
+	else if ( dynamic_cast<DiskWriterDriver*>( pDriver ) != nullptr ) {
+		return "Disk";
 	}
 
-	if ( m_pMidiDriver == nullptr ) {
-		sMidiDriver = "nullptr";
+	return "Null";
+}
+
+const char* AudioEngine::getMidiDriverName() const {
+	const auto pDriver = m_pMidiDriver.get();
+	if ( pDriver == nullptr ) {
+		return "nullptr";
 #ifdef H2CORE_HAVE_ALSA
 	}
-	else if ( std::dynamic_pointer_cast<AlsaMidiDriver>( m_pMidiDriver ) !=
-			  nullptr ) {
-		sMidiDriver = "ALSA";
+	else if ( dynamic_cast<AlsaMidiDriver*>( pDriver ) != nullptr ) {
+		return "ALSA";
 #endif
 #ifdef H2CORE_HAVE_PORTMIDI
 	}
-	else if ( std::dynamic_pointer_cast<PortMidiDriver>( m_pMidiDriver ) !=
-			  nullptr ) {
-		sMidiDriver = "PortMidi";
+	else if ( dynamic_cast<PortMidiDriver*>( pDriver ) != nullptr ) {
+		return "PortMidi";
 #endif
 #ifdef H2CORE_HAVE_COREMIDI
 	}
-	else if ( std::dynamic_pointer_cast<CoreMidiDriver>( m_pMidiDriver ) !=
-			  nullptr ) {
-		sMidiDriver = "CoreMidi";
+	else if ( dynamic_cast<CoreMidiDriver*>( pDriver ) != nullptr ) {
+		return "CoreMidi";
 #endif
 #ifdef H2CORE_HAVE_JACK
 	}
-	else if ( std::dynamic_pointer_cast<JackDriver>( m_pMidiDriver ) !=
-			  nullptr ) {
-		sMidiDriver = "JACK";
+	else if ( dynamic_cast<JackDriver*>( pDriver ) != nullptr ) {
+		return "JACK";
 #endif
 	}
-	else if ( std::dynamic_pointer_cast<LoopBackMidiDriver>( m_pMidiDriver ) !=
-			  nullptr ) {
-		sMidiDriver = "LoopBack";
+	else if ( dynamic_cast<LoopBackMidiDriver*>( pDriver ) != nullptr ) {
+		return "LoopBack";
 	}
 
-	auto res = QString( "%1|%2" )
-		.arg( Preferences::audioDriverToQString( audioDriver ) )
-		.arg( sMidiDriver );
-
-	return std::move( res );
+	return "unknown";
 }
 
 
@@ -23,12 +23,17 @@
 #ifndef AUDIO_ENGINE_H
 #define AUDIO_ENGINE_H
 
+#include <core/AudioEngine/AudioEngineProfiler.h>
 #include <core/AudioEngine/AudioEngineTests.h>
+#include <core/AudioEngine/LiveNoteQueue.h>
+#include <core/AudioEngine/NotePool.h>
+#include <core/AudioEngine/TempoMap.h>
 #include <core/AudioEngine/Transport.h>
 #include <core/Basics/Event.h>
 #include <core/Basics/Note.h>
 #include <core/config.h>
 #include <core/CoreActionController.h>
+#include <core/Helpers/RtSharedPtr.h>
 #include <core/Hydrogen.h>
 #include <core/IO/AudioDriver.h>
 #include <core/IO/DiskWriterDriver.h>
@@ -36,6 +41,7 @@
 #include <core/IO/JackDriver.h>
 #include <core/Object.h>
 #include <core/Preferences/Preferences.h>
+#include <core/Sampler/RubberbandCache.h>
 #include <core/Sampler/Sampler.h>
 
 
@@ -68,6 +74,7 @@ namespace H2Core
 	class Instrument;
 	class MidiBaseDriver;
 	class PatternList;
+	class Random;
 	class Song;
 
 /**
@@ -249,7 +256,6 @@ public:
 	 */
 	void			assertLocked( const QString& sClass, const char* sFunction,
 								  const QString& sMsg );
-	void			noteOn( std::shared_ptr<Note> pNote );
 
 	/**
 	 * Main audio processing function called by the audio drivers whenever
@@ -271,6 +277,49 @@ public:
 	static double computeDoubleTickSize(const int nSampleRate, const float fBpm );
 
 	Sampler*		getSampler() const;
+	/** Notes handed over to the #Sampler during playback are taken from
+	 * this pool. */
+	std::shared_ptr<NotePool> getNotePool() const;
+	/** Adapts the capacity of the #NotePool to #Preferences::m_nMaxNotes and
+	 * preallocates the layer infos of its notes to cover all components of
+	 * the instruments in @a pDrumkit. Passing `nullptr` keeps the current
+	 * number of components.
+	 *
+	 * Allocates memory. Has to be called while holding the lock of the audio
+	 * engine whenever instruments or drumkits are added or replaced. */
+	void updateNotePool( std::shared_ptr<Drumkit> pDrumkit );
+	/** Per-stage timing of audioEngine_process(). */
+	std::shared_ptr<AudioEngineProfiler> getProfiler() const;
+	/** Source of all random contributions during playback - humanization,
+	 * note probability, and random layer selection. Must only be accessed
+	 * while the audio engine is locked. */
+	std::shared_ptr<Random> getRandom() const;
+	/** Notes played live are passed to the audio thread using this queue
+	 * without locking the audio engine. */
+	std::shared_ptr<LiveNoteQueue> getLiveNoteQueue() const;
+	/** Point in time the current process cycle started at. Must only be
+	 * accessed from within the audio thread. */
+	const TimePoint& getCycleStartTimePoint() const;
+	/** Samples stretched in the background whenever the tempo changes
+	 * while #Preferences::getRubberBandBatchMode() is enabled. */
+	std::shared_ptr<RubberbandCache> getRubberbandCache() const;
+	/** Tempo segments of the #Timeline used to convert between ticks and
+	 * frames.
+	 *
+	 * The map is rebuilt outside of the audio thread using updateTempoMap()
+	 * whenever the song, its size, the #Timeline, or the audio driver
+	 * changes. This getter itself is lock-free and does neither create nor
+	 * release a map. It is thus safe to call it from within the audio
+	 * thread.
+	 *
+	 * The map is always created for the sample rate of the current audio
+	 * driver. */
+	std::shared_ptr<const TempoMap> getTempoMap() const;
+	/** Creates a #TempoMap for the current song, song size, and sample rate
+	 * of the audio driver and publishes it.
+	 *
+	 * Must not be called from within the audio thread. */
+	void updateTempoMap();
 
 	/** \return Time passed since the beginning of the song*/
 	float			getElapsedTime() const;	
@@ -515,7 +564,7 @@ private:
 	 */
 	double coarseGrainTick( double fTick );
 
-		/** Flush the incoming MIDI note queue and song note queue.
+		/** Flush the song note queue.
 		 *
 		 * @param pInstrument particular instrument for which notes will be
 		 *   removed (`nullptr` to release them all) */
@@ -525,11 +574,17 @@ private:
 	 */
 	void			clearAudioBuffers( uint32_t nFrames );
 	/**
-	 * Takes all notes from the currently playing patterns, from the
-	 * MIDI queue #m_midiNoteQueue, and those triggered by the
-	 * metronome and pushes them onto #m_songNoteQueue for playback.
+	 * Takes all notes from the currently playing patterns and those
+	 * triggered by the metronome and pushes them onto #m_songNoteQueue for
+	 * playback.
 	 */
 	void			updateNoteQueue( unsigned nIntervalLengthInFrames );
+	/**
+	 * Drains #m_pLiveNoteQueue and pushes the corresponding notes onto
+	 * #m_songNoteQueue. Based on their time stamps, they are placed within
+	 * the @a nFrames frames of the current buffer.
+	 */
+	void			processLiveNotes( uint32_t nFrames );
 	void 			processAudio( uint32_t nFrames );
 	long long 		computeTickInterval( double* fTickStart, double* fTickEnd, unsigned nIntervalLengthInFrames );
 	void			updateBpmAndTickSize( std::shared_ptr<Transport> pTransport,
@@ -585,15 +640,15 @@ private:
 	void startCountIn();
 
 	/**
-	 * Updates all notes in #m_songNoteQueue and #m_midiNoteQueue to
-	 * be still valid after a tempo change.
+	 * Updates all notes in #m_songNoteQueue to be still valid after a
+	 * tempo change.
 	 */
 	void handleTempoChange();
 
 	/**
 	 * Updates the transport states and all notes in #m_songNoteQueue
-	 * and #m_midiNoteQueue after adding or deleting a TempoMarker or
-	 * enabling/disabling the #Timeline.
+	 * after adding or deleting a TempoMarker or enabling/disabling the
+	 * #Timeline.
 	 *
 	 * If the #Timeline is activated, adding or removing a TempoMarker
 	 * does effectively has the same effects as a relocation with
@@ -629,8 +684,29 @@ private:
 	void handleSongModeChanged( Event::Trigger trigger );
 
 	QString getDriverNames() const;
+	/** Realtime-safe counterparts of getDriverNames().
+	 *
+	 * @return string literal naming the current audio/MIDI driver. */
+	const char* getAudioDriverName() const;
+	const char* getMidiDriverName() const;
+
+	/** Asks the #RubberbandCache to stretch all samples to the tempi of the
+	 * current #Timeline in advance. */
+	void prefetchTimelineTempi();
 
 	Sampler* 			m_pSampler;
+	std::shared_ptr<NotePool> m_pNotePool;
+	std::shared_ptr<AudioEngineProfiler> m_pProfiler;
+	std::shared_ptr<Random> m_pRandom;
+	std::shared_ptr<LiveNoteQueue> m_pLiveNoteQueue;
+	/** Start of the current and the previous process cycle. The latter is
+	 * used as reference for placing live notes within the buffer. */
+	TimePoint m_cycleStartTimePoint;
+	TimePoint m_previousCycleStartTimePoint;
+	std::shared_ptr<RubberbandCache> m_pRubberbandCache;
+	/** Read by both the audio and the GUI thread without holding the lock
+	 * of the audio engine. */
+	RtSharedPtr<TempoMap> m_tempoMap;
 	std::shared_ptr<AudioDriver> m_pAudioDriver;
 	std::shared_ptr<MidiBaseDriver> m_pMidiDriver;
 
@@ -737,7 +813,6 @@ private:
 
 	std::priority_queue<std::shared_ptr<Note>,
 		std::deque<std::shared_ptr<Note>>, Note::compareStartStruct > m_songNoteQueue;
-	std::deque<std::shared_ptr<Note>>	m_midiNoteQueue;	///< Midi Note FIFO
 	
 	/**
 	 * Pointer to the metronome.
@@ -892,6 +967,25 @@ inline int AudioEngine::getEnqueuedNotesNumber() const {
 inline long long AudioEngine::getLastLoopFrame() const {
 	return m_nLastLoopFrame;
 }
+inline std::shared_ptr<NotePool> AudioEngine::getNotePool() const {
+	return m_pNotePool;
+}
+
+inline std::shared_ptr<AudioEngineProfiler> AudioEngine::getProfiler() const {
+	return m_pProfiler;
+}
+inline std::shared_ptr<Random> AudioEngine::getRandom() const {
+	return m_pRandom;
+}
+inline std::shared_ptr<LiveNoteQueue> AudioEngine::getLiveNoteQueue() const {
+	return m_pLiveNoteQueue;
+}
+inline const TimePoint& AudioEngine::getCycleStartTimePoint() const {
+	return m_cycleStartTimePoint;
+}
+inline std::shared_ptr<RubberbandCache> AudioEngine::getRubberbandCache() const {
+	return m_pRubberbandCache;
+}
 };
 
 #endif
@@ -0,0 +1,233 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/AudioEngine/AudioEngineProfiler.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace H2Core {
+
+QString AudioEngineProfiler::StageToQString( const Stage& stage, int nSlot ) {
+	switch ( stage ) {
+	case Stage::Cycle:
+		return "Cycle";
+	case Stage::LockWait:
+		return "LockWait";
+	case Stage::UpdateNoteQueue:
+		return "UpdateNoteQueue";
+	case Stage::ProcessPlayNotes:
+		return "ProcessPlayNotes";
+	case Stage::Sampler:
+		return "Sampler";
+	case Stage::LadspaFX:
+		return QString( "LadspaFX%1" ).arg( nSlot );
+	case Stage::DriverIO:
+		return "DriverIO";
+	default:
+		return "Unknown stage";
+	}
+}
+
+AudioEngineProfiler::AudioEngineProfiler()
+	: m_nOverruns( 0 ), m_nMissedCycles( 0 ), m_fBudget( 0 ) {
+	for ( int nn = 0; nn < nStages; ++nn ) {
+		if ( nn < timerIndex( Stage::LadspaFX, 0 ) ) {
+			m_names[ nn ] = StageToQString( static_cast<Stage>( nn ) );
+		}
+		else if ( nn < timerIndex( Stage::DriverIO, 0 ) ) {
+			m_names[ nn ] = StageToQString(
+				Stage::LadspaFX, nn - timerIndex( Stage::LadspaFX, 0 ) );
+		}
+		else {
+			m_names[ nn ] = StageToQString( Stage::DriverIO );
+		}
+	}
+	reset();
+}
+
+AudioEngineProfiler::~AudioEngineProfiler() {
+}
+
+int AudioEngineProfiler::timerIndex( Stage stage, int nSlot ) {
+	switch ( stage ) {
+	case Stage::LadspaFX:
+		return static_cast<int>( Stage::LadspaFX ) +
+			std::clamp( nSlot, 0, MAX_FX - 1 );
+	case Stage::DriverIO:
+		return static_cast<int>( Stage::LadspaFX ) + MAX_FX;
+	default:
+		return static_cast<int>( stage );
+	}
+}
+
+void AudioEngineProfiler::record( Stage stage, float fMicroseconds,
+								  int nSlot ) {
+	auto& timer = m_timers[ timerIndex( stage, nSlot ) ];
+
+	// There is only a single writer. Relaxed ordering is sufficient since
+	// readers do not require a consistent snapshot.
+	const auto nCount = timer.nCount.load( std::memory_order_relaxed );
+	timer.samples[ nCount % nWindowSize ].store(
+		fMicroseconds, std::memory_order_relaxed );
+	timer.nCount.store( nCount + 1, std::memory_order_release );
+
+	if ( fMicroseconds > timer.fPeak.load( std::memory_order_relaxed ) ) {
+		timer.fPeak.store( fMicroseconds, std::memory_order_relaxed );
+	}
+}
+
+void AudioEngineProfiler::recordCycle( float fMicroseconds,
+									   float fBudgetMicroseconds ) {
+	record( Stage::Cycle, fMicroseconds );
+	m_fBudget.store( fBudgetMicroseconds, std::memory_order_relaxed );
+	if ( fBudgetMicroseconds > 0 && fMicroseconds > fBudgetMicroseconds ) {
+		m_nOverruns.fetch_add( 1, std::memory_order_relaxed );
+	}
+}
+
+void AudioEngineProfiler::recordMissedCycle( float fMicroseconds,
+											 float fBudgetMicroseconds ) {
+	record( Stage::Cycle, fMicroseconds );
+	m_fBudget.store( fBudgetMicroseconds, std::memory_order_relaxed );
+	m_nOverruns.fetch_add( 1, std::memory_order_relaxed );
+	m_nMissedCycles.fetch_add( 1, std::memory_order_relaxed );
+}
+
+void AudioEngineProfiler::reset() {
+	for ( auto& ttimer : m_timers ) {
+		for ( auto& ssample : ttimer.samples ) {
+			ssample.store( 0, std::memory_order_relaxed );
+		}
+		ttimer.nCount.store( 0, std::memory_order_relaxed );
+		ttimer.fPeak.store( 0, std::memory_order_relaxed );
+	}
+	m_nOverruns.store( 0, std::memory_order_relaxed );
+	m_nMissedCycles.store( 0, std::memory_order_relaxed );
+	m_fBudget.store( 0, std::memory_order_relaxed );
+}
+
+AudioEngineProfiler::Statistics AudioEngineProfiler::computeStatistics(
+	int nTimer ) const {
+	const auto& timer = m_timers[ nTimer ];
+
+	Statistics statistics;
+	statistics.sName = m_names[ nTimer ];
+	statistics.nCount = timer.nCount.load( std::memory_order_acquire );
+	statistics.fPeak = timer.fPeak.load( std::memory_order_relaxed );
+
+	const int nSamples = static_cast<int>(
+		std::min<long long>( statistics.nCount, nWindowSize ) );
+	if ( nSamples == 0 ) {
+		return statistics;
+	}
+
+	std::vector<float> samples( nSamples );
+	for ( int ii = 0; ii < nSamples; ++ii ) {
+		samples[ ii ] = timer.samples[ ii ].load( std::memory_order_relaxed );
+	}
+	std::sort( samples.begin(), samples.end() );
+
+	// Nearest-rank percentiles.
+	auto percentile = [&]( float fPercent ) {
+		const int nRank = static_cast<int>(
+			std::ceil( fPercent / 100 * nSamples ) );
+		return samples[ std::clamp( nRank - 1, 0, nSamples - 1 ) ];
+	};
+	statistics.fP50 = percentile( 50 );
+	statistics.fP99 = percentile( 99 );
+	statistics.fMax = samples.back();
+
+	return statistics;
+}
+
+std::vector<AudioEngineProfiler::Statistics>
+AudioEngineProfiler::getStatistics() const {
+	std::vector<Statistics> statistics;
+	statistics.reserve( nStages );
+	for ( int nn = 0; nn < nStages; ++nn ) {
+		statistics.push_back( computeStatistics( nn ) );
+	}
+	return statistics;
+}
+
+AudioEngineProfiler::Statistics AudioEngineProfiler::getStatistics(
+	Stage stage, int nSlot ) const {
+	return computeStatistics( timerIndex( stage, nSlot ) );
+}
+
+QString AudioEngineProfiler::formatStatistics() const {
+	QString sOutput = QString( "%1 %2 %3 %4 %5 %6\n" )
+		.arg( "Stage [us]", -18 ).arg( "p50", 9 ).arg( "p99", 9 )
+		.arg( "max", 9 ).arg( "peak", 9 ).arg( "count", 10 );
+
+	for ( const auto& sstatistics : getStatistics() ) {
+		sOutput.append( QString( "%1 %2 %3 %4 %5 %6\n" )
+						.arg( sstatistics.sName, -18 )
+						.arg( sstatistics.fP50, 9, 'f', 1 )
+						.arg( sstatistics.fP99, 9, 'f', 1 )
+						.arg( sstatistics.fMax, 9, 'f', 1 )
+						.arg( sstatistics.fPeak, 9, 'f', 1 )
+						.arg( sstatistics.nCount, 10 ) );
+	}
+	sOutput.append( QString( "Overruns: %1 (missed cycles: %2, budget: %3 us)" )
+					.arg( getOverruns() ).arg( getMissedCycles() )
+					.arg( getBudget(), 0, 'f', 1 ) );
+
+	return sOutput;
+}
+
+QString AudioEngineProfiler::toQString( const QString& sPrefix,
+										bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[AudioEngineProfiler]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nOverruns: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( getOverruns() ) )
+			.append( QString( "%1%2m_nMissedCycles: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( getMissedCycles() ) )
+			.append( QString( "%1%2m_fBudget: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( getBudget() ) );
+		for ( const auto& sstatistics : getStatistics() ) {
+			sOutput.append( QString( "%1%2%3: p50: %4, p99: %5, max: %6, peak: %7, count: %8\n" )
+							.arg( sPrefix ).arg( s ).arg( sstatistics.sName )
+							.arg( sstatistics.fP50 ).arg( sstatistics.fP99 )
+							.arg( sstatistics.fMax ).arg( sstatistics.fPeak )
+							.arg( sstatistics.nCount ) );
+		}
+	}
+	else {
+		sOutput = QString( "[AudioEngineProfiler] m_nOverruns: %1" )
+			.arg( getOverruns() )
+			.append( QString( ", m_nMissedCycles: %1" )
+					 .arg( getMissedCycles() ) )
+			.append( QString( ", m_fBudget: %1" ).arg( getBudget() ) );
+		const auto cycle = getStatistics( Stage::Cycle );
+		sOutput.append( QString( ", Cycle: [p50: %1, p99: %2, max: %3]" )
+						.arg( cycle.fP50 ).arg( cycle.fP99 )
+						.arg( cycle.fMax ) );
+	}
+
+	return sOutput;
+}
+
+};	// namespace H2Core
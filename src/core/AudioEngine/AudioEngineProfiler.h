@@ -0,0 +1,212 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef AUDIO_ENGINE_PROFILER_H
+#define AUDIO_ENGINE_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include <core/config.h>
+#include <core/Helpers/Time.h>
+#include <core/Object.h>
+
+namespace H2Core {
+
+/**
+ * Per-stage timing of the audio callback.
+ *
+ * Each stage of AudioEngine::audioEngine_process() - waiting for the lock,
+ * updating the note queue, handing notes to the #Sampler, rendering,
+ * processing each LADSPA slot - as well as the blocking I/O of drivers
+ * writing to the hardware themselves is timed with sub-microsecond
+ * resolution. The most recent #nWindowSize durations of each stage are
+ * kept in a ring buffer from which percentiles are derived on demand.
+ *
+ * All recording methods are lock-free, realtime-safe, and must only be
+ * called from the audio thread. The statistics can be queried from any
+ * other thread. Since samples are overwritten while being read, the
+ * resulting numbers are approximate.
+ */
+/** \ingroup docCore docAudioEngine docDebugging */
+class AudioEngineProfiler : public H2Core::Object<AudioEngineProfiler> {
+	H2_OBJECT( AudioEngineProfiler )
+   public:
+	enum class Stage {
+		/** Whole audio callback including waiting for the lock. */
+		Cycle = 0,
+		/** Waiting for the lock of the #AudioEngine. */
+		LockWait = 1,
+		UpdateNoteQueue = 2,
+		ProcessPlayNotes = 3,
+		Sampler = 4,
+		/** Processing a single LADSPA slot. Requires a slot number. */
+		LadspaFX = 5,
+		/** Writing the rendered buffer to a device in drivers which do
+		 * blocking I/O. */
+		DriverIO = 6
+	};
+	static QString StageToQString( const Stage& stage, int nSlot = 0 );
+
+	/** Number of durations per stage used to derive the statistics. */
+	static constexpr int nWindowSize = 1024;
+
+	/** Rolling statistics of a single stage. All durations are in
+	 * microseconds. */
+	struct Statistics {
+		QString sName;
+		float fP50 = 0;
+		float fP99 = 0;
+		/** Maximum within the rolling window. */
+		float fMax = 0;
+		/** Maximum since the last reset(). */
+		float fPeak = 0;
+		/** Number of durations recorded since the last reset(). */
+		long long nCount = 0;
+	};
+
+	/** Measures the time between its construction and destruction. */
+	class ScopedTimer {
+	   public:
+		ScopedTimer( AudioEngineProfiler* pProfiler, Stage stage,
+					 int nSlot = 0 );
+		~ScopedTimer();
+
+	   private:
+		AudioEngineProfiler* m_pProfiler;
+		Stage m_stage;
+		int m_nSlot;
+		TimePoint m_start;
+	};
+
+	AudioEngineProfiler();
+	~AudioEngineProfiler();
+
+	/** Adds @a fMicroseconds to the window of @a stage.
+	 *
+	 * Realtime-safe. */
+	void record( Stage stage, float fMicroseconds, int nSlot = 0 );
+	/** Adds the time passed since @a start to the window of @a stage.
+	 *
+	 * Realtime-safe. */
+	void recordSince( Stage stage, const TimePoint& start, int nSlot = 0 );
+
+	/** Records a whole audio cycle and counts it as overrun in case
+	 * @a fMicroseconds exceeds @a fBudgetMicroseconds - the duration of the
+	 * buffer - which results in an xrun in the driver.
+	 *
+	 * Realtime-safe. */
+	void recordCycle( float fMicroseconds, float fBudgetMicroseconds );
+	/** Records an audio cycle in which the lock of the #AudioEngine could
+	 * not be acquired in time and the buffer was dropped. It counts both
+	 * as missed cycle and as overrun.
+	 *
+	 * Realtime-safe. */
+	void recordMissedCycle( float fMicroseconds, float fBudgetMicroseconds );
+
+	/** Discards all recorded durations and overruns.
+	 *
+	 * Must not be called while the audio thread is running. */
+	void reset();
+
+	/** \return statistics of all stages. Allocates memory and must not be
+	 *   called from within the audio thread. */
+	std::vector<Statistics> getStatistics() const;
+	/** \return Statistics of a single stage. */
+	Statistics getStatistics( Stage stage, int nSlot = 0 ) const;
+
+	/** Number of audio cycles which took longer than the duration of the
+	 * buffer. */
+	long long getOverruns() const;
+	/** Number of audio cycles dropped because the #AudioEngine could not
+	 * be locked. */
+	long long getMissedCycles() const;
+	/** Duration of the buffer used in the last cycle in microseconds. */
+	float getBudget() const;
+
+	/** Human-readable table of all statistics, one stage per line. */
+	QString formatStatistics() const;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true )
+		const override;
+
+   private:
+	struct Timer {
+		std::array<std::atomic<float>, nWindowSize> samples;
+		/** Total number of durations recorded. The next one will be
+		 * written to `samples[ nCount % nWindowSize ]`. */
+		std::atomic<long long> nCount;
+		std::atomic<float> fPeak;
+	};
+
+	static constexpr int nStages = 6 + MAX_FX;
+	static int timerIndex( Stage stage, int nSlot );
+	Statistics computeStatistics( int nTimer ) const;
+
+	std::array<Timer, nStages> m_timers;
+	std::array<QString, nStages> m_names;
+	std::atomic<long long> m_nOverruns;
+	std::atomic<long long> m_nMissedCycles;
+	std::atomic<float> m_fBudget;
+};
+
+inline long long AudioEngineProfiler::getOverruns() const {
+	return m_nOverruns.load( std::memory_order_relaxed );
+}
+
+inline long long AudioEngineProfiler::getMissedCycles() const {
+	return m_nMissedCycles.load( std::memory_order_relaxed );
+}
+
+inline float AudioEngineProfiler::getBudget() const {
+	return m_fBudget.load( std::memory_order_relaxed );
+}
+
+inline AudioEngineProfiler::ScopedTimer::ScopedTimer(
+	AudioEngineProfiler* pProfiler, Stage stage, int nSlot )
+	: m_pProfiler( pProfiler ), m_stage( stage ), m_nSlot( nSlot ),
+	  m_start( Clock::now() ) {
+}
+
+inline AudioEngineProfiler::ScopedTimer::~ScopedTimer() {
+	m_pProfiler->recordSince( m_stage, m_start, m_nSlot );
+}
+
+inline void AudioEngineProfiler::recordSince( Stage stage,
+											  const TimePoint& start,
+											  int nSlot ) {
+	record( stage,
+			std::chrono::duration<float, std::micro>( Clock::now() - start )
+				.count(),
+			nSlot );
+}
+
+};	// namespace H2Core
+
+#endif
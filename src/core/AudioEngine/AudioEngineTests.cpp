@@ -41,6 +41,7 @@
 #include <core/Sampler/Sampler.h>
 #include <core/Timeline.h>
 
+#include <array>
 #include <random>
 #include <stdexcept>
 
@@ -2227,7 +2228,111 @@ void AudioEngineTests::testUpdateTransport() {
 	pHydrogen->setSong( pSong );
 }
 
+void AudioEngineTests::benchmarkSetUp() {
+	auto pAE = Hydrogen::get_instance()->getAudioEngine();
+
+	pAE->lock( RIGHT_HERE );
+	pAE->setState( AudioEngine::State::Testing );
+	pAE->reset( false );
+	pAE->unlock();
+}
+
+void AudioEngineTests::benchmarkTearDown() {
+	auto pAE = Hydrogen::get_instance()->getAudioEngine();
+
+	pAE->lock( RIGHT_HERE );
+	pAE->clearNoteQueues();
+	pAE->getSampler()->stopPlayingNotes();
+	pAE->reset( false );
+	pAE->setState( AudioEngine::State::Ready );
+	pAE->unlock();
+}
+
+int AudioEngineTests::benchmarkUpdateNoteQueue( uint32_t nFrames ) {
+	auto pAE = Hydrogen::get_instance()->getAudioEngine();
+
+	pAE->lock( RIGHT_HERE );
+	pAE->updateNoteQueue( nFrames );
+	const int nNotes = pAE->m_songNoteQueue.size();
+	pAE->clearNoteQueues();
+	pAE->incrementPlayhead( nFrames );
+	pAE->unlock();
+
+	return nNotes;
+}
+
+void AudioEngineTests::processCycle( uint32_t nFrames ) {
+	auto pAE = Hydrogen::get_instance()->getAudioEngine();
+
+	pAE->lock( RIGHT_HERE );
+	pAE->updateNoteQueue( nFrames );
+	pAE->processAudio( nFrames );
+	pAE->incrementPlayhead( nFrames );
+	pAE->unlock();
+}
+
 #ifdef H2CORE_HAVE_JACK
+void AudioEngineTests::testPerTrackPortCleanUp() {
+	auto pAE = Hydrogen::get_instance()->getAudioEngine();
+	const uint32_t nFrames = 512;
+
+	// The driver is not connected to a JACK server. The port pointers are
+	// only used to identify the ports and never dereferenced.
+	auto pDriver = std::make_shared<JackDriver>(
+		jackTestProcessCallback, JackDriver::Mode::Audio );
+	std::array<char, 2> dummyPorts;
+
+	pAE->lock( RIGHT_HERE );
+
+	JackDriver::InstrumentPorts ports;
+	ports.sPortNameBase = "Track_removed";
+	ports.Left = reinterpret_cast<jack_port_t*>( &dummyPorts[ 0 ] );
+	ports.Right = reinterpret_cast<jack_port_t*>( &dummyPorts[ 1 ] );
+	ports.marked = JackDriver::InstrumentPorts::Marked::ForDeath;
+	pDriver->m_audioPortMap[ std::make_shared<Instrument>() ] = ports;
+
+	// Audio thread picks up a table containing the ports.
+	pDriver->updateTrackTable();
+	pDriver->clearPerTrackAudioBuffers( nFrames );
+	if ( pDriver->m_pTrackTable == nullptr ||
+		 pDriver->m_pTrackTable->ports.size() != 1 ) {
+		throwException( "[testPerTrackPortCleanUp] ports not picked up" );
+	}
+
+	// The instrument is done rendering. Its ports must be removed from the
+	// map but kept alive as long as the audio thread might be using them.
+	for ( int ii = 0; ii < 2; ++ii ) {
+		pDriver->cleanUpPerTrackAudioPorts();
+		if ( pDriver->m_audioPortMap.size() != 0 ) {
+			throwException( "[testPerTrackPortCleanUp] ports not removed" );
+		}
+		if ( pDriver->m_portsToUnregister.size() != 1 ) {
+			throwException( QString( "[testPerTrackPortCleanUp] [%1] ports "
+									 "unregistered while still in use" )
+							.arg( ii ) );
+		}
+		if ( pDriver->m_pTrackTable->ports.size() != 1 ) {
+			throwException( QString( "[testPerTrackPortCleanUp] [%1] table "
+									 "replaced outside of process cycle" )
+							.arg( ii ) );
+		}
+	}
+
+	// Next process cycle.
+	pDriver->clearPerTrackAudioBuffers( nFrames );
+	if ( pDriver->m_pTrackTable == nullptr ||
+		 pDriver->m_pTrackTable->ports.size() != 0 ) {
+		throwException( "[testPerTrackPortCleanUp] new table not picked up" );
+	}
+
+	pDriver->cleanUpPerTrackAudioPorts();
+	if ( pDriver->m_portsToUnregister.size() != 0 ) {
+		throwException( "[testPerTrackPortCleanUp] ports not unregistered" );
+	}
+
+	pAE->unlock();
+}
+
 void AudioEngineTests::testTransportProcessingJack() {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
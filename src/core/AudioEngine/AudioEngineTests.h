@@ -108,6 +108,30 @@ public:
 		 * Checks is reproducible and works even without any song set.
 		 */
 		static void testUpdateTransport();
+
+		/** Puts the #AudioEngine into #AudioEngine::State::Testing and
+		 * resets transport.
+		 *
+		 * The audio driver does not process audio in this state. This way
+		 * h2bench can drive the #Sampler and the enqueuing of notes from the
+		 * main thread without competing with the audio thread. Has to be
+		 * followed by benchmarkTearDown(). */
+		static void benchmarkSetUp();
+		/** Stops all notes still rendered by the #Sampler and sets the
+		 * #AudioEngine back to #AudioEngine::State::Ready. */
+		static void benchmarkTearDown();
+		/** Enqueues the notes of the next @a nFrames frames - just as the audio
+		 * thread does in audioEngine_process() - discards them, and moves the
+		 * playhead forward.
+		 *
+		 * \return Number of notes enqueued. */
+		static int benchmarkUpdateNoteQueue( uint32_t nFrames );
+		/** Runs a full process cycle of @a nFrames frames - enqueuing
+		 * notes, rendering them in the #Sampler, and moving the playhead
+		 * forward - just as the audio thread does in audioEngine_process().
+		 * Requires the #AudioEngine to be in #AudioEngine::State::Testing
+		 * (see benchmarkSetUp()). */
+		static void processCycle( uint32_t nFrames );
 #ifdef H2CORE_HAVE_JACK
 	/**
 	 * Unit test checking the incremental update of the transport position in
@@ -131,6 +155,13 @@ public:
 	 * all frame offsets.
 	 */
 	static void testTransportRelocationOffsetsJack();
+	/**
+	 * Unit test checking that per-track output ports of instruments removed
+	 * from the drumkit are not unregistered before the audio thread picked up
+	 * a #JackDriver::TrackTable not containing them anymore. Does not require
+	 * a running JACK server.
+	 */
+	static void testPerTrackPortCleanUp();
 
 		/** Process callback for the testing instance of the
 		 * #H2Core::JackDriver */
@@ -0,0 +1,128 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/AudioEngine/LiveNoteQueue.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace H2Core {
+
+LiveNoteQueue::LiveNoteQueue()
+	: m_nWritePosition( 0 ), m_nReadPosition( 0 ), m_nDropped( 0 ) {
+	for ( size_t ii = 0; ii < nCapacity; ++ii ) {
+		m_slots[ ii ].sequence.store( ii, std::memory_order_relaxed );
+	}
+}
+
+LiveNoteQueue::~LiveNoteQueue() {
+}
+
+bool LiveNoteQueue::push( const LiveNote& liveNote ) {
+	Slot* pSlot;
+	size_t nPosition = m_nWritePosition.load( std::memory_order_relaxed );
+	while ( true ) {
+		pSlot = &m_slots[ nPosition & nBufferMask ];
+		const size_t nSequence = pSlot->sequence.load( std::memory_order_acquire );
+		const auto nDiff = static_cast<std::ptrdiff_t>( nSequence ) -
+			static_cast<std::ptrdiff_t>( nPosition );
+		if ( nDiff == 0 ) {
+			// Slot is free. Claim it.
+			if ( m_nWritePosition.compare_exchange_weak(
+					 nPosition, nPosition + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		}
+		else if ( nDiff < 0 ) {
+			// The audio thread did not keep up. In contrast to the
+			// #EventQueue we drop the newest note since overwriting older
+			// ones would require the producers to synchronize with the
+			// audio thread.
+			m_nDropped.fetch_add( 1, std::memory_order_relaxed );
+			return false;
+		}
+		else {
+			// Another thread claimed the slot in the meantime.
+			nPosition = m_nWritePosition.load( std::memory_order_relaxed );
+		}
+	}
+
+	pSlot->liveNote = liveNote;
+	pSlot->sequence.store( nPosition + 1, std::memory_order_release );
+
+	return true;
+}
+
+bool LiveNoteQueue::pop( LiveNote& liveNote ) {
+	auto& slot = m_slots[ m_nReadPosition & nBufferMask ];
+	if ( slot.sequence.load( std::memory_order_acquire ) !=
+		 m_nReadPosition + 1 ) {
+		// Empty or the next note is still being written.
+		return false;
+	}
+
+	liveNote = slot.liveNote;
+	// Mark the slot as free for the next round through the buffer.
+	slot.sequence.store( m_nReadPosition + nCapacity,
+						 std::memory_order_release );
+	++m_nReadPosition;
+
+	return true;
+}
+
+int LiveNoteQueue::computeFrameOffset( const TimePoint& timePoint,
+									   const TimePoint& cycleStart,
+									   int nSampleRate, int nFrames ) {
+	if ( nFrames <= 0 ) {
+		return 0;
+	}
+
+	const double fOffset = std::round(
+		std::chrono::duration<double>( timePoint - cycleStart ).count() *
+		static_cast<double>( nSampleRate ) );
+
+	return static_cast<int>(
+		std::clamp( fOffset, 0.0, static_cast<double>( nFrames - 1 ) ) );
+}
+
+QString LiveNoteQueue::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[LiveNoteQueue]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nWritePosition: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nWritePosition.load() ) )
+			.append( QString( "%1%2m_nReadPosition: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nReadPosition ) )
+			.append( QString( "%1%2m_nDropped: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( getDropped() ) );
+	}
+	else {
+		sOutput = QString( "[LiveNoteQueue] m_nWritePosition: %1" )
+			.arg( m_nWritePosition.load() )
+			.append( QString( ", m_nReadPosition: %1" ).arg( m_nReadPosition ) )
+			.append( QString( ", m_nDropped: %1" ).arg( getDropped() ) );
+	}
+
+	return sOutput;
+}
+
+};	// namespace H2Core
@@ -0,0 +1,145 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef LIVE_NOTE_QUEUE_H
+#define LIVE_NOTE_QUEUE_H
+
+#include <array>
+#include <atomic>
+
+#include <core/Basics/Note.h>
+#include <core/Helpers/Time.h>
+#include <core/Object.h>
+
+namespace H2Core {
+
+/**
+ * Hands notes played live - via MIDI, the virtual keyboard, or OSC - over
+ * to the audio thread.
+ *
+ * Producers push plain values into a preallocated ring buffer without
+ * locking the #AudioEngine. The audio thread drains the queue at the
+ * beginning of each process cycle, creates the corresponding notes, and
+ * places them within the buffer according to their time stamps. This way
+ * hits are rendered sample-accurately with a constant latency of one
+ * buffer instead of being snapped to the start of the next one.
+ *
+ * push() is lock-free, does not allocate memory, and can be called from
+ * several threads at once. pop() must only be called by the audio thread.
+ */
+/** \ingroup docCore docAudioEngine docMIDI */
+class LiveNoteQueue : public H2Core::Object<LiveNoteQueue> {
+	H2_OBJECT( LiveNoteQueue )
+   public:
+	/** Has to be a power of two. */
+	static constexpr size_t nCapacity = 512;
+
+	struct LiveNote {
+		/** Position of the instrument within the #InstrumentList of the
+		 * current drumkit. It is resolved by the audio thread since the
+		 * list must not be accessed by producers without locking the
+		 * #AudioEngine. */
+		int nInstrument;
+		float fVelocity;
+		bool bNoteOff;
+		/** Whether the note was played on the selected instrument using
+		 * #key and #octave (see #MidiInstrumentMap::Input::SelectedInstrument). */
+		bool bUseKey;
+		Note::Key key;
+		Note::Octave octave;
+		/** Point in time at which the note was played. */
+		TimePoint timePoint;
+	};
+
+	LiveNoteQueue();
+	~LiveNoteQueue();
+
+	/** Realtime-safe.
+	 *
+	 * \return `false` in case the queue is full and @a liveNote was
+	 *   dropped. */
+	bool push( const LiveNote& liveNote );
+	/** Must only be called by the audio thread.
+	 *
+	 * \return `false` in case the queue is empty. */
+	bool pop( LiveNote& liveNote );
+
+	/** Maps @a timePoint onto a frame within a buffer of @a nFrames frames.
+	 *
+	 * The buffer rendered in the current process cycle corresponds to the
+	 * span of time between @a cycleStart of the previous and the current
+	 * cycle. Notes played within it are delayed by exactly one buffer.
+	 * Notes arriving late are placed at the beginning of the buffer.
+	 *
+	 * \param timePoint When the note was played.
+	 * \param cycleStart Start of the previous process cycle.
+	 * \param nSampleRate Sample rate of the audio driver.
+	 * \param nFrames Size of the buffer.
+	 *
+	 * \return Frame within [0, @a nFrames). */
+	static int computeFrameOffset( const TimePoint& timePoint,
+								   const TimePoint& cycleStart,
+								   int nSampleRate, int nFrames );
+
+	/** Number of notes dropped since the queue was created because it was
+	 * full. */
+	long long getDropped() const;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true )
+		const override;
+
+   private:
+	/** Preallocated storage of a single note. */
+	struct Slot {
+		/** Equals the position of the slot within the ring buffer in case
+		 * it is ready to be written and position + 1 when ready to be read.
+		 * This way wrap-arounds are detected without additional state. */
+		std::atomic<size_t> sequence;
+		LiveNote liveNote;
+	};
+
+	static constexpr size_t nBufferMask = nCapacity - 1;
+
+	std::array<Slot, nCapacity> m_slots;
+
+	/** Position the next note will be written to. */
+	alignas( 64 ) std::atomic<size_t> m_nWritePosition;
+	/** Position the next note will be read from. Only accessed by the
+	 * audio thread. */
+	alignas( 64 ) size_t m_nReadPosition;
+
+	std::atomic<long long> m_nDropped;
+};
+
+inline long long LiveNoteQueue::getDropped() const {
+	return m_nDropped.load( std::memory_order_relaxed );
+}
+
+};	// namespace H2Core
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#include <core/AudioEngine/NotePool.h>
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+
+#include <algorithm>
+
+namespace H2Core {
+
+NotePool::NotePool( int nCapacity, int nComponents )
+	: m_nComponents( 0 ), m_nDropped( 0 )
+{
+	setCapacity( nCapacity, nComponents );
+}
+
+NotePool::~NotePool()
+{
+}
+
+std::shared_ptr<Note> NotePool::acquire( std::shared_ptr<Note> pOther )
+{
+	auto pNote = nextFreeNote();
+	if ( pNote != nullptr ) {
+		pNote->copyFrom( pOther );
+	}
+	return pNote;
+}
+
+std::shared_ptr<Note> NotePool::acquire(
+	std::shared_ptr<Instrument> pInstrument,
+	int nPosition,
+	float fVelocity,
+	float fPan,
+	int nLength
+)
+{
+	auto pNote = nextFreeNote();
+	if ( pNote != nullptr ) {
+		pNote->reset( pInstrument, nPosition, fVelocity, fPan, nLength );
+	}
+	return pNote;
+}
+
+std::shared_ptr<Note> NotePool::nextFreeNote()
+{
+	if ( m_freeIndices.empty() ) {
+		// Capacity was reserved in setCapacity(). Pushing back does not
+		// allocate. We add the indices in reverse order to hand out the
+		// notes retired first.
+		for ( int ii = static_cast<int>( m_notes.size() ) - 1; ii >= 0; --ii ) {
+			if ( m_notes[ii].use_count() == 1 ) {
+				m_freeIndices.push_back( ii );
+			}
+		}
+	}
+
+	if ( m_freeIndices.empty() ) {
+		// Pool is exhausted. We do not log in here since this is called from
+		// within the audio thread. The number of dropped notes can be
+		// queried instead.
+		++m_nDropped;
+		return nullptr;
+	}
+
+	const int nIndex = m_freeIndices.back();
+	m_freeIndices.pop_back();
+
+	return m_notes[nIndex];
+}
+
+void NotePool::setCapacity( int nCapacity, int nComponents )
+{
+	if ( nCapacity < 0 ) {
+		ERRORLOG( QString( "Invalid capacity [%1]" ).arg( nCapacity ) );
+		nCapacity = 0;
+	}
+	if ( nComponents < 1 ) {
+		nComponents = 1;
+	}
+
+	// Drop unused notes beyond the new capacity and release the instruments
+	// held by the remaining ones.
+	for ( auto it = m_notes.begin(); it != m_notes.end(); ) {
+		if ( it->use_count() == 1 &&
+			 static_cast<int>( m_notes.size() ) > nCapacity ) {
+			it = m_notes.erase( it );
+		}
+		else {
+			if ( it->use_count() == 1 ) {
+				( *it )->reset( nullptr );
+			}
+			++it;
+		}
+	}
+
+	m_notes.reserve( nCapacity );
+	while ( static_cast<int>( m_notes.size() ) < nCapacity ) {
+		m_notes.push_back( std::make_shared<Note>() );
+	}
+
+	// Notes still in use are preallocated as well. Their layer infos are
+	// not touched and only spare ones are added.
+	for ( auto& ppNote : m_notes ) {
+		ppNote->preallocate( nComponents );
+	}
+	m_nComponents = nComponents;
+
+	m_freeIndices.clear();
+	m_freeIndices.reserve( m_notes.size() );
+}
+
+int NotePool::countComponents( std::shared_ptr<Drumkit> pDrumkit )
+{
+	int nComponents = 1;
+	if ( pDrumkit == nullptr || pDrumkit->getInstruments() == nullptr ) {
+		return nComponents;
+	}
+
+	for ( const auto& ppInstrument : *pDrumkit->getInstruments() ) {
+		if ( ppInstrument != nullptr && ppInstrument->getComponents() != nullptr ) {
+			nComponents = std::max(
+				nComponents,
+				static_cast<int>( ppInstrument->getComponents()->size() ) );
+		}
+	}
+
+	return nComponents;
+}
+
+int NotePool::getUsed() const
+{
+	int nUsed = 0;
+	for ( const auto& ppNote : m_notes ) {
+		if ( ppNote.use_count() > 1 ) {
+			++nUsed;
+		}
+	}
+
+	return nUsed;
+}
+
+QString NotePool::toQString( const QString& sPrefix, bool bShort ) const
+{
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( !bShort ) {
+		sOutput = QString( "%1[NotePool]\n" )
+					  .arg( sPrefix )
+					  .append( QString( "%1%2capacity: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( getCapacity() ) )
+					  .append( QString( "%1%2used: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( getUsed() ) )
+					  .append( QString( "%1%2m_nComponents: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_nComponents ) )
+					  .append( QString( "%1%2m_nDropped: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_nDropped ) );
+	}
+	else {
+		sOutput = QString( "[NotePool] " )
+					  .append( QString( "capacity: %1" ).arg( getCapacity() ) )
+					  .append( QString( ", used: %1" ).arg( getUsed() ) )
+					  .append( QString( ", m_nComponents: %1" )
+								   .arg( m_nComponents ) )
+					  .append( QString( ", m_nDropped: %1" )
+								   .arg( m_nDropped ) );
+	}
+
+	return sOutput;
+}
+
+};	// namespace H2Core
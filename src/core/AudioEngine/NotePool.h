@@ -0,0 +1,147 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef NOTE_POOL_H
+#define NOTE_POOL_H
+
+#include <memory>
+#include <vector>
+
+#include <core/Basics/Note.h>
+#include <core/Object.h>
+
+namespace H2Core {
+
+class Drumkit;
+class Instrument;
+
+/**
+ * Preallocated set of #H2Core::Note instances used by the #AudioEngine to
+ * create the notes it hands over to the #Sampler.
+ *
+ * Creating a fresh note for each pattern note, metronome tick, or stop note
+ * would require heap allocations and atomic reference counting within the
+ * audio thread. Instead, all notes are created upfront and the pool keeps a
+ * reference to each of them. A note is considered free again once the pool
+ * holds the only remaining reference. This is the case as soon as the
+ * #Sampler retired it (and it is neither part of a note-off queue nor
+ * inspected by the GUI anymore).
+ *
+ * The pool never grows within the audio thread. Each note has its #ADSR and
+ * the #SelectedLayerInfo of all components preallocated (see
+ * Note::preallocate()). In case the pool is exhausted, acquire() returns
+ * `nullptr` and the note is dropped.
+ *
+ * The pool is not thread-safe and must only be accessed while holding the
+ * lock of the #AudioEngine.
+ */
+/** \ingroup docCore docAudioEngine */
+class NotePool : public H2Core::Object<NotePool> {
+	H2_OBJECT( NotePool )
+   public:
+	/** Number of notes preallocated per voice allowed in
+	 * #Preferences::m_nMaxNotes. Besides the notes rendered by the #Sampler
+	 * the pool also has to cover the lookahead of the #AudioEngine and
+	 * pending Note-Off MIDI messages. */
+	static constexpr int nNotesPerVoice = 2;
+
+	NotePool( int nCapacity, int nComponents = 1 );
+	~NotePool();
+
+	/** Recycled counterpart of `std::make_shared<Note>( pOther )`.
+	 *
+	 * \return `nullptr` in case the pool is exhausted. */
+	std::shared_ptr<Note> acquire( std::shared_ptr<Note> pOther );
+	/** Recycled counterpart of the regular #Note constructor.
+	 *
+	 * \return `nullptr` in case the pool is exhausted. */
+	std::shared_ptr<Note> acquire(
+		std::shared_ptr<Instrument> pInstrument,
+		int nPosition = 0,
+		float fVelocity = VELOCITY_DEFAULT,
+		float fPan = PAN_DEFAULT,
+		int nLength = LENGTH_ENTIRE_SAMPLE
+	);
+
+	/** Adapts the number of preallocated notes, ensures each of them can
+	 * hold the layer infos of @a nComponents components, and drops the
+	 * references free notes still hold to instruments (and thus samples) of
+	 * previous drumkits.
+	 *
+	 * Allocates memory and must not be called from within the audio
+	 * thread. */
+	void setCapacity( int nCapacity, int nComponents );
+	int getCapacity() const;
+	int getComponents() const;
+
+	/** @return Number of notes currently in use. */
+	int getUsed() const;
+
+	/** @return Number of notes which could not be provided because the pool
+	 * was exhausted. In steady state this number should not increase. */
+	long long getDropped() const;
+
+	/** @return Maximum number of components of a single instrument in @a
+	 * pDrumkit (but at least one). */
+	static int countComponents( std::shared_ptr<Drumkit> pDrumkit );
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true )
+		const override;
+
+   private:
+	/** @return a note not referenced outside of the pool or `nullptr` in
+	 * case none is available. */
+	std::shared_ptr<Note> nextFreeNote();
+
+	std::vector<std::shared_ptr<Note>> m_notes;
+	/** Indices in #m_notes of notes found to be free. Whenever it runs
+	 * empty, it is refilled by a single sweep over #m_notes. This way the
+	 * costs of the sweep are shared by all notes found. */
+	std::vector<int> m_freeIndices;
+	int m_nComponents;
+	long long m_nDropped;
+};
+
+inline int NotePool::getCapacity() const
+{
+	return static_cast<int>( m_notes.size() );
+}
+
+inline int NotePool::getComponents() const
+{
+	return m_nComponents;
+}
+
+inline long long NotePool::getDropped() const
+{
+	return m_nDropped;
+}
+
+};	// namespace H2Core
+
+#endif
@@ -0,0 +1,369 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#include <core/AudioEngine/TempoMap.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Song.h>
+#include <core/Hydrogen.h>
+#include <core/Timeline.h>
+
+namespace H2Core {
+
+TempoMap::TempoMap( std::shared_ptr<Song> pSong, double fSongSizeInTicks,
+					int nSampleRate )
+	: m_fSongSizeInTicks( fSongSizeInTicks ),
+	  m_fSongSizeInFrames( 0 ),
+	  m_fFirstMarkerTick( 0 ),
+	  m_nSampleRate( nSampleRate ),
+	  m_nColumns( 0 ),
+	  m_nTimelineRevision( -1 )
+{
+	if ( pSong == nullptr ) {
+		return;
+	}
+	m_nColumns = pSong->getPatternGroupVector()->size();
+
+	const auto pTimeline = pSong->getTimeline();
+	if ( pTimeline == nullptr ) {
+		return;
+	}
+	m_nTimelineRevision = pTimeline->getRevision();
+
+	// If there are no patterns in the current song, we treat song mode like
+	// pattern mode.
+	const auto& tempoMarkers = pTimeline->getAllTempoMarkers();
+	if ( tempoMarkers.size() == 0 ||
+		 ( tempoMarkers.size() == 1 &&
+		   pTimeline->isFirstTempoMarkerSpecial() ) ||
+		 m_nColumns == 0 || fSongSizeInTicks <= 0 || nSampleRate <= 0 ) {
+		return;
+	}
+
+	const auto pHydrogen = Hydrogen::get_instance();
+	const int nMarkers = static_cast<int>( tempoMarkers.size() );
+
+	m_segments.reserve( nMarkers );
+	double fStartTick = 0;
+	double fStartFrame = 0;
+	for ( int ii = 1; ii <= nMarkers; ++ii ) {
+		double fEndTick;
+		if ( ii == nMarkers || tempoMarkers[ ii ]->nColumn >= m_nColumns ) {
+			fEndTick = fSongSizeInTicks;
+		}
+		else {
+			fEndTick = static_cast<double>(
+				pHydrogen->getTickForColumn( tempoMarkers[ ii ]->nColumn ) );
+		}
+		// Ensure the segments are ordered. Else the binary search would not
+		// work.
+		fEndTick = std::max( fEndTick, fStartTick );
+
+		Segment segment;
+		segment.fStartTick = fStartTick;
+		segment.fEndTick = fEndTick;
+		segment.fStartFrame = fStartFrame;
+		segment.fTickSize = AudioEngine::computeDoubleTickSize(
+			nSampleRate, tempoMarkers[ ii - 1 ]->fBpm );
+		segment.fLengthInFrames =
+			( fEndTick - fStartTick ) * segment.fTickSize;
+		m_segments.push_back( segment );
+
+		fStartFrame += segment.fLengthInFrames;
+		fStartTick = fEndTick;
+	}
+
+	m_fSongSizeInFrames = fStartFrame;
+	m_fFirstMarkerTick = static_cast<double>(
+		pHydrogen->getTickForColumn( tempoMarkers[ 0 ]->nColumn ) );
+}
+
+TempoMap::~TempoMap()
+{
+}
+
+bool TempoMap::isValid( std::shared_ptr<Song> pSong, double fSongSizeInTicks,
+						int nSampleRate ) const
+{
+	int nColumns = 0;
+	int nTimelineRevision = -1;
+	if ( pSong != nullptr ) {
+		nColumns = pSong->getPatternGroupVector()->size();
+		if ( pSong->getTimeline() != nullptr ) {
+			nTimelineRevision = pSong->getTimeline()->getRevision();
+		}
+	}
+
+	return m_nTimelineRevision == nTimelineRevision &&
+		   m_nColumns == nColumns && m_nSampleRate == nSampleRate &&
+		   m_fSongSizeInTicks == fSongSizeInTicks;
+}
+
+int TempoMap::findSegmentByTick( double fTick ) const
+{
+	const auto it = std::lower_bound(
+		m_segments.begin(), m_segments.end(), fTick,
+		[]( const Segment& segment, double fValue ) {
+			return segment.fEndTick < fValue;
+		} );
+
+	return std::min( static_cast<int>( it - m_segments.begin() ),
+					 static_cast<int>( m_segments.size() ) - 1 );
+}
+
+int TempoMap::findSegmentByFrame( double fFrame ) const
+{
+	const int nSegments = static_cast<int>( m_segments.size() );
+	const auto it = std::lower_bound(
+		m_segments.begin(), m_segments.end(), fFrame,
+		[]( const Segment& segment, double fValue ) {
+			return segment.fStartFrame + segment.fLengthInFrames < fValue;
+		} );
+	int nIndex = static_cast<int>( it - m_segments.begin() );
+
+	// Since the sum of start and length is subject to rounding errors, the
+	// candidate is refined using the very same criterion applied when
+	// walking the segments one after another.
+	auto isPassed = [&]( int nSegment ) {
+		return m_segments[ nSegment ].fLengthInFrames <
+			   fFrame - m_segments[ nSegment ].fStartFrame;
+	};
+	while ( nIndex > 0 && ! isPassed( nIndex - 1 ) ) {
+		--nIndex;
+	}
+	while ( nIndex < nSegments && isPassed( nIndex ) ) {
+		++nIndex;
+	}
+
+	return nIndex;
+}
+
+long long TempoMap::finalizeFrame( double fFrame, double fPassedTicks,
+								   double fRemainingTicks, double fNextTick,
+								   double fTickSize, double fNextTickSize,
+								   double* fTickMismatch ) const
+{
+	// The next frame is within this segment.
+	const double fNewFrame = fFrame + fRemainingTicks * fTickSize;
+	const long long nNewFrame =
+		static_cast<long long>( std::round( fNewFrame ) );
+
+	// Keep track of the rounding error to be able to switch between fTick
+	// and its frame counterpart later on. In case fTick is located close to
+	// a tempo marker we will only cover the part up to the tempo marker in
+	// here as only this region is governed by fTickSize.
+	const double fRoundingErrorInTicks =
+		( fNewFrame - static_cast<double>( nNewFrame ) ) / fTickSize;
+
+	// Compares the negative distance between current position (fNewFrame)
+	// and the one resulting from rounding - fRoundingErrorInTicks - with the
+	// negative distance between current position (fNewFrame) and location
+	// of next tempo marker.
+	if ( fRoundingErrorInTicks >
+		 fPassedTicks + fRemainingTicks - fNextTick ) {
+		// Whole mismatch located within the current tempo interval.
+		*fTickMismatch = fRoundingErrorInTicks;
+	}
+	else {
+		// Mismatch at this side of the tempo marker.
+		*fTickMismatch = fPassedTicks + fRemainingTicks - fNextTick;
+
+		const double fFinalFrame =
+			fNewFrame +
+			( fNextTick - fPassedTicks - fRemainingTicks ) * fTickSize;
+
+		// Mismatch located beyond the tempo marker.
+		*fTickMismatch +=
+			( fFinalFrame - static_cast<double>( nNewFrame ) ) / fNextTickSize;
+	}
+
+	return nNewFrame;
+}
+
+long long TempoMap::computeFrameFromTick( double fTick,
+										  double* fTickMismatch ) const
+{
+	if ( fTick <= 0 || m_segments.empty() ) {
+		*fTickMismatch = 0;
+		return 0;
+	}
+
+	double fFrameOffset = 0;
+	if ( fTick > m_fSongSizeInTicks ) {
+		// The provided fTick is larger than the song. But, luckily, we
+		// already know the song length in frames.
+		const int nRepetitions = std::floor( fTick / m_fSongSizeInTicks );
+		fFrameOffset =
+			static_cast<double>( nRepetitions ) * m_fSongSizeInFrames;
+
+		if ( std::isinf( fFrameOffset ) ||
+			 fFrameOffset >= static_cast<double>(
+								 std::numeric_limits<long long>::max() ) ) {
+			ERRORLOG( QString( "Provided ticks [%1] are too large." )
+					  .arg( fTick ) );
+			*fTickMismatch = 0;
+			return 0;
+		}
+
+		fTick = std::fmod( fTick, m_fSongSizeInTicks );
+
+		if ( fTick == 0 ) {
+			// The target tick matches a multiple of the song size. We need
+			// to reproduce the context within the last tempo marker in
+			// order to get the mismatch right.
+			return finalizeFrame(
+				fFrameOffset, 0, 0, m_fFirstMarkerTick,
+				m_segments.back().fTickSize, m_segments.front().fTickSize,
+				fTickMismatch );
+		}
+	}
+
+	const int nIndex = findSegmentByTick( fTick );
+	const auto& segment = m_segments[ nIndex ];
+
+	double fNextTickSize;
+	if ( nIndex + 1 < static_cast<int>( m_segments.size() ) ) {
+		fNextTickSize = m_segments[ nIndex + 1 ].fTickSize;
+	}
+	else {
+		fNextTickSize = m_segments.front().fTickSize;
+	}
+
+	return finalizeFrame(
+		fFrameOffset + segment.fStartFrame, segment.fStartTick,
+		fTick - segment.fStartTick, segment.fEndTick, segment.fTickSize,
+		fNextTickSize, fTickMismatch );
+}
+
+double TempoMap::computeTickFromFrame( long long nFrame ) const
+{
+	if ( nFrame <= 0 || m_segments.empty() ) {
+		return 0;
+	}
+
+	// We are using double precision in here to avoid rounding errors.
+	const double fTargetFrame = static_cast<double>( nFrame );
+	const int nSegments = static_cast<int>( m_segments.size() );
+
+	double fTick = 0;
+	double fPassedFrames = 0;
+	int nIndex = findSegmentByFrame( fTargetFrame );
+	if ( nIndex == nSegments ) {
+		// The provided nFrame is larger than the song. But, luckily, we
+		// already know the song length in frames.
+		const int nRepetitions =
+			std::floor( fTargetFrame / m_fSongSizeInFrames );
+		if ( m_fSongSizeInTicks * nRepetitions >
+			 std::numeric_limits<double>::max() ) {
+			ERRORLOG( QString( "Provided frames [%1] are too large." )
+					  .arg( nFrame ) );
+			return 0;
+		}
+		fTick = m_fSongSizeInTicks * nRepetitions;
+		fPassedFrames =
+			static_cast<double>( nRepetitions ) * m_fSongSizeInFrames;
+
+		if ( fPassedFrames == fTargetFrame ) {
+			return fTick;
+		}
+
+		nIndex = std::min( findSegmentByFrame( fTargetFrame - fPassedFrames ),
+						   nSegments - 1 );
+	}
+
+	// The target frame is located within this segment.
+	const auto& segment = m_segments[ nIndex ];
+	fTick += segment.fStartTick;
+	fPassedFrames += segment.fStartFrame;
+
+	return fTick + ( fTargetFrame - fPassedFrames ) / segment.fTickSize;
+}
+
+QString TempoMap::toQString( const QString& sPrefix, bool bShort ) const
+{
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( !bShort ) {
+		sOutput = QString( "%1[TempoMap]\n" )
+					  .arg( sPrefix )
+					  .append( QString( "%1%2m_fSongSizeInTicks: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_fSongSizeInTicks, 0, 'f' ) )
+					  .append( QString( "%1%2m_fSongSizeInFrames: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_fSongSizeInFrames, 0, 'f' ) )
+					  .append( QString( "%1%2m_fFirstMarkerTick: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_fFirstMarkerTick, 0, 'f' ) )
+					  .append( QString( "%1%2m_nSampleRate: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_nSampleRate ) )
+					  .append( QString( "%1%2m_nColumns: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_nColumns ) )
+					  .append( QString( "%1%2m_nTimelineRevision: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_nTimelineRevision ) )
+					  .append( QString( "%1%2m_segments:\n" )
+								   .arg( sPrefix )
+								   .arg( s ) );
+		for ( const auto& ssegment : m_segments ) {
+			sOutput.append(
+				QString( "%1%2%2[%3, %4] start frame: %5, length: %6, tick "
+						 "size: %7\n" )
+					.arg( sPrefix )
+					.arg( s )
+					.arg( ssegment.fStartTick, 0, 'f' )
+					.arg( ssegment.fEndTick, 0, 'f' )
+					.arg( ssegment.fStartFrame, 0, 'f' )
+					.arg( ssegment.fLengthInFrames, 0, 'f' )
+					.arg( ssegment.fTickSize, 0, 'f' ) );
+		}
+	}
+	else {
+		sOutput = QString( "[TempoMap] " )
+					  .append( QString( "m_fSongSizeInTicks: %1" )
+								   .arg( m_fSongSizeInTicks, 0, 'f' ) )
+					  .append( QString( ", m_fSongSizeInFrames: %1" )
+								   .arg( m_fSongSizeInFrames, 0, 'f' ) )
+					  .append( QString( ", m_nSampleRate: %1" )
+								   .arg( m_nSampleRate ) )
+					  .append( QString( ", m_nColumns: %1" )
+								   .arg( m_nColumns ) )
+					  .append( QString( ", m_nTimelineRevision: %1" )
+								   .arg( m_nTimelineRevision ) )
+					  .append( QString( ", segments: %1" )
+								   .arg( m_segments.size() ) );
+	}
+
+	return sOutput;
+}
+
+};	// namespace H2Core
@@ -0,0 +1,149 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef TEMPO_MAP_H
+#define TEMPO_MAP_H
+
+#include <memory>
+#include <vector>
+
+#include <core/Object.h>
+
+namespace H2Core {
+
+class Song;
+
+/**
+ * Immutable lookup table of all tempo segments of the #Timeline used by
+ * Transport::computeFrameFromTick() and Transport::computeTickFromFrame().
+ *
+ * Each #TempoMarker spans a segment reaching up to the next one (or the
+ * end of the song). For each of them the start position in both ticks and
+ * frames is precomputed. Converting a position boils down to a binary
+ * search instead of walking all tempo markers and summing up the lengths of
+ * all columns in front of it.
+ *
+ * Instances are created by the #AudioEngine whenever the #Timeline, the song
+ * size, or the sample rate changes and are handed to the audio thread by
+ * swapping a shared pointer atomically. Since a map is never altered after
+ * construction, it can be read from any thread without locking.
+ */
+/** \ingroup docCore docAudioEngine */
+class TempoMap : public H2Core::Object<TempoMap> {
+	H2_OBJECT( TempoMap )
+   public:
+	struct Segment {
+		double fStartTick;
+		double fEndTick;
+		double fStartFrame;
+		double fLengthInFrames;
+		double fTickSize;
+	};
+
+	/** Builds the map based on the tempo markers of @a pSong. Has to be
+	 * called while the #AudioEngine is locked or from the thread altering
+	 * the song. */
+	TempoMap( std::shared_ptr<Song> pSong, double fSongSizeInTicks,
+			  int nSampleRate );
+	~TempoMap();
+
+	/** @return whether the map was build for the current state of @a
+	 * pSong, @a fSongSizeInTicks, and @a nSampleRate. */
+	bool isValid( std::shared_ptr<Song> pSong, double fSongSizeInTicks,
+				  int nSampleRate ) const;
+
+	/** @return `true` in case the #Timeline does not contain any tempo
+	 * markers to apply (or there is no song or no pattern in it). The
+	 * conversion has to rely on a single tempo instead. */
+	bool isEmpty() const;
+
+	const std::vector<Segment>& getSegments() const;
+	double getSongSizeInFrames() const;
+	int getSampleRate() const;
+
+	/** Timeline-aware counterpart of Transport::computeFrameFromTick(). Must
+	 * only be called if the map is not empty. */
+	long long computeFrameFromTick( double fTick, double* fTickMismatch ) const;
+	/** Timeline-aware counterpart of Transport::computeTickFromFrame(). Must
+	 * only be called if the map is not empty. */
+	double computeTickFromFrame( long long nFrame ) const;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true )
+		const override;
+
+   private:
+	/** @return index of the segment containing @a fTick. */
+	int findSegmentByTick( double fTick ) const;
+	/** @return index of the segment containing @a fFrame or the number of
+	 * segments in case it is located beyond the end of the song. */
+	int findSegmentByFrame( double fFrame ) const;
+
+	/** Rounds @a fFrame and calculates the resulting mismatch in ticks.
+	 *
+	 * In case the rounded frame is located beyond the next tempo marker, the
+	 * mismatch is composed of the part up to the marker - governed by @a
+	 * fTickSize - and the remainder governed by @a fNextTickSize. */
+	long long finalizeFrame( double fFrame, double fPassedTicks,
+							 double fRemainingTicks, double fNextTick,
+							 double fTickSize, double fNextTickSize,
+							 double* fTickMismatch ) const;
+
+	std::vector<Segment> m_segments;
+	double m_fSongSizeInTicks;
+	double m_fSongSizeInFrames;
+	/** Tick of the column of the first tempo marker. */
+	double m_fFirstMarkerTick;
+	int m_nSampleRate;
+	int m_nColumns;
+	/** Timeline::getRevision() at the time of construction. */
+	int m_nTimelineRevision;
+};
+
+inline bool TempoMap::isEmpty() const
+{
+	return m_segments.empty();
+}
+
+inline const std::vector<TempoMap::Segment>& TempoMap::getSegments() const
+{
+	return m_segments;
+}
+
+inline double TempoMap::getSongSizeInFrames() const
+{
+	return m_fSongSizeInFrames;
+}
+
+inline int TempoMap::getSampleRate() const
+{
+	return m_nSampleRate;
+}
+
+};	// namespace H2Core
+
+#endif
@@ -22,7 +22,7 @@
 #include <core/AudioEngine/Transport.h>
 
 #include <core/AudioEngine/AudioEngine.h>
-#include <core/Basics/Drumkit.h>
+#include <core/AudioEngine/TempoMap.h>
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
 #include <core/Basics/Song.h>
@@ -144,17 +144,20 @@ void Transport::setBpm( float fNewBpm )
 	m_fBpm = fNewBpm;
 
 	if ( Preferences::get_instance()->getRubberBandBatchMode() ) {
+		// This function is called from within the audio thread. Stretching
+		// the samples is done in the background and the results are swapped
+		// in by the Sampler.
 		auto pHydrogen = Hydrogen::get_instance();
-		auto pSong = pHydrogen->getSong();
-		if ( pSong == nullptr ) {
+		if ( pHydrogen == nullptr ) {
 			return;
 		}
-		auto pDrumkit = pSong->getDrumkit();
-		if ( pDrumkit == nullptr ) {
+		auto pAudioEngine = pHydrogen->getAudioEngine();
+		if ( pAudioEngine == nullptr ||
+			 pAudioEngine->getRubberbandCache() == nullptr ) {
 			return;
 		}
 
-		pDrumkit->recalculateRubberband( getBpm() );
+		pAudioEngine->getRubberbandCache()->requestBpm( getBpm() );
 	}
 }
 
@@ -284,6 +287,19 @@ void Transport::setBeat( int nBeat )
 	m_nBeat = nBeat;
 }
 
+std::shared_ptr<const TempoMap> Transport::getTempoMap( int nSampleRate )
+{
+	const auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	auto pTempoMap = pAudioEngine->getTempoMap();
+	if ( pTempoMap == nullptr || pTempoMap->getSampleRate() != nSampleRate ) {
+		pTempoMap = std::make_shared<const TempoMap>(
+			Hydrogen::get_instance()->getSong(),
+			pAudioEngine->getSongSizeInTicks(), nSampleRate );
+	}
+
+	return pTempoMap;
+}
+
 // This function uses the assumption that sample rate and resolution
 // are constant over the whole song.
 long long Transport::computeFrameFromTick(
@@ -297,7 +313,6 @@ long long Transport::computeFrameFromTick(
 	if ( pSong == nullptr ) {
 		return 0;
 	}
-	const auto pTimeline = pSong->getTimeline();
 	const auto pAudioEngine = pHydrogen->getAudioEngine();
 	const auto pAudioDriver = pHydrogen->getAudioDriver();
 
@@ -310,7 +325,6 @@ long long Transport::computeFrameFromTick(
 	if ( nSampleRate == 0 ) {
 		nSampleRate = pAudioDriver->getSampleRate();
 	}
-	const double fSongSizeInTicks = pAudioEngine->getSongSizeInTicks();
 
 	if ( nSampleRate == 0 ) {
 		ERRORLOG( "Not properly initialized yet" );
@@ -323,245 +337,22 @@ long long Transport::computeFrameFromTick(
 		return 0;
 	}
 
-	std::vector<std::shared_ptr<const Timeline::TempoMarker>> tempoMarkers;
-	bool bSpecialFirstMarker = false;
-	if ( pTimeline != nullptr ) {
-		tempoMarkers = pTimeline->getAllTempoMarkers();
-		bSpecialFirstMarker = pTimeline->isFirstTempoMarkerSpecial();
-	}
-
-	int nColumns = 0;
-	if ( pSong != nullptr ) {
-		nColumns = pSong->getPatternGroupVector()->size();
-	}
-
-	// If there are no patterns in the current, we treat song mode
-	// like pattern mode.
+	// If there are no patterns in the current song, we treat song mode like
+	// pattern mode.
 	long long nNewFrame = 0;
+	const auto pTempoMap = getTempoMap( nSampleRate );
 	if ( pHydrogen->isTimelineEnabled() &&
-		 !( tempoMarkers.size() == 1 && bSpecialFirstMarker ) &&
-		 pHydrogen->getMode() == Song::Mode::Song && nColumns > 0 ) {
-		double fNewTick = fTick;
-		double fRemainingTicks = fTick;
-		double fNextTick, fPassedTicks = 0;
-		double fNextTickSize;
-		double fNewFrame = 0;
-		int ii;
-
-		auto handleEnd = [&]() {
-			// The next frame is within this segment.
-			fNewFrame += fRemainingTicks * fNextTickSize;
-
-			nNewFrame = static_cast<long long>( std::round( fNewFrame ) );
-
-			// Keep track of the rounding error to be able to switch
-			// between fTick and its frame counterpart later on.  In
-			// case fTick is located close to a tempo marker we will
-			// only cover the part up to the tempo marker in here as
-			// only this region is governed by fNextTickSize.
-			const double fRoundingErrorInTicks =
-				( fNewFrame - static_cast<double>( nNewFrame ) ) /
-				fNextTickSize;
-
-			// Compares the negative distance between current position
-			// (fNewFrame) and the one resulting from rounding -
-			// fRoundingErrorInTicks - with the negative distance
-			// between current position (fNewFrame) and location of
-			// next tempo marker.
-			if ( fRoundingErrorInTicks >
-				 fPassedTicks + fRemainingTicks - fNextTick ) {
-				// Whole mismatch located within the current tempo
-				// interval.
-				*fTickMismatch = fRoundingErrorInTicks;
-			}
-			else {
-				// Mismatch at this side of the tempo marker.
-				*fTickMismatch = fPassedTicks + fRemainingTicks - fNextTick;
-
-				const double fFinalFrame =
-					fNewFrame + ( fNextTick - fPassedTicks - fRemainingTicks ) *
-									fNextTickSize;
-
-				// Mismatch located beyond the tempo marker.
-				double fFinalTickSize;
-				if ( ii < tempoMarkers.size() ) {
-					fFinalTickSize = AudioEngine::computeDoubleTickSize(
-						nSampleRate, tempoMarkers[ii]->fBpm
-					);
-				}
-				else {
-					fFinalTickSize = AudioEngine::computeDoubleTickSize(
-						nSampleRate, tempoMarkers[0]->fBpm
-					);
-				}
-
-#if TRANSPORT_DEBUG
-				TP_DEBUGLOG(
-					QString(
-						"[::computeFrameFromTick mismatch : 2] fTickMismatch: "
-						"[%1 + %2], static_cast<double>(nNewFrame): %3, "
-						"fNewFrame: %4, fFinalFrame: %5, fNextTickSize: %6, "
-						"fPassedTicks: %7, fRemainingTicks: %8, "
-						"fFinalTickSize: %9"
-					)
-						.arg( fPassedTicks + fRemainingTicks - fNextTick )
-						.arg(
-							( fFinalFrame - static_cast<double>( nNewFrame ) ) /
-							fNextTickSize
-						)
-						.arg( nNewFrame )
-						.arg( fNewFrame, 0, 'f' )
-						.arg( fFinalFrame, 0, 'f' )
-						.arg( fNextTickSize, 0, 'f' )
-						.arg( fPassedTicks, 0, 'f' )
-						.arg( fRemainingTicks, 0, 'f' )
-						.arg( fFinalTickSize, 0, 'f' )
-				);
-#endif
-
-				*fTickMismatch +=
-					( fFinalFrame - static_cast<double>( nNewFrame ) ) /
-					fFinalTickSize;
-			}
-
-#if TRANSPORT_DEBUG
-			TP_DEBUGLOG(
-				QString(
-					"[::computeFrameFromTick end] fTick: %1, fNewFrame: %2, "
-					"fNextTick: %3, fRemainingTicks: %4, fPassedTicks: %5, "
-					"fNextTickSize: %6, tempoMarkers[ ii - 1 ]->nColumn: %7, "
-					"tempoMarkers[ ii - 1 ]->fBpm: %8, nNewFrame: %9, "
-					"fTickMismatch: %10, frame increment (fRemainingTicks * "
-					"fNextTickSize): %11, fRoundingErrorInTicks: %12"
-				)
-					.arg( fTick, 0, 'f' )
-					.arg( fNewFrame, 0, 'g', 30 )
-					.arg( fNextTick, 0, 'f' )
-					.arg( fRemainingTicks, 0, 'f' )
-					.arg( fPassedTicks, 0, 'f' )
-					.arg( fNextTickSize, 0, 'f' )
-					.arg( tempoMarkers[ii - 1]->nColumn )
-					.arg( tempoMarkers[ii - 1]->fBpm )
-					.arg( nNewFrame )
-					.arg( *fTickMismatch, 0, 'g', 30 )
-					.arg( fRemainingTicks * fNextTickSize, 0, 'g', 30 )
-					.arg( fRoundingErrorInTicks, 0, 'f' )
-			);
-#endif
-
-			fRemainingTicks -= fNewTick - fPassedTicks;
-		};
-
-		while ( fRemainingTicks > 0 ) {
-			for ( ii = 1; ii <= tempoMarkers.size(); ++ii ) {
-				if ( ii == tempoMarkers.size() ||
-					 tempoMarkers[ii]->nColumn >= nColumns ) {
-					fNextTick = fSongSizeInTicks;
-				}
-				else {
-					fNextTick = static_cast<double>(
-						pHydrogen->getTickForColumn( tempoMarkers[ii]->nColumn )
-					);
-				}
-
-				fNextTickSize = AudioEngine::computeDoubleTickSize(
-					nSampleRate, tempoMarkers[ii - 1]->fBpm
-				);
-
-				if ( fRemainingTicks > ( fNextTick - fPassedTicks ) ) {
-					// The whole segment of the timeline covered by tempo
-					// marker ii is left of the current transport position.
-					fNewFrame += ( fNextTick - fPassedTicks ) * fNextTickSize;
-
-#if TRANSPORT_DEBUG
-					TP_DEBUGLOG(
-						QString(
-							"[segment] fTick: %1, fNewFrame: %2, fNextTick: "
-							"%3, fRemainingTicks: %4, fPassedTicks: %5, "
-							"fNextTickSize: %6, tempoMarkers[ ii - 1 "
-							"]->nColumn: %7, tempoMarkers[ ii - 1 ]->fBpm: %8, "
-							"tick increment (fNextTick - fPassedTicks): %9, "
-							"frame increment (fRemainingTicks * "
-							"fNextTickSize): %10"
-						)
-							.arg( fTick, 0, 'f' )
-							.arg( fNewFrame, 0, 'g', 30 )
-							.arg( fNextTick, 0, 'f' )
-							.arg( fRemainingTicks, 0, 'f' )
-							.arg( fPassedTicks, 0, 'f' )
-							.arg( fNextTickSize, 0, 'f' )
-							.arg( tempoMarkers[ii - 1]->nColumn )
-							.arg( tempoMarkers[ii - 1]->fBpm )
-							.arg( fNextTick - fPassedTicks, 0, 'f' )
-							.arg(
-								( fNextTick - fPassedTicks ) * fNextTickSize, 0,
-								'g', 30
-							)
-					);
-#endif
-
-					fRemainingTicks -= fNextTick - fPassedTicks;
-
-					fPassedTicks = fNextTick;
-				}
-				else {
-					handleEnd();
-					break;
-				}
-			}
-
-			if ( fRemainingTicks > 0 ) {
-				// The provided fTick is larger than the song. But,
-				// luckily, we just calculated the song length in
-				// frames (fNewFrame).
-				const int nRepetitions = std::floor( fTick / fSongSizeInTicks );
-				const double fSongSizeInFrames = fNewFrame;
-
-				fNewFrame *= static_cast<double>( nRepetitions );
-				fNewTick = std::fmod( fTick, fSongSizeInTicks );
-				fRemainingTicks = fNewTick;
-				fPassedTicks = 0;
+		 pHydrogen->getMode() == Song::Mode::Song && ! pTempoMap->isEmpty() ) {
+		nNewFrame = pTempoMap->computeFrameFromTick( fTick, fTickMismatch );
 
 #if TRANSPORT_DEBUG
-				TP_DEBUGLOG(
-					QString( "[repeat] fTick: %1, fNewFrames: %2, fNewTick: "
-							 "%3, fRemainingTicks: %4, nRepetitions: %5, "
-							 "fSongSizeInTicks: %6, fSongSizeInFrames: %7" )
-						.arg( fTick, 0, 'g', 30 )
-						.arg( fNewFrame, 0, 'g', 30 )
-						.arg( fNewTick, 0, 'g', 30 )
-						.arg( fRemainingTicks, 0, 'g', 30 )
-						.arg( nRepetitions )
-						.arg( fSongSizeInTicks, 0, 'g', 30 )
-						.arg( fSongSizeInFrames, 0, 'g', 30 )
-				);
+		TP_DEBUGLOG( QString( "[timeline] nNewFrame: %1, fTick: %2, "
+							  "fTickMismatch: %3, tempo map: %4" )
+						 .arg( nNewFrame )
+						 .arg( fTick, 0, 'f' )
+						 .arg( *fTickMismatch, 0, 'g', 30 )
+						 .arg( pTempoMap->toQString( "", true ) ) );
 #endif
-
-				if ( std::isinf( fNewFrame ) ||
-					 static_cast<long long>( fNewFrame ) >
-						 std::numeric_limits<long long>::max() ) {
-					ERRORLOG( QString( "Provided ticks [%1] are too large." )
-								  .arg( fTick ) );
-					return 0;
-				}
-
-				// The target tick matches a multiple of the song
-				// size. We need to reproduce the context within the
-				// last tempo marker in order to get the mismatch
-				// right.
-				if ( fRemainingTicks == 0 ) {
-					ii = tempoMarkers.size();
-					fNextTick = static_cast<double>(
-						pHydrogen->getTickForColumn( tempoMarkers[0]->nColumn )
-					);
-					fNextTickSize = AudioEngine::computeDoubleTickSize(
-						nSampleRate, tempoMarkers[ii - 1]->fBpm
-					);
-
-					handleEnd();
-				}
-			}
-		}
 	}
 	else {
 		// There may be neither Timeline nor Song.
@@ -611,7 +402,6 @@ Transport::computeTickFromFrame( const long long nFrame, int nSampleRate )
 	if ( pSong == nullptr ) {
 		return 0;
 	}
-	const auto pTimeline = pSong->getTimeline();
 	const auto pAudioEngine = pHydrogen->getAudioEngine();
 	const auto pAudioDriver = pHydrogen->getAudioDriver();
 
@@ -626,8 +416,6 @@ Transport::computeTickFromFrame( const long long nFrame, int nSampleRate )
 
 	double fTick = 0;
 
-	const double fSongSizeInTicks = pAudioEngine->getSongSizeInTicks();
-
 	if ( nSampleRate == 0 ) {
 		ERRORLOG( "Not properly initialized yet" );
 		return fTick;
@@ -637,159 +425,20 @@ Transport::computeTickFromFrame( const long long nFrame, int nSampleRate )
 		return fTick;
 	}
 
-	std::vector<std::shared_ptr<const Timeline::TempoMarker>> tempoMarkers;
-	bool bSpecialFirstMarker = false;
-	if ( pTimeline != nullptr ) {
-		tempoMarkers = pTimeline->getAllTempoMarkers();
-		bSpecialFirstMarker = pTimeline->isFirstTempoMarkerSpecial();
-	}
-
-	int nColumns = 0;
-	if ( pSong != nullptr ) {
-		nColumns = pSong->getPatternGroupVector()->size();
-	}
-
-	// If there are no patterns in the current, we treat song mode
-	// like pattern mode.
+	// If there are no patterns in the current song, we treat song mode like
+	// pattern mode.
+	const auto pTempoMap = getTempoMap( nSampleRate );
 	if ( pHydrogen->isTimelineEnabled() &&
-		 !( tempoMarkers.size() == 1 && bSpecialFirstMarker ) &&
-		 pHydrogen->getMode() == Song::Mode::Song && nColumns > 0 ) {
-		// We are using double precision in here to avoid rounding
-		// errors.
-		const double fTargetFrame = static_cast<double>( nFrame );
-		double fPassedFrames = 0;
-		double fNextFrame = 0;
-		double fNextTicks, fPassedTicks = 0;
-		double fNextTickSize;
-		long long nRemainingFrames;
-
-		const int nColumns = pSong->getPatternGroupVector()->size();
-
-		while ( fPassedFrames < fTargetFrame ) {
-			for ( int ii = 1; ii <= tempoMarkers.size(); ++ii ) {
-				fNextTickSize = AudioEngine::computeDoubleTickSize(
-					nSampleRate, tempoMarkers[ii - 1]->fBpm
-				);
-
-				if ( ii == tempoMarkers.size() ||
-					 tempoMarkers[ii]->nColumn >= nColumns ) {
-					fNextTicks = fSongSizeInTicks;
-				}
-				else {
-					fNextTicks = static_cast<double>(
-						pHydrogen->getTickForColumn( tempoMarkers[ii]->nColumn )
-					);
-				}
-				fNextFrame = ( fNextTicks - fPassedTicks ) * fNextTickSize;
-
-				if ( fNextFrame < ( fTargetFrame - fPassedFrames ) ) {
-#if TRANSPORT_DEBUG
-					TP_DEBUGLOG(
-						QString(
-							"[segment] nFrame: %1, fTick: %2, nSampleRate: %3, "
-							"fNextTickSize: %4, fNextTicks: %5, fNextFrame: "
-							"%6, tempoMarkers[ ii -1 ]->nColumn: %7, "
-							"tempoMarkers[ ii -1 ]->fBpm: %8, fPassedTicks: "
-							"%9, fPassedFrames: %10, fNewTick (tick "
-							"increment): %11, fNewTick * fNextTickSize (frame "
-							"increment): %12"
-						)
-							.arg( nFrame )
-							.arg( fTick, 0, 'f' )
-							.arg( nSampleRate )
-							.arg( fNextTickSize, 0, 'f' )
-							.arg( fNextTicks, 0, 'f' )
-							.arg( fNextFrame, 0, 'f' )
-							.arg( tempoMarkers[ii - 1]->nColumn )
-							.arg( tempoMarkers[ii - 1]->fBpm )
-							.arg( fPassedTicks, 0, 'f' )
-							.arg( fPassedFrames, 0, 'f' )
-							.arg( fNextTicks - fPassedTicks, 0, 'f' )
-							.arg(
-								( fNextTicks - fPassedTicks ) * fNextTickSize,
-								0, 'g', 30
-							)
-					);
-#endif
-
-					// The whole segment of the timeline covered by tempo
-					// marker ii is left of the transport position.
-					fTick += fNextTicks - fPassedTicks;
-
-					fPassedFrames += fNextFrame;
-					fPassedTicks = fNextTicks;
-				}
-				else {
-					// The target frame is located within a segment.
-					const double fNewTick =
-						( fTargetFrame - fPassedFrames ) / fNextTickSize;
-
-					fTick += fNewTick;
+		 pHydrogen->getMode() == Song::Mode::Song && ! pTempoMap->isEmpty() ) {
+		fTick = pTempoMap->computeTickFromFrame( nFrame );
 
 #if TRANSPORT_DEBUG
-					TP_DEBUGLOG(
-						QString( "[end] nFrame: %1, fTick: %2, nSampleRate: "
-								 "%3, fNextTickSize: %4, fNextTicks: %5, "
-								 "fNextFrame: %6, tempoMarkers[ ii -1 "
-								 "]->nColumn: %7, tempoMarkers[ ii -1 ]->fBpm: "
-								 "%8, fPassedTicks: %9, fPassedFrames: %10, "
-								 "fNewTick (tick increment): %11, fNewTick * "
-								 "fNextTickSize (frame increment): %12" )
-							.arg( nFrame )
-							.arg( fTick, 0, 'f' )
-							.arg( nSampleRate )
-							.arg( fNextTickSize, 0, 'f' )
-							.arg( fNextTicks, 0, 'f' )
-							.arg( fNextFrame, 0, 'f' )
-							.arg( tempoMarkers[ii - 1]->nColumn )
-							.arg( tempoMarkers[ii - 1]->fBpm )
-							.arg( fPassedTicks, 0, 'f' )
-							.arg( fPassedFrames, 0, 'f' )
-							.arg( fNewTick, 0, 'f' )
-							.arg( fNewTick * fNextTickSize, 0, 'g', 30 )
-					);
-#endif
-
-					fPassedFrames = fTargetFrame;
-
-					break;
-				}
-			}
-
-			if ( fPassedFrames != fTargetFrame ) {
-				// The provided nFrame is larger than the song. But,
-				// luckily, we just calculated the song length in
-				// frames.
-				const double fSongSizeInFrames = fPassedFrames;
-				const int nRepetitions =
-					std::floor( fTargetFrame / fSongSizeInFrames );
-				if ( fSongSizeInTicks * nRepetitions >
-					 std::numeric_limits<double>::max() ) {
-					ERRORLOG( QString( "Provided frames [%1] are too large." )
-								  .arg( nFrame ) );
-					return 0;
-				}
-				fTick = fSongSizeInTicks * nRepetitions;
-
-				fPassedFrames =
-					static_cast<double>( nRepetitions ) * fSongSizeInFrames;
-				fPassedTicks = 0;
-
-#if TRANSPORT_DEBUG
-				TP_DEBUGLOG(
-					QString( "[repeat] frames covered: %1, frames remaining: "
-							 "%2, ticks covered: %3,  nRepetitions: %4, "
-							 "fSongSizeInFrames: %5, fSongSizeInTicks: %6" )
-						.arg( fPassedFrames, 0, 'g', 30 )
-						.arg( fTargetFrame - fPassedFrames, 0, 'g', 30 )
-						.arg( fTick, 0, 'g', 30 )
-						.arg( nRepetitions )
-						.arg( fSongSizeInFrames, 0, 'g', 30 )
-						.arg( fSongSizeInTicks, 0, 'g', 30 )
-				);
+		TP_DEBUGLOG( QString( "[timeline] nFrame: %1, fTick: %2, tempo map: "
+							  "%3" )
+						 .arg( nFrame )
+						 .arg( fTick, 0, 'f' )
+						 .arg( pTempoMap->toQString( "", true ) ) );
 #endif
-			}
-		}
 	}
 	else {
 		// There may be neither Timeline nor Song.
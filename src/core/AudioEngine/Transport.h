@@ -32,6 +32,7 @@ namespace H2Core {
 class AudioEngine;
 class AudioEngineTests;
 class PatternList;
+class TempoMap;
 
 /**
  * Object holding most of the information about the transport state of the
@@ -87,6 +88,8 @@ class Transport : public H2Core::Object<Transport> {
 	 * In case the #Timeline is activated, the function takes all passed tempo
 	 * markers into account in order to determine the number of ticks passed
 	 * when letting the #AudioEngine roll for @a nFrame frames.
+	 * The tempo markers are looked up in the #TempoMap cached by the
+	 * #AudioEngine.
 	 *
 	 * It depends on the sample rate @a nSampleRate and assumes that it as well
 	 * as the resolution to be constant over the whole song.
@@ -104,6 +107,8 @@ class Transport : public H2Core::Object<Transport> {
 	 * In case the #Timeline is activated, the function takes all passed tempo
 	 * markers into account in order to determine the number of frames passed
 	 * when letting the #AudioEngine roll for @a fTick ticks.
+	 * The tempo markers are looked up in the #TempoMap cached by the
+	 * #AudioEngine.
 	 *
 	 * It depends on the sample rate @a nSampleRate and assumes that it as well
 	 * as the resolution to be constant over the whole song.
@@ -168,6 +173,13 @@ class Transport : public H2Core::Object<Transport> {
 	friend class JackDriver;
 
    private:
+	/**
+	 * Map published by the #AudioEngine. In case @a nSampleRate differs
+	 * from the one of the current audio driver - which is never the case
+	 * within the audio thread - a temporary map is created instead.
+	 */
+	static std::shared_ptr<const TempoMap> getTempoMap( int nSampleRate );
+
 	/**
 	 * Copying the content of one position into the other is a lot cheaper than
 	 * performing computations, like #AudioEngine::updateTransport(),
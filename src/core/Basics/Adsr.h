@@ -51,6 +51,11 @@ class ADSR : public Object<ADSR>
 		/** copy constructor */
 		ADSR( const std::shared_ptr<ADSR> other );
 
+		/** Assigns parameters and state of @a other to this instance. In
+		 * contrast to the copy constructor no memory is allocated. Used to
+		 * recycle notes in the #H2Core::NotePool. */
+		void copyFrom( const std::shared_ptr<ADSR> other );
+
 		/** destructor */
 		~ADSR();
 
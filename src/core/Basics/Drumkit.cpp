@@ -37,6 +37,7 @@
   #endif
 #endif
 
+#include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/Sample.h>
 #include <core/Basics/DrumkitMap.h>
 #include <core/Basics/InstrumentList.h>
@@ -316,14 +317,17 @@ void Drumkit::upgrade( bool bSilent ) {
 	save( "", bSilent);
 }
 
-void Drumkit::loadSamples( float fBpm ) {
+void Drumkit::loadSamples( float fBpm, int nThreads,
+							std::shared_ptr<Drumkit> pSkip ) {
 	INFOLOG( QString( "Loading drumkit %1 instrument samples" ).arg( m_sName ) );
-	m_pInstruments->loadSamples( fBpm );
+	m_pInstruments->loadSamples(
+		fBpm, nThreads, pSkip != nullptr ? pSkip->getInstruments() : nullptr );
 }
 
-void Drumkit::unloadSamples() {
+void Drumkit::unloadSamples( std::shared_ptr<Drumkit> pSkip ) {
 	INFOLOG( QString( "Unloading drumkit %1 instrument samples" ).arg( m_sName ) );
-	m_pInstruments->unloadSamples();
+	m_pInstruments->unloadSamples(
+		pSkip != nullptr ? pSkip->getInstruments() : nullptr );
 }
 
 const bool Drumkit::areSamplesLoaded() const {
@@ -1247,6 +1251,9 @@ void Drumkit::recalculateRubberband( float fBpm )
 		ERRORLOG( "No InstrumentList present" );
 	}
 
+	auto pCache =
+		Hydrogen::get_instance()->getAudioEngine()->getRubberbandCache();
+
 	for ( auto& ppInstrument : *m_pInstruments ) {
 		if ( ppInstrument == nullptr ) {
 			continue;
@@ -1261,9 +1268,13 @@ void Drumkit::recalculateRubberband( float fBpm )
 					 !ppLayer->getSample()->getRubberband().bUse ) {
 					continue;
 				}
-				auto pNewSample = std::make_shared<Sample>( ppLayer->getSample() );
-				if ( !pNewSample->load( fBpm ) ) {
-				  continue;
+				// Each sample is only decoded once. Stretched versions are
+				// reused on subsequent calls.
+				auto pNewSample =
+					pCache->getStretchedSample( ppLayer->getSample(), fBpm );
+				if ( pNewSample == nullptr ||
+					 pNewSample == ppLayer->getSample() ) {
+					continue;
 				}
 
 				ppInstrument->setSample(
@@ -178,12 +178,17 @@ class Drumkit : public H2Core::Object<Drumkit>
 
 		/** Calls the InstrumentList::loadSamples() member
 		 * function of #m_pInstruments.
+		 *
+		 * Instruments shared with @a pSkip are not loaded.
 		 */
-		void loadSamples( float fBpm = 120 );
+		void loadSamples( float fBpm = 120, int nThreads = 0,
+						  std::shared_ptr<Drumkit> pSkip = nullptr );
 		/** Calls the InstrumentList::unloadSamples() member
 		 * function of #m_pInstruments.
+		 *
+		 * Instruments shared with @a pSkip are not unloaded.
 		 */
-		void unloadSamples();
+		void unloadSamples( std::shared_ptr<Drumkit> pSkip = nullptr );
 		/** return true if the samples are loaded */
 		const bool areSamplesLoaded() const;
 		bool hasMissingSamples() const;
@@ -307,6 +312,11 @@ class Drumkit : public H2Core::Object<Drumkit>
 		/** Recalculates all Samples using RubberBand for a specific
 		* tempo @a fBpm.
 		*
+		* Stretched samples are taken from the #RubberbandCache (and
+		* stretched on the spot if not present yet). This function blocks
+		* and must not be called from within the audio thread. Use
+		* RubberbandCache::requestBpm() instead.
+		*
 		* This function requires the calling function to lock the
 		* #AudioEngine first.
 		*/
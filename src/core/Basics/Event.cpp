@@ -145,6 +145,11 @@ Event::Event( Event::Type type, int nValue ) : m_type( type )
 	}
 }
 
+Event::Event( Event::Type type, int nValue, long nId ) : m_type( type )
+														, m_nValue( nValue )
+														, m_nId( nId ) {
+}
+
 Event::~Event() {
 }
 
@@ -69,6 +69,9 @@ public:
 			DrumkitLoaded,
 			EffectChanged,
 			Error,
+			/** A pattern was activated or deactivated in the song editor.
+			 *
+			 * The integer supplied is the column of the toggled cell. */
 			GridCellToggled,
 			/** An instrument layer was added, replaced, delete, or edited using
 			 * the #SampleEditor.
@@ -162,7 +165,11 @@ public:
 			PlayingPatternsChanged,
 			/**
 			 * Used by the thread of the `DiskWriterDriver` to indicate progress
-			 * of the ongoing audio export (from 0 to 100).
+			 * of the ongoing audio export (from 0 to 100). `100` is sent once
+			 * all rendered audio was written to disk. The exact number of
+			 * rendered and encoded frames can be queried using
+			 * `DiskWriterDriver::getRenderedFrames()` and
+			 * `DiskWriterDriver::getEncodedFrames()`.
 			 *
 			 * The value `-1` is used to indicate exporting failed.
 			 */
@@ -233,6 +240,9 @@ public:
 		static QString TypeToQString( Event::Type type );
 
 		Event( Event::Type type, int nValue );
+		/** Used by the #EventQueue to recreate an event from the plain data
+		 * stored in its ring buffer. */
+		Event( Event::Type type, int nValue, long nId );
 		~Event();
 
 		Event::Type getType() const;
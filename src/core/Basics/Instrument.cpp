@@ -42,6 +42,8 @@
 
 namespace H2Core {
 
+std::atomic<int> Instrument::m_nAudibilityRevision( 0 );
+
 Instrument::Instrument(
 	const Instrument::Id id,
 	const QString& name,
@@ -72,7 +74,6 @@ Instrument::Instrument(
 	  m_bMuted( false ),
 	  m_nMuteGroup( -1 ),
 	  m_nQueued( 0 ),
-	  m_enqueuedBy( QStringList() ),
 	  m_nHihatGrp( -1 ),
 	  m_lowerCc( Midi::ParameterMinimum ),
 	  m_higherCc( Midi::ParameterMaximum ),
@@ -82,7 +83,8 @@ Instrument::Instrument(
 	  m_bHasMissingSamples( false ),
 	  m_pComponents(
 		  std::make_shared<std::vector<std::shared_ptr<InstrumentComponent>>>()
-	  )
+	  ),
+	  m_bAudible( true )
 {
 	/*: Name assigned to an Instrument created either as part of a fresh kit
 	 *  created via the Main Menu > Drumkit > New or via the "Add Instrument"
@@ -129,7 +131,6 @@ Instrument::Instrument( std::shared_ptr<Instrument> other )
 	  m_bMuted( other->isMuted() ),
 	  m_nMuteGroup( other->getMuteGroup() ),
 	  m_nQueued( 0 ),
-	  m_enqueuedBy( QStringList() ),
 	  m_nHihatGrp( other->getHihatGrp() ),
 	  m_lowerCc( other->getLowerCc() ),
 	  m_higherCc( other->getHigherCc() ),
@@ -137,7 +138,8 @@ Instrument::Instrument( std::shared_ptr<Instrument> other )
 	  m_bApplyVelocity( other->getApplyVelocity() ),
 	  m_bCurrentInstrForExport( false ),
 	  m_bHasMissingSamples( other->hasMissingSamples() ),
-	  m_pComponents( nullptr )
+	  m_pComponents( nullptr ),
+	  m_bAudible( true )
 {
 	for ( int i = 0; i < MAX_FX; i++ ) {
 		m_fxLevel[i] = other->getFxLevel( i );
@@ -156,11 +158,9 @@ Instrument::~Instrument()
 {
 	if ( m_nQueued > 0 ) {
 		WARNINGLOG( QString( "Instrument [%1] is destroyed while still being "
-							 "enqueued! m_nQueued: %2,\nm_enqueuedNotes:\n\t%3"
-		)
+							 "enqueued! m_nQueued: %2" )
 						.arg( m_sName )
-						.arg( m_nQueued )
-						.arg( m_enqueuedBy.join( "\n\t" ) ) );
+						.arg( m_nQueued ) );
 	}
 }
 
@@ -675,8 +675,6 @@ bool Instrument::isAnyComponentSoloed() const
 void Instrument::enqueue( std::shared_ptr<Note> pNote )
 {
 	m_nQueued++;
-
-	m_enqueuedBy.push_back( pNote->prettyName() );
 }
 
 void Instrument::dequeue( std::shared_ptr<Note> pNote )
@@ -687,13 +685,6 @@ void Instrument::dequeue( std::shared_ptr<Note> pNote )
 	}
 
 	m_nQueued--;
-
-	if ( m_nQueued > 0 ) {
-		m_enqueuedBy.removeOne( pNote->prettyName() );
-	}
-	else {
-		m_enqueuedBy.clear();
-	}
 }
 
 void Instrument::setPitchOffset( float fValue )
@@ -738,6 +729,7 @@ int Instrument::index( std::shared_ptr<InstrumentComponent> pComponent ) const
 void Instrument::addComponent( std::shared_ptr<InstrumentComponent> pComponent )
 {
 	m_pComponents->push_back( pComponent );
+	bumpAudibilityRevision();
 }
 
 void Instrument::removeComponent( int nIdx )
@@ -750,6 +742,7 @@ void Instrument::removeComponent( int nIdx )
 	}
 
 	m_pComponents->erase( m_pComponents->begin() + nIdx );
+	bumpAudibilityRevision();
 }
 
 const QString& Instrument::getDrumkitPath() const
@@ -1038,12 +1031,7 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const
 				.append( QString( "%1%2m_nQueued: %3\n" )
 							 .arg( sPrefix )
 							 .arg( s )
-							 .arg( m_nQueued ) )
-				.append( QString( "%1%2m_enqueuedBy: %3\n" )
-							 .arg( sPrefix )
-							 .arg( s )
-							 .arg( m_enqueuedBy.join( "\n" + sPrefix + s + s ) )
-				);
+							 .arg( m_nQueued ) );
 		sOutput.append( QString( "%1%2m_fxLevel: [ " ).arg( sPrefix ).arg( s )
 		);
 		for ( const auto& ff : m_fxLevel ) {
@@ -1128,9 +1116,7 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const
 				.append( QString( ", m_bSoloed: %1" ).arg( m_bSoloed ) )
 				.append( QString( ", m_bMuted: %1" ).arg( m_bMuted ) )
 				.append( QString( ", m_nMuteGroup: %1" ).arg( m_nMuteGroup ) )
-				.append( QString( ", m_nQueued: %1" ).arg( m_nQueued ) )
-				.append( QString( ", m_enqueuedBy: [%1]" )
-							 .arg( m_enqueuedBy.join( " ; " ) ) );
+				.append( QString( ", m_nQueued: %1" ).arg( m_nQueued ) );
 		sOutput.append( QString( ", m_fxLevel: [ " ) );
 		for ( const auto& ff : m_fxLevel ) {
 			sOutput.append( QString( "%1 " ).arg( ff ) );
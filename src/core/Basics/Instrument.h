@@ -23,6 +23,7 @@
 #ifndef H2C_INSTRUMENT_H
 #define H2C_INSTRUMENT_H
 
+#include <atomic>
 #include <cassert>
 #include <memory>
 
@@ -255,13 +256,29 @@ class Instrument : public H2Core::Object<Instrument> {
 
 	bool isAnyComponentSoloed() const;
 
-	/** enqueue the instrument for @a pNote */
+	/** Counter incremented each time the mute, solo, or export state of an
+	 * instrument or one of its components changed or instruments and
+	 * components were added or removed.
+	 *
+	 * The #Sampler uses it to decide when to refresh its audibility
+	 * snapshot. */
+	static int getAudibilityRevision();
+	static void bumpAudibilityRevision();
+	/** Snapshot of whether the instrument is neither muted, silenced by the
+	 * solo of another instrument, nor excluded from the current export.
+	 * Maintained by Sampler::updateAudibility(). */
+	bool isAudible() const;
+
+	/** enqueue the instrument for @a pNote
+	 *
+	 * Called from within the audio thread and must not allocate memory. */
 	void enqueue( std::shared_ptr<Note> pNote );
 	/** dequeue the instrument for @a pNote */
 	void dequeue( std::shared_ptr<Note> pNote );
 	/** get the queued status of the instrument */
 	bool isQueued() const;
-	const QStringList& getEnqueuedBy() const;
+	/** @return Number of notes the instrument is enqueued for. */
+	int getQueued() const;
 
 	/** set the stop notes status of the instrument */
 	void setStopNotes( bool stopnotes );
@@ -362,6 +379,8 @@ class Instrument : public H2Core::Object<Instrument> {
 		const override;
 
    private:
+	friend class Sampler;
+
 	void checkForMissingSamples( Event::Trigger trigger );
 
 	/** Identifier of an instrument, which should be unique. It is set by
@@ -423,9 +442,6 @@ class Instrument : public H2Core::Object<Instrument> {
 	int m_nQueued;			///< count the number of notes queued within
 					///< Sampler::m_playingNotesQueue or std::priority_queue
 					///< m_songNoteQueue
-	/** List of short string representations of notes for which this
-	 * instrument was enqueued. */
-	QStringList m_enqueuedBy;
 	float m_fxLevel[MAX_FX];	  ///< Ladspa FX level array
 	int m_nHihatGrp;			  ///< the instrument is part of a hihat
 	Midi::Parameter m_lowerCc;
@@ -439,6 +455,12 @@ class Instrument : public H2Core::Object<Instrument> {
 									///< files?
 	std::shared_ptr<std::vector<std::shared_ptr<InstrumentComponent>>>
 		m_pComponents;
+
+	/** Whether the instrument is neither muted, silenced by the solo of
+	 * another instrument, nor excluded from the current export. Snapshot
+	 * maintained by the #Sampler. */
+	bool m_bAudible;
+	static std::atomic<int> m_nAudibilityRevision;
 };
 
 inline void Instrument::setName( const QString& name )
@@ -501,6 +523,7 @@ inline void Instrument::setMidiOutNote( Midi::Note note )
 inline void Instrument::setMuted( bool muted )
 {
 	m_bMuted = muted;
+	bumpAudibilityRevision();
 }
 
 inline bool Instrument::isMuted() const
@@ -625,6 +648,7 @@ inline float Instrument::getPitchOffset() const
 inline void Instrument::setSoloed( bool soloed )
 {
 	m_bSoloed = soloed;
+	bumpAudibilityRevision();
 }
 
 inline bool Instrument::isSoloed() const
@@ -637,9 +661,9 @@ inline bool Instrument::isQueued() const
 	return ( m_nQueued > 0 );
 }
 
-inline const QStringList& Instrument::getEnqueuedBy() const
+inline int Instrument::getQueued() const
 {
-	return m_enqueuedBy;
+	return m_nQueued;
 }
 
 inline void Instrument::setStopNotes( bool stopnotes )
@@ -726,6 +750,22 @@ inline bool Instrument::isCurrentlyExported() const
 inline void Instrument::setCurrentlyExported( bool isCurrentlyExported )
 {
 	m_bCurrentInstrForExport = isCurrentlyExported;
+	bumpAudibilityRevision();
+}
+
+inline int Instrument::getAudibilityRevision()
+{
+	return m_nAudibilityRevision.load();
+}
+
+inline void Instrument::bumpAudibilityRevision()
+{
+	++m_nAudibilityRevision;
+}
+
+inline bool Instrument::isAudible() const
+{
+	return m_bAudible;
 }
 
 inline Instrument::Type Instrument::getType() const
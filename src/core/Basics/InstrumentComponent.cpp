@@ -22,10 +22,15 @@
 
 #include <core/Basics/InstrumentComponent.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <set>
 
 #include <core/Basics/InstrumentLayer.h>
+#include <core/Helpers/Random.h>
 #include <core/Helpers/Xml.h>
 
 
@@ -38,6 +43,10 @@ InstrumentComponent::InstrumentComponent( const QString& sName, float fGain )
 	, m_bIsMuted( false )
 	, m_bIsSoloed( false )
 	, m_selection( Selection::Velocity )
+	, m_nVelocityTableRevision( -1 )
+	, m_nLastRoundRobinLayer( -1 )
+	, m_bAudible( true )
+	, m_bAnyLayerSoloed( false )
 {
 	/*: Name assigned to an InstrumentComponent of a fresh instrument. */
 	const QString sComponentName =
@@ -54,12 +63,17 @@ InstrumentComponent::InstrumentComponent( std::shared_ptr<InstrumentComponent> o
 	, m_bIsMuted( other->m_bIsMuted )
 	, m_bIsSoloed( other->m_bIsSoloed )
 	, m_selection( other->m_selection )
+	, m_nVelocityTableRevision( -1 )
+	, m_nLastRoundRobinLayer( -1 )
+	, m_bAudible( true )
+	, m_bAnyLayerSoloed( false )
 {
 	for ( const auto& ppLayer : other->m_layers ) {
 		if ( ppLayer != nullptr ) {
 			m_layers.push_back( std::make_shared<InstrumentLayer>( ppLayer ) );
 		}
 	}
+	m_bucketLayers.reserve( nVelocityBuckets * m_layers.size() );
 }
 
 InstrumentComponent::~InstrumentComponent()
@@ -87,7 +101,13 @@ void InstrumentComponent::addLayer(
 		ERRORLOG( QString( "Index [%1] out of bound [0, %2]" )
 					  .arg( nIndex )
 					  .arg( m_layers.size() ) );
+		return;
 	}
+
+	// Each bucket of the velocity table can hold all layers. This way the
+	// table can be rebuilt within the audio thread without allocations.
+	m_bucketLayers.reserve( nVelocityBuckets * m_layers.size() );
+	invalidateVelocityTable();
 }
 
 void InstrumentComponent::moveLayer( int nOldIndex, int nNewIndex )
@@ -119,6 +139,8 @@ void InstrumentComponent::moveLayer( int nOldIndex, int nNewIndex )
 	m_layers.insert( m_layers.begin() + nInsertAt, pLayer );
     const int nEraseAt = nNewIndex < nOldIndex ? nOldIndex + 1 : nOldIndex;
     m_layers.erase( m_layers.begin() + nEraseAt );
+
+	invalidateVelocityTable();
 }
 
 void InstrumentComponent::setLayer( std::shared_ptr<InstrumentLayer> pLayer, int nIndex )
@@ -130,6 +152,8 @@ void InstrumentComponent::setLayer( std::shared_ptr<InstrumentLayer> pLayer, int
 	  return;
 	}
 	m_layers[ nIndex ] = pLayer;
+
+	invalidateVelocityTable();
 }
 
 void InstrumentComponent::removeLayer( int nIndex )
@@ -141,6 +165,8 @@ void InstrumentComponent::removeLayer( int nIndex )
 	  return;
 	}
 	m_layers.erase( std::next( m_layers.begin(), nIndex ) );
+
+	invalidateVelocityTable();
 }
 
 std::shared_ptr<InstrumentComponent> InstrumentComponent::loadFrom(
@@ -245,6 +271,7 @@ void InstrumentComponent::saveTo(
 		}
 
 		m_layers = newLayers;
+		invalidateVelocityTable();
 	}
 }
 
@@ -270,6 +297,170 @@ bool InstrumentComponent::isAnyLayerSoloed() const {
 	return false;
 }
 
+std::shared_ptr<InstrumentLayer> InstrumentComponent::selectLayer(
+	float fVelocity, Random& random )
+{
+	updateVelocityTable();
+
+	const int nBucket = std::clamp(
+		static_cast<int>( fVelocity * nVelocityBuckets ), 0,
+		nVelocityBuckets - 1 );
+	const auto& bucket = m_velocityTable[ nBucket ];
+
+	// The bucket contains all layers overlapping with it. But we only
+	// consider those actually covering the velocity.
+	auto coveringLayer = [&]( int nOffset ) {
+		const int nLayer = m_bucketLayers[ bucket.nFirst + nOffset ];
+		if ( nLayer < m_layers.size() && m_layers[ nLayer ] != nullptr &&
+			 fVelocity >= m_layers[ nLayer ]->getStartVelocity() &&
+			 fVelocity <= m_layers[ nLayer ]->getEndVelocity() ) {
+			return nLayer;
+		}
+		return -1;
+	};
+
+	int nCovering = 0;
+	int nFirstCovering = -1;
+	for ( int ii = 0; ii < bucket.nCount; ++ii ) {
+		const int nLayer = coveringLayer( ii );
+		if ( nLayer != -1 ) {
+			if ( nFirstCovering == -1 ) {
+				nFirstCovering = nLayer;
+			}
+			++nCovering;
+		}
+	}
+
+	int nSelected = -1;
+	if ( nCovering == 0 ) {
+		// In some instruments the start and end velocities of a layer are
+		// not set perfectly giving rise to some 'holes'. Occasionally the
+		// velocity of a note can fall into it causing the sampler to just
+		// skip it. Instead, we play the nearest layer.
+		nSelected = bucket.nNearest;
+	}
+	else {
+		switch ( m_selection ) {
+		case Selection::Velocity:
+			// In case of "First in velocity", we select the first layer
+			// encountered. The order in #m_layers corresponds to the order
+			// shown in the ComponentView.
+			nSelected = nFirstCovering;
+			break;
+
+		case Selection::Random: {
+			int nRemaining = random.getInt( nCovering );
+			for ( int ii = 0; ii < bucket.nCount; ++ii ) {
+				const int nLayer = coveringLayer( ii );
+				if ( nLayer != -1 && nRemaining-- == 0 ) {
+					nSelected = nLayer;
+					break;
+				}
+			}
+			break;
+		}
+
+		case Selection::RoundRobin: {
+			// In case the last layer is among the covering ones, we select
+			// the next one. If not or if it was the last one, we start over
+			// with the first layer.
+			bool bLastFound = false;
+			for ( int ii = 0; ii < bucket.nCount; ++ii ) {
+				const int nLayer = coveringLayer( ii );
+				if ( nLayer == -1 ) {
+					continue;
+				}
+				if ( bLastFound ) {
+					nSelected = nLayer;
+					break;
+				}
+				if ( nLayer == m_nLastRoundRobinLayer ) {
+					bLastFound = true;
+				}
+			}
+			if ( nSelected == -1 ) {
+				nSelected = nFirstCovering;
+			}
+			break;
+		}
+		}
+	}
+
+	if ( nSelected < 0 || nSelected >= m_layers.size() ) {
+		return nullptr;
+	}
+
+	if ( m_selection == Selection::RoundRobin ) {
+		m_nLastRoundRobinLayer = nSelected;
+	}
+
+	return m_layers[ nSelected ];
+}
+
+void InstrumentComponent::invalidateVelocityTable()
+{
+	m_nVelocityTableRevision = -1;
+	InstrumentLayer::bumpRevision();
+}
+
+void InstrumentComponent::updateVelocityTable()
+{
+	// Only changes to the layers of this component require a rebuild.
+	bool bOutdated = m_nVelocityTableRevision == -1;
+	for ( const auto& ppLayer : m_layers ) {
+		if ( ppLayer != nullptr &&
+			 ppLayer->getLastChange() > m_nVelocityTableRevision ) {
+			bOutdated = true;
+			break;
+		}
+	}
+	if ( ! bOutdated ) {
+		return;
+	}
+	const int nRevision = InstrumentLayer::getRevision();
+
+	const bool bLayersSoloed = isAnyLayerSoloed();
+
+	m_bucketLayers.clear();
+	for ( int nnBucket = 0; nnBucket < nVelocityBuckets; ++nnBucket ) {
+		const float fBucketStart =
+			static_cast<float>( nnBucket ) / nVelocityBuckets;
+		const float fBucketEnd =
+			static_cast<float>( nnBucket + 1 ) / nVelocityBuckets;
+		const float fBucketCenter = ( fBucketStart + fBucketEnd ) / 2;
+
+		auto& bucket = m_velocityTable[ nnBucket ];
+		bucket.nFirst = static_cast<int>( m_bucketLayers.size() );
+		bucket.nCount = 0;
+		bucket.nNearest = -1;
+
+		float fShortestDistance = std::numeric_limits<float>::max();
+		for ( int ii = 0; ii < m_layers.size(); ++ii ) {
+			const auto& ppLayer = m_layers[ ii ];
+			if ( ppLayer == nullptr || ppLayer->getIsMuted() ||
+				 ( bLayersSoloed && !ppLayer->getIsSoloed() ) ) {
+				continue;
+			}
+
+			if ( ppLayer->getStartVelocity() <= fBucketEnd &&
+				 ppLayer->getEndVelocity() >= fBucketStart ) {
+				m_bucketLayers.push_back( ii );
+				++bucket.nCount;
+			}
+
+			const float fDistance = std::min(
+				std::abs( ppLayer->getStartVelocity() - fBucketCenter ),
+				std::abs( ppLayer->getEndVelocity() - fBucketCenter ) );
+			if ( fDistance < fShortestDistance ) {
+				fShortestDistance = fDistance;
+				bucket.nNearest = ii;
+			}
+		}
+	}
+
+	m_nVelocityTableRevision = nRevision;
+}
+
 void InstrumentComponent::setAutoVelocity()
 {
 	if ( m_layers.size() == 0 ) {
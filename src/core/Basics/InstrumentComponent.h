@@ -23,6 +23,7 @@
 #ifndef H2C_INSTRUMENTCOMPONENT_H
 #define H2C_INSTRUMENTCOMPONENT_H
 
+#include <array>
 #include <cassert>
 #include <vector>
 #include <memory>
@@ -38,6 +39,7 @@ namespace H2Core
 {
 
 class InstrumentLayer;
+class Random;
 class XMLNode;
 
 /** \ingroup docCore docDataStructure */
@@ -87,6 +89,10 @@ class InstrumentComponent : public H2Core::Object<InstrumentComponent>
 		bool				getIsMuted() const;
 		void				setIsSoloed( bool bIsSoloed );
 		bool				getIsSoloed() const;
+		/** Snapshot of whether the component is neither muted nor silenced
+		 * by the solo of another component. Maintained by
+		 * Sampler::updateAudibility(). */
+		bool				getIsAudible() const;
 
 		void setSelection( const Selection& selection );
 		Selection getSelection() const;
@@ -97,6 +103,24 @@ class InstrumentComponent : public H2Core::Object<InstrumentComponent>
 
 		bool isAnyLayerSoloed() const;
 
+		/** Picks the layer used to render a note of velocity @a fVelocity
+		 * according to #m_selection.
+		 *
+		 * Layers are looked up in a table mapping #nVelocityBuckets
+		 * velocity buckets to the layers covering them. It is rebuilt
+		 * whenever the layers were altered. Velocities falling into a hole
+		 * between the layers are resolved to the nearest one.
+		 *
+		 * Does not allocate memory (as long as the number of layers did not
+		 * grow since the last call of an altering function) and must be
+		 * called while the #AudioEngine is locked.
+		 *
+		 * \param random Generator used for #Selection::Random.
+		 *
+		 * \return `nullptr` in case there is no unmuted layer. */
+		std::shared_ptr<InstrumentLayer> selectLayer( float fVelocity,
+													  Random& random );
+
 		/** Reset the start and end velocity of each layer to be of the same
 		 * length and non-overlapping*/
 		void setAutoVelocity();
@@ -148,6 +172,8 @@ class InstrumentComponent : public H2Core::Object<InstrumentComponent>
 		);
 
 	   private:
+		friend class Sampler;
+
 		/** An @a nIndex of -1 will cause the method to append the new layer at
 		   the end.*/
 		void addLayer( std::shared_ptr<InstrumentLayer> pLayer, int nIndex );
@@ -157,6 +183,28 @@ class InstrumentComponent : public H2Core::Object<InstrumentComponent>
 		void setLayer( std::shared_ptr<InstrumentLayer> pLayer, int nIndex );
 		void removeLayer( int nIndex );
 
+		/** Number of buckets of #m_velocityTable. */
+		static constexpr int nVelocityBuckets = 128;
+
+		struct VelocityBucket {
+			/** Offset of the first layer overlapping the bucket in
+			 * #m_bucketLayers. */
+			int nFirst;
+			/** Number of layers overlapping the bucket. */
+			int nCount;
+			/** Index of the layer closest to the center of the bucket. Used
+			 * in case the velocity of a note is not covered by any layer.
+			 * `-1` if there are no layers. */
+			int nNearest;
+		};
+
+		/** Rebuilds #m_velocityTable in case one of the layers of this
+		 * component was altered since the last call. */
+		void updateVelocityTable();
+		/** Forces the next updateVelocityTable() to rebuild the table. Has to
+		 * be called whenever #m_layers itself is altered. */
+		void invalidateVelocityTable();
+
 		QString 			m_sName;
 		float				m_fGain;
 
@@ -166,6 +214,22 @@ class InstrumentComponent : public H2Core::Object<InstrumentComponent>
 		Selection		m_selection;
 
 		std::vector<std::shared_ptr<InstrumentLayer>>	m_layers;
+
+		std::array<VelocityBucket, nVelocityBuckets> m_velocityTable;
+		/** Indices of the (unmuted) layers in #m_layers overlapping each of
+		 * the buckets in #m_velocityTable. */
+		std::vector<int> m_bucketLayers;
+		/** InstrumentLayer::getRevision() at the time #m_velocityTable was
+		 * built. `-1` in case it has to be rebuilt. */
+		int m_nVelocityTableRevision;
+		/** Index of the layer selected last in round robin mode. */
+		int m_nLastRoundRobinLayer;
+
+		/** Whether the component is neither muted nor silenced by the solo
+		 * of another component. Snapshot maintained by the #Sampler. */
+		bool m_bAudible;
+		/** Snapshot of isAnyLayerSoloed() maintained by the #Sampler. */
+		bool m_bAnyLayerSoloed;
 };
 
 // DEFINITIONS
@@ -188,16 +252,21 @@ inline float InstrumentComponent::getGain() const
 
 inline void InstrumentComponent::setIsMuted( bool bIsMuted ) {
 	m_bIsMuted = bIsMuted;
+	Instrument::bumpAudibilityRevision();
 }
 inline bool InstrumentComponent::getIsMuted() const {
 	return m_bIsMuted;
 }
 inline void InstrumentComponent::setIsSoloed( bool bIsSoloed ) {
 	m_bIsSoloed = bIsSoloed;
+	Instrument::bumpAudibilityRevision();
 }
 inline bool InstrumentComponent::getIsSoloed() const {
 	return m_bIsSoloed;
 }
+inline bool InstrumentComponent::getIsAudible() const {
+	return m_bAudible;
+}
 
 inline void InstrumentComponent::setSelection( const Selection& selection ) {
 	m_selection = selection;
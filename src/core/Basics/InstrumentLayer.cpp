@@ -35,6 +35,8 @@
 namespace H2Core
 {
 
+std::atomic<int> InstrumentLayer::m_nRevision( 0 );
+
 InstrumentLayer::InstrumentLayer( std::shared_ptr<Sample> pSample ) :
 	m_fStartVelocity( 0.0 ),
 	m_fEndVelocity( 1.0 ),
@@ -42,13 +44,34 @@ InstrumentLayer::InstrumentLayer( std::shared_ptr<Sample> pSample ) :
 	m_fGain( 1.0 ),
 	m_bIsMuted( false ),
 	m_bIsSoloed( false ),
-	m_pSample( pSample )
+	m_pSample( pSample ),
+	m_nLastChange( 0 )
 {
 	if ( pSample != nullptr ) {
 		m_sFallbackSampleFileName = pSample->getFileName();
 	}
 }
 
+void InstrumentLayer::setPendingSample( std::shared_ptr<Sample> pSample )
+{
+	std::atomic_store( &m_pPendingSample, pSample );
+}
+
+void InstrumentLayer::commitPendingSample()
+{
+	if ( std::atomic_load( &m_pPendingSample ) == nullptr ) {
+		return;
+	}
+
+	auto pSample = std::atomic_exchange(
+		&m_pPendingSample, std::shared_ptr<Sample>() );
+	if ( pSample != nullptr ) {
+		// Since the pending sample is a stretched version of the current
+		// one, there is no need to update #m_sFallbackSampleFileName.
+		m_pSample = pSample;
+	}
+}
+
 InstrumentLayer::InstrumentLayer( std::shared_ptr<InstrumentLayer> pOther ) : Object( *pOther ),
 	m_fStartVelocity( pOther->getStartVelocity() ),
 	m_fEndVelocity( pOther->getEndVelocity() ),
@@ -57,6 +80,7 @@ InstrumentLayer::InstrumentLayer( std::shared_ptr<InstrumentLayer> pOther ) : Ob
 	m_bIsMuted( pOther->m_bIsMuted ),
 	m_bIsSoloed( pOther->m_bIsSoloed ),
 	m_pSample( nullptr ),
+	m_nLastChange( 0 ),
 	m_sFallbackSampleFileName( pOther->m_sFallbackSampleFileName )
 {
 	if ( pOther->m_pSample != nullptr ) {
@@ -71,7 +95,8 @@ InstrumentLayer::InstrumentLayer( std::shared_ptr<InstrumentLayer> pOther, std::
 	m_fGain( pOther->getGain() ),
 	m_bIsMuted( pOther->m_bIsMuted ),
 	m_bIsSoloed( pOther->m_bIsSoloed ),
-	m_pSample( pSample )
+	m_pSample( pSample ),
+	m_nLastChange( 0 )
 {
 	if ( pSample != nullptr ) {
 		m_sFallbackSampleFileName = pSample->getFileName();
@@ -85,6 +110,9 @@ InstrumentLayer::~InstrumentLayer()
 void InstrumentLayer::setSample( std::shared_ptr<Sample> pSample )
 {
 	m_pSample = pSample;
+	// A pending sample stretched from the previous one must not replace
+	// the new one.
+	std::atomic_store( &m_pPendingSample, std::shared_ptr<Sample>() );
 
 	if ( pSample != nullptr ) {
 		m_sFallbackSampleFileName = pSample->getFileName();
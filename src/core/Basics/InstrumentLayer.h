@@ -27,6 +27,7 @@
 #include <core/Object.h>
 #include <core/License.h>
 
+#include <atomic>
 #include <memory>
 
 namespace H2Core
@@ -94,9 +95,42 @@ namespace H2Core
 		void				setIsSoloed( bool bIsSoloed );
 		bool				getIsSoloed() const;
 
+		/** Incremented whenever the velocity range, mute, or solo state of
+		 * any layer or the layers of any #InstrumentComponent change.
+		 *
+		 * Used by the #Sampler to detect whether its audibility snapshot is
+		 * still up to date. */
+		static int getRevision();
+		/** \return The incremented revision. */
+		static int bumpRevision();
+		/** getRevision() at the time the velocity range, mute, or solo state
+		 * of this particular layer was changed last.
+		 *
+		 * Used by InstrumentComponent::selectLayer() to detect whether its
+		 * velocity table is still up to date. */
+		int getLastChange() const;
+
 		/** get the sample of the layer */
 		std::shared_ptr<Sample> getSample() const;
 
+		/**
+		 * Hands over a sample which will replace #m_pSample the next time
+		 * a note using this layer starts rendering.
+		 *
+		 * Used by the #RubberbandCache to swap in samples stretched in the
+		 * background. Can be called from any thread.
+		 */
+		void setPendingSample( std::shared_ptr<Sample> pSample );
+		/**
+		 * Replaces #m_pSample with the sample set via setPendingSample() (if
+		 * present).
+		 *
+		 * Called by the #Sampler within the audio thread. The caller of
+		 * setPendingSample() has to keep a reference to the previous sample
+		 * in order to not deallocate it in here.
+		 */
+		void commitPendingSample();
+
 		const QString& getFallbackSampleFileName() const;
 
 		/**
@@ -186,6 +220,12 @@ namespace H2Core
 		bool				m_bIsMuted;
 		bool				m_bIsSoloed;
 		std::shared_ptr<Sample> m_pSample;           ///< the underlaying sample
+		/** Sample to be swapped in by commitPendingSample(). Only accessed
+		 * via the atomic shared pointer functions. */
+		std::shared_ptr<Sample> m_pPendingSample;
+
+		static std::atomic<int> m_nRevision;
+		int m_nLastChange;
 
 		/** In case we can not load the sample properly, we can use its path -
          * stored in here - to avoid a loss of information.
@@ -215,6 +255,7 @@ namespace H2Core
 	inline void InstrumentLayer::setStartVelocity( float start )
 	{
 		m_fStartVelocity = start;
+		m_nLastChange = bumpRevision();
 	}
 
 	inline float InstrumentLayer::getStartVelocity() const
@@ -225,6 +266,7 @@ namespace H2Core
 	inline void InstrumentLayer::setEndVelocity( float end )
 	{
 		m_fEndVelocity = end;
+		m_nLastChange = bumpRevision();
 	}
 
 	inline float InstrumentLayer::getEndVelocity() const
@@ -234,12 +276,23 @@ namespace H2Core
 
 inline void InstrumentLayer::setIsMuted( bool bIsMuted ) {
 	m_bIsMuted = bIsMuted;
+	m_nLastChange = bumpRevision();
 }
 inline bool InstrumentLayer::getIsMuted() const {
 	return m_bIsMuted;
 }
 inline void InstrumentLayer::setIsSoloed( bool bIsSoloed ) {
 	m_bIsSoloed = bIsSoloed;
+	m_nLastChange = bumpRevision();
+}
+inline int InstrumentLayer::getRevision() {
+	return m_nRevision.load();
+}
+inline int InstrumentLayer::bumpRevision() {
+	return ++m_nRevision;
+}
+inline int InstrumentLayer::getLastChange() const {
+	return m_nLastChange;
 }
 inline bool InstrumentLayer::getIsSoloed() const {
 	return m_bIsSoloed;
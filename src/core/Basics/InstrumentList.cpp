@@ -29,7 +29,10 @@
 #include <core/Helpers/Xml.h>
 #include <core/License.h>
 
+#include <algorithm>
+#include <atomic>
 #include <set>
+#include <thread>
 #include "Midi/Midi.h"
 
 namespace H2Core
@@ -52,16 +55,65 @@ InstrumentList::~InstrumentList()
 {
 }
 
-void InstrumentList::loadSamples( float fBpm )
+void InstrumentList::loadSamples( float fBpm, int nThreads,
+								  std::shared_ptr<InstrumentList> pSkip )
 {
-	for( int i=0; i<m_pInstruments.size(); i++ ) {
-		m_pInstruments[i]->loadSamples( fBpm );
+	// Decoding is done per layer since drumkits often consist of a few
+	// instruments with a lot of layers.
+	std::vector<std::shared_ptr<InstrumentLayer>> layers;
+	for ( const auto& ppInstrument : m_pInstruments ) {
+		if ( ppInstrument == nullptr ||
+			 ( pSkip != nullptr && pSkip->index( ppInstrument ) != -1 ) ) {
+			continue;
+		}
+		for ( const auto& ppComponent : *ppInstrument->getComponents() ) {
+			if ( ppComponent == nullptr ) {
+				continue;
+			}
+			for ( const auto& ppLayer : *ppComponent ) {
+				if ( ppLayer != nullptr && ppLayer->getSample() != nullptr ) {
+					layers.push_back( ppLayer );
+				}
+			}
+		}
+	}
+
+	if ( nThreads <= 0 ) {
+		nThreads = static_cast<int>( std::thread::hardware_concurrency() );
+	}
+	nThreads = std::clamp( nThreads, 1,
+						   std::max( static_cast<int>( layers.size() ), 1 ) );
+
+	// Each worker picks the next layer not loaded yet. Errors are reported
+	// by the individual samples.
+	std::atomic<int> nNextLayer( 0 );
+	auto loadLayers = [&]() {
+		int nLayer;
+		while ( ( nLayer = nNextLayer.fetch_add( 1 ) ) <
+				static_cast<int>( layers.size() ) ) {
+			layers[ nLayer ]->loadSample( fBpm );
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve( nThreads - 1 );
+	for ( int ii = 1; ii < nThreads; ++ii ) {
+		workers.emplace_back( loadLayers );
+	}
+	// The calling thread does its share as well.
+	loadLayers();
+
+	for ( auto& wworker : workers ) {
+		wworker.join();
 	}
 }
 
-void InstrumentList::unloadSamples()
+void InstrumentList::unloadSamples( std::shared_ptr<InstrumentList> pSkip )
 {
 	for( int i=0; i<m_pInstruments.size(); i++ ) {
+		if ( pSkip != nullptr && pSkip->index( m_pInstruments[i] ) != -1 ) {
+			continue;
+		}
 		m_pInstruments[i]->unloadSamples();
 	}
 }
@@ -159,6 +211,7 @@ void InstrumentList::add( std::shared_ptr<Instrument> instrument )
 		if( m_pInstruments[i]==instrument ) return;
 	}
 	m_pInstruments.push_back( instrument );
+	Instrument::bumpAudibilityRevision();
 }
 
 void InstrumentList::insert( int idx, std::shared_ptr<Instrument> instrument )
@@ -168,6 +221,7 @@ void InstrumentList::insert( int idx, std::shared_ptr<Instrument> instrument )
 		if( m_pInstruments[i]==instrument ) return;
 	}
 	m_pInstruments.insert( m_pInstruments.begin() + idx, instrument );
+	Instrument::bumpAudibilityRevision();
 }
 
 std::shared_ptr<Instrument> InstrumentList::operator[]( int idx ) const
@@ -251,6 +305,7 @@ std::shared_ptr<Instrument> InstrumentList::del( std::shared_ptr<Instrument> ins
 	for( int i=0; i<m_pInstruments.size(); i++ ) {
 		if( m_pInstruments[i]==instrument ) {
 			m_pInstruments.erase( m_pInstruments.begin() + i );
+			Instrument::bumpAudibilityRevision();
 			return instrument;
 		}
 	}
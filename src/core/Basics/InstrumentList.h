@@ -151,14 +151,24 @@ class InstrumentList : public H2Core::Object<InstrumentList>
 		 */
 		void move( int idx_a, int idx_b );
 
-		/** Calls the Instrument::loadSamples() member
-		 * function of all Instruments in #m_pInstruments.
+		/** Loads the samples of all layers of all Instruments in
+		 * #m_pInstruments.
+		 *
+		 * \param fBpm Tempo used for Rubber Band.
+		 * \param nThreads Number of threads decoding the samples
+		 *   concurrently. If 0, one per CPU core will be used. Never more
+		 *   threads than layers are created.
+		 * \param pSkip Instruments also contained in this list are not
+		 *   loaded. Used for instruments still rendered by the audio engine,
+		 *   since loading replaces their sample data.
 		 */
-		void loadSamples( float fBpm = 120 );
+		void loadSamples( float fBpm = 120, int nThreads = 0,
+						  std::shared_ptr<InstrumentList> pSkip = nullptr );
 		/** Calls the Instrument::unloadSamples() member
-		 * function of all Instruments in #m_pInstruments.
+		 * function of all Instruments in #m_pInstruments not contained in
+		 * @a pSkip.
 		 */
-		void unloadSamples();
+		void unloadSamples( std::shared_ptr<InstrumentList> pSkip = nullptr );
 		/**
 		 * save the instrument list within the given XMLNode
 		 *
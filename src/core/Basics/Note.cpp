@@ -22,6 +22,7 @@
 
 #include <core/Basics/Note.h>
 
+#include <array>
 #include <cassert>
 #include "Midi/Midi.h"
 
@@ -133,6 +134,7 @@ Note::Note(
 	  m_nNoteStart( 0 ),
 	  m_fUsedTickSize( std::nan( "" ) ),
 	  m_fPitchHumanization( 0 ),
+	  m_bPreallocated( false ),
 	  m_nMidiNoteOnSentFrame( -1 ),
 	  m_nMidiNoteOffOffsetFrame( -1 ),
 	  m_midiNoteOffTimePoint( Clock::now() ),
@@ -168,6 +170,7 @@ Note::Note( std::shared_ptr<Note> pOther )
 	  m_nNoteStart( pOther->getNoteStart() ),
 	  m_fUsedTickSize( pOther->getUsedTickSize() ),
 	  m_fPitchHumanization( pOther->m_fPitchHumanization ),
+	  m_bPreallocated( false ),
 	  m_nMidiNoteOnSentFrame( pOther->m_nMidiNoteOnSentFrame ),
 	  m_nMidiNoteOffOffsetFrame( pOther->m_nMidiNoteOffOffsetFrame ),
 	  m_midiNoteOffTimePoint( pOther->m_midiNoteOffTimePoint ),
@@ -177,34 +180,243 @@ Note::Note( std::shared_ptr<Note> pOther )
 		m_pAdsr = m_pInstrument->copyAdsr();
 		m_instrumentId = m_pInstrument->getId();
 
-		for ( const auto& [ppOtherComponent, ppOtherSelectedLayerInfo] :
-			  pOther->m_selectedLayerInfoMap ) {
-			if ( ppOtherComponent != nullptr &&
-				 ppOtherSelectedLayerInfo != nullptr ) {
-				// We took a deep copy of the instrument and have to ensure we
-				// point to the right component.
-				auto pComponent = m_pInstrument->getComponent(
-					pOther->m_pInstrument->index( ppOtherComponent )
-				);
-				if ( pComponent == nullptr ) {
-					continue;
-				}
+		copySelectedLayerInfos( pOther );
+	}
+}
+
+Note::~Note()
+{
+}
+
+void Note::copyFrom( std::shared_ptr<Note> pOther )
+{
+	if ( pOther == nullptr ) {
+		ERRORLOG( "Invalid note" );
+		return;
+	}
+
+	m_instrumentId = pOther->getInstrumentId();
+	m_sType = pOther->getType();
+	m_nPosition = pOther->getPosition();
+	m_fVelocity = pOther->getVelocity();
+	m_fPan = pOther->getPan();
+	m_nLength = pOther->getLength();
+	m_key = pOther->getKey();
+	m_octave = pOther->getOctave();
+	m_fLeadLag = pOther->getLeadLag();
+	m_nHumanizeDelay = pOther->getHumanizeDelay();
+	m_fBpfbL = pOther->m_fBpfbL;
+	m_fBpfbR = pOther->m_fBpfbR;
+	m_fLpfbL = pOther->m_fLpfbL;
+	m_fLpfbR = pOther->m_fLpfbR;
+	m_bNoteOff = pOther->getNoteOff();
+	m_fProbability = pOther->getProbability();
+	m_nNoteStart = pOther->getNoteStart();
+	m_fUsedTickSize = pOther->getUsedTickSize();
+	m_fPitchHumanization = pOther->m_fPitchHumanization;
+	m_nMidiNoteOnSentFrame = pOther->m_nMidiNoteOnSentFrame;
+	m_nMidiNoteOffOffsetFrame = pOther->m_nMidiNoteOffOffsetFrame;
+	m_midiNoteOffTimePoint = pOther->m_midiNoteOffTimePoint;
+
+	recycleInstrument( pOther->getInstrument() );
+
+	if ( m_pInstrument != nullptr ) {
+		m_instrumentId = m_pInstrument->getId();
+
+		if ( pOther->m_selectedLayerInfoMap.size() > 0 ) {
+			releaseLayerInfos();
+			copySelectedLayerInfos( pOther );
+		}
+	}
+}
+
+void Note::reset(
+	std::shared_ptr<Instrument> pInstrument,
+	int nPosition,
+	float fVelocity,
+	float fPan,
+	int nLength
+)
+{
+	m_instrumentId = Instrument::EmptyId;
+	m_sType.clear();
+	m_nPosition = nPosition;
+	m_fVelocity = fVelocity;
+	m_nLength = nLength;
+	m_key = Note::KeyDefault;
+	m_octave = Note::OctaveDefault;
+	m_fLeadLag = LEAD_LAG_DEFAULT;
+	m_nHumanizeDelay = 0;
+	m_fBpfbL = 0.0;
+	m_fBpfbR = 0.0;
+	m_fLpfbL = 0.0;
+	m_fLpfbR = 0.0;
+	m_bNoteOff = false;
+	m_fProbability = PROBABILITY_DEFAULT;
+	m_nNoteStart = 0;
+	m_fUsedTickSize = std::nan( "" );
+	m_fPitchHumanization = 0;
+	m_nMidiNoteOnSentFrame = -1;
+	m_nMidiNoteOffOffsetFrame = -1;
+	m_midiNoteOffTimePoint = Clock::now();
+
+	recycleInstrument( pInstrument );
+
+	if ( pInstrument != nullptr ) {
+		m_instrumentId = pInstrument->getId();
+		m_sType = pInstrument->getType();
+	}
+
+	setPan( fPan );	 // this checks the boundaries
+}
+
+void Note::preallocate( int nComponents )
+{
+	if ( m_pAdsr == nullptr ) {
+		m_pAdsr = std::make_shared<ADSR>();
+	}
+
+	const int nAvailable = static_cast<int>(
+		m_selectedLayerInfoMap.size() + m_spareLayerInfos.size() );
+	m_spareLayerInfos.reserve( std::max( nComponents, nAvailable ) );
+
+	// Map nodes can only be created by a map. We use a temporary one and
+	// extract its nodes (including their layer info) right away.
+	decltype( m_selectedLayerInfoMap ) tmp;
+	for ( int ii = nAvailable; ii < nComponents; ++ii ) {
+		tmp.emplace( nullptr, std::make_shared<SelectedLayerInfo>() );
+		m_spareLayerInfos.push_back( tmp.extract( tmp.begin() ) );
+	}
+
+	m_bPreallocated = true;
+}
+
+void Note::releaseLayerInfos()
+{
+	if ( ! m_bPreallocated ) {
+		m_selectedLayerInfoMap.clear();
+		return;
+	}
+
+	while ( ! m_selectedLayerInfoMap.empty() ) {
+		auto node = m_selectedLayerInfoMap.extract(
+			m_selectedLayerInfoMap.begin() );
+		if ( node.mapped() == nullptr ) {
+			continue;
+		}
+		// Do not keep the component (and thus its samples) alive.
+		node.key() = nullptr;
+		m_spareLayerInfos.push_back( std::move( node ) );
+	}
+}
 
-				auto pSelectedLayerInfo = std::make_shared<SelectedLayerInfo>();
-				pSelectedLayerInfo->pLayer = ppOtherSelectedLayerInfo->pLayer;
-				pSelectedLayerInfo->fSamplePosition =
-					ppOtherSelectedLayerInfo->fSamplePosition;
-				pSelectedLayerInfo->nNoteLength =
-					ppOtherSelectedLayerInfo->nNoteLength;
+std::shared_ptr<SelectedLayerInfo> Note::addLayerInfo(
+	std::shared_ptr<InstrumentComponent> pComponent )
+{
+	if ( m_bPreallocated ) {
+		if ( m_spareLayerInfos.empty() ) {
+			// All preallocated layer infos are in use. The component will
+			// not be rendered.
+			return nullptr;
+		}
 
-				setSelectedLayerInfo( pSelectedLayerInfo, pComponent );
+		auto node = std::move( m_spareLayerInfos.back() );
+		m_spareLayerInfos.pop_back();
+		node.key() = pComponent;
+
+		auto pSelectedLayerInfo = node.mapped();
+		pSelectedLayerInfo->pLayer = nullptr;
+		pSelectedLayerInfo->fSamplePosition = 0;
+		pSelectedLayerInfo->nNoteLength = LENGTH_ENTIRE_SAMPLE;
+
+		auto result = m_selectedLayerInfoMap.insert( std::move( node ) );
+		if ( ! result.inserted ) {
+			// Entry already present.
+			m_spareLayerInfos.push_back( std::move( result.node ) );
+			return result.position->second;
+		}
+
+		return pSelectedLayerInfo;
+	}
+
+	auto pSelectedLayerInfo = std::make_shared<SelectedLayerInfo>();
+	m_selectedLayerInfoMap[pComponent] = pSelectedLayerInfo;
+	return pSelectedLayerInfo;
+}
+
+void Note::copySelectedLayerInfos( std::shared_ptr<Note> pOther )
+{
+	for ( const auto& [ppOtherComponent, ppOtherSelectedLayerInfo] :
+		  pOther->m_selectedLayerInfoMap ) {
+		if ( ppOtherComponent != nullptr &&
+			 ppOtherSelectedLayerInfo != nullptr ) {
+			// We took a deep copy of the instrument and have to ensure we
+			// point to the right component.
+			auto pComponent = m_pInstrument->getComponent(
+				pOther->m_pInstrument->index( ppOtherComponent )
+			);
+			if ( pComponent == nullptr ) {
+				continue;
+			}
+
+			auto pSelectedLayerInfo = addLayerInfo( pComponent );
+			if ( pSelectedLayerInfo == nullptr ) {
+				continue;
 			}
+			pSelectedLayerInfo->pLayer = ppOtherSelectedLayerInfo->pLayer;
+			pSelectedLayerInfo->fSamplePosition =
+				ppOtherSelectedLayerInfo->fSamplePosition;
+			pSelectedLayerInfo->nNoteLength =
+				ppOtherSelectedLayerInfo->nNoteLength;
 		}
 	}
 }
 
-Note::~Note()
+void Note::recycleInstrument( std::shared_ptr<Instrument> pInstrument )
 {
+	if ( pInstrument == nullptr ) {
+		m_pInstrument = nullptr;
+		if ( ! m_bPreallocated ) {
+			m_pAdsr = nullptr;
+		}
+		releaseLayerInfos();
+		return;
+	}
+
+	if ( m_pAdsr != nullptr ) {
+		m_pAdsr->copyFrom( pInstrument->getAdsr() );
+	}
+	else {
+		m_pAdsr = pInstrument->copyAdsr();
+	}
+
+	// In case the layer infos still cover exactly the components of the
+	// instrument, we reset and keep them. selectLayers() will fill them
+	// again without having to allocate new ones.
+	bool bKeepLayerInfos = pInstrument == m_pInstrument &&
+		m_selectedLayerInfoMap.size() == pInstrument->getComponents()->size();
+	if ( bKeepLayerInfos ) {
+		for ( const auto& ppComponent : *pInstrument->getComponents() ) {
+			const auto it = m_selectedLayerInfoMap.find( ppComponent );
+			if ( it == m_selectedLayerInfoMap.end() || it->second == nullptr ) {
+				bKeepLayerInfos = false;
+				break;
+			}
+		}
+	}
+
+	if ( bKeepLayerInfos ) {
+		for ( auto& [_, ppSelectedLayerInfo] : m_selectedLayerInfoMap ) {
+			ppSelectedLayerInfo->pLayer = nullptr;
+			ppSelectedLayerInfo->fSamplePosition = 0;
+			ppSelectedLayerInfo->nNoteLength = LENGTH_ENTIRE_SAMPLE;
+		}
+	}
+	else {
+		releaseLayerInfos();
+	}
+
+	m_pInstrument = pInstrument;
 }
 
 Note::Pitch Note::toPitch() const
@@ -298,178 +510,19 @@ bool Note::layersAlreadySelected() const
 	return false;
 }
 
-void Note::selectLayers( const std::map<
-						 std::shared_ptr<InstrumentComponent>,
-						 std::shared_ptr<InstrumentLayer> >& lastUsedLayers )
+void Note::selectLayers( Random& random )
 {
-	std::shared_ptr<Sample> pSample;
-
 	if ( m_pInstrument == nullptr ) {
 		ERRORLOG( "Sample does not hold an instrument" );
 		return;
 	}
 
-	auto selectLayer = [=]( std::shared_ptr<InstrumentComponent> pComponent ) {
-		// Aggregate all layers covering the velocity of this note.
-		std::vector<std::shared_ptr<InstrumentLayer> > possibleLayersVector;
-		int nLayersEncountered = 0;
-		const bool bLayersSoloed = pComponent->isAnyLayerSoloed();
-		auto pSong = Hydrogen::get_instance()->getSong();
-
-		for ( const auto& ppLayer : pComponent->getLayers() ) {
-			if ( ppLayer == nullptr || ppLayer->getIsMuted() ||
-				 ( bLayersSoloed && !ppLayer->getIsSoloed() ) ) {
-				continue;
-			}
-			++nLayersEncountered;
-
-			if ( m_fVelocity >= ppLayer->getStartVelocity() &&
-				 m_fVelocity <= ppLayer->getEndVelocity() ) {
-				possibleLayersVector.push_back( ppLayer );
-				if ( pComponent->getSelection() ==
-					 InstrumentComponent::Selection::Velocity ) {
-					// In case of "First in velocity", we select the first layer
-					// encountered. The order in
-					// InstrumentComponent::getLayers() corresponds to the order
-					// shown in the ComponentView.
-					return ppLayer;
-				}
-			}
-		}
-
-		if ( nLayersEncountered == 0 ) {
-			// Not returning `nullptr` directly because the return type
-			// detection of the lambda functions fails.
-			std::shared_ptr<InstrumentLayer> pNoLayer = nullptr;
-			return pNoLayer;
-		}
-
-		// In some instruments the start and end velocities of a layer
-		// are not set perfectly giving rise to some 'holes'.
-		// Occasionally the velocity of a note can fall into it
-		// causing the sampler to just skip it. Instead, we will
-		// search for the nearest sample and play this one instead.
-		if ( possibleLayersVector.size() == 0 ) {
-			WARNINGLOG(
-				QString(
-					"Velocity [%1] did fall into a hole between the instrument "
-					"layers for component [%2] of instrument [%3]."
-				)
-					.arg( m_fVelocity )
-					.arg( pComponent->getName() )
-					.arg( m_pInstrument->getName() )
-			);
-
-			float fShortestDistance = 1.0f;
-			std::shared_ptr<InstrumentLayer> pNearestLayer = nullptr;
-			for ( const auto& ppLayer : pComponent->getLayers() ) {
-				if ( ppLayer == nullptr || ppLayer->getIsMuted() ||
-					 ( bLayersSoloed && !ppLayer->getIsSoloed() ) ) {
-					continue;
-				}
-
-				if ( std::min(
-						 abs( ppLayer->getStartVelocity() - m_fVelocity ),
-						 abs( ppLayer->getStartVelocity() - m_fVelocity )
-					 ) < fShortestDistance ) {
-					fShortestDistance = std::min(
-						abs( ppLayer->getStartVelocity() - m_fVelocity ),
-						abs( ppLayer->getStartVelocity() - m_fVelocity )
-					);
-					pNearestLayer = ppLayer;
-				}
-			}
-
-			// Check whether the search was successful and assign the results.
-			if ( pNearestLayer != nullptr ) {
-				possibleLayersVector.push_back( pNearestLayer );
-			}
-			else {
-				ERRORLOG(
-					QString(
-						"No sample found for component [%1] of instrument [%2]"
-					)
-						.arg( pComponent->getName() )
-						.arg( m_pInstrument->getName() )
-				);
-				std::shared_ptr<InstrumentLayer> pNoLayer = nullptr;
-				return pNoLayer;
-			}
-		}
-
-		// Select a layer.
-		if ( possibleLayersVector.size() == 0 ) {
-			ERRORLOG(
-				"No samples found during random layer selection. This is a bug "
-				"and shouldn't happen!"
-			);
-			std::shared_ptr<InstrumentLayer> pNoLayer = nullptr;
-			return pNoLayer;
-		}
-
-		std::shared_ptr<InstrumentLayer> pSelectedLayer = nullptr;
-		switch ( pComponent->getSelection() ) {
-			case InstrumentComponent::Selection::Velocity:
-				pSelectedLayer = possibleLayersVector[0];
-				break;
-
-			case InstrumentComponent::Selection::Random:
-				pSelectedLayer =
-					possibleLayersVector[rand() % possibleLayersVector.size()];
-				break;
-
-			case InstrumentComponent::Selection::RoundRobin:
-				// We check whether there was already a layer for this
-				// component. If so, we use the next one.
-				if ( lastUsedLayers.find( pComponent ) !=
-					 lastUsedLayers.end() ) {
-					auto pLastLayer = lastUsedLayers.at( pComponent );
-					if ( pLastLayer != nullptr ) {
-						// Is the last layer among the possible ones?
-						int nNextLayerIndex = -1;
-						for ( int ii = 0; ii < possibleLayersVector.size();
-							  ++ii ) {
-							if ( pLastLayer == possibleLayersVector[ii] ) {
-								// Found. We select the next layer.
-								nNextLayerIndex = ii + 1;
-								break;
-							}
-						}
-
-						if ( nNextLayerIndex >= 0 &&
-							 nNextLayerIndex < possibleLayersVector.size() ) {
-							pSelectedLayer =
-								possibleLayersVector[nNextLayerIndex];
-						}
-						else if ( nNextLayerIndex ==
-								  possibleLayersVector.size() ) {
-							// We use periodic boundary conditions and start
-							// over with the first layer.
-							pSelectedLayer = possibleLayersVector[0];
-						}
-					}
-				}
-
-				if ( pSelectedLayer == nullptr ) {
-					// Cache miss. We start again at the top.
-					pSelectedLayer = possibleLayersVector[0];
-				}
-				break;
-
-			default:
-				ERRORLOG(
-					QString(
-						"Unknown selection algorithm [%1] for instrument [%2]"
-					)
-						.arg( InstrumentComponent::SelectionToQString(
-							pComponent->getSelection()
-						) )
-						.arg( m_pInstrument->getName() )
-				);
-				break;
+	auto selectLayer = [&]( std::shared_ptr<InstrumentComponent> pComponent ) {
+		std::shared_ptr<InstrumentLayer> pLayer = nullptr;
+		if ( pComponent != nullptr ) {
+			pLayer = pComponent->selectLayer( m_fVelocity, random );
 		}
-
-		return pSelectedLayer;
+		return pLayer;
 	};
 
 	if ( m_selectedLayerInfoMap.size() > 0 ) {
@@ -481,21 +534,31 @@ void Note::selectLayers( const std::map<
 				continue;
 			}
 
-			if ( ppSelectedLayerInfo == nullptr ||
-				 ppSelectedLayerInfo->pLayer == nullptr ) {
+			if ( ppSelectedLayerInfo == nullptr ) {
+				if ( m_bPreallocated ) {
+					// Not allowed to allocate. The component is skipped.
+					continue;
+				}
 				auto pNewSelectedLayerInfo =
 					std::make_shared<SelectedLayerInfo>();
 				pNewSelectedLayerInfo->pLayer = selectLayer( ppComponent );
 				m_selectedLayerInfoMap[ppComponent] = pNewSelectedLayerInfo;
 			}
+			else if ( ppSelectedLayerInfo->pLayer == nullptr ) {
+				// Reuse the existing object (e.g. of a recycled note).
+				ppSelectedLayerInfo->pLayer = selectLayer( ppComponent );
+				ppSelectedLayerInfo->fSamplePosition = 0;
+				ppSelectedLayerInfo->nNoteLength = LENGTH_ENTIRE_SAMPLE;
+			}
 		}
 	}
 	else {
 		// Select layers for all components
 		for ( const auto& ppComponent : *m_pInstrument->getComponents() ) {
-			auto pNewSelectedLayerInfo = std::make_shared<SelectedLayerInfo>();
-			pNewSelectedLayerInfo->pLayer = selectLayer( ppComponent );
-			m_selectedLayerInfoMap[ppComponent] = pNewSelectedLayerInfo;
+			auto pNewSelectedLayerInfo = addLayerInfo( ppComponent );
+			if ( pNewSelectedLayerInfo != nullptr ) {
+				pNewSelectedLayerInfo->pLayer = selectLayer( ppComponent );
+			}
 		}
 	}
 }
@@ -537,11 +600,18 @@ void Note::mapToInstrument( std::shared_ptr<Instrument> pInstrument )
 		// The instrument ID will be kept to avoid any loss of information.
 	}
 
-	m_selectedLayerInfoMap.clear();
+	releaseLayerInfos();
 }
 
-void Note::humanize()
+void Note::humanize( Random& random )
 {
+	// All contributions are drawn in a single batch of unit variance -
+	// regardless of whether they are used - and scaled afterwards. This
+	// keeps the number of values consumed per note constant. Two full
+	// Box-Muller pairs are requested in order to avoid the scalar tail.
+	std::array<float, 4> gaussians;
+	random.fillGaussian( gaussians.data(), gaussians.size(), 1.0 );
+
 	// Due to the nature of the Gaussian distribution, the factors
 	// will also scale the standard deviations of the generated random
 	// variables.
@@ -551,8 +621,8 @@ void Note::humanize()
 		if ( fRandomVelocityFactor != 0 ) {
 			setVelocity(
 				m_fVelocity +
-				fRandomVelocityFactor *
-					Random::getGaussian( AudioEngine::fHumanizeVelocitySD )
+				fRandomVelocityFactor * AudioEngine::fHumanizeVelocitySD *
+					gaussians[ 0 ]
 			);
 		}
 
@@ -561,7 +631,7 @@ void Note::humanize()
 			setHumanizeDelay(
 				m_nHumanizeDelay +
 				fRandomTimeFactor * AudioEngine::nMaxTimeHumanize *
-					Random::getGaussian( AudioEngine::fHumanizeTimingSD )
+					AudioEngine::fHumanizeTimingSD * gaussians[ 1 ]
 			);
 		}
 	}
@@ -569,9 +639,8 @@ void Note::humanize()
 	if ( m_pInstrument != nullptr ) {
 		const float fRandomPitchFactor = m_pInstrument->getRandomPitchFactor();
 		if ( fRandomPitchFactor != 0 ) {
-			m_fPitchHumanization =
-				Random::getGaussian( AudioEngine::fHumanizePitchSD ) *
-				fRandomPitchFactor;
+			m_fPitchHumanization = AudioEngine::fHumanizePitchSD *
+				gaussians[ 2 ] * fRandomPitchFactor;
 		}
 	}
 }
@@ -662,8 +731,106 @@ std::shared_ptr<Note> Note::loadFrom( const XMLNode& node, bool bSilent )
 	pNote->setLeadLag(
 		node.read_float( "leadlag", pNote->getLeadLag(), false, false, bSilent )
 	);
-	const QString sKeyOctave =
-		node.read_string( "key", "C0", false, false, bSilent );
+	pNote->loadKeyOctave(
+		node.read_string( "key", "C0", false, false, bSilent ), fPitch );
+	pNote->setNoteOff(
+		node.read_bool( "note_off", pNote->getNoteOff(), false, false, bSilent )
+	);
+	pNote->setInstrumentId( static_cast<Instrument::Id>( node.read_int(
+		"instrument", static_cast<int>( pNote->getInstrumentId() ), false,
+		false, bSilent
+	) ) );
+	pNote->setType(
+		node.read_string( "type", pNote->getType(), true, true, bSilent )
+	);
+	pNote->setProbability( node.read_float(
+		"probability", pNote->getProbability(), false, false, bSilent
+	) );
+
+	return pNote;
+}
+
+std::shared_ptr<Note> Note::loadFrom( XMLStreamReader& reader, bool bSilent )
+{
+	auto pNote = std::make_shared<Note>();
+
+	bool bFound = false, bFoundL = false, bFoundR = false;
+	float fPan = pNote->getPan();
+	float fPanL = 1.f;
+	float fPanR = 1.f;
+	float fPitch = pNote->m_fPitchHumanization;
+	QString sKeyOctave( "C0" );
+
+	// All child elements are visited exactly once in the order they were
+	// written.
+	while ( reader.readNextStartElement() ) {
+		const auto name = reader.name();
+		if ( name == QLatin1String( "position" ) ) {
+			pNote->setPosition( reader.read_int( pNote->getPosition() ) );
+		}
+		else if ( name == QLatin1String( "leadlag" ) ) {
+			pNote->setLeadLag( reader.read_float( pNote->getLeadLag() ) );
+		}
+		else if ( name == QLatin1String( "velocity" ) ) {
+			pNote->setVelocity( reader.read_float( pNote->getVelocity() ) );
+		}
+		else if ( name == QLatin1String( "pan" ) ) {
+			fPan = reader.read_float( fPan, &bFound );
+		}
+		else if ( name == QLatin1String( "pan_L" ) ) {
+			fPanL = reader.read_float( fPanL, &bFoundL );
+		}
+		else if ( name == QLatin1String( "pan_R" ) ) {
+			fPanR = reader.read_float( fPanR, &bFoundR );
+		}
+		else if ( name == QLatin1String( "pitch" ) ) {
+			fPitch = reader.read_float( fPitch );
+		}
+		else if ( name == QLatin1String( "key" ) ) {
+			sKeyOctave = reader.read_string( sKeyOctave );
+		}
+		else if ( name == QLatin1String( "length" ) ) {
+			pNote->setLength( reader.read_int( pNote->getLength() ) );
+		}
+		else if ( name == QLatin1String( "instrument" ) ) {
+			pNote->setInstrumentId( static_cast<Instrument::Id>( reader.read_int(
+				static_cast<int>( pNote->getInstrumentId() ) ) ) );
+		}
+		else if ( name == QLatin1String( "type" ) ) {
+			pNote->setType( reader.read_string( pNote->getType() ) );
+		}
+		else if ( name == QLatin1String( "note_off" ) ) {
+			pNote->setNoteOff( reader.read_bool( pNote->getNoteOff() ) );
+		}
+		else if ( name == QLatin1String( "probability" ) ) {
+			pNote->setProbability(
+				reader.read_float( pNote->getProbability() ) );
+		}
+		else {
+			reader.skipCurrentElement();
+		}
+	}
+
+	if ( ! bFound ) {
+		// Old fashioned pan (version <= 1.1)
+		if ( bFoundL && bFoundR ) {
+			fPan = Sampler::getRatioPan( fPanL, fPanR );
+		}
+		else if ( ! bSilent ) {
+			WARNINGLOG(
+				QString( "Neither `pan` nor `pan_L` and `pan_R` were found. "
+						 "Falling back to `pan = 0`" )
+			);
+		}
+	}
+	pNote->setPan( fPan );
+	pNote->loadKeyOctave( sKeyOctave, fPitch );
+
+	return pNote;
+}
+
+void Note::loadKeyOctave( const QString& sKeyOctave, float fPitch )
+{
 	const int nKeyOctaveLength = sKeyOctave.length();
 	QString sKey = sKeyOctave.left( nKeyOctaveLength - 1 );
 	QString sOctave = sKeyOctave.mid( nKeyOctaveLength - 1, nKeyOctaveLength );
@@ -694,23 +861,8 @@ std::shared_ptr<Note> Note::loadFrom( const XMLNode& node, bool bSilent )
 		key = totalPitch.toKey();
         octave = totalPitch.toOctave();
 	}
-	pNote->setKey( key );
-	pNote->setOctave( octave );
-	pNote->setNoteOff(
-		node.read_bool( "note_off", pNote->getNoteOff(), false, false, bSilent )
-	);
-	pNote->setInstrumentId( static_cast<Instrument::Id>( node.read_int(
-		"instrument", static_cast<int>( pNote->getInstrumentId() ), false,
-		false, bSilent
-	) ) );
-	pNote->setType(
-		node.read_string( "type", pNote->getType(), true, true, bSilent )
-	);
-	pNote->setProbability( node.read_float(
-		"probability", pNote->getProbability(), false, false, bSilent
-	) );
-
-	return pNote;
+	setKey( key );
+	setOctave( octave );
 }
 
 QString Note::prettyName() const
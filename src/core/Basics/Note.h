@@ -25,6 +25,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <core/Basics/DrumkitMap.h>
 #include <core/Basics/Instrument.h>
@@ -53,9 +54,11 @@
 namespace H2Core {
 
 class XMLNode;
+class XMLStreamReader;
 class ADSR;
 class InstrumentLayer;
 class InstrumentList;
+class Random;
 
 /** Auxiliary variables storing the rendering state of a #H2Core::Note within
  * the #H2Core::Sampler */
@@ -340,6 +343,27 @@ class Note : public H2Core::Object<Note> {
 	Note( std::shared_ptr<Note> pOther );
 	~Note();
 
+	/** Assigns all properties of @a pOther to this note - just like the
+	 * copy constructor does - but reuses the #ADSR and #SelectedLayerInfo
+	 * instances already owned by this note. This way notes can be recycled
+	 * by the #NotePool without allocating memory in the audio thread. */
+	void copyFrom( std::shared_ptr<Note> pOther );
+	/** Counterpart of copyFrom() for the regular constructor. */
+	void reset(
+		std::shared_ptr<Instrument> pInstrument,
+		int nPosition = 0,
+		float fVelocity = VELOCITY_DEFAULT,
+		float fPan = PAN_DEFAULT,
+		int nLength = LENGTH_ENTIRE_SAMPLE
+	);
+	/** Allocates the #ADSR and the #SelectedLayerInfo of up to
+	 * @a nComponents components upfront.
+	 *
+	 * Afterwards, copyFrom(), reset(), and selectLayers() do not allocate
+	 * memory anymore. Components of instruments exceeding @a nComponents
+	 * will not be rendered instead. Used by the #NotePool. */
+	void preallocate( int nComponents );
+
 	Note::Pitch toPitch() const;
 
 	/*
@@ -356,6 +380,16 @@ class Note : public H2Core::Object<Note> {
 	 */
 	static std::shared_ptr<Note>
 	loadFrom( const XMLNode& node, bool bSilent = false );
+	/**
+	 * load a note in a single pass over its child elements
+	 * \param reader positioned at the StartElement token of the note. It
+	 *   will be moved past the corresponding EndElement.
+	 * \param bSilent Whether infos, warnings, and errors should
+	 * be logged.
+	 * \return a new Note instance
+	 */
+	static std::shared_ptr<Note>
+	loadFrom( XMLStreamReader& reader, bool bSilent = false );
 
 	/** #m_pInstrument accessor */
 	std::shared_ptr<Instrument> getInstrument() const;
@@ -424,18 +458,15 @@ class Note : public H2Core::Object<Note> {
 	bool layersAlreadySelected() const;
 
 	/** Picks one #H2Core::InstrumentLayer for each
-	 * #H2Core::InstrumentComponent in #m_pInstrument according to
-	 * #H2Core::InstrumentComponent::m_selection.
+	 * #H2Core::InstrumentComponent in #m_pInstrument using
+	 * InstrumentComponent::selectLayer().
 	 *
-	 * In order to allow for a consistent round robin selection, the layers
-	 * used last for all encountered components is provided. */
-	void selectLayers( const std::map<
-					   std::shared_ptr<InstrumentComponent>,
-					   std::shared_ptr<InstrumentLayer> >& lastUsedLayers );
+	 * \param random Generator used for random layer selection. */
+	void selectLayers( Random& random );
 
-	std::map<
+	const std::map<
 		std::shared_ptr<InstrumentComponent>,
-		std::shared_ptr<SelectedLayerInfo> >
+		std::shared_ptr<SelectedLayerInfo> >&
 	getAllSelectedLayerInfos() const;
 	/** Returns the #H2Core::InstrumentLayer and some additional rendering
 	 * meta data for a given component. If no selection took place yet,
@@ -581,12 +612,19 @@ class Note : public H2Core::Object<Note> {
 	 * needs to be rerun.
 	 */
 	void computeNoteStart();
+	/**
+	 * Sets #m_nNoteStart directly. Used for notes played live which are
+	 * not associated with a tick position.
+	 */
+	void setNoteStart( long long nNoteStart );
 
 	/**
 	 * Add random contributions to #m_fPitchHumanization, #m_nHumanizeDelay, and
 	 * #m_fVelocity.
+	 *
+	 * \param random Generator the random contributions are drawn from.
 	 */
-	void humanize();
+	void humanize( Random& random );
 
 	/**
 	 * Add swing contribution to #m_nHumanizeDelay.
@@ -615,6 +653,28 @@ class Note : public H2Core::Object<Note> {
 		const override;
 
    private:
+	/** Deep copies the layer selection of @a pOther. The components are
+	 * looked up by index in #m_pInstrument. */
+	void copySelectedLayerInfos( std::shared_ptr<Note> pOther );
+	/** Sets #m_pInstrument and refreshes #m_pAdsr as well as
+	 * #m_selectedLayerInfoMap while reusing existing objects whenever
+	 * possible. */
+	void recycleInstrument( std::shared_ptr<Instrument> pInstrument );
+	/** Moves all entries of #m_selectedLayerInfoMap into
+	 * #m_spareLayerInfos (or discards them in case the note was not
+	 * preallocated). */
+	void releaseLayerInfos();
+	/** Adds an entry for @a pComponent to #m_selectedLayerInfoMap. Spare
+	 * layer infos are reused. New ones are only allocated in case the note
+	 * was not preallocated.
+	 *
+	 * \return `nullptr` in case no layer info could be provided. */
+	std::shared_ptr<SelectedLayerInfo> addLayerInfo(
+		std::shared_ptr<InstrumentComponent> pComponent );
+	/** Sets #m_key and #m_octave from their serialized form (e.g. "C0")
+	 * and the legacy pitch offset @a fPitch. */
+	void loadKeyOctave( const QString& sKeyOctave, float fPitch );
+
 	/** The ID of the instrument the note will be mapped to in case a
 	 * drumkit with no or incomplete types is used (e.g. a new or legacy
 	 * kit).
@@ -696,6 +756,13 @@ class Note : public H2Core::Object<Note> {
 		std::shared_ptr<InstrumentComponent>,
 		std::shared_ptr<SelectedLayerInfo> >
 		m_selectedLayerInfoMap;
+	/** Entries of #m_selectedLayerInfoMap not used by the current
+	 * instrument. Map nodes can be moved in and out of the map without
+	 * allocating memory. */
+	std::vector<decltype( m_selectedLayerInfoMap )::node_type>
+		m_spareLayerInfos;
+	/** Whether preallocate() was called. */
+	bool m_bPreallocated;
 
 	/** Transient member not written to file. Indicates whether - `-1` if not -
 	 * and when a `Note-On` MIDI message was sent for this note within the
@@ -797,9 +864,9 @@ inline bool Note::getNoteOff() const
 	return m_bNoteOff;
 }
 
-inline std::map<
+inline const std::map<
 	std::shared_ptr<InstrumentComponent>,
-	std::shared_ptr<SelectedLayerInfo> >
+	std::shared_ptr<SelectedLayerInfo> >&
 Note::getAllSelectedLayerInfos() const
 {
 	return m_selectedLayerInfoMap;
@@ -988,6 +1055,10 @@ inline long long Note::getNoteStart() const
 {
 	return m_nNoteStart;
 }
+inline void Note::setNoteStart( long long nNoteStart )
+{
+	m_nNoteStart = nNoteStart;
+}
 inline float Note::getUsedTickSize() const
 {
 	return m_fUsedTickSize;
@@ -23,6 +23,7 @@
 #include <core/Basics/Pattern.h>
 
 #include <cassert>
+#include <vector>
 
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/Drumkit.h>
@@ -190,6 +191,119 @@ std::shared_ptr<Pattern> Pattern::loadFrom( const XMLNode& node,
 	return pPattern;
 }
 
+std::shared_ptr<Pattern> Pattern::loadFrom( XMLStreamReader& reader,
+											bool bSilent )
+{
+	auto pPattern = std::make_shared<Pattern>();
+	QString sName, sLegacyName;
+	bool bHasNoteList = false;
+	// Notes of the old format are only used in case no "noteList" element
+	// is present. Since the order of the elements is not fixed, they have
+	// to be kept aside till the end of the pattern is reached.
+	std::vector<std::shared_ptr<Note>> legacyNotes;
+
+	auto loadNotes = [&]( bool bFilter,
+						  std::vector<std::shared_ptr<Note>>* pNotes ) {
+		while ( reader.readNextStartElement() ) {
+			if ( reader.name() != QLatin1String( "note" ) ) {
+				reader.skipCurrentElement();
+				continue;
+			}
+			auto pNote = Note::loadFrom( reader, bSilent );
+			if ( pNote == nullptr ||
+				 ( bFilter && pNote->getInstrumentId() == Instrument::EmptyId &&
+				   pNote->getType().isEmpty() ) ) {
+				continue;
+			}
+			if ( pNotes != nullptr ) {
+				pNotes->push_back( pNote );
+			}
+			else {
+				pPattern->insertNote( pNote );
+			}
+		}
+	};
+
+	while ( reader.readNextStartElement() ) {
+		const auto name = reader.name();
+		if ( name == QLatin1String( "noteList" ) ) {
+			// Only the first one is considered, like in the DOM-based
+			// loader.
+			if ( bHasNoteList ) {
+				reader.skipCurrentElement();
+			}
+			else {
+				bHasNoteList = true;
+				loadNotes( true, nullptr );
+			}
+		}
+		else if ( name == QLatin1String( "name" ) ) {
+			sName = reader.read_string( "" );
+		}
+		else if ( name == QLatin1String( "pattern_name" ) ) {
+			sLegacyName = reader.read_string( "" );
+		}
+		else if ( name == QLatin1String( "info" ) ) {
+			pPattern->setInfo( reader.read_string( pPattern->getInfo() ) );
+		}
+		else if ( name == QLatin1String( "category" ) ) {
+			pPattern->setCategory(
+				reader.read_string( pPattern->getCategory() ) );
+		}
+		else if ( name == QLatin1String( "size" ) ) {
+			pPattern->setLength( reader.read_int( pPattern->getLength() ) );
+		}
+		else if ( name == QLatin1String( "denominator" ) ) {
+			pPattern->setDenominator(
+				reader.read_int( pPattern->getDenominator() ) );
+		}
+		else if ( name == QLatin1String( "userVersion" ) ) {
+			pPattern->m_nVersion = reader.read_int( pPattern->m_nVersion );
+		}
+		else if ( name == QLatin1String( "author" ) ) {
+			pPattern->m_sAuthor = reader.read_string( pPattern->m_sAuthor );
+		}
+		else if ( name == QLatin1String( "license" ) ) {
+			pPattern->setLicense( License( reader.read_string(
+				pPattern->m_license.getLicenseString() ) ) );
+		}
+		else if ( name == QLatin1String( "sequenceList" ) && ! bHasNoteList ) {
+			// Old format < 0.9.4
+			while ( reader.readNextStartElement() ) {
+				if ( reader.name() != QLatin1String( "sequence" ) ) {
+					reader.skipCurrentElement();
+					continue;
+				}
+				while ( reader.readNextStartElement() ) {
+					if ( reader.name() == QLatin1String( "noteList" ) ) {
+						loadNotes( false, &legacyNotes );
+					}
+					else {
+						reader.skipCurrentElement();
+					}
+				}
+			}
+		}
+		else {
+			reader.skipCurrentElement();
+		}
+	}
+
+	if ( ! bHasNoteList ) {
+		for ( const auto& ppNote : legacyNotes ) {
+			pPattern->insertNote( ppNote );
+		}
+	}
+
+	if ( sName.isEmpty() ) {
+		// Fall back to previous version.
+		sName = sLegacyName.isEmpty() ? pPattern->getName() : sLegacyName;
+	}
+	pPattern->setName( sName );
+
+	return pPattern;
+}
+
 bool Pattern::save( const QString& sPatternPath, bool bSilent ) const
 {
 	auto pSong = Hydrogen::get_instance()->getSong();
@@ -38,6 +38,7 @@ namespace H2Core
 
 class Drumkit;
 class XMLNode;
+class XMLStreamReader;
 class InstrumentList;
 class PatternList;
 
@@ -107,6 +108,22 @@ class Pattern : public H2Core::Object<Pattern>
 											  const QString& sDrumkitName,
 											  std::shared_ptr<Drumkit> pDrumkit = nullptr,
 											  bool bSilent = false );
+		/**
+		 * load a pattern in a single pass over its child elements
+		 *
+		 * In contrast to the XMLNode version neither the drumkit name is set
+		 * nor are missing types applied. Within a song the patterns are read
+		 * before its drumkit is available. The caller has to use
+		 * setDrumkitName() and applyMissingTypes() afterwards.
+		 *
+		 * \param reader positioned at the StartElement token of the pattern.
+		 *   It will be moved past the corresponding EndElement.
+		 * \param bSilent Whether infos, warnings, and errors should
+		 *   be logged.
+		 * \return a new Pattern instance
+		 */
+	static std::shared_ptr<Pattern> loadFrom( XMLStreamReader& reader,
+											  bool bSilent = false );
 		/**
 		 * save a pattern into an xml file
 		 * \param sPatternPath the path to save the pattern into
@@ -79,6 +79,33 @@ std::shared_ptr<PatternList> PatternList::loadFrom( const XMLNode& node,
 	return pPatternList;
 }
 
+std::shared_ptr<PatternList> PatternList::loadFrom( XMLStreamReader& reader,
+													bool bSilent ) {
+	auto pPatternList = std::make_shared<PatternList>();
+	int nPatternCount = 0;
+
+	while ( reader.readNextStartElement() ) {
+		if ( reader.name() != QLatin1String( "pattern" ) ) {
+			reader.skipCurrentElement();
+			continue;
+		}
+		nPatternCount++;
+		auto pPattern = Pattern::loadFrom( reader, bSilent );
+		if ( pPattern != nullptr ) {
+			pPatternList->add( pPattern );
+		}
+		else {
+			ERRORLOG( "Error loading pattern" );
+			return nullptr;
+		}
+	}
+	if ( nPatternCount == 0 && ! bSilent ) {
+		WARNINGLOG( "0 patterns?" );
+	}
+
+	return pPatternList;
+}
+
 void PatternList::saveTo(
 	XMLNode& node,
 	Instrument::Id id,
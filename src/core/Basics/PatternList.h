@@ -39,6 +39,7 @@ class Drumkit;
 class InstrumentList;
 class Pattern;
 class XMLNode;
+class XMLStreamReader;
 
 /**
  * PatternList is a collection of patterns
@@ -70,6 +71,18 @@ class XMLNode;
 												  const QString& sDrumkitName,
 												  std::shared_ptr<Drumkit> pDrumkit = nullptr,
 												  bool bSilent = false );
+		/**
+		 * load a #PatternList in a single pass over the elements of a
+		 * `patternList` node (see Pattern::loadFrom( XMLStreamReader&, bool )
+		 * for the steps left to the caller).
+		 * \param reader positioned at the StartElement token of the list.
+		 *   It will be moved past the corresponding EndElement.
+		 * \param bSilent Whether infos, warnings, and errors should
+		 * be logged.
+		 * \return a new PatternList instance
+		 */
+	static std::shared_ptr<PatternList> loadFrom( XMLStreamReader& reader,
+												  bool bSilent = false );
 
 	/** Stores a serialized version of the instance to the XML note @a
 	 * pNote.
@@ -313,19 +313,25 @@ bool Sample::load( float fBpm )
 	}
 	applyVelocity();
 	applyPan();
-#ifdef H2CORE_HAVE_RUBBERBAND
-	applyRubberband( fBpm );
-#else
-	if ( !execRubberbandCli( fBpm ) ) {
+	if ( !stretch( fBpm ) ) {
 		WARNINGLOG( "Unable to apply rubberband" );
 	}
-#endif
 
 	m_bIsLoaded = true;
 
 	return true;
 }
 
+bool Sample::stretch( float fBpm )
+{
+#ifdef H2CORE_HAVE_RUBBERBAND
+	applyRubberband( fBpm );
+	return true;
+#else
+	return execRubberbandCli( fBpm );
+#endif
+}
+
 void Sample::unload()
 {
 	if ( m_data_L != nullptr ) {
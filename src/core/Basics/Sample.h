@@ -236,6 +236,19 @@ class Sample : public H2Core::Object<Sample> {
 	 * \fn load()
 	 */
 	bool load( float fBpm = 120 );
+	/**
+	 * Applies the #m_rubberband transformation to the current content of
+	 * the sample without reading the sample file again.
+	 *
+	 * It is the responsibility of the caller to ensure the current content
+	 * was not stretched before (e.g. by loading a copy of the sample with
+	 * #Rubberband::bUse set to `false`).
+	 *
+	 * \param fBpm tempo the Rubberband transformation will target
+	 *
+	 * \return `false` in case the transformation failed.
+	 */
+	bool stretch( float fBpm );
 	/**
 	 * Flush the current content of the left and right
 	 * channel and the current metadata.
@@ -82,6 +82,7 @@ Song::Song( const QString& sName, const QString& sAuthor, float fBpm, float fVol
 	, m_fHumanizeTimeValue( 0.0 )
 	, m_fHumanizeVelocityValue( 0.0 )
 	, m_fSwingFactor( 0.0 )
+	, m_nRandomSeed( 0 )
 	, m_bIsModified( false )
 	, m_mode( Mode::Pattern )
 	, m_pVelocityAutomationPath( nullptr )
@@ -118,6 +119,7 @@ Song::~Song()
 
 void Song::setDrumkit( std::shared_ptr<Drumkit> pDrumkit ) {
 	m_pDrumkit = pDrumkit;
+	Instrument::bumpAudibilityRevision();
 
 	if ( m_pDrumkit->getContext() != Drumkit::Context::Song ) {
 		m_pDrumkit->setContext( Drumkit::Context::Song );
@@ -193,8 +195,14 @@ std::shared_ptr<Song> Song::load( const QString& sFileName, bool bSilent )
 		INFOLOG( "Reading " + sPath );
 	}
 
+	// The patterns hold the bulk of a song. They are loaded while parsing
+	// the file instead of being stored in the DOM first.
+	std::shared_ptr<PatternList> pPatternList;
 	XMLDoc doc;
-	if ( ! doc.read( sFileName ) && ! bSilent ) {
+	if ( ! doc.read( sFileName, "song/patternList",
+					 [&]( XMLStreamReader& reader ) {
+						 pPatternList = PatternList::loadFrom( reader, bSilent );
+					 }, bSilent ) && ! bSilent ) {
 		ERRORLOG( QString( "Something went wrong while loading song [%1]" )
 				  .arg( sFileName ) );
 	}
@@ -216,7 +224,7 @@ std::shared_ptr<Song> Song::load( const QString& sFileName, bool bSilent )
 		}
 	}
 
-	auto pSong = Song::loadFrom( songNode, sFileName, bSilent );
+	auto pSong = Song::loadFrom( songNode, sFileName, bSilent, pPatternList );
 	if ( pSong != nullptr ) {
 		pSong->setFileName( sFileName );
 	}
@@ -224,7 +232,8 @@ std::shared_ptr<Song> Song::load( const QString& sFileName, bool bSilent )
 	return pSong;
 }
 
-std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sFileName, bool bSilent )
+std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sFileName, bool bSilent,
+									  std::shared_ptr<PatternList> pPatternList )
 {
 	auto pPreferences = Preferences::get_instance();
 	auto pSong = std::make_shared<Song>();
@@ -345,6 +354,9 @@ std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sF
 	pSong->setSwingFactor( rootNode.read_float(
 		"swing_factor", pSong->getSwingFactor(), false, false, bSilent
 	) );
+	pSong->setRandomSeed( rootNode.read_int(
+		"random_seed", pSong->getRandomSeed(), true, false, bSilent
+	) );
 	pSong->setActionMode( static_cast<Song::ActionMode>( rootNode.read_int(
 		"action_mode", static_cast<int>( pSong->getActionMode() ), false, false,
 		bSilent
@@ -459,10 +471,20 @@ std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sF
 	) );
 
 	// Pattern list
-	auto pPatternList = PatternList::loadFrom(
-		rootNode, pDrumkit->getExportName(),
-		bCurrentDrumkitLoaded ? pDrumkit : nullptr, bSilent
-	);
+	if ( pPatternList == nullptr ) {
+		pPatternList = PatternList::loadFrom(
+			rootNode, pDrumkit->getExportName(),
+			bCurrentDrumkitLoaded ? pDrumkit : nullptr, bSilent
+		);
+	}
+	else {
+		// Already read by load(). Catch up on the steps requiring the kit.
+		for ( const auto& ppPattern : *pPatternList ) {
+			ppPattern->setDrumkitName( pDrumkit->getExportName() );
+			ppPattern->applyMissingTypes(
+				bCurrentDrumkitLoaded ? pDrumkit : nullptr, bSilent );
+		}
+	}
 	if ( pPatternList != nullptr ) {
 		pPatternList->mapToDrumkit( pDrumkit, nullptr );
 	}
@@ -840,6 +862,7 @@ void Song::saveTo( XMLNode& rootNode, bool bKeepMissingSamples,
 	rootNode.write_float( "humanize_time", m_fHumanizeTimeValue );
 	rootNode.write_float( "humanize_velocity", m_fHumanizeVelocityValue );
 	rootNode.write_float( "swing_factor", m_fSwingFactor );
+	rootNode.write_int( "random_seed", m_nRandomSeed );
 
 	// "drumkit_info" instead of "drumkit" seem unintuitive but is dictated by a
 	// ancient design desicion and we will stick to it.
@@ -1012,15 +1035,20 @@ std::shared_ptr<Song> Song::getEmptySong( std::shared_ptr<SoundLibraryDatabase>
 	const QString sDefaultDrumkitPath = Filesystem::drumkit_default_kit();
 	auto pDrumkit = pSoundLibraryDatabase->getDrumkit( sDefaultDrumkitPath );
 	if ( pDrumkit == nullptr ) {
+		QString sFallbackPath;
 		for ( const auto& pEntry : pSoundLibraryDatabase->getDrumkitDatabase() ) {
 			if ( pEntry.second != nullptr ) {
-				WARNINGLOG( QString( "Unable to retrieve default drumkit [%1]. Using kit [%2] instead." )
-							.arg( sDefaultDrumkitPath )
-							.arg( pEntry.first ) );
-				pDrumkit = pEntry.second;
+				sFallbackPath = pEntry.first;
 				break;
 			}
 		}
+		if ( ! sFallbackPath.isEmpty() ) {
+			WARNINGLOG( QString( "Unable to retrieve default drumkit [%1]. Using kit [%2] instead." )
+						.arg( sDefaultDrumkitPath )
+						.arg( sFallbackPath ) );
+			// Entries of the database might only hold metadata.
+			pDrumkit = pSoundLibraryDatabase->getDrumkit( sFallbackPath );
+		}
 	}
 
 	if ( pDrumkit == nullptr ) {
@@ -1256,6 +1284,8 @@ QString Song::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_fHumanizeVelocityValue ) )
 			.append( QString( "%1%2m_fSwingFactor: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_fSwingFactor ) )
+			.append( QString( "%1%2m_nRandomSeed: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nRandomSeed ) )
 			.append( QString( "%1%2m_bIsModified: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_bIsModified ) )
 			.append( QString( "%1%2m_latestRoundRobins\n" ).arg( sPrefix ).arg( s ) );
@@ -1329,6 +1359,7 @@ QString Song::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", m_fHumanizeTimeValue: %1" ).arg( m_fHumanizeTimeValue ) )
 			.append( QString( ", m_fHumanizeVelocityValue: %1" ).arg( m_fHumanizeVelocityValue ) )
 			.append( QString( ", m_fSwingFactor: %1" ).arg( m_fSwingFactor ) )
+			.append( QString( ", m_nRandomSeed: %1" ).arg( m_nRandomSeed ) )
 			.append( QString( ", m_bIsModified: %1" ).arg( m_bIsModified ) )
 			.append( QString( ", m_latestRoundRobins" ) );
 		for ( const auto& mm : m_latestRoundRobins ) {
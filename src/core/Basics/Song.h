@@ -221,6 +221,9 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 		float			getSwingFactor() const;
 		void			setSwingFactor( float fFactor );
 
+		int				getRandomSeed() const;
+		void			setRandomSeed( int nSeed );
+
 		const Mode&		getMode() const;
 		void			setMode( const Mode& mode );
 							
@@ -272,9 +275,12 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 	
 private:
 
+	/** \param pPatternList Patterns already read from the file by load().
+	 *   If `nullptr`, they are loaded from @a pNode. */
 	static std::shared_ptr<Song> loadFrom( const XMLNode& pNode,
 										   const QString& sFileName,
-										   bool bSilent = false );
+										   bool bSilent = false,
+										   std::shared_ptr<PatternList> pPatternList = nullptr );
 	void saveTo( XMLNode& pNode, bool bKeepMissingSamples,
 				bool bSilent = false ) const;
 
@@ -339,6 +345,13 @@ private:
 		 */
 		float			m_fHumanizeVelocityValue;
 		float			m_fSwingFactor;
+		/**
+		 * Seed of the random number generator of the #AudioEngine applied
+		 * at the beginning of each audio export. Random contributions of
+		 * humanization, note probability, and random layer selection are
+		 * thus identical in all exports of the song.
+		 */
+		int				m_nRandomSeed;
 		bool			m_bIsModified;
 		std::map< float, int> 	m_latestRoundRobins;
 		Mode			m_mode;
@@ -586,6 +599,16 @@ inline float Song::getSwingFactor() const
 	return m_fSwingFactor;
 }
 
+inline int Song::getRandomSeed() const
+{
+	return m_nRandomSeed;
+}
+
+inline void Song::setRandomSeed( int nSeed )
+{
+	m_nRandomSeed = nSeed;
+}
+
 inline void Song::setSwingFactor( float fValue )
 {
 	m_fSwingFactor =
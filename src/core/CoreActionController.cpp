@@ -861,11 +861,6 @@ bool CoreActionController::setSong( std::shared_ptr<Song> pSong ) {
 	// Update the Song.
 	pHydrogen->setSong( pSong );
 
-	auto pAudioEngine = pHydrogen->getAudioEngine();
-	pAudioEngine->lock( RIGHT_HERE );
-	pAudioEngine->getSampler()->clearLastUsedLayers();
-	pAudioEngine->unlock();
-		
 	if ( pHydrogen->isUnderSessionManagement() ) {
 		pHydrogen->restartAudioDriver();
 	}
@@ -1474,10 +1469,10 @@ bool CoreActionController::setDrumkit( std::shared_ptr<Drumkit> pNewDrumkit ) {
 	// the remaining ones enter ADSR release phase.
 	pAudioEngine->clearNoteQueues();
 	pAudioEngine->getSampler()->releasePlayingNotes();
-	pAudioEngine->getSampler()->clearLastUsedLayers();
 
 	pSong->setDrumkit( pNewDrumkit );
 	pSong->getPatternList()->mapToDrumkit( pNewDrumkit, pPreviousDrumkit );
+	pAudioEngine->updateNotePool( pNewDrumkit );
 
 	pHydrogen->renamePerTrackJackAudioPorts( pSong, pPreviousDrumkit );
 
@@ -1913,6 +1908,7 @@ bool CoreActionController::addInstrument( std::shared_ptr<Instrument> pInstrumen
 	pDrumkit->addInstrument( pInstrument, nIndex );
 	pHydrogen->renamePerTrackJackAudioPorts( pSong, nullptr );
 	pSong->getPatternList()->mapToDrumkit( pDrumkit, pDrumkit );
+	pAudioEngine->updateNotePool( pDrumkit );
 
 	pAudioEngine->unlock();
 
@@ -2071,6 +2067,7 @@ bool CoreActionController::replaceDrumkitInstrument(
 	pDrumkit->addInstrument( pNewInstrument, nOldInstrumentNumber );
 	pHydrogen->renamePerTrackJackAudioPorts( pSong, nullptr );
 	pSong->getPatternList()->mapToDrumkit( pDrumkit, pDrumkit );
+	pAudioEngine->updateNotePool( pDrumkit );
 
 	// Unloading the samples of the old instrument will be done in the death
 	// row.
@@ -2650,7 +2647,8 @@ bool CoreActionController::toggleGridCell( const GridPoint& gridPoint ){
 	
 	// Update the SongEditor.
 	if ( pHydrogen->getGUIState() != Hydrogen::GUIState::headless ) {
-		EventQueue::get_instance()->pushEvent( Event::Type::GridCellToggled, 0 );
+		EventQueue::get_instance()->pushEvent(
+			Event::Type::GridCellToggled, gridPoint.getColumn() );
 	}
 
 	return true;
@@ -2661,7 +2659,8 @@ bool CoreActionController::handleNote(
 	Midi::Channel channel,
 	float fVelocity,
 	bool bNoteOff,
-	QStringList* pMappedInstruments
+	QStringList* pMappedInstruments,
+	const TimePoint& timePoint
 )
 {
 	const auto pPref = Preferences::get_instance();
@@ -2708,7 +2707,7 @@ bool CoreActionController::handleNote(
 		}
 
 		if ( pHydrogen->addRealtimeNote(
-				 nCurrentInstrument, fVelocity, bNoteOff, note ) ) {
+				 nCurrentInstrument, fVelocity, bNoteOff, note, timePoint ) ) {
 			instrumentStrings << QString( "%1 (%2)" )
 				.arg( ppInstrument->getName() ).arg( nCurrentInstrument );
 		}
@@ -28,6 +28,7 @@
 #include <vector>
 
 #include <core/Basics/DrumkitMap.h>
+#include <core/Helpers/Time.h>
 #include <core/Midi/Midi.h>
 #include <core/Object.h>
 
@@ -487,6 +488,8 @@ class CoreActionController : public H2Core::Object<CoreActionController> {
 		 * @param bNoteOff whether note should trigger or stop sound.
 		 * @param pMappedInstrument if provided, will hold the names of all
 		 *   instruments the note was mapped to.
+		 * @param timePoint when the note was played. Used to place it
+		 *   within the buffer rendered by the audio engine.
 		 *
 		 * @return bool true on success */
 		static bool handleNote(
@@ -494,7 +497,8 @@ class CoreActionController : public H2Core::Object<CoreActionController> {
 			Midi::Channel channel,
 			float fVelocity,
 			bool bNoteOff = false,
-			QStringList* pMappedInstruments = nullptr
+			QStringList* pMappedInstruments = nullptr,
+			const TimePoint& timePoint = Clock::now()
 		);
 
 		/**
@@ -37,23 +37,108 @@ void EventQueue::create_instance()
 }
 
 
-EventQueue::EventQueue() : m_bSilent( false ) {
+EventQueue::EventQueue() : m_nWritePosition( 0 )
+						 , m_nReadPosition( 0 )
+						 , m_nNextEventId( Event::nInvalidId + 1 )
+						 , m_nDroppedEvents( 0 )
+						 , m_nReportedDroppedEvents( 0 )
+						 , m_bSilent( false ) {
 	__instance = this;
 
-    std::random_device randomSeed;
-	m_randomEngine = std::default_random_engine( randomSeed() );
-	m_randomDistribution =
-		std::uniform_int_distribution<long>( Event::nInvalidId + 1, LONG_MAX );
+	for ( size_t ii = 0; ii < m_slots.size(); ++ii ) {
+		m_slots[ ii ].sequence.store( ii, std::memory_order_relaxed );
+		m_slots[ ii ].type = Event::Type::Xrun;
+		m_slots[ ii ].nValue = 0;
+		m_slots[ ii ].nId = Event::nInvalidId;
+	}
+	for ( auto& ppDropPosition : m_dropPositions ) {
+		ppDropPosition.store( 0, std::memory_order_relaxed );
+	}
+	for ( auto& ppPendingNoteRender : m_pendingNoteRenders ) {
+		ppPendingNoteRender.store( Event::nInvalidId, std::memory_order_relaxed );
+	}
 }
 
 
 EventQueue::~EventQueue() {
 }
 
+bool EventQueue::tryPush( Event::Type type, int nValue, long nId ) {
+	Slot* pSlot;
+	size_t nPosition = m_nWritePosition.load( std::memory_order_relaxed );
+	while ( true ) {
+		pSlot = &m_slots[ nPosition & nBufferMask ];
+		const size_t nSequence = pSlot->sequence.load( std::memory_order_acquire );
+		const auto nDiff = static_cast<std::ptrdiff_t>( nSequence ) -
+			static_cast<std::ptrdiff_t>( nPosition );
+		if ( nDiff == 0 ) {
+			// Slot is free. Claim it.
+			if ( m_nWritePosition.compare_exchange_weak(
+					 nPosition, nPosition + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		}
+		else if ( nDiff < 0 ) {
+			// Slot still holds an event which was not read yet.
+			return false;
+		}
+		else {
+			// Another thread claimed the slot in the meantime.
+			nPosition = m_nWritePosition.load( std::memory_order_relaxed );
+		}
+	}
+
+	pSlot->type = type;
+	pSlot->nValue = nValue;
+	pSlot->nId = nId;
+	pSlot->sequence.store( nPosition + 1, std::memory_order_release );
 
-long EventQueue::pushEvent( const Event::Type type, const int nValue ) {
-	std::lock_guard< std::mutex > lock( m_mutex );
+	return true;
+}
+
+bool EventQueue::tryPop( Event::Type& type, int& nValue, long& nId,
+						 size_t& nPosition ) {
+	Slot* pSlot;
+	nPosition = m_nReadPosition.load( std::memory_order_relaxed );
+	while ( true ) {
+		pSlot = &m_slots[ nPosition & nBufferMask ];
+		const size_t nSequence = pSlot->sequence.load( std::memory_order_acquire );
+		const auto nDiff = static_cast<std::ptrdiff_t>( nSequence ) -
+			static_cast<std::ptrdiff_t>( nPosition + 1 );
+		if ( nDiff == 0 ) {
+			if ( m_nReadPosition.compare_exchange_weak(
+					 nPosition, nPosition + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		}
+		else if ( nDiff < 0 ) {
+			// Queue is empty.
+			return false;
+		}
+		else {
+			nPosition = m_nReadPosition.load( std::memory_order_relaxed );
+		}
+	}
+
+	type = pSlot->type;
+	nValue = pSlot->nValue;
+	nId = pSlot->nId;
+	// Mark the slot as free for the next round through the buffer.
+	pSlot->sequence.store( nPosition + nBufferMask + 1,
+						   std::memory_order_release );
+
+	return true;
+}
+
+void EventQueue::releaseCoalescedEvent( Event::Type type, int nValue ) {
+	if ( type == Event::Type::NoteRender && nValue >= 0 &&
+		 nValue < nMaxCoalescedInstruments ) {
+		m_pendingNoteRenders[ nValue ].store(
+			Event::nInvalidId, std::memory_order_release );
+	}
+}
 
+long EventQueue::pushEvent( const Event::Type type, const int nValue ) {
 	auto pHydrogen = Hydrogen::get_instance();
 	if ( pHydrogen == nullptr ||
 		 pHydrogen->getGUIState() == Hydrogen::GUIState::startup ||
@@ -61,81 +146,100 @@ long EventQueue::pushEvent( const Event::Type type, const int nValue ) {
 		return Event::nInvalidId;
 	}
 
-	/* The event queue is full. We could drop the old event, or the new event
-	   we're trying to place. It's preferable to drop the oldest event in the
-	   queue, on the basis that many change-of-state-events are probably no
-	   longer relevant or redundant based on newer events in the queue, so we
-	   keep the new event. */
-	while ( m_eventQueue.size() >= EventQueue::nMaxEvents ) {
-		auto pOldestEvent = std::move( m_eventQueue.front() );
-		m_eventQueue.pop_front();
-		if ( ! m_bSilent ) {
-			ERRORLOG( QString( "Event queue full. Dropping oldest event: [%1]" )
-					  .arg( pOldestEvent != nullptr ?
-							pOldestEvent->toQString() : "nullptr" ) );
+	const long nId = createEventId();
+
+	if ( type == Event::Type::NoteRender && nValue >= 0 &&
+		 nValue < nMaxCoalescedInstruments ) {
+		long nPendingId = Event::nInvalidId;
+		if ( ! m_pendingNoteRenders[ nValue ].compare_exchange_strong(
+				 nPendingId, nId, std::memory_order_acq_rel ) ) {
+			// There is still an event for this instrument waiting to be
+			// handled by the GUI. A second one would not add anything.
+			return nPendingId;
 		}
 	}
 
-	auto pEvent = std::make_unique<Event>( type, nValue );
-	const auto nId = pEvent->getId();
-	m_eventQueue.push_back( std::move( pEvent ) );
+	while ( ! tryPush( type, nValue, nId ) ) {
+		// The queue is full. Drop the oldest event. We do not log in here
+		// since this function is called from within the audio thread.
+		// popEvent() will report the number of dropped events instead.
+		Event::Type droppedType;
+		int nDroppedValue;
+		long nDroppedId;
+		size_t nDroppedPosition;
+		if ( tryPop( droppedType, nDroppedValue, nDroppedId,
+					 nDroppedPosition ) ) {
+			releaseCoalescedEvent( droppedType, nDroppedValue );
+			m_nDroppedEvents.fetch_add( 1, std::memory_order_relaxed );
+		}
+	}
 
 	return nId;
 }
 
 std::unique_ptr<Event> EventQueue::popEvent() {
-	std::lock_guard< std::mutex > lock( m_mutex );
-
-	if ( m_eventQueue.empty() ) {
-		return nullptr;
+	const long long nDroppedEvents =
+		m_nDroppedEvents.load( std::memory_order_relaxed );
+	if ( nDroppedEvents != m_nReportedDroppedEvents ) {
+		if ( ! m_bSilent ) {
+			ERRORLOG( QString( "Event queue full. [%1] events were dropped" )
+					  .arg( nDroppedEvents - m_nReportedDroppedEvents ) );
+		}
+		m_nReportedDroppedEvents = nDroppedEvents;
 	}
 
-	auto pEvent = std::move( m_eventQueue.front() );
-	m_eventQueue.pop_front();
+	Event::Type type;
+	int nValue;
+	long nId;
+	size_t nPosition;
+	while ( tryPop( type, nValue, nId, nPosition ) ) {
+		releaseCoalescedEvent( type, nValue );
+
+		if ( nPosition < m_dropPositions[ static_cast<int>( type ) ].load(
+				 std::memory_order_acquire ) ) {
+			// Event was discarded using dropEvents().
+			continue;
+		}
+
+		return std::make_unique<Event>( type, nValue, nId );
+	}
 
-	return std::move( pEvent );
+	return nullptr;
 }
 
 void EventQueue::dropEvents( const Event::Type& type ) {
-	std::lock_guard< std::mutex > lock( m_mutex );
-
-	for ( auto it = m_eventQueue.begin(); it != m_eventQueue.end(); ) {
-        if ( *it != nullptr && (*it)->getType() == type ) {
-            it = m_eventQueue.erase( it );
-		}
-        else {
-            ++it;
-		}
-    }
+	m_dropPositions[ static_cast<int>( type ) ].store(
+		m_nWritePosition.load( std::memory_order_acquire ),
+		std::memory_order_release );
 }
 
 long EventQueue::createEventId() {
-	return m_randomDistribution( m_randomEngine );
+	return m_nNextEventId.fetch_add( 1, std::memory_order_relaxed );
 }
 
 QString EventQueue::toQString( const QString& sPrefix, bool bShort ) {
-	std::lock_guard< std::mutex > lock( m_mutex );
-
 	QString s = Base::sPrintIndention;
-	QString sOutput, sIndexPrefix;
+	QString sOutput;
 	if ( ! bShort ) {
 		sOutput = QString( "%1[EventQueue]\n" ).arg( sPrefix )
 			.append( QString( "%1%2m_bSilent: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_bSilent ) )
-			.append( QString( "%1%2m_eventQueue: \n" ).arg( sPrefix ).arg( s ) );
-		for ( const auto& ppEvent : m_eventQueue ) {
-			sOutput.append( QString( "%1" )
-							.arg( ppEvent->toQString( sPrefix + s, bShort ) ) );
-		}
+			.append( QString( "%1%2m_nWritePosition: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nWritePosition.load() ) )
+			.append( QString( "%1%2m_nReadPosition: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nReadPosition.load() ) )
+			.append( QString( "%1%2m_nDroppedEvents: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nDroppedEvents.load() ) );
 	}
 	else {
 		sOutput = QString( "[EventQueue] " )
 			.append( QString( "m_bSilent: %1" ).arg( m_bSilent ) )
-			.append( QString( ", m_eventQueue: [" ) );
-		for ( const auto& ppEvent : m_eventQueue ) {
-			sOutput.append( QString( "%1" )
-							.arg( ppEvent->toQString( "", bShort ) ) );
-		}
+			.append( QString( ", m_nWritePosition: %1" )
+					 .arg( m_nWritePosition.load() ) )
+			.append( QString( ", m_nReadPosition: %1" )
+					 .arg( m_nReadPosition.load() ) )
+			.append( QString( ", m_nDroppedEvents: %1" )
+					 .arg( m_nDroppedEvents.load() ) );
 	}
 
 	return sOutput;
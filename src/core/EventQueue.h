@@ -28,11 +28,11 @@
 #include <core/Basics/Note.h>
 #include <core/Object.h>
 
+#include <array>
+#include <atomic>
 #include <cassert>
-#include <deque>
+#include <cstddef>
 #include <memory>
-#include <mutex>
-#include <random>
 #include <vector>
 
 namespace H2Core
@@ -49,16 +49,30 @@ namespace H2Core
  * an Event of a certain Event::Type is encountered, the corresponding function
  * in the EventListener will be invoked to respond to the condition of the
  * engine. For details about the mapping of Event::Type to functions please see
- * the documentation of HydrogenApp::onEventQueueTimer().*/
+ * the documentation of HydrogenApp::onEventQueueTimer().
+ *
+ * Since events are pushed from within the audio thread (e.g. for every note
+ * rendered), pushEvent() must neither lock nor allocate. The queue is a
+ * bounded ring buffer of #nMaxEvents preallocated slots holding plain event
+ * data (based on Dmitry Vyukov's bounded MPMC queue). Each slot carries a
+ * sequence number telling producers and consumers whether it is ready to be
+ * written or read. Only popEvent(), which is called by the GUI, does create
+ * actual #Event objects.*/
 /** \ingroup docCore docEvent */
 class EventQueue : public H2Core::Object<EventQueue>
 {
 	H2_OBJECT(EventQueue)
 public:
 
-	/** Maximum number of events to be stored in the
-		H2Core::EventQueue::m_eventQueue.*/
+	/** Maximum number of events to be stored in the queue. Must be a power
+	 * of two. */
 	static constexpr int nMaxEvents = 1024;
+	static_assert( ( nMaxEvents & ( nMaxEvents - 1 ) ) == 0,
+				   "nMaxEvents must be a power of two" );
+
+	/** #Event::Type::NoteRender events of instruments with an index below
+	 * this number are coalesced. */
+	static constexpr int nMaxCoalescedInstruments = 1024;
 
 	/**
 	* If #__instance equals 0, a new EventQueue singleton will be
@@ -77,42 +91,44 @@ public:
 	/**
 	 * Queues the next event into the EventQueue.
 	 *
-	 * The event itself will be constructed inside the function and will be two
-	 * properties: an Event::Type @a type and a value @a nValue. Since the event
-	 * written to the queue most recently is indexed with #m_nWriteIndex, this
-	 * variable is incremented once and its modulo with respect to #MAX_EVENTS
-	 * is calculated to determine the position of insertion into
-	 * #m_eventQueue.
+	 * This function is lock-free and does not allocate memory. It is safe
+	 * to be called from the audio thread and from several threads at once.
+	 *
+	 * In case the queue is full, the oldest event will be dropped. It is
+	 * preferable to drop the oldest event in the queue, on the basis that
+	 * many change-of-state-events are probably no longer relevant or
+	 * redundant based on newer events in the queue. Dropped events are
+	 * counted (see getDroppedEvents()) and reported in popEvent().
 	 *
-	 * The modulo operation is necessary because #m_nWriteIndex will be only
-	 * incremented and does not respect the actual length of #m_eventQueue
-	 * itself.
+	 * #Event::Type::NoteRender events are coalesced per instrument: as long
+	 * as there is still one event for a particular instrument pending,
+	 * additional ones are discarded right away.
 	 *
 	 * \param type Type of the event, which will be queued.
 	 * \param nValue Value specifying the content of the new event.
 	 *
-	 * \returns the ID of the created #H2Core::Event.
+	 * \returns the ID of the created #H2Core::Event (or of the pending one in
+	 * case it was coalesced).
 	 */
 	long pushEvent( const Event::Type type, const int nValue );
 	/**
 	 * Reads out the next event of the EventQueue.
 	 *
-	 * Since the event read out most recently is indexed with #m_nReadIndex,
-	 * this variable is incremented once and its modulo with respect to
-	 * #MAX_EVENTS is calculated to determine the event returned from
-	 * #m_eventQueue.
-	 *
-	 * The modulo operation is necessary because #m_nReadIndex will be only
-	 * incremented and does not respect the actual length of #m_eventQueue
-	 * itself.
-	 *
-	 * \return Next event in line.
+	 * \return Next event in line or `nullptr` in case the queue is empty.
 	 */
 	std::unique_ptr<Event> popEvent();
 
-	/** Removes all events of type @a type from the queue. */
+	/** Removes all events of type @a type currently present in the queue.
+	 *
+	 * Since events can not be removed from the middle of the ring buffer,
+	 * we store the current write position for @a type and popEvent() skips
+	 * all events of this type queued prior to it. */
 	void dropEvents( const Event::Type& type );
 
+	/** @return the number of events dropped due to an overflow of the
+	 * queue since its creation. */
+	long long getDroppedEvents() const;
+
 	struct AddMidiNoteVector {
 		int nColumn;       // position
 		Instrument::Id id; // specifies the instrument triggered
@@ -128,8 +144,7 @@ public:
 	bool getSilent() const;
 	void setSilent( bool bSilent );
 
-	/** The EventQueue holds the seeded random engine used to assign each new
-     * #H2Core::Event a (more or less) unique id on creation. */
+	/** Assigns a unique id to each new #H2Core::Event. */
 	long createEventId();
 	
 	/** Formatted string version for debugging purposes.
@@ -146,15 +161,59 @@ private:
 	EventQueue();
 	static EventQueue *__instance;
 
-	std::deque< std::unique_ptr<Event> >m_eventQueue;
+	/** Preallocated storage of a single event. */
+	struct Slot {
+		/** Equals the position of the slot within the ring buffer in case
+		 * it is ready to be written and position + 1 when ready to be read.
+		 * This way wrap-arounds are detected without additional state. */
+		std::atomic<size_t> sequence;
+		Event::Type type;
+		int nValue;
+		long nId;
+	};
+
+	/** Attempts to write an event into the next free slot.
+	 *
+	 * \return `false` in case the queue is full. */
+	bool tryPush( Event::Type type, int nValue, long nId );
+	/** Attempts to read the oldest event in the queue.
+	 *
+	 * \param nPosition Position of the read event within the stream of all
+	 *   events (not wrapped around the size of the buffer).
+	 * \return `false` in case the queue is empty. */
+	bool tryPop( Event::Type& type, int& nValue, long& nId, size_t& nPosition );
+
+	/** Marks a coalesced #Event::Type::NoteRender as consumed. */
+	void releaseCoalescedEvent( Event::Type type, int nValue );
+
+	static constexpr size_t nBufferMask = nMaxEvents - 1;
+	static constexpr int nEventTypes =
+		static_cast<int>( Event::Type::Xrun ) + 1;
+
+	std::array<Slot, nMaxEvents> m_slots;
+
+	/** Position the next event will be written to. */
+	alignas( 64 ) std::atomic<size_t> m_nWritePosition;
+	/** Position the next event will be read from. */
+	alignas( 64 ) std::atomic<size_t> m_nReadPosition;
 
-	std::mutex m_mutex;
+	/** All events of a particular type with a position smaller than the
+	 * corresponding element will be skipped (see dropEvents()). */
+	std::array<std::atomic<size_t>, nEventTypes> m_dropPositions;
+
+	/** Ids of pending #Event::Type::NoteRender events indexed by instrument.
+	 * #Event::nInvalidId indicates no event is pending. */
+	std::array<std::atomic<long>, nMaxCoalescedInstruments> m_pendingNoteRenders;
+
+	std::atomic<long> m_nNextEventId;
+
+	std::atomic<long long> m_nDroppedEvents;
+	/** Number of dropped events already reported in the log. Only accessed
+	 * by the reading thread. */
+	long long m_nReportedDroppedEvents;
 
 	/** Whether or not to push log messages.*/
 	bool m_bSilent;
-
-	std::default_random_engine m_randomEngine;
-	std::uniform_int_distribution<long> m_randomDistribution;
 };
 
 inline bool EventQueue::getSilent() const {
@@ -163,6 +222,9 @@ inline bool EventQueue::getSilent() const {
 inline void EventQueue::setSilent( bool bSilent ) {
 	m_bSilent = bSilent;
 }
+inline long long EventQueue::getDroppedEvents() const {
+	return m_nDroppedEvents.load( std::memory_order_relaxed );
+}
 
 };
 
@@ -48,12 +48,21 @@ Effects* Effects::__instance = nullptr;
 Effects::Effects()
 		: m_pRootGroup( nullptr )
 		, m_pRecentGroup( nullptr )
+		, m_catalogue( Filesystem::cache_dir() + "ladspa_catalogue.xml" )
 {
 	__instance = this;
 
 	m_FXs.resize( MAX_FX );
 
-	getPluginList();
+	if ( m_catalogue.load() ) {
+		// Start with the cached plugins and check for changes without
+		// blocking the startup.
+		publishPluginList();
+		rescanPluginList();
+	}
+	else {
+		scanPlugins();
+	}
 }
 
 
@@ -65,6 +74,9 @@ void Effects::create_instance()
 }
 
 Effects::~Effects() {
+	if ( m_scanThread.joinable() ) {
+		m_scanThread.join();
+	}
 }
 
 
@@ -94,6 +106,7 @@ void Effects::setLadspaFX( std::shared_ptr<LadspaFX> pFX, int nFX ) {
 
 	if ( pFX != nullptr ) {
 		Preferences::get_instance()->setMostRecentFX( pFX->getPluginName() );
+		std::lock_guard<std::mutex> lock( m_pluginListMutex );
 		updateRecentGroup();
 	}
 
@@ -105,113 +118,48 @@ void Effects::setLadspaFX( std::shared_ptr<LadspaFX> pFX, int nFX ) {
 	}
 }
 
-///
-/// Loads only usable plugins
-///
 std::vector< std::shared_ptr<LadspaFXInfo> > Effects::getPluginList()
 {
-	if ( m_pluginList.size() != 0 ) {
-		return m_pluginList;
-	}
-
-	foreach ( const QString& sPluginDir, Filesystem::ladspa_paths() ) {
-		INFOLOG( "*** [getPluginList] reading directory: " + sPluginDir );
+	std::lock_guard<std::mutex> lock( m_pluginListMutex );
+	return m_pluginList;
+}
 
-		QDir dir( sPluginDir );
-		if ( !dir.exists() ) {
-			INFOLOG( "Directory " + sPluginDir + " not found" );
-			continue;
-		}
+void Effects::rescanPluginList()
+{
+	if ( m_scanThread.joinable() ) {
+		m_scanThread.join();
+	}
 
-		QFileInfoList list = dir.entryInfoList();
-		for ( int i = 0; i < list.size(); ++i ) {
-			QString sPluginName = list.at( i ).fileName();
+	m_scanThread = std::thread( &Effects::scanPlugins, this );
+}
 
-			if ( ( sPluginName == "." ) || ( sPluginName == ".." ) ) {
-				continue;
-			}
+void Effects::scanPlugins()
+{
+	if ( m_catalogue.update( Filesystem::ladspa_paths() ) ) {
+		m_catalogue.save();
+		publishPluginList();
+	}
+}
 
-			// if the file ends with .so or .dll is a plugin, else...
-#ifdef WIN32
-			int pos = sPluginName.indexOf( ".dll" );
-#else
-#ifdef Q_OS_MACX
-			int pos = sPluginName.indexOf( ".dylib" );
-#else
-			int pos = sPluginName.indexOf( ".so" );
-#endif
-#endif
-			if ( pos == -1 ) {
-				continue;
-			}
+void Effects::publishPluginList()
+{
+	const auto pluginList = m_catalogue.getPlugins();
 
-			QString sAbsPath = QString( "%1/%2" ).arg( sPluginDir ).arg( sPluginName );
+	INFOLOG( QString( "Loaded %1 LADSPA plugins" ).arg( pluginList.size() ) );
 
-			QLibrary lib( sAbsPath );
-			LADSPA_Descriptor_Function desc_func = ( LADSPA_Descriptor_Function )lib.resolve( "ladspa_descriptor" );
-			if ( desc_func == nullptr ) {
-				ERRORLOG( "Error loading the library. (" + sAbsPath + ")" );
-				continue;
-			}
-			const LADSPA_Descriptor * d;
-			if ( desc_func ) {
-				for ( unsigned i = 0; ( d = desc_func ( i ) ) != nullptr; i++ ) {
-					auto pFX = std::make_shared<LadspaFXInfo>(
-						QString::fromLocal8Bit(d->Name) );
-					pFX->m_sFileName = sAbsPath;
-					pFX->m_sLabel = QString::fromLocal8Bit(d->Label);
-					pFX->m_sID = QString::number(d->UniqueID);
-					pFX->m_sMaker = QString::fromLocal8Bit(d->Maker);
-					pFX->m_sCopyright = QString::fromLocal8Bit(d->Copyright);
-
-					for ( unsigned j = 0; j < d->PortCount; j++ ) {
-						LADSPA_PortDescriptor pd = d->PortDescriptors[j];
-						if ( LADSPA_IS_PORT_INPUT( pd ) &&
-							 LADSPA_IS_PORT_CONTROL( pd ) ) {
-							pFX->m_nICPorts++;
-						}
-						else if ( LADSPA_IS_PORT_INPUT( pd ) &&
-									LADSPA_IS_PORT_AUDIO( pd ) ) {
-							pFX->m_nIAPorts++;
-						}
-						else if ( LADSPA_IS_PORT_OUTPUT( pd ) &&
-									LADSPA_IS_PORT_CONTROL( pd ) ) {
-							pFX->m_nOCPorts++;
-						}
-						else if ( LADSPA_IS_PORT_OUTPUT( pd ) &&
-									LADSPA_IS_PORT_AUDIO( pd ) ) {
-							pFX->m_nOAPorts++;
-						}
-						else {
-							QString sPortName;
-							ERRORLOG( QString( "%1::%2 unknown port type" )
-									  .arg( pFX->m_sLabel ).arg( sPortName ) );
-						}
-					}
-					if ( ( pFX->m_nIAPorts == 2 ) && ( pFX->m_nOAPorts == 2 ) ) {	// Stereo plugin
-						m_pluginList.push_back( pFX );
-					}
-					else if ( ( pFX->m_nIAPorts == 1 ) && ( pFX->m_nOAPorts == 1 ) ) {	// Mono plugin
-						m_pluginList.push_back( pFX );
-					}
-					// Otherwise the plugin is not supported.
-				}
-			} else {
-				ERRORLOG( "Error loading: " + sPluginName  );
-			}
-		}
-	}
+	std::lock_guard<std::mutex> lock( m_pluginListMutex );
+	m_pluginList = pluginList;
 
-	INFOLOG( QString( "Loaded %1 LADSPA plugins" ).arg( m_pluginList.size() ) );
-	std::sort( m_pluginList.begin(), m_pluginList.end(),
-			   LadspaFXInfo::alphabeticOrder );
-	return m_pluginList;
+	// Groups will be rebuilt on next access.
+	m_pRootGroup = nullptr;
+	m_pRecentGroup = nullptr;
 }
 
 std::shared_ptr<LadspaFXGroup> Effects::getLadspaFXGroup()
 {
 	INFOLOG( "[getLadspaFXGroup]" );
 
+	std::lock_guard<std::mutex> lock( m_pluginListMutex );
 	if ( m_pRootGroup ) {
 		return m_pRootGroup;
 	}
@@ -28,14 +28,25 @@
 
 #include <core/Globals.h>
 #include <core/Object.h>
+#include <core/FX/LadspaCatalogue.h>
 #include <core/FX/LadspaFX.h>
 
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <cassert>
 
 namespace H2Core
 {
+/**
+ * Catalogue of all LADSPA plugins found in Filesystem::ladspa_paths() and
+ * the slots of the master FX rack.
+ *
+ * The descriptors of all plugins are cached in a #LadspaCatalogue within
+ * Filesystem::cache_dir(). Plugins themselves are instantiated in
+ * LadspaFX::load().
+ */
 /** \ingroup docCore docAudioEngine */
 class Effects : public H2Core::Object<Effects>
 {
@@ -58,9 +69,15 @@ public:
 	std::shared_ptr<LadspaFX> getLadspaFX( int nFX ) const;
 	void  setLadspaFX( std::shared_ptr<LadspaFX> pFX, int nFX );
 
+	/** \return all supported plugins in alphabetic order. */
 	std::vector< std::shared_ptr<LadspaFXInfo> > getPluginList();
 	std::shared_ptr<LadspaFXGroup> getLadspaFXGroup();
 
+	/** Checks the plugin directories for added, removed, or modified
+	 * libraries in a background thread and updates the plugin list
+	 * accordingly. */
+	void rescanPluginList();
+
 
 private:
 	/**
@@ -72,9 +89,23 @@ private:
 	std::vector< std::shared_ptr<LadspaFXInfo> > m_pluginList;
 	std::shared_ptr<LadspaFXGroup> m_pRootGroup;
 	std::shared_ptr<LadspaFXGroup> m_pRecentGroup;
+	/** Protects #m_pluginList, #m_pRootGroup, and #m_pRecentGroup against
+	 * the scan thread. */
+	std::mutex m_pluginListMutex;
 
+	/** Only accessed by the thread performing the scan. */
+	LadspaCatalogue m_catalogue;
+	std::thread m_scanThread;
+
+	/** Must be called while holding #m_pluginListMutex. */
 	void updateRecentGroup();
 
+	/** Synchronizes #m_catalogue with the content of all plugin directories
+	 * and publishes the result. */
+	void scanPlugins();
+	/** Replaces #m_pluginList by the content of #m_catalogue. */
+	void publishPluginList();
+
 	std::vector< std::shared_ptr<LadspaFX> > m_FXs;
 
 	Effects();
@@ -0,0 +1,295 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/FX/LadspaCatalogue.h>
+
+#if defined(H2CORE_HAVE_LADSPA) || _DOXYGEN_
+
+#include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Xml.h>
+
+#include <algorithm>
+#include <set>
+#include <QDir>
+#include <QFileInfo>
+#include <QLibrary>
+
+namespace H2Core
+{
+
+LadspaCatalogue::LadspaCatalogue( const QString& sPath )
+	: m_sPath( sPath )
+{
+}
+
+LadspaCatalogue::~LadspaCatalogue()
+{
+}
+
+std::vector< std::shared_ptr<LadspaFXInfo> > LadspaCatalogue::getPlugins() const
+{
+	std::vector< std::shared_ptr<LadspaFXInfo> > pluginList;
+	for ( const auto& [ _, eentry ] : m_entries ) {
+		pluginList.insert( pluginList.end(), eentry.plugins.begin(),
+						   eentry.plugins.end() );
+	}
+	std::sort( pluginList.begin(), pluginList.end(),
+			   LadspaFXInfo::alphabeticOrder );
+
+	return pluginList;
+}
+
+bool LadspaCatalogue::update( const QStringList& directories )
+{
+	bool bChanged = false;
+	std::set<QString> libraryPaths;
+
+	for ( const auto& sPluginDir : directories ) {
+		INFOLOG( "*** [update] reading directory: " + sPluginDir );
+
+		QDir dir( sPluginDir );
+		if ( !dir.exists() ) {
+			INFOLOG( "Directory " + sPluginDir + " not found" );
+			continue;
+		}
+
+		QFileInfoList list = dir.entryInfoList();
+		for ( int i = 0; i < list.size(); ++i ) {
+			QString sPluginName = list.at( i ).fileName();
+
+			if ( ( sPluginName == "." ) || ( sPluginName == ".." ) ) {
+				continue;
+			}
+
+			// if the file ends with .so or .dll is a plugin, else...
+#ifdef WIN32
+			int pos = sPluginName.indexOf( ".dll" );
+#else
+#ifdef Q_OS_MACX
+			int pos = sPluginName.indexOf( ".dylib" );
+#else
+			int pos = sPluginName.indexOf( ".so" );
+#endif
+#endif
+			if ( pos == -1 ) {
+				continue;
+			}
+
+			QString sAbsPath = QString( "%1/%2" ).arg( sPluginDir ).arg( sPluginName );
+			if ( libraryPaths.find( sAbsPath ) != libraryPaths.end() ) {
+				continue;
+			}
+			libraryPaths.insert( sAbsPath );
+
+			const qint64 nModified =
+				list.at( i ).lastModified().toMSecsSinceEpoch();
+			const qint64 nSize = list.at( i ).size();
+
+			const auto it = m_entries.find( sAbsPath );
+			if ( it != m_entries.end() &&
+				 it->second.nModified == nModified &&
+				 it->second.nSize == nSize ) {
+				// Library did not change since it was scanned last time.
+				continue;
+			}
+
+			Entry entry;
+			entry.nModified = nModified;
+			entry.nSize = nSize;
+			entry.plugins = loadLibrary( sAbsPath );
+			m_entries[ sAbsPath ] = entry;
+			bChanged = true;
+		}
+	}
+
+	for ( auto it = m_entries.begin(); it != m_entries.end(); ) {
+		if ( libraryPaths.find( it->first ) == libraryPaths.end() ) {
+			INFOLOG( QString( "LADSPA library [%1] was removed" ).arg( it->first ) );
+			it = m_entries.erase( it );
+			bChanged = true;
+		}
+		else {
+			++it;
+		}
+	}
+
+	return bChanged;
+}
+
+std::vector< std::shared_ptr<LadspaFXInfo> > LadspaCatalogue::loadLibrary(
+	const QString& sLibraryPath )
+{
+	std::vector< std::shared_ptr<LadspaFXInfo> > plugins;
+
+	QLibrary lib( sLibraryPath );
+	LADSPA_Descriptor_Function desc_func = ( LADSPA_Descriptor_Function )lib.resolve( "ladspa_descriptor" );
+	if ( desc_func == nullptr ) {
+		ERRORLOG( "Error loading the library. (" + sLibraryPath + ")" );
+		return plugins;
+	}
+
+	const LADSPA_Descriptor * d;
+	for ( unsigned i = 0; ( d = desc_func ( i ) ) != nullptr; i++ ) {
+		auto pFX = std::make_shared<LadspaFXInfo>(
+			QString::fromLocal8Bit(d->Name) );
+		pFX->m_sFileName = sLibraryPath;
+		pFX->m_sLabel = QString::fromLocal8Bit(d->Label);
+		pFX->m_sID = QString::number(d->UniqueID);
+		pFX->m_sMaker = QString::fromLocal8Bit(d->Maker);
+		pFX->m_sCopyright = QString::fromLocal8Bit(d->Copyright);
+
+		for ( unsigned j = 0; j < d->PortCount; j++ ) {
+			LADSPA_PortDescriptor pd = d->PortDescriptors[j];
+			if ( LADSPA_IS_PORT_INPUT( pd ) &&
+				 LADSPA_IS_PORT_CONTROL( pd ) ) {
+				pFX->m_nICPorts++;
+			}
+			else if ( LADSPA_IS_PORT_INPUT( pd ) &&
+						LADSPA_IS_PORT_AUDIO( pd ) ) {
+				pFX->m_nIAPorts++;
+			}
+			else if ( LADSPA_IS_PORT_OUTPUT( pd ) &&
+						LADSPA_IS_PORT_CONTROL( pd ) ) {
+				pFX->m_nOCPorts++;
+			}
+			else if ( LADSPA_IS_PORT_OUTPUT( pd ) &&
+						LADSPA_IS_PORT_AUDIO( pd ) ) {
+				pFX->m_nOAPorts++;
+			}
+			else {
+				QString sPortName;
+				ERRORLOG( QString( "%1::%2 unknown port type" )
+						  .arg( pFX->m_sLabel ).arg( sPortName ) );
+			}
+		}
+		if ( ( pFX->m_nIAPorts == 2 ) && ( pFX->m_nOAPorts == 2 ) ) {	// Stereo plugin
+			plugins.push_back( pFX );
+		}
+		else if ( ( pFX->m_nIAPorts == 1 ) && ( pFX->m_nOAPorts == 1 ) ) {	// Mono plugin
+			plugins.push_back( pFX );
+		}
+		// Otherwise the plugin is not supported.
+	}
+
+	return plugins;
+}
+
+bool LadspaCatalogue::load()
+{
+	m_entries.clear();
+
+	if ( ! Filesystem::file_exists( m_sPath, true ) ) {
+		return false;
+	}
+
+	XMLDoc doc;
+	if ( ! doc.read( m_sPath, true ) ) {
+		WARNINGLOG( QString( "Unable to read LADSPA catalogue [%1]" ).arg( m_sPath ) );
+		return false;
+	}
+
+	const XMLNode rootNode = doc.firstChildElement( "ladspa_catalogue" );
+	if ( rootNode.isNull() ||
+		 rootNode.read_int( "formatVersion", -1, false, false, true ) !=
+		 nFormatVersion ) {
+		INFOLOG( QString( "Discarding outdated LADSPA catalogue [%1]" ).arg( m_sPath ) );
+		return false;
+	}
+
+	XMLNode libraryNode = rootNode.firstChildElement( "libraryList" )
+		.firstChildElement( "library" );
+	while ( ! libraryNode.isNull() ) {
+		const QString sLibraryPath =
+			libraryNode.read_string( "path", "", false, false, true );
+		if ( ! sLibraryPath.isEmpty() ) {
+			Entry entry;
+			entry.nModified = libraryNode.read_string( "modified", "-1", false,
+													   false, true ).toLongLong();
+			entry.nSize = libraryNode.read_string( "size", "-1", false,
+												   false, true ).toLongLong();
+
+			XMLNode pluginNode = libraryNode.firstChildElement( "plugin" );
+			while ( ! pluginNode.isNull() ) {
+				auto pFX = std::make_shared<LadspaFXInfo>(
+					pluginNode.read_string( "name", "", true, true, true ) );
+				pFX->m_sFileName = sLibraryPath;
+				pFX->m_sLabel = pluginNode.read_string( "label", "", true, true, true );
+				pFX->m_sID = pluginNode.read_string( "id", "", true, true, true );
+				pFX->m_sMaker = pluginNode.read_string( "maker", "", true, true, true );
+				pFX->m_sCopyright =
+					pluginNode.read_string( "copyright", "", true, true, true );
+				pFX->m_nICPorts = pluginNode.read_int( "icPorts", 0, true, true, true );
+				pFX->m_nOCPorts = pluginNode.read_int( "ocPorts", 0, true, true, true );
+				pFX->m_nIAPorts = pluginNode.read_int( "iaPorts", 0, true, true, true );
+				pFX->m_nOAPorts = pluginNode.read_int( "oaPorts", 0, true, true, true );
+				entry.plugins.push_back( pFX );
+
+				pluginNode = pluginNode.nextSiblingElement( "plugin" );
+			}
+
+			m_entries[ sLibraryPath ] = entry;
+		}
+
+		libraryNode = libraryNode.nextSiblingElement( "library" );
+	}
+
+	return true;
+}
+
+bool LadspaCatalogue::save() const
+{
+	XMLDoc doc;
+	XMLNode rootNode = doc.set_root( "ladspa_catalogue" );
+	rootNode.write_int( "formatVersion", nFormatVersion );
+
+	XMLNode libraryListNode = rootNode.createNode( "libraryList" );
+	for ( const auto& [ ssPath, eentry ] : m_entries ) {
+		XMLNode libraryNode = libraryListNode.createNode( "library" );
+		libraryNode.write_string( "path", ssPath );
+		libraryNode.write_string( "modified", QString::number( eentry.nModified ) );
+		libraryNode.write_string( "size", QString::number( eentry.nSize ) );
+
+		for ( const auto& ppFX : eentry.plugins ) {
+			XMLNode pluginNode = libraryNode.createNode( "plugin" );
+			pluginNode.write_string( "name", ppFX->m_sName );
+			pluginNode.write_string( "label", ppFX->m_sLabel );
+			pluginNode.write_string( "id", ppFX->m_sID );
+			pluginNode.write_string( "maker", ppFX->m_sMaker );
+			pluginNode.write_string( "copyright", ppFX->m_sCopyright );
+			pluginNode.write_int( "icPorts", ppFX->m_nICPorts );
+			pluginNode.write_int( "ocPorts", ppFX->m_nOCPorts );
+			pluginNode.write_int( "iaPorts", ppFX->m_nIAPorts );
+			pluginNode.write_int( "oaPorts", ppFX->m_nOAPorts );
+		}
+	}
+
+	if ( ! doc.write( m_sPath ) ) {
+		ERRORLOG( QString( "Unable to write LADSPA catalogue [%1]" ).arg( m_sPath ) );
+		return false;
+	}
+
+	return true;
+}
+
+};
+
+#endif // H2CORE_HAVE_LADSPA
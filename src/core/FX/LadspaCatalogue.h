@@ -0,0 +1,107 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef LADSPA_CATALOGUE_H
+#define LADSPA_CATALOGUE_H
+
+#include <core/config.h>
+#if defined(H2CORE_HAVE_LADSPA) || _DOXYGEN_
+
+#include <core/FX/LadspaFX.h>
+#include <core/Object.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QStringList>
+
+namespace H2Core
+{
+
+/**
+ * Descriptors of all LADSPA plugins found in a set of directories cached in
+ * a file.
+ *
+ * Each library is stored along with its modification time and size and is
+ * only loaded again in case one of them changed. Libraries without
+ * supported plugins are recorded as well.
+ */
+/** \ingroup docCore docAudioEngine */
+class LadspaCatalogue : public H2Core::Object<LadspaCatalogue>
+{
+	H2_OBJECT(LadspaCatalogue)
+public:
+	/** Content of the catalogue for a single library. */
+	struct Entry {
+		qint64 nModified = -1;
+		qint64 nSize = -1;
+		/** Supported plugins provided by the library. Might be empty. */
+		std::vector< std::shared_ptr<LadspaFXInfo> > plugins;
+	};
+
+	/** \param sPath Absolute path of the file the catalogue is stored in. */
+	LadspaCatalogue( const QString& sPath );
+	~LadspaCatalogue();
+
+	/** Reads the catalogue from disk.
+	 *
+	 * \return `false` in case there is no catalogue file or it is
+	 *   outdated. */
+	bool load();
+	bool save() const;
+
+	/** Synchronizes the catalogue with the libraries in @a directories.
+	 * Only new and modified libraries are loaded. Entries of removed ones
+	 * are dropped.
+	 *
+	 * \return whether the catalogue changed. */
+	bool update( const QStringList& directories );
+
+	/** \return all supported plugins in alphabetic order. */
+	std::vector< std::shared_ptr<LadspaFXInfo> > getPlugins() const;
+	/** Keyed by the absolute path of the plugin library. */
+	const std::map<QString, Entry>& getEntries() const;
+
+private:
+	/** Loads the library in @a sLibraryPath and returns all supported
+	 * plugins it provides. */
+	static std::vector< std::shared_ptr<LadspaFXInfo> > loadLibrary(
+		const QString& sLibraryPath );
+
+	/** Bumped whenever the layout of the catalogue file changes. */
+	static constexpr int nFormatVersion = 1;
+
+	QString m_sPath;
+	std::map<QString, Entry> m_entries;
+};
+
+inline const std::map<QString, LadspaCatalogue::Entry>&
+LadspaCatalogue::getEntries() const
+{
+	return m_entries;
+}
+
+};
+
+#endif // H2CORE_HAVE_LADSPA
+
+#endif
@@ -21,18 +21,110 @@
 
 #include <core/Helpers/Random.h>
 
+#include <chrono>
+#include <cmath>
+#include <random>
+
 namespace H2Core {
 
+namespace {
+	/** Used to expand a seed into the state of xoshiro128+. */
+	uint64_t splitMix64( uint64_t& nState ) {
+		uint64_t nZ = ( nState += 0x9E3779B97F4A7C15ull );
+		nZ = ( nZ ^ ( nZ >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+		nZ = ( nZ ^ ( nZ >> 27 ) ) * 0x94D049BB133111EBull;
+		return nZ ^ ( nZ >> 31 );
+	}
+
+	constexpr float fTwoPi = 6.28318530717958647692f;
+}
+
+Random::Random( uint64_t nSeed ) {
+	seed( nSeed );
+}
+
+void Random::seed( uint64_t nSeed ) {
+	m_nSeed = nSeed;
+
+	uint64_t nState = nSeed;
+	const uint64_t nFirst = splitMix64( nState );
+	const uint64_t nSecond = splitMix64( nState );
+	m_state[ 0 ] = static_cast<uint32_t>( nFirst );
+	m_state[ 1 ] = static_cast<uint32_t>( nFirst >> 32 );
+	m_state[ 2 ] = static_cast<uint32_t>( nSecond );
+	m_state[ 3 ] = static_cast<uint32_t>( nSecond >> 32 );
+
+	m_fSpareGaussian = 0;
+	m_bHasSpareGaussian = false;
+}
+
+uint64_t Random::createSeed() {
+	std::random_device device;
+	const uint64_t nDevice =
+		( static_cast<uint64_t>( device() ) << 32 ) ^ device();
+	// Some platforms provide a deterministic random_device.
+	const uint64_t nTime = static_cast<uint64_t>(
+		std::chrono::high_resolution_clock::now().time_since_epoch().count() );
+	return nDevice ^ nTime;
+}
+
 float Random::getGaussian( float fStandardDeviation ) {
-	// gaussian distribution -- dimss
-	float x1, x2, w;
-	do {
-		x1 = 2.0 * ( ( ( float ) rand() ) / static_cast<float>(RAND_MAX) ) - 1.0;
-		x2 = 2.0 * ( ( ( float ) rand() ) / static_cast<float>(RAND_MAX) ) - 1.0;
-		w = x1 * x1 + x2 * x2;
-	} while ( w >= 1.0 );
-
-	w = sqrtf( ( -2.0 * logf( w ) ) / w );
-	return x1 * w * fStandardDeviation + 0.0; // tunable
+	if ( m_bHasSpareGaussian ) {
+		m_bHasSpareGaussian = false;
+		return m_fSpareGaussian * fStandardDeviation;
+	}
+
+	const float fRadius = std::sqrt( -2.0f * std::log( getUniformNonZero() ) );
+	const float fAngle = fTwoPi * getUniform();
+
+	m_fSpareGaussian = fRadius * std::sin( fAngle );
+	m_bHasSpareGaussian = true;
+
+	return fRadius * std::cos( fAngle ) * fStandardDeviation;
 }
+
+void Random::fillGaussian( float* pValues, int nValues,
+						   float fStandardDeviation ) {
+	// Uniform variables are drawn first since the generator itself is
+	// inherently sequential. The transformation of both halves of each pair
+	// is done in independent loops without branches.
+	const int nPairs = nValues / 2;
+	for ( int ii = 0; ii < nPairs; ++ii ) {
+		pValues[ 2 * ii ] = getUniformNonZero();
+		pValues[ 2 * ii + 1 ] = getUniform();
+	}
+	for ( int ii = 0; ii < nPairs; ++ii ) {
+		const float fRadius = std::sqrt( -2.0f * std::log( pValues[ 2 * ii ] ) ) *
+			fStandardDeviation;
+		const float fAngle = fTwoPi * pValues[ 2 * ii + 1 ];
+		pValues[ 2 * ii ] = fRadius * std::cos( fAngle );
+		pValues[ 2 * ii + 1 ] = fRadius * std::sin( fAngle );
+	}
+
+	if ( nValues % 2 != 0 ) {
+		pValues[ nValues - 1 ] = getGaussian( fStandardDeviation );
+	}
+}
+
+QString Random::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[Random]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nSeed: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nSeed ) )
+			.append( QString( "%1%2m_state: [%3, %4, %5, %6]\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_state[ 0 ] ).arg( m_state[ 1 ] )
+					 .arg( m_state[ 2 ] ).arg( m_state[ 3 ] ) );
+	}
+	else {
+		sOutput = QString( "[Random] m_nSeed: %1" ).arg( m_nSeed )
+			.append( QString( ", m_state: [%1, %2, %3, %4]" )
+					 .arg( m_state[ 0 ] ).arg( m_state[ 1 ] )
+					 .arg( m_state[ 2 ] ).arg( m_state[ 3 ] ) );
+	}
+
+	return sOutput;
+}
+
 };
@@ -22,13 +22,24 @@
 #ifndef H2C_RANDOM_H
 #define H2C_RANDOM_H
 
+#include <array>
+#include <cstdint>
+
 #include <core/Object.h>
 
 namespace H2Core
 {
 
 /**
- * Container for functions generating random number.
+ * Seedable pseudo random number generator based on xoshiro128+.
+ *
+ * In contrast to `rand()` it does not use any global state or locks and
+ * the sequence of numbers drawn depends on the seed only. This makes it
+ * usable within the audio thread and allows for reproducible renderings.
+ *
+ * An instance must not be shared between threads without external
+ * synchronization. The one used for playback is owned by the #AudioEngine
+ * and only accessed while it is locked.
  *
  * \ingroup docCore
  */
@@ -36,15 +47,101 @@ class Random : public H2Core::Object<Random>
 {
 	H2_OBJECT(Random)
 public:
+	/** @param nSeed Any value - including 0 - is a valid seed. */
+	explicit Random( uint64_t nSeed = 0 );
+
+	/** Resets the state of the generator. Two instances seeded with the
+	 * same value yield identical sequences. */
+	void seed( uint64_t nSeed );
+	uint64_t getSeed() const;
+
+	/** \return a seed which differs between calls and runs. */
+	static uint64_t createSeed();
+
+	/** \return uniformly distributed 32 bit value. */
+	uint32_t next();
+	/** \return uniformly distributed value within [0, 1). */
+	float getUniform();
+	/** \return uniformly distributed integer within [0, @a nMax). @a nMax
+	 * must be positive. */
+	int getInt( int nMax );
+
 	/**
-	 * Draws an uncorrelated random value from a Gaussian distribution
-	 * of mean 0 and @a fStandardDeviation.
+	 * Draws a random value from a Gaussian distribution of mean 0 and @a
+	 * fStandardDeviation.
+	 *
+	 * Values are generated in pairs using the Box-Muller transform. The
+	 * second one is kept for the next call.
 	 *
 	 * @param fStandardDeviation Defines the width of the distribution used.
 	 */
-	static float getGaussian( float fStandardDeviation );
+	float getGaussian( float fStandardDeviation );
+	/**
+	 * Fills @a pValues with @a nValues values drawn from a Gaussian
+	 * distribution of mean 0 and @a fStandardDeviation.
+	 *
+	 * The transformation is done in a separate pass free of branches and
+	 * can be vectorized by the compiler.
+	 */
+	void fillGaussian( float* pValues, int nValues, float fStandardDeviation );
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	/** \return uniformly distributed value within (0, 1]. Safe to pass to
+	 * `log()`. */
+	float getUniformNonZero();
+
+	uint64_t m_nSeed;
+	std::array<uint32_t, 4> m_state;
+	/** Second value of the last Box-Muller pair for a standard deviation
+	 * of 1. */
+	float m_fSpareGaussian;
+	bool m_bHasSpareGaussian;
 };
 
+inline uint64_t Random::getSeed() const {
+	return m_nSeed;
+}
+
+inline uint32_t Random::next() {
+	// xoshiro128+ by David Blackman and Sebastiano Vigna (public domain).
+	// The lowest bits have low linear complexity. We only ever use the
+	// upper ones.
+	const uint32_t nResult = m_state[ 0 ] + m_state[ 3 ];
+	const uint32_t nT = m_state[ 1 ] << 9;
+
+	m_state[ 2 ] ^= m_state[ 0 ];
+	m_state[ 3 ] ^= m_state[ 1 ];
+	m_state[ 1 ] ^= m_state[ 2 ];
+	m_state[ 0 ] ^= m_state[ 3 ];
+	m_state[ 2 ] ^= nT;
+	m_state[ 3 ] = ( m_state[ 3 ] << 11 ) | ( m_state[ 3 ] >> 21 );
+
+	return nResult;
+}
+
+inline float Random::getUniform() {
+	return static_cast<float>( next() >> 8 ) * ( 1.0f / 16777216.0f );
+}
+
+inline float Random::getUniformNonZero() {
+	return static_cast<float>( ( next() >> 8 ) + 1 ) * ( 1.0f / 16777216.0f );
+}
+
+inline int Random::getInt( int nMax ) {
+	return static_cast<int>(
+		( static_cast<uint64_t>( next() ) * static_cast<uint64_t>( nMax ) ) >> 32 );
+}
+
 };
 
 #endif  // H2C_RANDOM_H
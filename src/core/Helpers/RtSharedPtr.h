@@ -0,0 +1,89 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef RT_SHARED_PTR_H
+#define RT_SHARED_PTR_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace H2Core {
+
+/**
+ * Immutable object created outside of the audio thread and read by it
+ * without locking.
+ *
+ * Writers replace the current instance using publish(). The previous one
+ * is not released right away but moved to a retirement list. Entries of
+ * this list are only dropped - within a subsequent call to publish() - once
+ * no reader holds a reference anymore. This way the audio thread never ends
+ * up deallocating an instance, regardless of how many of them were
+ * published while it was still working on an old one.
+ *
+ * publish() must not be called from within the audio thread.
+ */
+template <class T>
+class RtSharedPtr {
+public:
+	RtSharedPtr() = default;
+	RtSharedPtr( const RtSharedPtr& ) = delete;
+	RtSharedPtr& operator=( const RtSharedPtr& ) = delete;
+
+	/** Lock-free and real-time safe. */
+	std::shared_ptr<const T> load() const {
+		return std::atomic_load( &m_pCurrent );
+	}
+
+	void publish( std::shared_ptr<const T> pNew ) {
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		auto pPrevious = std::atomic_exchange( &m_pCurrent, pNew );
+		if ( pPrevious != nullptr ) {
+			m_retired.push_back( pPrevious );
+		}
+
+		// Since the instances are not reachable via #m_pCurrent anymore, no
+		// reader is able to pick them up again once their reference count
+		// dropped to the one held by the list.
+		for ( auto it = m_retired.begin(); it != m_retired.end(); ) {
+			if ( it->use_count() == 1 ) {
+				it = m_retired.erase( it );
+			}
+			else {
+				++it;
+			}
+		}
+	}
+
+private:
+	/** Must only be accessed using `std::atomic_load()` and
+	 * `std::atomic_exchange()`. */
+	std::shared_ptr<const T> m_pCurrent;
+	/** Replaced instances possibly still used by a reader. */
+	std::vector<std::shared_ptr<const T>> m_retired;
+	/** Serializes writers. */
+	std::mutex m_mutex;
+};
+
+};
+
+#endif
@@ -26,6 +26,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QLocale>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtCore/QTextStream>
 
 #ifdef H2CORE_HAVE_QT6
@@ -291,6 +292,65 @@ XMLDoc::XMLDoc( const QString& sSerialized ) {
 	setContent( sSerialized );
 }
 
+XMLStreamReader::XMLStreamReader( QIODevice* pDevice )
+	: QXmlStreamReader( pDevice ) { }
+
+QString XMLStreamReader::read_string( const QString& sDefaultValue )
+{
+	const QString sText = readElementText( QXmlStreamReader::IncludeChildElements );
+	if ( sText.isEmpty() && ! sDefaultValue.isEmpty() ) {
+		return sDefaultValue;
+	}
+	return sText;
+}
+
+float XMLStreamReader::read_float( float default_value, bool* pFound )
+{
+	const QString sText = readElementText( QXmlStreamReader::IncludeChildElements );
+	if ( pFound != nullptr ) {
+		*pFound = ! sText.isEmpty();
+	}
+	if ( sText.isEmpty() ) {
+		return default_value;
+	}
+	bool bOk;
+	const float fValue = QLocale::c().toFloat( sText, &bOk );
+	if ( ! bOk ) {
+		WARNINGLOG( QString( "Invalid value [%1]. Using default value %2 for %3" )
+					.arg( sText ).arg( default_value ).arg( name() ) );
+		if ( pFound != nullptr ) {
+			*pFound = false;
+		}
+		return default_value;
+	}
+	return fValue;
+}
+
+int XMLStreamReader::read_int( int default_value )
+{
+	const QString sText = readElementText( QXmlStreamReader::IncludeChildElements );
+	if ( sText.isEmpty() ) {
+		return default_value;
+	}
+	bool bOk;
+	const int nValue = QLocale::c().toInt( sText, &bOk );
+	if ( ! bOk ) {
+		WARNINGLOG( QString( "Invalid value [%1]. Using default value %2 for %3" )
+					.arg( sText ).arg( default_value ).arg( name() ) );
+		return default_value;
+	}
+	return nValue;
+}
+
+bool XMLStreamReader::read_bool( bool default_value )
+{
+	const QString sText = readElementText( QXmlStreamReader::IncludeChildElements );
+	if ( sText.isEmpty() ) {
+		return default_value;
+	}
+	return sText == "true";
+}
+
 bool XMLDoc::read( const QString& sFilePath, bool bSilent ) {
 	
 	QFile file( sFilePath );
@@ -324,6 +384,93 @@ bool XMLDoc::read( const QString& sFilePath, bool bSilent ) {
 	return true;
 }
 
+bool XMLDoc::read( const QString& sFilePath, const QString& sStreamedElement,
+				   const StreamHandler& handler, bool bSilent ) {
+
+	QFile file( sFilePath );
+	if ( !file.open( QIODevice::ReadOnly ) ) {
+		ERRORLOG( QString( "Unable to open [%1] for reading" )
+				  .arg( sFilePath ) );
+		return false;
+	}
+
+	if ( Legacy::checkTinyXMLCompatMode( &file ) ) {
+		file.close();
+		return read( sFilePath, bSilent );
+	}
+	file.seek( 0 );
+
+	const QStringList streamedPath = sStreamedElement.split( '/' );
+	QStringList path;
+	QDomNode parent = *this;
+
+	XMLStreamReader reader( &file );
+	// Keep namespace declarations as plain attributes just like
+	// setContent() does.
+	reader.setNamespaceProcessing( false );
+	while ( ! reader.atEnd() ) {
+		switch ( reader.readNext() ) {
+		case QXmlStreamReader::StartElement: {
+			const QString sName = reader.qualifiedName().toString();
+			path << sName;
+			if ( path == streamedPath ) {
+				handler( reader );
+				path.removeLast();
+				break;
+			}
+
+			QDomElement element = createElement( sName );
+			for ( const auto& aattribute : reader.attributes() ) {
+				element.setAttribute( aattribute.qualifiedName().toString(),
+									  aattribute.value().toString() );
+			}
+			parent.appendChild( element );
+			parent = element;
+			break;
+		}
+
+		case QXmlStreamReader::EndElement:
+			path.removeLast();
+			parent = parent.parentNode();
+			break;
+
+		case QXmlStreamReader::Characters:
+			if ( reader.isCDATA() ) {
+				parent.appendChild(
+					createCDATASection( reader.text().toString() ) );
+			}
+			else if ( ! reader.isWhitespace() ) {
+				// setContent() drops whitespace-only text nodes as well.
+				parent.appendChild( createTextNode( reader.text().toString() ) );
+			}
+			break;
+
+		case QXmlStreamReader::Comment:
+			parent.appendChild( createComment( reader.text().toString() ) );
+			break;
+
+		case QXmlStreamReader::ProcessingInstruction:
+			parent.appendChild( createProcessingInstruction(
+				reader.processingInstructionTarget().toString(),
+				reader.processingInstructionData().toString() ) );
+			break;
+
+		default:
+			break;
+		}
+	}
+	file.close();
+
+	if ( reader.hasError() ) {
+		ERRORLOG( QString( "Unable to read XML document [%1]: %2 (line %3, column %4)" )
+				  .arg( sFilePath ).arg( reader.errorString() )
+				  .arg( reader.lineNumber() ).arg( reader.columnNumber() ) );
+		return false;
+	}
+
+	return true;
+}
+
 bool XMLDoc::write( const QString& sFilePath )
 {
 	QFile file( sFilePath );
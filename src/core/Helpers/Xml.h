@@ -23,8 +23,11 @@
 #ifndef H2C_XML_H
 #define H2C_XML_H
 
+#include <functional>
+
 #include <core/Object.h>
 #include <QtCore/QString>
+#include <QtCore/QXmlStreamReader>
 #include <QColor>
 #include <QtXml/QDomDocument>
 
@@ -193,6 +196,50 @@ class XMLNode : public H2Core::Object<XMLNode>, public QDomNode
 		void write_child_node( const QString& node, const QString& text );
 };
 
+/**
+ * XMLStreamReader is a subclass of QXmlStreamReader with methods reading
+ * the text of the current element as values.
+ *
+ * In contrast to #XMLNode, child elements are not looked up by name. Loaders
+ * iterate all children once using readNextStartElement(), dispatch on
+ * name(), and call one of the read methods below (or skipCurrentElement()
+ * for unknown ones).
+*/
+/** \ingroup docCore*/
+class XMLStreamReader : public H2Core::Object<XMLStreamReader>, public QXmlStreamReader
+{
+		H2_OBJECT(XMLStreamReader)
+	public:
+		XMLStreamReader( QIODevice* pDevice );
+
+		/**
+		 * reads the text of the current element as integer
+		 *
+		 * Has to be called on a StartElement token and consumes everything
+		 * up to and including the corresponding EndElement.
+		 * \param default_value the value returned if the element is empty
+		 *   or does not contain a valid integer
+		 */
+		int read_int( int default_value );
+		/**
+		 * reads the text of the current element as boolean
+		 * \param default_value the value returned if the element is empty
+		 */
+		bool read_bool( bool default_value );
+		/**
+		 * reads the text of the current element as float
+		 * \param default_value the value returned if the element is empty
+		 *   or does not contain a valid number
+		 * \param pFound Indicates whether a valid value was found.
+		 */
+		float read_float( float default_value, bool* pFound = nullptr );
+		/**
+		 * reads the text of the current element
+		 * \param default_value the value returned if the element is empty
+		 */
+		QString read_string( const QString& default_value );
+};
+
 /**
  * XMLDoc is a subclass of QDomDocument with read and write methods
 */
@@ -211,6 +258,35 @@ class XMLDoc : public H2Core::Object<XMLDoc>, public QDomDocument
 		 *   when anomalies are encountered while reading the XML nodes.
 		 */
 	bool read( const QString& sFilePath, bool bSilent = false );
+
+		/**
+		 * Loads an element directly from the stream. The reader is
+		 * positioned at its StartElement token and the handler has to
+		 * consume everything up to and including the corresponding
+		 * EndElement.
+		 */
+		typedef std::function<void(XMLStreamReader&)> StreamHandler;
+		/**
+		 * read the content of an xml file in a single pass
+		 *
+		 * All elements but the one at @a sStreamedElement are stored in the
+		 * document just like in read(). The latter - usually the one
+		 * holding the bulk of the data, like the patterns of a song - is
+		 * handed to @a handler instead and does never end up in the DOM.
+		 *
+		 * Documents written by TinyXML are converted and read as a whole
+		 * using read(). @a handler is not called in this case and the
+		 * caller has to fall back to load the element from the document.
+		 *
+		 * \param sFilePath the path to the file to read from
+		 * \param sStreamedElement path of the element starting at the root
+		 *   node, e.g. "song/patternList"
+		 * \param handler called for the element
+		 * \param bSilent Whether debug and info messages should be logged
+		 *   when anomalies are encountered while reading the XML nodes.
+		 */
+	bool read( const QString& sFilePath, const QString& sStreamedElement,
+			   const StreamHandler& handler, bool bSilent = false );
 		/**
 		 * write itself into a file
 		 * \param sFilePath the path to the file to write to
@@ -54,6 +54,7 @@
 #include <core/FX/LadspaFX.h>
 #include <core/H2Exception.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Random.h>
 #include <core/Helpers/TimeHelper.h>
 #include <core/IO/AlsaAudioDriver.h>
 #include <core/IO/AlsaMidiDriver.h>
@@ -91,7 +92,8 @@ namespace H2Core
 
 Hydrogen* Hydrogen::__instance = nullptr;
 
-Hydrogen::Hydrogen() : m_fBeatCounterBeatLength( 1 )
+Hydrogen::Hydrogen() : m_nSongGeneration( 0 )
+					 , m_fBeatCounterBeatLength( 1 )
 					 , m_nBeatCounterTotalBeats( 4 )
 					 , m_nBeatCounterEventCount( 1 )
 					 , m_nBeatCounterBeatCount( 1 )
@@ -124,6 +126,7 @@ Hydrogen::Hydrogen() : m_fBeatCounterBeatLength( 1 )
 
 	m_pSoundLibraryDatabase = std::make_shared<SoundLibraryDatabase>();
 	m_pSong = Song::getEmptySong( m_pSoundLibraryDatabase );
+	updateColumnIndex();
 
 	m_pAudioEngine = new AudioEngine();
 	m_pMidiActionManager = std::make_shared<MidiActionManager>();
@@ -244,6 +247,23 @@ void Hydrogen::setSong( std::shared_ptr<Song> pSong )
 		return;
 	}
 
+	std::shared_ptr<Drumkit> pCurrentDrumkit =
+		pCurrentSong != nullptr ? pCurrentSong->getDrumkit() : nullptr;
+
+	// Decoding all samples of a drumkit can take several seconds. This is done
+	// before locking the audio engine in order to not starve the audio thread
+	// while the current song is still played back. Loading replaces the sample
+	// data. Instruments shared with the current drumkit are still rendered and
+	// must not be touched.
+	if ( pSong != nullptr && pSong->getDrumkit() != nullptr &&
+		 pSong->getDrumkit() != pCurrentDrumkit ) {
+		pSong->getDrumkit()->loadSamples( 120, 0, pCurrentDrumkit );
+	}
+
+	// Drumkit of the current song to be released once the new one is in
+	// place.
+	std::shared_ptr<Drumkit> pOldDrumkit = nullptr;
+
 	m_pAudioEngine->lock( RIGHT_HERE );
 
 	// Move to the beginning.
@@ -265,8 +285,10 @@ void Hydrogen::setSong( std::shared_ptr<Song> pSong )
 		}
 		m_pAudioEngine->prepare( Event::Trigger::Suppress );
 
-		if ( pCurrentSong->getDrumkit() != nullptr ) {
-			pCurrentSong->getDrumkit()->unloadSamples();
+		if ( pCurrentSong->getDrumkit() != nullptr &&
+			 ( pSong == nullptr ||
+			   pSong->getDrumkit() != pCurrentSong->getDrumkit() ) ) {
+			pOldDrumkit = pCurrentSong->getDrumkit();
 		}
 	}
 
@@ -277,9 +299,8 @@ void Hydrogen::setSong( std::shared_ptr<Song> pSong )
 	// are activated, m_pSong has to be set prior to the call of
 	// AudioEngine::setSong().
 	m_pSong = pSong;
-	if ( pSong != nullptr && pSong->getDrumkit() != nullptr ) {
-		pSong->getDrumkit()->loadSamples();
-	}
+	++m_nSongGeneration;
+	updateColumnIndex();
 
 	// Ensure the selected instrument is within the range of new
 	// instrument list.
@@ -295,17 +316,73 @@ void Hydrogen::setSong( std::shared_ptr<Song> pSong )
 
 	m_pAudioEngine->unlock();
 
+	// All notes referencing the previous drumkit were already discarded in
+	// AudioEngine::prepare(). Its samples can be freed without holding the
+	// lock. Instruments shared with the new drumkit are kept.
+	if ( pOldDrumkit != nullptr ) {
+		pOldDrumkit->unloadSamples(
+			pSong != nullptr ? pSong->getDrumkit() : nullptr );
+	}
+
 	// Push current state of Hydrogen to attached control interfaces,
 	// like OSC clients.
 	CoreActionController::initExternalControlInterfaces();
 }
 
-void Hydrogen::midiNoteOn( std::shared_ptr<Note> pNote )
+bool Hydrogen::addRealtimeNote(
+	int nInstrument,
+	float fVelocity,
+	bool bNoteOff,
+	Midi::Note note,
+	const TimePoint& timePoint
+)
 {
-	m_pAudioEngine->noteOn( pNote );
+	const auto pPref = Preferences::get_instance();
+	const bool bPlaySelectedInstrument = pPref->getMidiInstrumentMap()->getInput() ==
+		MidiInstrumentMap::Input::SelectedInstrument;
+
+	std::shared_ptr<Song> pSong = getSong();
+
+	if ( pSong == nullptr ) {
+		ERRORLOG( "No song set yet" );
+		return false;
+	}
+
+	if ( nInstrument < 0 ) {
+		ERRORLOG( QString( "Invalid instrument number [%1]" ).arg( nInstrument ) );
+		return false;
+	}
+
+	// Only recording requires the audio engine to be locked.
+	if ( m_bRecordEnabled &&
+		 m_pAudioEngine->getState() == AudioEngine::State::Playing &&
+		 ! recordRealtimeNote( pSong, nInstrument, fVelocity, bNoteOff, note ) ) {
+		return false;
+	}
+
+	// Play back the note. The instrument list of the drumkit must not be
+	// accessed without locking the audio engine. The note is thus passed by
+	// index and the audio engine resolves it within its next process cycle.
+	LiveNoteQueue::LiveNote liveNote;
+	liveNote.nInstrument = nInstrument;
+	liveNote.fVelocity = fVelocity;
+	liveNote.bNoteOff = bNoteOff;
+	liveNote.bUseKey = bPlaySelectedInstrument && note != Midi::NoteInvalid;
+	liveNote.key = liveNote.bUseKey ? Note::keyFrom( note ) : Note::KeyDefault;
+	liveNote.octave =
+		liveNote.bUseKey ? Note::octaveFrom( note ) : Note::OctaveDefault;
+	liveNote.timePoint = timePoint;
+	if ( ! m_pAudioEngine->getLiveNoteQueue()->push( liveNote ) ) {
+		ERRORLOG( QString( "Live note queue full. Dropping note for instrument [%1]" )
+				  .arg( nInstrument ) );
+		return false;
+	}
+
+	return true;
 }
 
-bool Hydrogen::addRealtimeNote(
+bool Hydrogen::recordRealtimeNote(
+	std::shared_ptr<Song> pSong,
 	int nInstrument,
 	float fVelocity,
 	bool bNoteOff,
@@ -313,9 +390,7 @@ bool Hydrogen::addRealtimeNote(
 )
 {
 	AudioEngine* pAudioEngine = m_pAudioEngine;
-	auto pSampler = pAudioEngine->getSampler();
 	const auto pPref = Preferences::get_instance();
-	unsigned int nRealColumn = 0;
 	unsigned res = pPref->getPatternEditorGridResolution();
 	int nBase = pPref->isPatternEditorUsingTriplets() ? 3 : 4;
 	const bool bPlaySelectedInstrument = pPref->getMidiInstrumentMap()->getInput() ==
@@ -323,29 +398,22 @@ bool Hydrogen::addRealtimeNote(
 	int scalar = ( 4 * 4 * H2Core::nTicksPerQuarter ) / ( res * nBase );
 	int currentPatternNumber;
 
-	std::shared_ptr<Song> pSong = getSong();
+	m_pAudioEngine->lock( RIGHT_HERE );
 
-	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
-		ERRORLOG( "No song set yet" );
+	if ( pSong->getDrumkit() == nullptr ) {
+		pAudioEngine->unlock();
+		ERRORLOG( "No drumkit set yet" );
 		return false;
 	}
-
-	m_pAudioEngine->lock( RIGHT_HERE );
-	
-	if ( nInstrument >= pSong->getDrumkit()->getInstruments()->size() ||
-	     nInstrument < 0 ) {
-          ERRORLOG( QString("Provided instrument number [%1] out of bound [0,%2]")
-                  .arg(nInstrument)
-                  .arg( pSong->getDrumkit()->getInstruments()->size() ) );
-	  pAudioEngine->unlock();
-	  return false;
-	}
-	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( nInstrument );
-    if ( pInstrument == nullptr ) {
-      ERRORLOG( QString( "Unable to obtain instrument [%1]" ).arg( nInstrument ) );
-      pAudioEngine->unlock();
-      return false;
-    }
+	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+	if ( ! pInstrumentList->isValidIndex( nInstrument ) ) {
+		const int nSize = pInstrumentList->size();
+		pAudioEngine->unlock();
+		ERRORLOG( QString( "Provided instrument number [%1] out of bound [0,%2]" )
+				  .arg( nInstrument ).arg( nSize ) );
+		return false;
+	}
+	auto pInstrument = pInstrumentList->get( nInstrument );
 	const auto instrumentId = pInstrument->getId();
 
 	// Get current pattern and column
@@ -512,45 +580,6 @@ bool Hydrogen::addRealtimeNote(
 		}
 	}
 
-	// Play back the note.
-	if ( ! pInstrument->hasSamples() ) {
-		pAudioEngine->unlock();
-		return true;
-	}
-	
-	if ( bPlaySelectedInstrument && note != Midi::NoteInvalid ) {
-		if ( bNoteOff ) {
-			if ( pSampler->isInstrumentPlaying( pInstrument ) ) {
-				pSampler->midiKeyboardNoteOff(
-					pInstrument, Note::keyFrom( note ), Note::octaveFrom( note )
-				);
-			}
-		}
-		else { // note on
-			auto pNote2 = std::make_shared<Note>(
-				pInstrument, nRealColumn, fVelocity, fPan
-			);
-
-			pNote2->setKey( Note::keyFrom( note ) );
-			pNote2->setOctave( Note::octaveFrom( note ) );
-			midiNoteOn( pNote2 );
-		}
-	}
-	else {
-		if ( bNoteOff ) {
-			if ( pSampler->isInstrumentPlaying( pInstrument ) ) {
-				auto pNoteOff = std::make_shared<Note>( pInstrument );
-				pNoteOff->setNoteOff( true );
-				midiNoteOn( pNoteOff );
-			}
-		}
-		else { // note on
-			auto pNote2 = std::make_shared<Note>(
-				pInstrument, nRealColumn, fVelocity, fPan );
-			midiNoteOn( pNote2 );
-		}
-	}
-
 	m_pAudioEngine->unlock(); // unlock the audio engine
 	return true;
 }
@@ -687,6 +716,9 @@ bool Hydrogen::startExportSession( int nSampleRate, int nSampleDepth,
 	pDiskWriterDriver->setSampleRate( static_cast<unsigned>(nSampleRate) );
 	pDiskWriterDriver->setSampleDepth( nSampleDepth );
 	pDiskWriterDriver->setCompressionLevel( fCompressionLevel );
+	// The map published while creating the driver was done for its default
+	// sample rate.
+	pAudioEngine->updateTempoMap();
 
 	m_bExportSessionIsActive = true;
 
@@ -694,16 +726,26 @@ bool Hydrogen::startExportSession( int nSampleRate, int nSampleDepth,
 }
 
 /// Export a song to a wav file
-void Hydrogen::startExportSong( const QString& sFileName)
+void Hydrogen::startExportSong( const QString& sFileName,
+								const std::map<Instrument::Id, QString>& stems )
 {
 	AudioEngine* pAudioEngine = m_pAudioEngine;
 	CoreActionController::locateToTick( 0 );
 	pAudioEngine->play();
 	pAudioEngine->getSampler()->stopPlayingNotes();
 
+	// Random contributions are drawn from the same sequence in each export
+	// to render identical files.
+	if ( m_pSong != nullptr ) {
+		pAudioEngine->lock( RIGHT_HERE );
+		pAudioEngine->getRandom()->seed( m_pSong->getRandomSeed() );
+		pAudioEngine->unlock();
+	}
+
 	auto pDiskWriterDriver =
 		std::dynamic_pointer_cast<DiskWriterDriver>( pAudioEngine->getAudioDriver() );
 	pDiskWriterDriver->setFileName( sFileName );
+	pDiskWriterDriver->setStems( stems );
 	pDiskWriterDriver->write();
 }
 
@@ -1105,9 +1147,9 @@ void Hydrogen::killInstruments() {
 	if ( m_instrumentDeathRow.size() > 0 ) {
 		pInstr = m_instrumentDeathRow.front();
 		if ( pInstr != nullptr ) {
-			INFOLOG( QString( "Instrument [%1] still has active notes:\n\t%2 " )
+			INFOLOG( QString( "Instrument [%1] still has [%2] active notes" )
 					 .arg( pInstr->getName() )
-					 .arg( pInstr->getEnqueuedBy().join( "\n\t" ) ) );
+					 .arg( pInstr->getQueued() ) );
 		}
 	}
 
@@ -1409,10 +1451,46 @@ int Hydrogen::getColumnForTick( long nTick, bool bLoopMode, long* pPatternStartT
 		return nColumn;
 	}
 
-	long nTotalTick = 0;
+	const auto pIndex = getColumnIndex( pSong );
+	if ( pIndex == nullptr ) {
+		// The song was altered without updating the index. Scan all columns
+		// instead.
+		const auto pColumns = pSong->getPatternGroupVector();
+		if ( pColumns->size() == 0 ) {
+			*pPatternStartTick = 0;
+			return 0;
+		}
+
+		long nTotalTick = 0;
+		for ( const auto& ppColumn : *pColumns ) {
+			nTotalTick += getColumnLength( ppColumn );
+		}
+
+		long nTickInSong = nTick;
+		if ( nTick < 0 || nTick >= nTotalTick ) {
+			if ( ! bLoopMode || nTotalTick == 0 || nTick % nTotalTick < 0 ) {
+				*pPatternStartTick = 0;
+				return -1;
+			}
+			nTickInSong = nTick % nTotalTick;
+		}
+
+		long nStartTick = 0;
+		for ( int ii = 0; ii < pColumns->size(); ++ii ) {
+			const long nLength = getColumnLength( ( *pColumns )[ ii ] );
+			if ( nTickInSong < nStartTick + nLength ) {
+				*pPatternStartTick = nStartTick;
+				return ii;
+			}
+			nStartTick += nLength;
+		}
+
+		*pPatternStartTick = 0;
+		return -1;
+	}
 
-	auto pPatternColumns = pSong->getPatternGroupVector();
-	int nColumns = pPatternColumns->size();
+	const auto& startTicks = pIndex->columnStartTicks;
+	const int nColumns = static_cast<int>( startTicks.size() ) - 1;
 
 	if ( nColumns == 0 ) {
 		// There are no patterns in the current song.
@@ -1420,51 +1498,31 @@ int Hydrogen::getColumnForTick( long nTick, bool bLoopMode, long* pPatternStartT
 		return 0;
 	}
 
-	// Sum the lengths of all pattern columns and use four quarters in case some
-	// of them are of size zero. If the supplied value nTick is bigger than this
-	// and doesn't belong to the next pattern column, we just found the pattern
-	// list we were searching for.
-	int nPatternSize;
-	for ( int i = 0; i < nColumns; ++i ) {
-		auto pColumn = ( *pPatternColumns )[ i ];
-		if ( pColumn->size() != 0 ) {
-			nPatternSize = pColumn->longestPatternLength();
-		} else {
-			nPatternSize = 4 * H2Core::nTicksPerQuarter;
-		}
+	// Index of the column containing nTickInSong. Searching for the last
+	// start tick not exceeding it skips columns of zero length.
+	auto findColumn = [&]( long nTickInSong ) {
+		const auto it = std::upper_bound(
+			startTicks.begin(), startTicks.end(), nTickInSong );
+		return static_cast<int>( it - startTicks.begin() ) - 1;
+	};
 
-		if ( ( nTick >= nTotalTick ) && ( nTick < nTotalTick + nPatternSize ) ) {
-			( *pPatternStartTick ) = nTotalTick;
-			return i;
-		}
-		nTotalTick += nPatternSize;
+	const long nTotalTick = startTicks.back();
+	if ( nTick >= 0 && nTick < nTotalTick ) {
+		const int nColumn = findColumn( nTick );
+		*pPatternStartTick = startTicks[ nColumn ];
+		return nColumn;
 	}
 
 	// If the song is played in loop mode, the tick numbers of the
 	// second turn are added on top of maximum tick number of the
 	// song. Therefore, we will introduced periodic boundary
 	// conditions and start the search again.
-	if ( bLoopMode ) {
-		long nLoopTick = 0;
-		// nTotalTicks is now the same as m_nSongSizeInTicks
-		if ( nTotalTick != 0 ) {
-			nLoopTick = nTick % nTotalTick;
-		}
-		nTotalTick = 0;
-		for ( int i = 0; i < nColumns; ++i ) {
-			auto pColumn = ( *pPatternColumns )[ i ];
-			if ( pColumn->size() != 0 ) {
-				nPatternSize = pColumn->longestPatternLength();
-			} else {
-				nPatternSize = 4 * H2Core::nTicksPerQuarter;
-			}
-
-			if ( ( nLoopTick >= nTotalTick )
-				 && ( nLoopTick < nTotalTick + nPatternSize ) ) {
-				( *pPatternStartTick ) = nTotalTick;
-				return i;
-			}
-			nTotalTick += nPatternSize;
+	if ( bLoopMode && nTotalTick != 0 ) {
+		const long nLoopTick = nTick % nTotalTick;
+		if ( nLoopTick >= 0 ) {
+			const int nColumn = findColumn( nLoopTick );
+			*pPatternStartTick = startTicks[ nColumn ];
+			return nColumn;
 		}
 	}
 
@@ -1480,7 +1538,11 @@ long Hydrogen::getTickForColumn( int nColumn ) const
 		return static_cast<long>(nColumn * 4 * H2Core::nTicksPerQuarter);
 	}
 
-	const int nPatternGroups = pSong->getPatternGroupVector()->size();
+	const auto pIndex = getColumnIndex( pSong );
+	const auto pColumns = pSong->getPatternGroupVector();
+	const int nPatternGroups = pIndex != nullptr ?
+		static_cast<int>( pIndex->columnStartTicks.size() ) - 1 :
+		static_cast<int>( pColumns->size() );
 	if ( nPatternGroups == 0 ) {
 		// No patterns in song.
 		return 0;
@@ -1500,23 +1562,62 @@ long Hydrogen::getTickForColumn( int nColumn ) const
 		}
 	}
 
-	auto pColumns = pSong->getPatternGroupVector();
-	long totalTick = 0;
-	int nPatternSize;
+	if ( nColumn <= 0 ) {
+		return 0;
+	}
 
-	for ( int i = 0; i < nColumn; ++i ) {
-		auto pColumn = ( *pColumns )[ i ];
-		
-		if ( pColumn->size() > 0 ) {
-			nPatternSize = pColumn->longestPatternLength();
+	if ( pIndex == nullptr ) {
+		// The song was altered without updating the index.
+		long nStartTick = 0;
+		for ( int ii = 0; ii < nColumn; ++ii ) {
+			nStartTick += getColumnLength( ( *pColumns )[ ii ] );
 		}
-		else {
-			nPatternSize = 4 * H2Core::nTicksPerQuarter;
+		return nStartTick;
+	}
+
+	return pIndex->columnStartTicks[ nColumn ];
+}
+
+void Hydrogen::updateColumnIndex() {
+	auto pSong = getSong();
+	auto pIndex = std::make_shared<ColumnIndex>();
+	pIndex->nSongGeneration = m_nSongGeneration.load();
+	pIndex->columnStartTicks.push_back( 0 );
+	if ( pSong != nullptr ) {
+		// Sum the lengths of all pattern columns.
+		const auto pColumns = pSong->getPatternGroupVector();
+		pIndex->columnStartTicks.reserve( pColumns->size() + 1 );
+		long nTotalTick = 0;
+		for ( const auto& ppColumn : *pColumns ) {
+			nTotalTick += getColumnLength( ppColumn );
+			pIndex->columnStartTicks.push_back( nTotalTick );
 		}
-		totalTick += nPatternSize;
 	}
 
-	return totalTick;
+	m_columnIndex.publish( pIndex );
+}
+
+std::shared_ptr<const Hydrogen::ColumnIndex> Hydrogen::getColumnIndex(
+	std::shared_ptr<Song> pSong ) const
+{
+	auto pIndex = m_columnIndex.load();
+	if ( pIndex == nullptr ||
+		 pIndex->nSongGeneration != m_nSongGeneration.load() ||
+		 pIndex->columnStartTicks.size() !=
+		 pSong->getPatternGroupVector()->size() + 1 ) {
+		return nullptr;
+	}
+
+	return pIndex;
+}
+
+long Hydrogen::getColumnLength( std::shared_ptr<PatternList> pColumn )
+{
+	// Four quarters are used in case the column is empty.
+	if ( pColumn == nullptr || pColumn->size() == 0 ) {
+		return 4 * H2Core::nTicksPerQuarter;
+	}
+	return pColumn->longestPatternLength();
 }
 
 void Hydrogen::updateSongSize() {
@@ -23,8 +23,10 @@
 #define HYDROGEN_H
 
 #include <core/Basics/Event.h>
+#include <core/Basics/Instrument.h>
 #include <core/Basics/Song.h>
 #include <core/config.h>
+#include <core/Helpers/RtSharedPtr.h>
 #include <core/Helpers/Time.h>
 #include <core/IO/JackDriver.h>
 #include <core/Midi/Midi.h>
@@ -32,9 +34,13 @@
 #include <core/Object.h>
 
 #include <stdint.h> // for uint32_t et al
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace H2Core
 {
@@ -185,8 +191,8 @@ public:
 	 * Find a PatternList/column corresponding to the supplied tick
 	 * position @a nTick.
 	 *
-	 * Adds up the lengths of all pattern columns until @a nTick lies in
-	 * between the bounds of a Pattern.
+	 * Looks up @a nTick in the cached start ticks of all pattern columns
+	 * using binary search.
 	 *
 	 * \param nTick Position in ticks.
 	 * \param bLoopMode Whether looping is enabled in the Song, see
@@ -213,6 +219,16 @@ public:
 	 *  - >= 0 : the total number of ticks passed.
 	 */
 	long			getTickForColumn( int nColumn ) const;
+	/**
+	 * Recalculates the start ticks of all columns cached for
+	 * getColumnForTick() and getTickForColumn().
+	 *
+	 * Has to be called whenever the song is replaced, columns are added or
+	 * removed, or the length of their patterns does change. This is done by
+	 * setSong() and AudioEngine::updateSongSize(). Must not be called from
+	 * within the audio thread.
+	 */
+	void			updateColumnIndex();
 
 	Song::Mode getMode() const;
 	/** Wrapper around Song::setMode() which also triggers
@@ -240,11 +256,23 @@ public:
 
 	void updateSongSize();
 
+	/**
+	 * Plays back a note live and records it into the current pattern in
+	 * case recording is enabled.
+	 *
+	 * Playback does not lock the #AudioEngine. The note is pushed into
+	 * AudioEngine::getLiveNoteQueue() and placed within the buffer of the
+	 * next process cycle according to @a timePoint.
+	 *
+	 * \param timePoint When the note was played. For MIDI input this is
+	 *   the time stamp of the corresponding #MidiMessage.
+	 */
 	bool addRealtimeNote(
 		int instrument,
 		float velocity,
 		bool noteoff = false,
-		Midi::Note note = Midi::NoteDefault
+		Midi::Note note = Midi::NoteDefault,
+		const TimePoint& timePoint = Clock::now()
 	);
 
 	Midi::Parameter getHihatOpenness() const;
@@ -337,7 +365,15 @@ public:
 	bool			startExportSession( int nSampleRate, int nSampleDepth,
 										double fCompressionLevel = 0.0 );
 	void			stopExportSession();
-	void			startExportSong( const QString& sFileName );
+	/**
+	 * @param sFileName File the main mix will be written to. If empty, only
+	 *   @a stems will be exported.
+	 * @param stems Maps the ids of instruments to the files their
+	 *   individual contributions to the main mix will be written to. All of
+	 *   them are rendered in a single pass along with the main mix. See
+	 *   #DiskWriterDriver::createStemFileNames(). */
+	void			startExportSong( const QString& sFileName,
+									 const std::map<Instrument::Id, QString>& stems = {} );
 	void			stopExportSong();
 	
 	/************************************************************/
@@ -440,6 +476,35 @@ public:
 
 private:
 
+	/** Start ticks of all columns of a song. */
+	struct ColumnIndex {
+		/** Value of #m_nSongGeneration the index was created for. */
+		int nSongGeneration;
+		/** Element ii holds the tick column ii starts at. The additional
+		 * last element holds the length of the whole song. */
+		std::vector<long> columnStartTicks;
+	};
+
+	/** @return index cached for @a pSong or `nullptr` in case it is
+	 * outdated. In the latter case the columns have to be scanned
+	 * directly.
+	 *
+	 * The index itself is only created in updateColumnIndex(). This way
+	 * neither locking nor allocations are required in here and the
+	 * function can safely be called from within the audio thread. */
+	std::shared_ptr<const ColumnIndex> getColumnIndex(
+		std::shared_ptr<Song> pSong ) const;
+	/** @return number of ticks @a pColumn is long. */
+	static long getColumnLength( std::shared_ptr<PatternList> pColumn );
+
+	/** Read by the audio thread without locking. */
+	RtSharedPtr<ColumnIndex> m_columnIndex;
+	/** Incremented each time #m_pSong is replaced. Song pointers
+	 * themselves are not suitable to check whether an index is still up
+	 * to date since the address of a new song might coincide with the one
+	 * of a previous one. */
+	std::atomic<int> m_nSongGeneration;
+
 	/**
 	 * Constructor, entry point, and initialization of the
 	 * Hydrogen application.
@@ -456,7 +521,12 @@ private:
 
 		void killInstruments();
 
-	void			midiNoteOn( std::shared_ptr<Note> pNote );
+	/** Adds a note played live to the current pattern. Locks the
+	 * #AudioEngine. */
+	bool			recordRealtimeNote( std::shared_ptr<Song> pSong,
+										int nInstrument,
+										float fVelocity, bool bNoteOff,
+										Midi::Note note );
 
 	/**
 	 * Static reference to the Hydrogen singleton. 
@@ -533,7 +603,7 @@ private:
 	bool			m_bSessionIsExported;
 
 	/**
-	 * Onset of the recorded last in addRealtimeNote(). It is used to
+	 * Onset of the recorded last in recordRealtimeNote(). It is used to
 	 * determine the custom length of the note in case the note on
 	 * event is followed by a note off event.
 	 */
@@ -26,8 +26,11 @@
 
 #include <pthread.h>
 #include <iostream>
+#include <vector>
+#include <core/AudioEngine/AudioEngine.h>
 #include <core/Preferences/Preferences.h>
 #include <core/EventQueue.h>
+#include <core/Hydrogen.h>
 
 namespace H2Core
 {
@@ -53,6 +56,78 @@ static int alsa_xrun_recovery( snd_pcm_t *handle, int err )
 	return err;
 }
 
+/** Converts @a nFrames frames of the output buffers of @a pDriver directly
+ * into the memory mapped ring buffer of the device.
+ *
+ * \return number of frames written or a negative error code. */
+static snd_pcm_sframes_t alsa_write_mmap( AlsaAudioDriver* pDriver,
+										  const float* pNoise_L,
+										  const float* pNoise_R,
+										  int nFrames )
+{
+	snd_pcm_t* pHandle = pDriver->m_pPlayback_handle;
+
+	int nWritten = 0;
+	while ( nWritten < nFrames ) {
+		const snd_pcm_sframes_t nAvail = snd_pcm_avail_update( pHandle );
+		if ( nAvail < 0 ) {
+			return nAvail;
+		}
+		else if ( nAvail == 0 ) {
+			const int err = snd_pcm_wait( pHandle, 100 );
+			if ( err < 0 ) {
+				return err;
+			}
+			else if ( err == 0 ) {
+				return -EAGAIN;
+			}
+			continue;
+		}
+
+		// The device might provide less frames than requested in case we
+		// hit the end of its ring buffer.
+		const snd_pcm_channel_area_t* pAreas;
+		snd_pcm_uframes_t nOffset;
+		snd_pcm_uframes_t nChunk = nFrames - nWritten;
+		int err;
+		if ( ( err = snd_pcm_mmap_begin( pHandle, &pAreas, &nOffset,
+										 &nChunk ) ) < 0 ) {
+			return err;
+		}
+
+		uint8_t* pDest = static_cast<uint8_t*>( pAreas[ 0 ].addr ) +
+			pAreas[ 0 ].first / 8 + nOffset * ( pAreas[ 0 ].step / 8 );
+		PcmConversion::interleave(
+			pDriver->m_format, &pDriver->m_pOut_L[ nWritten ],
+			&pDriver->m_pOut_R[ nWritten ],
+			pNoise_L != nullptr ? &pNoise_L[ nWritten ] : nullptr,
+			pNoise_R != nullptr ? &pNoise_R[ nWritten ] : nullptr,
+			pDest, static_cast<int>( nChunk ) );
+
+		const snd_pcm_sframes_t nCommitted =
+			snd_pcm_mmap_commit( pHandle, nOffset, nChunk );
+		if ( nCommitted < 0 ) {
+			return nCommitted;
+		}
+		else if ( static_cast<snd_pcm_uframes_t>( nCommitted ) != nChunk ) {
+			return -EPIPE;
+		}
+		nWritten += nCommitted;
+	}
+
+	// In contrast to snd_pcm_writei() committing does not start the stream.
+	// Just like the former we wait till the buffer is filled.
+	if ( snd_pcm_state( pHandle ) == SND_PCM_STATE_PREPARED &&
+		 snd_pcm_avail_update( pHandle ) < nFrames ) {
+		int err;
+		if ( ( err = snd_pcm_start( pHandle ) ) < 0 ) {
+			return err;
+		}
+	}
+
+	return nWritten;
+}
+
 void* alsaAudioDriver_processCaller( void* param )
 {
 	Base *__object = (Base*)param;
@@ -78,20 +153,45 @@ void* alsaAudioDriver_processCaller( void* param )
 
 	int nFrames = pDriver->m_nBufferSize;
 	__INFOLOG( QString( "nFrames: %1" ).arg( nFrames ) );
-	short pBuffer[ nFrames * 2 ];
-
-	float *pOut_L = pDriver->m_pOut_L;
-	float *pOut_R = pDriver->m_pOut_R;
 
 	int nTimeoutInMilliseconds = 100;
 
+	// Writes the current period either to the ring buffer of the device or
+	// via the intermediate interleaved buffer.
+	const float* pNoise_L = nullptr;
+	const float* pNoise_R = nullptr;
+	auto write = [&]() -> snd_pcm_sframes_t {
+		if ( pDriver->m_bMmap ) {
+			return alsa_write_mmap( pDriver, pNoise_L, pNoise_R, nFrames );
+		}
+		return snd_pcm_writei( pDriver->m_pPlayback_handle,
+							   pDriver->m_pInterleaved, nFrames );
+	};
+
+	const auto pProfiler =
+		Hydrogen::get_instance()->getAudioEngine()->getProfiler();
+
 	while ( pDriver->m_bIsRunning ) {
 		// prepare the audio data
 		pDriver->m_processCallback( nFrames, nullptr );
 
-		for ( int i = 0; i < nFrames; ++i ) {
-			pBuffer[ i * 2 ] = ( short )( pOut_L[ i ] * 32768.0 );
-			pBuffer[ i * 2 + 1 ] = ( short )( pOut_R[ i ] * 32768.0 );
+		// Conversion, waiting for the device, and writing the buffer.
+		AudioEngineProfiler::ScopedTimer timer(
+			pProfiler.get(), AudioEngineProfiler::Stage::DriverIO );
+
+		if ( pDriver->m_pDither_L != nullptr && pDriver->m_pDither_R != nullptr ) {
+			PcmConversion::generateTpdfNoise(
+				pDriver->m_pDither_L, nFrames, pDriver->m_nDitherState );
+			PcmConversion::generateTpdfNoise(
+				pDriver->m_pDither_R, nFrames, pDriver->m_nDitherState );
+			pNoise_L = pDriver->m_pDither_L;
+			pNoise_R = pDriver->m_pDither_R;
+		}
+
+		if ( ! pDriver->m_bMmap ) {
+			PcmConversion::interleave( pDriver->m_format, pDriver->m_pOut_L,
+									   pDriver->m_pOut_R, pNoise_L, pNoise_R,
+									   pDriver->m_pInterleaved, nFrames );
 		}
 
 		// Check whether the playback stream is ready to process
@@ -117,7 +217,9 @@ void* alsaAudioDriver_processCaller( void* param )
 
 			// Playback stream is ready, let's write out the audio
 			// buffer.
-			if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle, pBuffer, nFrames ) ) < 0 ) {
+			snd_pcm_sframes_t nErr;
+			if ( ( nErr = write() ) < 0 ) {
+				err = static_cast<int>( nErr );
 				___ERRORLOG( QString( "Error while writing playback stream: %1" )
 							 .arg( snd_strerror( err ) ) );
 
@@ -125,7 +227,8 @@ void* alsaAudioDriver_processCaller( void* param )
 				// again and retry writing the output buffer.
 				if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, err, 0 ) ) == 0 ) {
 					___INFOLOG( "Successfully recovered from error. Attempt to write buffer again." );
-					if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle, pBuffer, nFrames ) ) < 0 ) {
+					if ( ( nErr = write() ) < 0 ) {
+						err = static_cast<int>( nErr );
 						___ERRORLOG( QString( "Unable to write playback stream again: %1" )
 									 .arg( snd_strerror( err ) ) );
 						pDriver->m_nXRuns++;
@@ -195,9 +298,16 @@ AlsaAudioDriver::AlsaAudioDriver( audioProcessCallback processCallback )
 		, m_nBufferSize( 0 )
 		, m_pPlayback_handle( nullptr )
 		, m_processCallback( processCallback )
+		, m_format( PcmConversion::Format::S16 )
+		, m_bMmap( false )
+		, m_pInterleaved( nullptr )
+		, m_pDither_L( nullptr )
+		, m_pDither_R( nullptr )
+		, m_nDitherState( 0x9e3779b9 )
 {
 	m_nSampleRate = Preferences::get_instance()->m_nSampleRate;
 	m_sAlsaAudioDevice = Preferences::get_instance()->m_sAlsaAudioDevice;
+	m_bDither = Preferences::get_instance()->m_bAlsaDither;
 }
 
 AlsaAudioDriver::~AlsaAudioDriver()
@@ -277,21 +387,43 @@ int AlsaAudioDriver::connect()
 				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
 		return 1;
 	}
-//	snd_pcm_hw_params_set_access( m_pPlayback_handle, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED  );
 
-	if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
-											   hw_params,
-											   SND_PCM_ACCESS_RW_INTERLEAVED ) ) < 0 ) {
+	// Memory mapped access allows us to convert the output of the audio
+	// engine directly into the buffer of the device.
+	if ( snd_pcm_hw_params_set_access( m_pPlayback_handle, hw_params,
+									   SND_PCM_ACCESS_MMAP_INTERLEAVED ) == 0 ) {
+		m_bMmap = true;
+	}
+	else if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
+													hw_params,
+													SND_PCM_ACCESS_RW_INTERLEAVED ) ) < 0 ) {
 		ERRORLOG( QString( "error in snd_pcm_hw_params_set_access: %1" )
 				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
 		return 1;
 	}
+	else {
+		m_bMmap = false;
+	}
 
-	if ( ( err = snd_pcm_hw_params_set_format( m_pPlayback_handle,
-											   hw_params,
-											   SND_PCM_FORMAT_S16_LE ) ) < 0 ) {
-		ERRORLOG( QString( "error in snd_pcm_hw_params_set_format: %1" )
-				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+	// Formats in order of preference.
+	const std::vector<std::pair<snd_pcm_format_t, PcmConversion::Format>> formats = {
+		{ SND_PCM_FORMAT_FLOAT, PcmConversion::Format::Float },
+		{ SND_PCM_FORMAT_S32, PcmConversion::Format::S32 },
+		{ SND_PCM_FORMAT_S24_3LE, PcmConversion::Format::S24_3LE },
+		{ SND_PCM_FORMAT_S16, PcmConversion::Format::S16 } };
+	bool bFormatFound = false;
+	for ( const auto& [ aalsaFormat, fformat ] : formats ) {
+		if ( snd_pcm_hw_params_test_format( m_pPlayback_handle, hw_params,
+											aalsaFormat ) == 0 &&
+			 snd_pcm_hw_params_set_format( m_pPlayback_handle, hw_params,
+										   aalsaFormat ) == 0 ) {
+			m_format = fformat;
+			bFormatFound = true;
+			break;
+		}
+	}
+	if ( ! bFormatFound ) {
+		ERRORLOG( "Device does support neither of float, S32, S24_3LE, and S16 sample formats" );
 		return 1;
 	}
 
@@ -348,6 +480,9 @@ int AlsaAudioDriver::connect()
 	INFOLOG( QString( "*** PERIOD SIZE: %1" ).arg( period_size ) );
 	INFOLOG( QString( "*** SAMPLE RATE: %1" ).arg( m_nSampleRate ) );
 	INFOLOG( QString( "*** BUFFER SIZE: %1" ).arg( nPeriods * m_nBufferSize ) );
+	INFOLOG( QString( "*** FORMAT: %1, ACCESS: %2" )
+			 .arg( PcmConversion::FormatToQString( m_format ) )
+			 .arg( m_bMmap ? "mmap" : "read/write" ) );
 
 	//snd_pcm_hw_params_free( hw_params );
 
@@ -357,6 +492,18 @@ int AlsaAudioDriver::connect()
 	memset( m_pOut_L, 0, m_nBufferSize * sizeof( float ) );
 	memset( m_pOut_R, 0, m_nBufferSize * sizeof( float ) );
 
+	if ( ! m_bMmap ) {
+		m_pInterleaved = new uint8_t[
+			m_nBufferSize * 2 * PcmConversion::bytesPerSample( m_format ) ];
+	}
+
+	// Dither is only of use when reducing the resolution considerably.
+	if ( m_bDither && ( m_format == PcmConversion::Format::S16 ||
+						m_format == PcmConversion::Format::S24_3LE ) ) {
+		m_pDither_L = new float[ m_nBufferSize ];
+		m_pDither_R = new float[ m_nBufferSize ];
+	}
+
 	m_bIsRunning = true;
 
 	// start the main thread
@@ -385,6 +532,15 @@ void AlsaAudioDriver::disconnect()
 
 	delete[] m_pOut_R;
 	m_pOut_R = nullptr;
+
+	delete[] m_pInterleaved;
+	m_pInterleaved = nullptr;
+
+	delete[] m_pDither_L;
+	m_pDither_L = nullptr;
+
+	delete[] m_pDither_R;
+	m_pDither_R = nullptr;
 }
 
 unsigned AlsaAudioDriver::getBufferSize()
@@ -421,14 +577,24 @@ QString AlsaAudioDriver::toQString( const QString& sPrefix, bool bShort ) const
 			.append( QString( "%1%2m_nXRuns: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_nXRuns ) )
 			.append( QString( "%1%2m_nSampleRate: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( m_nSampleRate ) );
+					 .arg( m_nSampleRate ) )
+			.append( QString( "%1%2m_format: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( PcmConversion::FormatToQString( m_format ) ) )
+			.append( QString( "%1%2m_bMmap: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bMmap ) )
+			.append( QString( "%1%2m_bDither: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bDither ) );
 	} else {
 		sOutput = QString( "[AlsaAudioDriver]" )
 			.append( QString( " m_bIsRunning: %1" ).arg( m_bIsRunning ) )
 			.append( QString( ", m_nBufferSize: %1" ).arg( m_nBufferSize ) )
 			.append( QString( ", m_sAlsaAudioDevice: %1" ).arg( m_sAlsaAudioDevice ) )
 			.append( QString( ", m_nXRuns: %1" ).arg( m_nXRuns ) )
-			.append( QString( ", m_nSampleRate: %1" ).arg( m_nSampleRate ) );
+			.append( QString( ", m_nSampleRate: %1" ).arg( m_nSampleRate ) )
+			.append( QString( ", m_format: %1" )
+					 .arg( PcmConversion::FormatToQString( m_format ) ) )
+			.append( QString( ", m_bMmap: %1" ).arg( m_bMmap ) )
+			.append( QString( ", m_bDither: %1" ).arg( m_bDither ) );
 	}
 
 	return sOutput;
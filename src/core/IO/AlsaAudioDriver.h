@@ -24,6 +24,7 @@
 
 #include <core/IO/AudioDriver.h>
 #include <core/IO/NullDriver.h>
+#include <core/IO/PcmConversion.h>
 
 #if defined(H2CORE_HAVE_ALSA) || _DOXYGEN_
 
@@ -33,6 +34,15 @@
 namespace H2Core
 {
 
+/**
+ * Audio driver writing to an ALSA PCM device.
+ *
+ * On connect() the driver negotiates the best sample format supported by
+ * the device - float, 32 bit, packed 24 bit, or 16 bit integer - and prefers
+ * memory mapped access over read/write access. In the former case the
+ * output of the audio engine is converted directly into the ring buffer of
+ * the device.
+ */
 /** \ingroup docCore docAudioDriver */
 class AlsaAudioDriver : public Object<AlsaAudioDriver>, public AudioDriver
 {
@@ -47,6 +57,23 @@ public:
 	audioProcessCallback m_processCallback;
 	int m_nXRuns;
 
+	/** Sample format negotiated in connect(). */
+	PcmConversion::Format m_format;
+	/** Whether the device is accessed via `SND_PCM_ACCESS_MMAP_INTERLEAVED`
+	 * instead of `SND_PCM_ACCESS_RW_INTERLEAVED`. */
+	bool m_bMmap;
+	/** Interleaved output of a single period. Only used in case #m_bMmap
+	 * is `false`. */
+	uint8_t* m_pInterleaved;
+	/** Whether TPDF dither is applied when converting to 16 or 24 bit
+	 * integers. */
+	bool m_bDither;
+	/** Dither noise of a single period. `nullptr` in case no dither is
+	 * applied. */
+	float* m_pDither_L;
+	float* m_pDither_R;
+	uint32_t m_nDitherState;
+
 	AlsaAudioDriver( audioProcessCallback processCallback );
 	~AlsaAudioDriver();
 
@@ -21,14 +21,24 @@
  */
 #include <unistd.h>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <QFileInfo>
 
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/EventQueue.h>
 #include <core/CoreActionController.h>
 #include <core/Hydrogen.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
 #include <core/Basics/Sample.h>
+#include <core/Basics/Song.h>
 #include <core/IO/DiskWriterDriver.h>
 
 #include <pthread.h>
@@ -51,18 +61,14 @@ namespace H2Core
 
 pthread_t diskWriterDriverThread;
 
-void* diskWriterDriver_thread( void* param )
+/** Opens @a sFileName for writing using the format corresponding to its
+ * suffix as well as the sample rate, sample depth, and compression level of
+ * @a pDriver.
+ *
+ * \return `nullptr` on failure. */
+static SNDFILE* openSndfile( DiskWriterDriver* pDriver, const QString& sFileName )
 {
-
-	DiskWriterDriver *pDriver = ( DiskWriterDriver* )param;
-
-	EventQueue::get_instance()->pushEvent( Event::Type::Progress, 0 );
-
-	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
-	
-	___INFOLOG( "DiskWriterDriver thread started" );
-
-	const auto format = Filesystem::AudioFormatFromSuffix( pDriver->m_sFileName );
+	const auto format = Filesystem::AudioFormatFromSuffix( sFileName );
 
 	SF_INFO soundInfo;
 	soundInfo.samplerate = pDriver->m_nSampleRate;
@@ -118,13 +124,8 @@ void* diskWriterDriver_thread( void* param )
 #endif
 	else {
 		___ERRORLOG( QString( "Unsupported file extension [%1] using libsndfile [%2]" )
-					.arg( pDriver->m_sFileName ).arg( sf_version_string() ) );
-		pDriver->m_bDoneWriting = true;
-		pDriver->m_bWritingFailed = true;
-		EventQueue::get_instance()->pushEvent( Event::Type::Progress, 100 );
-		pthread_exit( nullptr );
+					.arg( sFileName ).arg( sf_version_string() ) );
 		return nullptr;
-
 	}
 
 	// Instead of making audio export fail on non-supported parameter
@@ -161,10 +162,6 @@ void* diskWriterDriver_thread( void* param )
 	if ( !sf_format_check( &soundInfo ) ) {
 		___ERRORLOG( QString( "Error while checking format using libsndfile [%1]" )
 					.arg( sf_version_string() ) );
-		pDriver->m_bDoneWriting = true;
-		pDriver->m_bWritingFailed = true;
-		EventQueue::get_instance()->pushEvent( Event::Type::Progress, 100 );
-		pthread_exit( nullptr );
 		return nullptr;
 	}
 
@@ -173,29 +170,25 @@ void* diskWriterDriver_thread( void* param )
 	// characters of the filename entered in the GUI right. No matter which
 	// encoding was used locally.
 	// We have to terminate the string using a null character ourselves.
-	QString sPaddedPath = pDriver->m_sFileName.append( '\0' );
+	QString sPaddedPath = QString( sFileName ).append( '\0' );
 	wchar_t* encodedFileName = new wchar_t[ sPaddedPath.size() ];
 
 	sPaddedPath.toWCharArray( encodedFileName );
 	
 	SNDFILE* pSndfile = sf_wchar_open( encodedFileName, SFM_WRITE,
 								   &soundInfo );
-	delete encodedFileName;
+	delete[] encodedFileName;
 #else
-	SNDFILE* pSndfile = sf_open( pDriver->m_sFileName.toLocal8Bit(), SFM_WRITE,
+	SNDFILE* pSndfile = sf_open( sFileName.toLocal8Bit(), SFM_WRITE,
 							   &soundInfo );
 #endif
 
 	if ( pSndfile == nullptr ) {
 		___ERRORLOG( QString( "Unable to open file [%1] with format [%2] using libsndfile [%3]: %4" )
-					.arg( pDriver->m_sFileName )
+					.arg( sFileName )
 					.arg( Sample::sndfileFormatToQString( soundInfo.format ) )
 					.arg( sf_version_string() )
 					.arg( sf_strerror( pSndfile ) ) );
-		pDriver->m_bDoneWriting = true;
-		pDriver->m_bWritingFailed = true;
-		EventQueue::get_instance()->pushEvent( Event::Type::Progress, 100 );
-		pthread_exit( nullptr );
 		return nullptr;
 	}
 
@@ -227,11 +220,217 @@ void* diskWriterDriver_thread( void* param )
 	}
 #endif
 
-	float *pData = new float[ pDriver->m_nBufferSize * 2 ];	// always stereo
+	return pSndfile;
+}
+
+namespace {
+
+	/** Interleaved and clipped audio of a single processing cycle for the
+	 * main mix and all stems. The data of file @a nFile starts at
+	 * `nFile * 2 * nBufferSize`. */
+	struct Block {
+		std::vector<float> data;
+		int nFrames;
+	};
+
+	/** Bounded single-producer single-consumer ring of preallocated
+	 * #Block. The DiskWriterDriver thread renders into it and an encoder
+	 * thread drains it into libsndfile.
+	 *
+	 * Neither of the two threads is a realtime one. So, a plain mutex and
+	 * condition variable are fine. */
+	class BlockRing {
+	public:
+		BlockRing( int nBlocks, int nBlockSize )
+			: m_blocks( nBlocks )
+			, m_nReadIndex( 0 )
+			, m_nWriteIndex( 0 )
+			, m_nFilled( 0 )
+			, m_bFinished( false )
+			, m_bAborted( false ) {
+			for ( auto& bblock : m_blocks ) {
+				bblock.data.resize( nBlockSize, 0 );
+				bblock.nFrames = 0;
+			}
+		}
+
+		/** \return next block to render into or `nullptr` in case the ring
+		 * was aborted. Blocks till the encoder freed one. */
+		Block* beginWrite() {
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_condition.wait( lock, [&]() {
+				return m_nFilled < static_cast<int>( m_blocks.size() ) ||
+					m_bAborted; } );
+			if ( m_bAborted ) {
+				return nullptr;
+			}
+			return &m_blocks[ m_nWriteIndex ];
+		}
+		void endWrite() {
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_nWriteIndex = ( m_nWriteIndex + 1 ) % m_blocks.size();
+				++m_nFilled;
+			}
+			m_condition.notify_all();
+		}
+
+		/** \return next block to encode or `nullptr` in case the ring was
+		 * either aborted or finished and fully drained. */
+		Block* beginRead() {
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_condition.wait( lock, [&]() {
+				return m_nFilled > 0 || m_bFinished || m_bAborted; } );
+			if ( m_bAborted || m_nFilled == 0 ) {
+				return nullptr;
+			}
+			return &m_blocks[ m_nReadIndex ];
+		}
+		void endRead() {
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_nReadIndex = ( m_nReadIndex + 1 ) % m_blocks.size();
+				--m_nFilled;
+			}
+			m_condition.notify_all();
+		}
+
+		/** No more blocks will be written. */
+		void finish() {
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_bFinished = true;
+			}
+			m_condition.notify_all();
+		}
+		/** Discard all pending blocks and wake up both threads. */
+		void abort() {
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_bAborted = true;
+			}
+			m_condition.notify_all();
+		}
+
+	private:
+		std::vector<Block> m_blocks;
+		int m_nReadIndex;
+		int m_nWriteIndex;
+		int m_nFilled;
+		bool m_bFinished;
+		bool m_bAborted;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+	};
+
+} // anonymous namespace
+
+void* diskWriterDriver_thread( void* param )
+{
+
+	DiskWriterDriver *pDriver = ( DiskWriterDriver* )param;
+
+	EventQueue::get_instance()->pushEvent( Event::Type::Progress, 0 );
+
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	
+	___INFOLOG( "DiskWriterDriver thread started" );
+
+	// The main mix is only written in case a file name was provided. When
+	// exporting stems only, it is still rendered but discarded. Index 0 holds
+	// the main mix and all subsequent ones the stems in the order of
+	// DiskWriterDriver::m_stems.
+	std::vector<SNDFILE*> sndfiles;
+
+	auto closeFiles = [&]() {
+		for ( auto& ppSndfile : sndfiles ) {
+			if ( ppSndfile != nullptr ) {
+				sf_close( ppSndfile );
+				ppSndfile = nullptr;
+			}
+		}
+	};
+
+	bool bOpeningFailed = false;
+	if ( ! pDriver->m_sFileName.isEmpty() ) {
+		sndfiles.push_back( openSndfile( pDriver, pDriver->m_sFileName ) );
+		bOpeningFailed = sndfiles.back() == nullptr;
+	}
+	else {
+		sndfiles.push_back( nullptr );
+	}
+	for ( const auto& sstem : pDriver->m_stems ) {
+		if ( bOpeningFailed ) {
+			break;
+		}
+		sndfiles.push_back( openSndfile( pDriver, sstem.sFileName ) );
+		bOpeningFailed = sndfiles.back() == nullptr;
+	}
+	if ( sndfiles[ 0 ] == nullptr && sndfiles.size() == 1 ) {
+		___ERRORLOG( "Neither file name nor stems provided" );
+		bOpeningFailed = true;
+	}
+
+	if ( bOpeningFailed ) {
+		closeFiles();
+		pDriver->m_bDoneWriting = true;
+		pDriver->m_bWritingFailed = true;
+		EventQueue::get_instance()->pushEvent( Event::Type::Progress, 100 );
+		pthread_exit( nullptr );
+		return nullptr;
+	}
+
+	const int nFiles = static_cast<int>( sndfiles.size() );
+	const int nFileStride = pDriver->m_nBufferSize * 2;	// always stereo
 
 	float *pData_L = pDriver->m_pOut_L;
 	float *pData_R = pDriver->m_pOut_R;
 
+	// Writes a rendered block to all files. Used by the encoder thread or -
+	// in case no blocks are used - directly by this one.
+	std::atomic<bool> bEncodingFailed( false );
+	auto encodeBlock = [&]( const Block* pBlock ) {
+		for ( int ii = 0; ii < nFiles; ++ii ) {
+			if ( sndfiles[ ii ] == nullptr ) {
+				continue;
+			}
+
+			const int res = sf_writef_float(
+				sndfiles[ ii ], &pBlock->data[ ii * nFileStride ],
+				pBlock->nFrames );
+			if ( res != pBlock->nFrames ) {
+				___ERRORLOG( QString( "Error during sf_write_float using [%1]. Floats written: [%2], target: [%3]. %4" )
+							.arg( sf_version_string() ).arg( res )
+							.arg( pBlock->nFrames )
+							.arg( sf_strerror( sndfiles[ ii ] ) ) );
+				bEncodingFailed = true;
+				return false;
+			}
+		}
+
+		pDriver->m_nEncodedFrames += pBlock->nFrames;
+		return true;
+	};
+
+	// Encoding - especially for compressed formats - can take as long as
+	// rendering itself. When using more than one block, it is done in a
+	// separate thread while the next buffers are rendered.
+	const int nBlockCount = std::max( pDriver->m_nBlockCount, 0 );
+	BlockRing ring( std::max( nBlockCount, 1 ), nFiles * nFileStride );
+	std::thread encoderThread;
+	if ( nBlockCount > 0 ) {
+		encoderThread = std::thread( [&]() {
+			Block* pBlock;
+			while ( ( pBlock = ring.beginRead() ) != nullptr ) {
+				if ( ! encodeBlock( pBlock ) ) {
+					ring.abort();
+					return;
+				}
+				ring.endRead();
+			}
+		} );
+	}
+
 	Hydrogen* pHydrogen = Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
 	auto pSampler = pHydrogen->getAudioEngine()->getSampler();
@@ -242,18 +441,48 @@ void* diskWriterDriver_thread( void* param )
 	auto pPatternColumns = pSong->getPatternGroupVector();
 	int nColumns = pPatternColumns->size();
 
-	// Used to cleanly terminate this thread and close all handlers.
-	auto tearDown = [&](){
-		pDriver->m_bDoneWriting = true;
-		delete[] pData;
-		pData = nullptr;
+	// Used to cleanly terminate this thread and close all handlers. In case
+	// of success, all pending blocks are encoded first.
+	auto tearDown = [&]( bool bSuccess ){
+		if ( encoderThread.joinable() ) {
+			if ( bSuccess ) {
+				ring.finish();
+			} else {
+				ring.abort();
+			}
+			encoderThread.join();
+		}
+
+		closeFiles();
 
-		sf_close( pSndfile );
+		if ( bSuccess && bEncodingFailed ) {
+			EventQueue::get_instance()->pushEvent( Event::Type::Progress, -1 );
+			pDriver->m_bWritingFailed = true;
+		}
+		else if ( bSuccess ) {
+			// Explicitly mark export as finished.
+			EventQueue::get_instance()->pushEvent( Event::Type::Progress, 100 );
+		}
 
-		___INFOLOG( "DiskWriterDriver thread end" );
+		___INFOLOG( QString( "DiskWriterDriver thread end. Frames rendered: [%1], encoded: [%2]" )
+					.arg( pDriver->getRenderedFrames() )
+					.arg( pDriver->getEncodedFrames() ) );
+
+		pDriver->m_bDoneWriting = true;
 
 		pthread_exit( nullptr );
 	};
+
+	// Interleaves and clips the provided buffers into the section of @a
+	// pBlock corresponding to file @a nFile.
+	auto interleave = [&]( Block* pBlock, int nFile, const float* pBuffer_L,
+						   const float* pBuffer_R, int nFrames ) {
+		float* pData = &pBlock->data[ nFile * nFileStride ];
+		for ( int ii = 0; ii < nFrames; ii++ ) {
+			pData[ ii * 2 ] = std::clamp( pBuffer_L[ ii ], -1.0f, 1.0f );
+			pData[ ii * 2 + 1 ] = std::clamp( pBuffer_R[ ii ], -1.0f, 1.0f );
+		}
+	};
 	
 	int nPatternSize, nBufferWriteLength;
 	float fBpm;
@@ -307,7 +536,18 @@ void* diskWriterDriver_thread( void* param )
 				___ERRORLOG( "Driver was stop before export was completed." );
 				EventQueue::get_instance()->pushEvent( Event::Type::Progress, -1 );
 				pDriver->m_bWritingFailed = true;
-				tearDown();
+				tearDown( false );
+				return nullptr;
+			}
+
+			// Wait for the encoder to free a block before rendering into
+			// the output buffers of the driver.
+			Block* pBlock = ring.beginWrite();
+			if ( pBlock == nullptr ) {
+				// Encoding failed.
+				EventQueue::get_instance()->pushEvent( Event::Type::Progress, -1 );
+				pDriver->m_bWritingFailed = true;
+				tearDown( false );
 				return nullptr;
 			}
 			
@@ -329,7 +569,7 @@ void* diskWriterDriver_thread( void* param )
 					
 					EventQueue::get_instance()->pushEvent( Event::Type::Progress, -1 );
 					pDriver->m_bWritingFailed = true;
-					tearDown();
+					tearDown( false );
 					return nullptr;
 				}
 			}
@@ -350,6 +590,9 @@ void* diskWriterDriver_thread( void* param )
 				// We are at the last pattern and just waited for the
 				// Sampler to finish rendering all notes (at an
 				// arbitrary point within the buffer).
+				//
+				// The main mix is used for stems as well to ensure all
+				// files of an export share the same length.
 				nBufferWriteLength = 0;
 
 				int nSilentFrames = 0;
@@ -370,35 +613,25 @@ void* diskWriterDriver_thread( void* param )
 			}
 			
 			nFrameNumber += nBufferWriteLength;
-			
-			for ( unsigned ii = 0; ii < nBufferWriteLength; ii++ ) {
-				if( pData_L[ ii ] > 1 ) {
-					pData[ ii * 2 ] = 1;
-				} else if( pData_L[ ii ] < -1 ) {
-					pData[ ii * 2 ] = -1;
-				} else {
-					pData[ ii * 2 ] = pData_L[ ii ];
-				}
-				
-				if( pData_R[ ii ] > 1 ){
-					pData[ ii * 2 + 1 ] = 1;
-				} else if ( pData_R[ ii ] < -1 ) {
-					pData[ ii * 2 + 1 ] = -1;
-				} else {
-					pData[ ii * 2 + 1 ] = pData_R[ ii ];
-				}
+
+			if ( sndfiles[ 0 ] != nullptr ) {
+				interleave( pBlock, 0, pData_L, pData_R, nBufferWriteLength );
 			}
-			
-			const int res = sf_writef_float( pSndfile, pData, nBufferWriteLength );
-			if ( res != ( int )nBufferWriteLength ) {
-				___ERRORLOG( QString( "Error during sf_write_float using [%1]. Floats written: [%2], target: [%3]. %4" )
-							.arg( sf_version_string() ).arg( res )
-							.arg( nBufferWriteLength )
-							.arg( sf_strerror( nullptr ) ) );
+			for ( int ii = 1; ii < nFiles; ++ii ) {
+				const auto& stem = pDriver->m_stems[ ii - 1 ];
+				interleave( pBlock, ii, stem.pOut_L, stem.pOut_R,
+							nBufferWriteLength );
+			}
+			pBlock->nFrames = nBufferWriteLength;
+			pDriver->m_nRenderedFrames += nBufferWriteLength;
 
+			if ( nBlockCount > 0 ) {
+				ring.endWrite();
+			}
+			else if ( ! encodeBlock( pBlock ) ) {
 				EventQueue::get_instance()->pushEvent( Event::Type::Progress, -1 );
 				pDriver->m_bWritingFailed = true;
-				tearDown();
+				tearDown( false );
 				return nullptr;
 			}
 
@@ -418,10 +651,7 @@ void* diskWriterDriver_thread( void* param )
 		}
 	}
 
-	// Explicitly mark export as finished.
-	EventQueue::get_instance()->pushEvent( Event::Type::Progress, 100 );
-	
-	tearDown();
+	tearDown( true );
 
 	return nullptr;
 }
@@ -439,12 +669,16 @@ DiskWriterDriver::DiskWriterDriver( audioProcessCallback processCallback )
 		, m_bIsRunning( false )
 		, m_bDoneWriting( false )
 		, m_bWritingFailed( false )
-		, m_fCompressionLevel( 0.0 ) {
+		, m_fCompressionLevel( 0.0 )
+		, m_nBlockCount( DiskWriterDriver::nDefaultBlockCount )
+		, m_nRenderedFrames( 0 )
+		, m_nEncodedFrames( 0 ) {
 }
 
 
 
 DiskWriterDriver::~DiskWriterDriver() {
+	clearStems();
 }
 
 
@@ -471,6 +705,8 @@ void DiskWriterDriver::write()
 	INFOLOG( "" );
 
 	m_bIsRunning = true;
+	m_nRenderedFrames = 0;
+	m_nEncodedFrames = 0;
 	
 	pthread_attr_t attr;
 	pthread_attr_init( &attr );
@@ -493,6 +729,130 @@ void DiskWriterDriver::disconnect()
 	delete[] m_pOut_R;
 	m_pOut_R = nullptr;
 
+	clearStems();
+}
+
+void DiskWriterDriver::setStems( const std::map<Instrument::Id, QString>& stems )
+{
+	clearStems();
+
+	for ( const auto& [ iid, ssFileName ] : stems ) {
+		Stem stem;
+		stem.id = iid;
+		stem.sFileName = ssFileName;
+		stem.pOut_L = new float[ m_nBufferSize ];
+		stem.pOut_R = new float[ m_nBufferSize ];
+		memset( stem.pOut_L, 0, m_nBufferSize * sizeof( float ) );
+		memset( stem.pOut_R, 0, m_nBufferSize * sizeof( float ) );
+		m_stems.push_back( stem );
+
+		const int nIndex = static_cast<int>( iid );
+		if ( nIndex < 0 ) {
+			continue;
+		}
+		if ( nIndex >= static_cast<int>( m_stemSlots.size() ) ) {
+			m_stemSlots.resize( nIndex + 1, -1 );
+		}
+		m_stemSlots[ nIndex ] = static_cast<int>( m_stems.size() ) - 1;
+	}
+}
+
+void DiskWriterDriver::clearStems()
+{
+	for ( auto& sstem : m_stems ) {
+		delete[] sstem.pOut_L;
+		delete[] sstem.pOut_R;
+	}
+	m_stems.clear();
+	m_stemSlots.clear();
+}
+
+float* DiskWriterDriver::getTrackBuffer( Instrument::Id id,
+										 Channel channel ) const
+{
+	const int nIndex = static_cast<int>( id );
+	if ( nIndex < 0 || nIndex >= static_cast<int>( m_stemSlots.size() ) ||
+		 m_stemSlots[ nIndex ] == -1 ) {
+		return nullptr;
+	}
+
+	const auto& stem = m_stems[ m_stemSlots[ nIndex ] ];
+	return channel == Channel::Left ? stem.pOut_L : stem.pOut_R;
+}
+
+void DiskWriterDriver::clearTrackBuffers( uint32_t nFrames )
+{
+	for ( auto& sstem : m_stems ) {
+		memset( sstem.pOut_L, 0, nFrames * sizeof( float ) );
+		memset( sstem.pOut_R, 0, nFrames * sizeof( float ) );
+	}
+}
+
+std::map<Instrument::Id, QString> DiskWriterDriver::createStemFileNames(
+	const QString& sFileName, std::shared_ptr<Song> pSong )
+{
+	std::map<Instrument::Id, QString> stems;
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		return stems;
+	}
+
+	// Ensure we use the right extension.
+	const QString sSuffix = QString( ".%1" )
+		.arg( QFileInfo( sFileName ).suffix() );
+	QString sBaseName = sFileName;
+	if ( sBaseName.endsWith( sSuffix, Qt::CaseInsensitive ) ) {
+		sBaseName.chop( sSuffix.size() );
+	}
+
+	// It's a little inefficient to check all notes because patterns are
+	// likely to be present multiple times. But this way we do not have to
+	// check whether a pattern is actually played back over the course of a
+	// song.
+	std::set<Instrument::Id> usedIds;
+	for ( const auto& ppNote : pSong->getAllNotes() ) {
+		if ( ppNote != nullptr ) {
+			usedIds.insert( ppNote->getInstrumentId() );
+		}
+	}
+
+	const auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+	for ( const auto& ppInstrument : *pInstrumentList ) {
+		if ( ppInstrument == nullptr ||
+			 usedIds.find( ppInstrument->getId() ) == usedIds.end() ) {
+			continue;
+		}
+
+		int nOccurrences = 0;
+		for ( const auto& ppOther : *pInstrumentList ) {
+			if ( ppOther != nullptr &&
+				 ppOther->getName() == ppInstrument->getName() ) {
+				++nOccurrences;
+			}
+		}
+
+		QString sInstrumentName = ppInstrument->getName();
+		if ( nOccurrences >= 2 ) {
+			sInstrumentName.append( QString( "_%1" ).arg(
+				static_cast<int>( ppInstrument->getId() ) ) );
+		}
+
+		QString sStemName;
+		if ( sBaseName.isEmpty() || sBaseName.endsWith( "/" ) ||
+			 sBaseName.endsWith( "\\" ) ) {
+			// Allow to use just the instrument names when leaving the song
+			// name blank.
+			sStemName = QString( "%1%2%3" ).arg( sBaseName )
+				.arg( sInstrumentName ).arg( sSuffix );
+		}
+		else {
+			sStemName = QString( "%1-%2%3" ).arg( sBaseName )
+				.arg( sInstrumentName ).arg( sSuffix );
+		}
+
+		stems[ ppInstrument->getId() ] = sStemName;
+	}
+
+	return stems;
 }
 
 unsigned DiskWriterDriver::getSampleRate()
@@ -520,7 +880,20 @@ QString DiskWriterDriver::toQString( const QString& sPrefix, bool bShort ) const
 			.append( QString( "%1%2m_bWritingFailed: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_bWritingFailed ) )
 			.append( QString( "%1%2m_fCompressionLevel: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( m_fCompressionLevel ) );
+					 .arg( m_fCompressionLevel ) )
+			.append( QString( "%1%2m_nBlockCount: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nBlockCount ) )
+			.append( QString( "%1%2m_nRenderedFrames: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nRenderedFrames.load() ) )
+			.append( QString( "%1%2m_nEncodedFrames: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nEncodedFrames.load() ) )
+			.append( QString( "%1%2m_stems: [\n" ).arg( sPrefix ).arg( s ) );
+		for ( const auto& sstem : m_stems ) {
+			sOutput.append( QString( "%1%2%2%3: %4\n" ).arg( sPrefix ).arg( s )
+							.arg( static_cast<int>( sstem.id ) )
+							.arg( sstem.sFileName ) );
+		}
+		sOutput.append( QString( "%1%2]\n" ).arg( sPrefix ).arg( s ) );
 	} else {
 		sOutput = QString( "[DiskWriterDriver]" )
 			.append( QString( " m_nSampleRate: %1" ).arg( m_nSampleRate ) )
@@ -531,7 +904,19 @@ QString DiskWriterDriver::toQString( const QString& sPrefix, bool bShort ) const
 			.append( QString( ", m_bDoneWriting: %1" ).arg( m_bDoneWriting ) )
 			.append( QString( ", m_bWritingFailed: %1" ).arg( m_bWritingFailed ) )
 			.append( QString( ", m_fCompressionLevel: %1" )
-					 .arg( m_fCompressionLevel ) );
+					 .arg( m_fCompressionLevel ) )
+			.append( QString( ", m_nBlockCount: %1" ).arg( m_nBlockCount ) )
+			.append( QString( ", m_nRenderedFrames: %1" )
+					 .arg( m_nRenderedFrames.load() ) )
+			.append( QString( ", m_nEncodedFrames: %1" )
+					 .arg( m_nEncodedFrames.load() ) )
+			.append( ", m_stems: [" );
+		for ( const auto& sstem : m_stems ) {
+			sOutput.append( QString( " %1: %2" )
+							.arg( static_cast<int>( sstem.id ) )
+							.arg( sstem.sFileName ) );
+		}
+		sOutput.append( " ]" );
 	}
 
 	return sOutput;
@@ -26,13 +26,20 @@
 #include <sndfile.h>
 
 #include <inttypes.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
 
+#include <core/Basics/Instrument.h>
 #include <core/IO/AudioDriver.h>
 #include <core/Object.h>
 
 namespace H2Core
 {
 
+class Song;
+
 	void* diskWriterDriver_thread( void *param );
 ///
 /// Driver for export audio to disk
@@ -43,6 +50,20 @@ class DiskWriterDriver : public Object<DiskWriterDriver>, public AudioDriver
 	H2_OBJECT(DiskWriterDriver)
 	public:
 
+		enum class Channel { Left, Right };
+
+		/** Number of rendered buffers which can be queued for encoding
+		 * while the next ones are rendered. */
+		static constexpr int nDefaultBlockCount = 8;
+
+		/** An instrument exported into a separate file. */
+		struct Stem {
+			Instrument::Id id;
+			QString sFileName;
+			float* pOut_L;
+			float* pOut_R;
+		};
+
 		unsigned				m_nSampleRate;
 		QString					m_sFileName;
 		unsigned				m_nBufferSize;
@@ -54,6 +75,20 @@ class DiskWriterDriver : public Object<DiskWriterDriver>, public AudioDriver
 		float*					m_pOut_L;
 		float*					m_pOut_R;
 		bool					 m_bIsRunning;
+		/** Instruments rendered into files of their own in the same pass
+		 * the main mix is rendered in. */
+		std::vector<Stem>		m_stems;
+		/** Index into #m_stems for each instrument id or `-1` if the
+		 * instrument is not exported as a stem. Built in setStems() so the
+		 * audio thread can look up buffers in constant time. */
+		std::vector<int>		m_stemSlots;
+		/** Number of preallocated blocks of interleaved audio passed from
+		 * the thread rendering the song to the one encoding it using
+		 * libsndfile. If set to 0, both are done sequentially in the same
+		 * thread. */
+		int						m_nBlockCount;
+		std::atomic<long long>	m_nRenderedFrames;
+		std::atomic<long long>	m_nEncodedFrames;
 
 		DiskWriterDriver( audioProcessCallback processCallback );
 		~DiskWriterDriver();
@@ -85,6 +120,24 @@ class DiskWriterDriver : public Object<DiskWriterDriver>, public AudioDriver
 		m_nSampleDepth = nNewDepth;
 	}
 		void setCompressionLevel( double fCompressionLevel );
+		/** Must not be called while writing. */
+		void setBlockCount( int nBlockCount ) {
+			m_nBlockCount = nBlockCount;
+		}
+		int getBlockCount() const {
+			return m_nBlockCount;
+		}
+		/** Number of frames of the ongoing export already rendered by the
+		 * #AudioEngine. */
+		long long getRenderedFrames() const {
+			return m_nRenderedFrames;
+		}
+		/** Number of frames of the ongoing export already written to
+		 * disk. Lags behind getRenderedFrames() by at most #m_nBlockCount
+		 * buffers. */
+		long long getEncodedFrames() const {
+			return m_nEncodedFrames;
+		}
 
 		virtual float* getOut_L() override {
 			return m_pOut_L;
@@ -97,8 +150,29 @@ class DiskWriterDriver : public Object<DiskWriterDriver>, public AudioDriver
 			m_sFileName = sFileName;
 		}
 
+		/** Sets up the instruments to be exported as stems in addition to
+		 * the main mix. An empty map disables stem export.
+		 *
+		 * Must not be called while writing. */
+		void setStems( const std::map<Instrument::Id, QString>& stems );
+		bool hasStems() const {
+			return m_stems.size() > 0;
+		}
+		/** Buffer the #Sampler mixes the output of instrument @a id into.
+		 *
+		 * \return `nullptr` in case @a id is not exported as a stem. */
+		float* getTrackBuffer( Instrument::Id id, Channel channel ) const;
+		void clearTrackBuffers( uint32_t nFrames );
+
+		/** Derives the file names of all stems of @a pSong from @a
+		 * sFileName, e.g. `song-Kick.wav` for `song.wav`. Only instruments
+		 * actually used within the song are considered. */
+		static std::map<Instrument::Id, QString> createStemFileNames(
+			const QString& sFileName, std::shared_ptr<Song> pSong );
+
 	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 	private:
+		void clearStems();
 
 };
 
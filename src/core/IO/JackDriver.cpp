@@ -355,6 +355,8 @@ JackDriver::JackDriver( JackProcessCallback processCallback, Mode mode )
 	  m_processCallback( processCallback ),
 	  m_pAudioOutputPort1( nullptr ),
 	  m_pAudioOutputPort2( nullptr ),
+	  m_nTrackTableRevision( 0 ),
+	  m_nAdoptedTrackTableRevision( 0 ),
 	  m_timebaseTracking( TimebaseTracking::None ),
 	  m_timebaseState( Timebase::None ),
 	  m_fLastTimebaseBpm( 120 ),
@@ -431,6 +433,10 @@ void JackDriver::deactivate()
 			for ( auto& [_, ports] : m_audioPortMapStatic ) {
 				unregisterPerTrackAudioPorts( ports );
 			}
+			for ( auto& [_, ports] : m_portsToUnregister ) {
+				unregisterPerTrackAudioPorts( ports );
+			}
+			m_portsToUnregister.clear();
 		}
 
 		if ( m_mode == Mode::Combined ) {
@@ -1396,6 +1402,14 @@ int JackDriver::jackDriverSampleRate( jack_nframes_t nframes, void* pInstance )
 	Preferences::get_instance()->m_nSampleRate =
 		static_cast<unsigned>( nframes );
 
+	// This callback is not invoked from within the process thread. So, we
+	// can rebuild the tempo map right here.
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	if ( pAudioEngine != nullptr &&
+		 pAudioEngine->getAudioDriver().get() == pJackDriver ) {
+		pAudioEngine->updateTempoMap();
+	}
+
 	return 0;
 }
 
@@ -1426,12 +1440,26 @@ int JackDriver::jackXRunCallback( void* pInstance )
 
 void JackDriver::cleanUpPerTrackAudioPorts()
 {
+	// Tear down ports removed by previous calls the audio thread is done with.
+	const int nAdoptedRevision = m_nAdoptedTrackTableRevision.load();
+	for ( auto it = m_portsToUnregister.begin();
+		  it != m_portsToUnregister.end(); ) {
+		if ( it->first <= nAdoptedRevision ) {
+			unregisterPerTrackAudioPorts( it->second );
+			it = m_portsToUnregister.erase( it );
+		}
+		else {
+			++it;
+		}
+	}
+
+	std::vector<InstrumentPorts> portsToUnregister;
 	for ( auto it = m_audioPortMap.cbegin(); it != m_audioPortMap.cend(); ) {
 		if ( it->first != nullptr &&
 			 it->second.marked != InstrumentPorts::Marked::None &&
 			 !it->first->isQueued() ) {
 			if ( it->second.marked == InstrumentPorts::Marked::ForDeath ) {
-				unregisterPerTrackAudioPorts( it->second );
+				portsToUnregister.push_back( it->second );
 			}
 			m_audioPortMap.erase( it++ );
 		}
@@ -1439,84 +1467,140 @@ void JackDriver::cleanUpPerTrackAudioPorts()
 			++it;
 		}
 	}
+
+	if ( portsToUnregister.size() > 0 ) {
+		// The audio thread might still write to the buffers of the ports in
+		// its current cycle. We hand it a table without them and tear them
+		// down only after it picked this one up.
+		updateTrackTable();
+		for ( const auto& pports : portsToUnregister ) {
+			m_portsToUnregister.push_back( { m_nTrackTableRevision, pports } );
+		}
+	}
 }
 
-void JackDriver::clearPerTrackAudioBuffers( uint32_t nFrames )
+void JackDriver::updateTrackTable()
 {
-	if ( m_pClient != nullptr &&
-		 Preferences::get_instance()->m_bJackTrackOuts ) {
-		for ( auto& [iid, _] : m_audioPortMapStatic ) {
-			auto pLeft = getTrackBuffer( iid, Channel::Left );
-			if ( pLeft != nullptr ) {
-				memset( pLeft, 0, nFrames * sizeof( float ) );
-			}
-			auto pRight = getTrackBuffer( iid, Channel::Right );
-			if ( pRight != nullptr ) {
-				memset( pRight, 0, nFrames * sizeof( float ) );
-			}
+	auto pTable = std::make_shared<TrackTable>();
+	pTable->nRevision = ++m_nTrackTableRevision;
+
+	int nMaxId = -1;
+	for ( const auto& [ppInstrument, _] : m_audioPortMap ) {
+		if ( ppInstrument != nullptr ) {
+			nMaxId = std::max( nMaxId, static_cast<int>( ppInstrument->getId() ) );
 		}
+	}
+	pTable->slots.resize( nMaxId + nTrackIdOffset + 1, -1 );
 
-		for ( auto& [ppInstrument, _] : m_audioPortMap ) {
-            if ( ppInstrument == nullptr ) {
-                continue;
-            }
-			auto pLeft = getTrackBuffer( ppInstrument->getId(), Channel::Left );
-			if ( pLeft != nullptr ) {
-				memset( pLeft, 0, nFrames * sizeof( float ) );
-			}
-			auto pRight = getTrackBuffer( ppInstrument->getId(), Channel::Right );
-			if ( pRight != nullptr ) {
-				memset( pRight, 0, nFrames * sizeof( float ) );
-			}
+	auto addPorts = [&]( Instrument::Id id, const InstrumentPorts& ports ) {
+		const int nIndex = static_cast<int>( id ) + nTrackIdOffset;
+		if ( nIndex < 0 || nIndex >= pTable->slots.size() ||
+			 pTable->slots[ nIndex ] != -1 ) {
+			return;
+		}
+		pTable->slots[ nIndex ] = pTable->ports.size();
+		pTable->ports.push_back( { ports.Left, ports.Right } );
+	};
+
+	for ( const auto& [iid, ports] : m_audioPortMapStatic ) {
+		addPorts( iid, ports );
+	}
+	// Ports of instruments in the current drumkit take precedence over those
+	// kept for instruments of the death row sharing the same id.
+	for ( const auto& [ppInstrument, ports] : m_audioPortMap ) {
+		if ( ppInstrument != nullptr &&
+			 ports.marked == InstrumentPorts::Marked::None ) {
+			addPorts( ppInstrument->getId(), ports );
+		}
+	}
+	for ( const auto& [ppInstrument, ports] : m_audioPortMap ) {
+		if ( ppInstrument != nullptr &&
+			 ports.marked != InstrumentPorts::Marked::None ) {
+			addPorts( ppInstrument->getId(), ports );
+		}
+	}
+	pTable->buffers.resize( 2 * pTable->ports.size(), nullptr );
+
+	auto pPrevious = std::atomic_exchange( &m_pNextTrackTable, pTable );
+	if ( pPrevious != nullptr ) {
+		m_retiredTrackTables.push_back( pPrevious );
+	}
+
+	// Drop all retired tables neither used by the audio thread nor pending
+	// anymore.
+	for ( auto it = m_retiredTrackTables.begin();
+		  it != m_retiredTrackTables.end(); ) {
+		if ( it->use_count() == 1 ) {
+			it = m_retiredTrackTables.erase( it );
+		}
+		else {
+			++it;
 		}
 	}
 }
 
-float* JackDriver::getTrackBuffer( Instrument::Id id, Channel channel ) const
+void JackDriver::clearPerTrackAudioBuffers( uint32_t nFrames )
 {
-	InstrumentPorts ports;
-	if ( id == Instrument::MetronomeId || id == Instrument::EmptyId ||
-		 id == Instrument::PlaybackTrackId ) {
-		if ( m_audioPortMapStatic.find( id ) == m_audioPortMapStatic.end() ) {
-			ERRORLOG( QString( "No ports for instrument id [%1]" )
-						  .arg( static_cast<int>( id ) ) );
-			return nullptr;
+	// Replaced tables are still referenced by #m_retiredTrackTables. So,
+	// this does not deallocate them.
+	auto pTable = std::atomic_load( &m_pNextTrackTable );
+	if ( pTable != m_pTrackTable ) {
+		m_pTrackTable = pTable;
+		if ( m_pTrackTable != nullptr ) {
+			// From now on ports not contained in the table are not touched
+			// by the audio thread anymore.
+			m_nAdoptedTrackTableRevision.store( m_pTrackTable->nRevision );
 		}
+	}
 
-		ports = m_audioPortMapStatic.at( id );
+	if ( m_pClient == nullptr ||
+		 ! Preferences::get_instance()->m_bJackTrackOuts ||
+		 m_pTrackTable == nullptr ) {
+		return;
 	}
-	else {
-		bool bFound = false;
-		for ( const auto& [ppInstrument, pport] : m_audioPortMap ) {
-			if ( ppInstrument != nullptr && ppInstrument->getId() == id ) {
-				ports = pport;
-				bFound = true;
-				break;
-			}
+
+	for ( int ii = 0; ii < m_pTrackTable->ports.size(); ++ii ) {
+		const auto [ pLeftPort, pRightPort ] = m_pTrackTable->ports[ ii ];
+		float* pLeft = nullptr;
+		float* pRight = nullptr;
+		if ( pLeftPort != nullptr ) {
+			pLeft = static_cast<jack_default_audio_sample_t*>(
+				jack_port_get_buffer( pLeftPort, m_jackServerBufferSize ) );
+		}
+		if ( pRightPort != nullptr ) {
+			pRight = static_cast<jack_default_audio_sample_t*>(
+				jack_port_get_buffer( pRightPort, m_jackServerBufferSize ) );
 		}
 
-		if ( !bFound ) {
-			ERRORLOG( QString( "No ports for instrument id [%1]" )
-						  .arg( static_cast<int>( id ) ) );
-			return nullptr;
+		if ( pLeft != nullptr ) {
+			memset( pLeft, 0, nFrames * sizeof( float ) );
 		}
+		if ( pRight != nullptr ) {
+			memset( pRight, 0, nFrames * sizeof( float ) );
+		}
+		m_pTrackTable->buffers[ 2 * ii ] = pLeft;
+		m_pTrackTable->buffers[ 2 * ii + 1 ] = pRight;
 	}
+}
 
-	jack_port_t* pPort;
-	if ( channel == Channel::Left ) {
-		pPort = ports.Left;
+float* JackDriver::getTrackBuffer( Instrument::Id id, Channel channel ) const
+{
+	if ( m_pTrackTable == nullptr ) {
+		return nullptr;
 	}
-	else {
-		pPort = ports.Right;
+
+	const int nIndex = static_cast<int>( id ) + nTrackIdOffset;
+	if ( nIndex < 0 || nIndex >= m_pTrackTable->slots.size() ) {
+		return nullptr;
 	}
 
-	if ( pPort == nullptr ) {
+	const int nSlot = m_pTrackTable->slots[ nIndex ];
+	if ( nSlot == -1 ) {
 		return nullptr;
 	}
 
-	return static_cast<jack_default_audio_sample_t*>(
-		jack_port_get_buffer( pPort, m_jackServerBufferSize )
-	);
+	return m_pTrackTable->buffers[ 2 * nSlot +
+								   ( channel == Channel::Left ? 0 : 1 ) ];
 }
 
 void JackDriver::createPerTrackAudioPorts(
@@ -1596,6 +1680,7 @@ void JackDriver::createPerTrackAudioPorts(
 
 	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ||
 		 m_pClient == nullptr ) {
+		updateTrackTable();
 		return;
 	}
 	const auto pDrumkit = pSong->getDrumkit();
@@ -1824,6 +1909,8 @@ void JackDriver::createPerTrackAudioPorts(
 		);
 	}
 
+	updateTrackTable();
+
 	// Clean up all ports not required anymore.
 	cleanUpPerTrackAudioPorts();
 }
@@ -2047,6 +2134,13 @@ void JackDriver::handleJackMidiInput( jack_nframes_t nframes )
 	events = jack_midi_get_event_count( buf );
 #endif
 
+	// Events carry their offset within the current cycle. By adding it to
+	// the start of the cycle, the audio engine is able to reproduce their
+	// timing exactly in the buffer it picks them up.
+	const auto cycleStart =
+		Hydrogen::get_instance()->getAudioEngine()->getCycleStartTimePoint();
+	const double fSampleRate = static_cast<double>( m_jackServerSampleRate );
+
 	for ( i = 0; i < events; i++ ) {
 #ifdef JACK_MIDI_NEEDS_NFRAMES
 		error = jack_midi_event_get( &event, buf, i, nframes );
@@ -2086,6 +2180,11 @@ void JackDriver::handleJackMidiInput( jack_nframes_t nframes )
 			msg.setData1( Midi::parameterFromIntClamp( buffer[1] ) );
 			msg.setData2( Midi::parameterFromIntClamp( buffer[2] ) );
 		}
+		if ( fSampleRate > 0 ) {
+			msg.setTimePoint( cycleStart +
+				std::chrono::duration_cast<Clock::duration>(
+					std::chrono::duration<double>( event.time / fSampleRate ) ) );
+		}
 		enqueueInputMessage( msg );
 	}
 }
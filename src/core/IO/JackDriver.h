@@ -36,10 +36,12 @@
 #include <jack/midiport.h>
 #include <jack/ringbuffer.h>
 #include <jack/transport.h>
+#include <atomic>
 #include <queue>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <core/Globals.h>
 
@@ -191,6 +193,13 @@ class JackDriver : public Object<JackDriver>,
 	bool isActive() const;
 
 	void deactivate();
+	/** Buffer of the per-track output port of the instrument @a id.
+	 *
+	 * The buffers are resolved once at the beginning of each process cycle
+	 * in clearPerTrackAudioBuffers(). This lookup is therefore constant in
+	 * time and safe to call from within the audio thread.
+	 *
+	 * \return `nullptr` in case there is no port for @a id. */
 	float* getTrackBuffer( Instrument::Id id, Channel channel ) const;
 	Mode getMode() const;
 
@@ -291,8 +300,15 @@ class JackDriver : public Object<JackDriver>,
 	/** Report an XRun event to the GUI.*/
 	static int jackXRunCallback( void* pInstance );
 	/** Checks whether there are ports associated with instrument in
-	 * #Hydrogen::m_instrumentDeathRow and whether they can be torn down. */
+	 * #Hydrogen::m_instrumentDeathRow and whether they can be torn down.
+	 *
+	 * Since the audio thread might still be using them in its current cycle,
+	 * ports are not unregistered right away but in a later call once the
+	 * audio thread picked up a #TrackTable not containing them anymore. */
 	void cleanUpPerTrackAudioPorts();
+	/** Picks up the latest #TrackTable, resolves the buffers of all its
+	 * ports, and silences them. Called at the beginning of each process
+	 * cycle. */
 	void clearPerTrackAudioBuffers( uint32_t nFrames );
 	/** In case the previous drumkit is provided as well, a more sophisticated
 	 * mapping between the instrument corresponding to the ports can be done. */
@@ -402,6 +418,10 @@ class JackDriver : public Object<JackDriver>,
 	static void jackDriverShutdown( void* pInstance );
 
 	void unregisterPerTrackAudioPorts( InstrumentPorts ports );
+	/** Creates a #TrackTable from #m_audioPortMap and #m_audioPortMapStatic
+	 * and hands it over to the audio thread. Has to be called whenever one
+	 * of the maps changed. */
+	void updateTrackTable();
 
 	/** Methods handling the MIDI part of the driver @{ */
 	void sendJackMidiMessage( MidiMessage msg );
@@ -453,6 +473,42 @@ class JackDriver : public Object<JackDriver>,
 	 * will stay till teardown. */
 	PortMapStatic m_audioPortMapStatic;
 
+	/** Dense layout of all per-track output ports. */
+	struct TrackTable {
+		/** Slot in #ports for each instrument id shifted by
+		 * #nTrackIdOffset. `-1` for ids without ports. */
+		std::vector<int> slots;
+		/** Left and right port of each slot. */
+		std::vector<std::pair<jack_port_t*, jack_port_t*>> ports;
+		/** Left and right buffer of each slot. Written by the audio thread
+		 * only. */
+		std::vector<float*> buffers;
+		/** Value of #m_nTrackTableRevision the table was created with. */
+		int nRevision;
+	};
+	/** Shift applied to instrument ids to account for the negative ids of
+	 * the metronome, the playback track, and the sample preview. */
+	static constexpr int nTrackIdOffset = 3;
+	/** Latest table created by updateTrackTable(). Only accessed using
+	 * atomic operations. */
+	std::shared_ptr<TrackTable> m_pNextTrackTable;
+	/** Table used by the audio thread in the current process cycle. */
+	std::shared_ptr<TrackTable> m_pTrackTable;
+	/** Tables replaced by newer ones. They are kept till the audio thread
+	 * does not use them anymore in order to not deallocate them within the
+	 * audio thread. */
+	std::vector<std::shared_ptr<TrackTable>> m_retiredTrackTables;
+	/** Incremented with each table created by updateTrackTable(). */
+	int m_nTrackTableRevision;
+	/** TrackTable::nRevision of the table picked up by the audio thread
+	 * most recently. */
+	std::atomic<int> m_nAdoptedTrackTableRevision;
+	/** Ports removed from #m_audioPortMap by cleanUpPerTrackAudioPorts()
+	 * along with the revision of the first table not containing them
+	 * anymore. They are unregistered once the audio thread picked up this
+	 * table. */
+	std::vector<std::pair<int, InstrumentPorts>> m_portsToUnregister;
+
 	/** Since #Sampler::m_pPreviewInstrument is changed with each new sample to
 	 * preview, this one serves as a dummy instrument mapping all instruments
 	 * not found in #m_portMap but with #Instrument::m_bIsPreviewInstrument set
@@ -148,9 +148,12 @@ class MidiBaseDriver : public Object<MidiBaseDriver>,
 	/** These shared members are used to provide a separate worker thread for
 	 * incoming MIDI messages. This is done in order to keep the MIDI driver as
 	 * responsive as possible - since on Note-On events
-	 * #Hydrogen::addRealtimeNote() is called, which locks the audio engine.
-	 * Otherwise MIDI clock signals interwoved with other messages would yield
-	 * poor results.
+	 * #Hydrogen::addRealtimeNote() is called, which maps notes to instruments
+	 * and locks the audio engine while recording. Otherwise MIDI clock signals
+	 * interwoved with other messages would yield poor results.
+	 *
+	 * Since each message keeps the time stamp of its arrival, the additional
+	 * hop does not affect the timing of notes played back live.
 	 *
 	 * @{ */
 	std::shared_ptr<MidiInput::HandledInput> handleMessage(
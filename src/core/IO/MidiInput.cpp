@@ -357,7 +357,8 @@ void MidiInput::handleNoteOnMessage(
 
 	QStringList mappedInstruments;
 	CoreActionController::handleNote(
-		note, msg.getChannel(), fVelocity, false, &mappedInstruments );
+		note, msg.getChannel(), fVelocity, false, &mappedInstruments,
+		msg.getTimePoint() );
 
 	pHandledInput->mappedInstruments = mappedInstruments;
 }
@@ -385,7 +386,7 @@ void MidiInput::handleNoteOffMessage( const MidiMessage& msg, bool CymbalChoke,
 	QStringList mappedInstruments;
 	CoreActionController::handleNote(
 		static_cast<Midi::Note>( msg.getData1() ), msg.getChannel(), 0.0, true,
-		&mappedInstruments
+		&mappedInstruments, msg.getTimePoint()
 	);
 
 	pHandledInput->mappedInstruments = mappedInstruments;
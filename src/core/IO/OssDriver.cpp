@@ -25,6 +25,8 @@
 // check if OSS support is enabled
 #if defined(H2CORE_HAVE_OSS) || _DOXYGEN_
 
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Hydrogen.h>
 #include <core/Preferences/Preferences.h>
 
 #include <pthread.h>
@@ -57,9 +59,16 @@ void* ossDriver_processCaller( void* param )
 
 	sleep( 1 );
 
+	const auto pProfiler =
+		Hydrogen::get_instance()->getAudioEngine()->getProfiler();
+
 	while ( ossDriver_running ) {
 		ossDriver_audioProcessCallback( oss_driver_bufferSize, NULL );
+
+		const auto writeStart = Clock::now();
 		ossDriver->write();
+		pProfiler->recordSince(
+			AudioEngineProfiler::Stage::DriverIO, writeStart );
 	}
 
 	pthread_exit( NULL );
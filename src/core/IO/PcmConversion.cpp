@@ -0,0 +1,227 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/IO/PcmConversion.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+namespace H2Core
+{
+
+namespace PcmConversion
+{
+
+namespace {
+
+	/** Scaling and saturation boundaries of an integer format. */
+	struct Range {
+		float fScale;
+		float fMin;
+		float fMax;
+	};
+
+	constexpr Range S16Range = { 32768.0f, -32768.0f, 32767.0f };
+	constexpr Range S24Range = { 8388608.0f, -8388608.0f, 8388607.0f };
+	/** The largest float below 2^31 is 2^31 - 128. */
+	constexpr Range S32Range = { 2147483648.0f, -2147483648.0f, 2147483520.0f };
+
+	inline int32_t quantize( float fValue, float fNoise, const Range& range ) {
+		const float fScaled = std::min( std::max(
+			fValue * range.fScale + fNoise, range.fMin ), range.fMax );
+		return static_cast<int32_t>( std::lrint( fScaled ) );
+	}
+
+	inline float noiseAt( const float* pNoise, int nFrame ) {
+		return pNoise != nullptr ? pNoise[ nFrame ] : 0.0f;
+	}
+
+#ifdef __SSE2__
+	inline __m128i quantize4( const float* pIn, const float* pNoise,
+							  const __m128& scale, const __m128& min,
+							  const __m128& max ) {
+		__m128 x = _mm_mul_ps( _mm_loadu_ps( pIn ), scale );
+		if ( pNoise != nullptr ) {
+			x = _mm_add_ps( x, _mm_loadu_ps( pNoise ) );
+		}
+		x = _mm_min_ps( _mm_max_ps( x, min ), max );
+		// Rounds to nearest just like std::lrint() does.
+		return _mm_cvtps_epi32( x );
+	}
+#endif
+
+	void interleaveFloat( const float* pL, const float* pR, float* pOut,
+						  int nFrames ) {
+		int nFrame = 0;
+#ifdef __SSE2__
+		const __m128 min = _mm_set1_ps( -1.0f );
+		const __m128 max = _mm_set1_ps( 1.0f );
+		for ( ; nFrame + 4 <= nFrames; nFrame += 4 ) {
+			const __m128 l = _mm_min_ps( _mm_max_ps(
+				_mm_loadu_ps( &pL[ nFrame ] ), min ), max );
+			const __m128 r = _mm_min_ps( _mm_max_ps(
+				_mm_loadu_ps( &pR[ nFrame ] ), min ), max );
+			_mm_storeu_ps( &pOut[ 2 * nFrame ], _mm_unpacklo_ps( l, r ) );
+			_mm_storeu_ps( &pOut[ 2 * nFrame + 4 ], _mm_unpackhi_ps( l, r ) );
+		}
+#endif
+		for ( ; nFrame < nFrames; ++nFrame ) {
+			pOut[ 2 * nFrame ] = std::min( std::max( pL[ nFrame ], -1.0f ), 1.0f );
+			pOut[ 2 * nFrame + 1 ] = std::min( std::max( pR[ nFrame ], -1.0f ), 1.0f );
+		}
+	}
+
+	void interleaveS32( const float* pL, const float* pR,
+						const float* pNoiseL, const float* pNoiseR,
+						int32_t* pOut, int nFrames ) {
+		int nFrame = 0;
+#ifdef __SSE2__
+		const __m128 scale = _mm_set1_ps( S32Range.fScale );
+		const __m128 min = _mm_set1_ps( S32Range.fMin );
+		const __m128 max = _mm_set1_ps( S32Range.fMax );
+		for ( ; nFrame + 4 <= nFrames; nFrame += 4 ) {
+			const __m128i l = quantize4(
+				&pL[ nFrame ], pNoiseL != nullptr ? &pNoiseL[ nFrame ] : nullptr,
+				scale, min, max );
+			const __m128i r = quantize4(
+				&pR[ nFrame ], pNoiseR != nullptr ? &pNoiseR[ nFrame ] : nullptr,
+				scale, min, max );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( &pOut[ 2 * nFrame ] ),
+							  _mm_unpacklo_epi32( l, r ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( &pOut[ 2 * nFrame + 4 ] ),
+							  _mm_unpackhi_epi32( l, r ) );
+		}
+#endif
+		for ( ; nFrame < nFrames; ++nFrame ) {
+			pOut[ 2 * nFrame ] = quantize(
+				pL[ nFrame ], noiseAt( pNoiseL, nFrame ), S32Range );
+			pOut[ 2 * nFrame + 1 ] = quantize(
+				pR[ nFrame ], noiseAt( pNoiseR, nFrame ), S32Range );
+		}
+	}
+
+	void interleaveS24_3LE( const float* pL, const float* pR,
+							const float* pNoiseL, const float* pNoiseR,
+							uint8_t* pOut, int nFrames ) {
+		// The packed layout does not map onto vector registers. Writing the
+		// bytes explicitly keeps the output little endian on all hosts.
+		auto write = []( uint8_t* pDest, int32_t nValue ) {
+			pDest[ 0 ] = static_cast<uint8_t>( nValue & 0xFF );
+			pDest[ 1 ] = static_cast<uint8_t>( ( nValue >> 8 ) & 0xFF );
+			pDest[ 2 ] = static_cast<uint8_t>( ( nValue >> 16 ) & 0xFF );
+		};
+
+		for ( int nFrame = 0; nFrame < nFrames; ++nFrame ) {
+			write( &pOut[ 6 * nFrame ], quantize(
+					   pL[ nFrame ], noiseAt( pNoiseL, nFrame ), S24Range ) );
+			write( &pOut[ 6 * nFrame + 3 ], quantize(
+					   pR[ nFrame ], noiseAt( pNoiseR, nFrame ), S24Range ) );
+		}
+	}
+
+	void interleaveS16( const float* pL, const float* pR,
+						const float* pNoiseL, const float* pNoiseR,
+						int16_t* pOut, int nFrames ) {
+		int nFrame = 0;
+#ifdef __SSE2__
+		const __m128 scale = _mm_set1_ps( S16Range.fScale );
+		const __m128 min = _mm_set1_ps( S16Range.fMin );
+		const __m128 max = _mm_set1_ps( S16Range.fMax );
+		for ( ; nFrame + 4 <= nFrames; nFrame += 4 ) {
+			const __m128i l = quantize4(
+				&pL[ nFrame ], pNoiseL != nullptr ? &pNoiseL[ nFrame ] : nullptr,
+				scale, min, max );
+			const __m128i r = quantize4(
+				&pR[ nFrame ], pNoiseR != nullptr ? &pNoiseR[ nFrame ] : nullptr,
+				scale, min, max );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( &pOut[ 2 * nFrame ] ),
+							  _mm_packs_epi32( _mm_unpacklo_epi32( l, r ),
+											   _mm_unpackhi_epi32( l, r ) ) );
+		}
+#endif
+		for ( ; nFrame < nFrames; ++nFrame ) {
+			pOut[ 2 * nFrame ] = static_cast<int16_t>( quantize(
+				pL[ nFrame ], noiseAt( pNoiseL, nFrame ), S16Range ) );
+			pOut[ 2 * nFrame + 1 ] = static_cast<int16_t>( quantize(
+				pR[ nFrame ], noiseAt( pNoiseR, nFrame ), S16Range ) );
+		}
+	}
+
+} // anonymous namespace
+
+int bytesPerSample( Format format ) {
+	switch ( format ) {
+	case Format::Float:
+	case Format::S32:
+		return 4;
+	case Format::S24_3LE:
+		return 3;
+	case Format::S16:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+void interleave( Format format, const float* pL, const float* pR,
+				 const float* pNoiseL, const float* pNoiseR,
+				 void* pOut, int nFrames ) {
+	switch ( format ) {
+	case Format::Float:
+		interleaveFloat( pL, pR, static_cast<float*>( pOut ), nFrames );
+		break;
+	case Format::S32:
+		interleaveS32( pL, pR, pNoiseL, pNoiseR,
+					   static_cast<int32_t*>( pOut ), nFrames );
+		break;
+	case Format::S24_3LE:
+		interleaveS24_3LE( pL, pR, pNoiseL, pNoiseR,
+						   static_cast<uint8_t*>( pOut ), nFrames );
+		break;
+	case Format::S16:
+		interleaveS16( pL, pR, pNoiseL, pNoiseR,
+					   static_cast<int16_t*>( pOut ), nFrames );
+		break;
+	}
+}
+
+void generateTpdfNoise( float* pNoise, int nSamples, uint32_t& nState ) {
+	// xorshift32. The upper 24 bits are mapped onto [0, 1).
+	auto next = [&]() {
+		nState ^= nState << 13;
+		nState ^= nState >> 17;
+		nState ^= nState << 5;
+		return static_cast<float>( nState >> 8 ) * ( 1.0f / 16777216.0f );
+	};
+
+	for ( int ii = 0; ii < nSamples; ++ii ) {
+		// The difference of two uniform variables is triangular.
+		pNoise[ ii ] = next() - next();
+	}
+}
+
+};
+
+};
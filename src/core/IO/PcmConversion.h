@@ -0,0 +1,97 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef PCM_CONVERSION_H
+#define PCM_CONVERSION_H
+
+#include <cstdint>
+#include <QString>
+
+namespace H2Core
+{
+
+/**
+ * Conversion of the float buffers of the audio engine into the interleaved
+ * stereo sample formats written by audio drivers talking to the hardware
+ * directly.
+ *
+ * All conversions clip the input to [-1, 1]. Integer formats round to the
+ * nearest value and saturate at the boundaries of their range.
+ */
+namespace PcmConversion
+{
+	enum class Format {
+		/** 32 bit float in native byte order. */
+		Float = 0,
+		/** 32 bit signed integer in native byte order. */
+		S32 = 1,
+		/** 24 bit signed integer packed into three bytes, little endian. */
+		S24_3LE = 2,
+		/** 16 bit signed integer in native byte order. */
+		S16 = 3
+	};
+
+	static const QString FormatToQString( const Format& format )
+	{
+		switch ( format ) {
+		case Format::Float:
+			return "Float";
+		case Format::S32:
+			return "S32";
+		case Format::S24_3LE:
+			return "S24_3LE";
+		case Format::S16:
+			return "S16";
+		default:
+			return "<unknown>";
+		}
+	}
+
+	/** \return number of bytes of a single sample of a single channel. */
+	int bytesPerSample( Format format );
+
+	/**
+	 * Interleaves @a pL and @a pR into @a pOut using @a format.
+	 *
+	 * \param pNoiseL If not `nullptr`, @a nFrames values in units of the
+	 *   least significant bit of @a format added to the left channel prior
+	 *   to quantization. Ignored for #Format::Float.
+	 * \param pNoiseR Same for the right channel.
+	 * \param pOut Has to hold at least @a nFrames frames of two channels.
+	 */
+	void interleave( Format format, const float* pL, const float* pR,
+					 const float* pNoiseL, const float* pNoiseR,
+					 void* pOut, int nFrames );
+
+	/**
+	 * Fills @a pNoise with triangular probability density function noise
+	 * spanning +/- one least significant bit.
+	 *
+	 * Realtime-safe.
+	 *
+	 * \param nState State of the random number generator. Must not be 0.
+	 */
+	void generateTpdfNoise( float* pNoise, int nSamples, uint32_t& nState );
+};
+
+};
+
+#endif // PCM_CONVERSION_H
@@ -24,8 +24,10 @@
 #include "core/Helpers/Filesystem.h"
 #include <core/Version.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <chrono>
+#include <ctime>
 #include <thread>
 #include <QtCore/QDir>
 #include <QDateTime>
@@ -96,21 +98,37 @@ void* loggerThread_func( void* param ) {
 	Logger::queue_t* queue = &pLogger->__msg_queue;
 	Logger::queue_t::iterator it, last;
 
+	auto write = [&]( const QString& sMsg ) {
+		if ( pLogger->m_bUseStdout ) {
+			stdoutStream << sMsg;
+			stdoutStream.flush();
+		}
+		if ( bUseLogFile ) {
+			logFileStream << sMsg;
+			logFileStream.flush();
+		}
+	};
+
+	QString sRtMsg;
 	while ( pLogger->__running ) {
+		// Messages logged from within the audio thread via Logger::logRt() do
+		// not signal the condition variable. Instead, we wake up periodically
+		// to check for them.
+		const auto deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			( std::chrono::system_clock::now() +
+			  std::chrono::milliseconds( 20 ) ).time_since_epoch() ).count();
+		struct timespec timeout;
+		timeout.tv_sec = static_cast<time_t>( deadline / 1000000000 );
+		timeout.tv_nsec = static_cast<long>( deadline % 1000000000 );
+
 		pthread_mutex_lock( &pLogger->__mutex );
-		pthread_cond_wait( &pLogger->__messages_available, &pLogger->__mutex );
+		pthread_cond_timedwait( &pLogger->__messages_available,
+								&pLogger->__mutex, &timeout );
 		pthread_mutex_unlock( &pLogger->__mutex );
 		if ( !queue->empty() ) {
 			for ( it = last = queue->begin() ; it != queue->end() ; ++it ) {
 				last = it;
-				if ( pLogger->m_bUseStdout ) {
-					stdoutStream << *it;
-					stdoutStream.flush();
-				}
-				if ( bUseLogFile ) {
-					logFileStream << *it;
-					logFileStream.flush();
-				}
+				write( *it );
 			}
 			// remove all in front of last
 			pthread_mutex_lock( &pLogger->__mutex );
@@ -118,6 +136,22 @@ void* loggerThread_func( void* param ) {
 			queue->pop_front();
 			pthread_mutex_unlock( &pLogger->__mutex );
 		}
+
+		while ( pLogger->popRt( sRtMsg ) ) {
+			write( sRtMsg );
+			pLogger->m_nRtWrittenPosition.fetch_add(
+				1, std::memory_order_release );
+		}
+
+		const long long nRtDropped = pLogger->getRtDropped();
+		if ( nRtDropped != pLogger->m_nRtReportedDropped ) {
+			write( pLogger->format(
+					   Logger::Error, "Logger", "loggerThread_func",
+					   QString( "Realtime log buffer full. [%1] messages were dropped" )
+					   .arg( nRtDropped - pLogger->m_nRtReportedDropped ), "",
+					   QDateTime::currentDateTime() ) );
+			pLogger->m_nRtReportedDropped = nRtDropped;
+		}
 	}
 	if ( bUseLogFile ) {
 		logFileStream << "Stop logger";
@@ -169,13 +203,22 @@ Logger* Logger::create_instance( const QString& sLogFilePath, bool bUseStdout,
 
 Logger::Logger( const QString& sLogFilePath, bool bUseStdout,
 				bool bLogTimestamps, bool bLogColors )
-	: __running( true )
+	: m_nRtWritePosition( 0 )
+	, m_nRtReadPosition( 0 )
+	, m_nRtWrittenPosition( 0 )
+	, m_nRtDropped( 0 )
+	, m_nRtReportedDropped( 0 )
+	, __running( true )
 	, m_sLogFilePath( sLogFilePath )
 	, m_bUseStdout( bUseStdout )
 	, m_bLogTimestamps( bLogTimestamps )
 	, m_bLogColors( bLogColors ) {
 	__instance = this;
 
+	for ( size_t ii = 0; ii < nRtQueueSize; ++ii ) {
+		m_rtRecords[ ii ].sequence.store( ii, std::memory_order_relaxed );
+	}
+
 	m_prefixList << "" << "(E) " << "(W) " << "(I) " << "(D) " << "(C)" << "(L) ";
 
 	if ( ! m_bLogColors ) {
@@ -220,42 +263,34 @@ Logger::~Logger() {
 	pthread_join( loggerThread, nullptr );
 }
 
-void Logger::log( unsigned level, const QString& sClassName, const char* func_name,
-				  const QString& sMsg, const QString& sColor ) {
-
-	if( level == None ){
-		return;
-	}
-
-	int i;
+int Logger::levelIndex( unsigned level ) {
 	switch( level ) {
 	case Error:
-		i = 1;
-		break;
+		return 1;
 	case Warning:
-		i = 2;
-		break;
+		return 2;
 	case Info:
-		i = 3;
-		break;
+		return 3;
 	case Debug:
-		i = 4;
-		break;
+		return 4;
 	case Constructors:
-		i = 5;
-		break;
+		return 5;
 	case Locks:
-		i = 6;
-		break;
+		return 6;
 	default:
-		i = 0;
-		break;
+		return 0;
 	}
+}
+
+QString Logger::format( unsigned level, const QString& sClassName,
+						const char* func_name, const QString& sMsg,
+						const QString& sColor, const QDateTime& timestamp ) const {
+	const int i = levelIndex( level );
 
 	QString sTimestampPrefix;
 	if ( m_bLogTimestamps ) {
 		sTimestampPrefix = QString( "[%1] " )
-			.arg( QDateTime::currentDateTime().toString( "hh:mm:ss.zzz" ) );
+			.arg( timestamp.toString( "hh:mm:ss.zzz" ) );
 	}
 
 	QString sCol = "";
@@ -263,9 +298,25 @@ void Logger::log( unsigned level, const QString& sClassName, const char* func_na
 		sCol = sColor.isEmpty() ? m_colorList[ i ] : sColor;
 	}
 
-	const QString tmp = QString( "%1%2%3[%4::%5] %6%7\n" )
+	return QString( "%1%2%3[%4::%5] %6%7\n" )
 		.arg( sCol ).arg( sTimestampPrefix ).arg( m_prefixList[i] )
 		.arg( sClassName ).arg( func_name ).arg( sMsg ).arg( m_sColorOff );
+}
+
+void Logger::log( unsigned level, const QString& sClassName, const char* func_name,
+				  const QString& sMsg, const QString& sColor ) {
+
+	if( level == None ){
+		return;
+	}
+
+	QDateTime timestamp;
+	if ( m_bLogTimestamps ) {
+		timestamp = QDateTime::currentDateTime();
+	}
+
+	const QString tmp = format( level, sClassName, func_name, sMsg, sColor,
+								timestamp );
 
 	pthread_mutex_lock( &__mutex );
 	__msg_queue.push_back( tmp );
@@ -273,11 +324,97 @@ void Logger::log( unsigned level, const QString& sClassName, const char* func_na
 	pthread_cond_broadcast( &__messages_available );
 }
 
+bool Logger::pushRt( unsigned level, const char* sClassName,
+					 const char* func_name, const char* sFormat,
+					 const RtArg* pArgs, int nArgs ) {
+	if ( level == None ) {
+		return true;
+	}
+
+	RtRecord* pRecord;
+	size_t nPosition = m_nRtWritePosition.load( std::memory_order_relaxed );
+	while ( true ) {
+		pRecord = &m_rtRecords[ nPosition & nRtQueueMask ];
+		const size_t nSequence = pRecord->sequence.load( std::memory_order_acquire );
+		const auto nDiff = static_cast<std::ptrdiff_t>( nSequence ) -
+			static_cast<std::ptrdiff_t>( nPosition );
+		if ( nDiff == 0 ) {
+			// Record is free. Claim it.
+			if ( m_nRtWritePosition.compare_exchange_weak(
+					 nPosition, nPosition + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		}
+		else if ( nDiff < 0 ) {
+			// Record still holds a message which was not read yet.
+			return false;
+		}
+		else {
+			// Another thread claimed the record in the meantime.
+			nPosition = m_nRtWritePosition.load( std::memory_order_relaxed );
+		}
+	}
+
+	pRecord->level = level;
+	pRecord->sClassName = sClassName;
+	pRecord->sFunction = func_name;
+	pRecord->sFormat = sFormat;
+	pRecord->nArgs = std::min( nArgs, nMaxRtArgs );
+	for ( int ii = 0; ii < pRecord->nArgs; ++ii ) {
+		pRecord->args[ ii ] = pArgs[ ii ];
+	}
+	pRecord->timestamp = std::chrono::system_clock::now();
+	pRecord->sequence.store( nPosition + 1, std::memory_order_release );
+
+	return true;
+}
+
+bool Logger::popRt( QString& sMsg ) {
+	// There is only a single consumer, the logger thread. No need for a CAS
+	// loop.
+	const size_t nPosition = m_nRtReadPosition.load( std::memory_order_relaxed );
+	RtRecord* pRecord = &m_rtRecords[ nPosition & nRtQueueMask ];
+	if ( pRecord->sequence.load( std::memory_order_acquire ) != nPosition + 1 ) {
+		// Queue is empty.
+		return false;
+	}
+
+	QString sFormatted( pRecord->sFormat );
+	for ( int ii = 0; ii < pRecord->nArgs; ++ii ) {
+		const auto& arg = pRecord->args[ ii ];
+		if ( arg.sText != nullptr ) {
+			sFormatted = sFormatted.arg( QString::fromUtf8( arg.sText ) );
+		}
+		else {
+			sFormatted = sFormatted.arg( arg.fValue, 0, 'g', 15 );
+		}
+	}
+
+	QDateTime timestamp;
+	if ( m_bLogTimestamps ) {
+		timestamp = QDateTime::fromMSecsSinceEpoch(
+			std::chrono::duration_cast<std::chrono::milliseconds>(
+				pRecord->timestamp.time_since_epoch() ).count() );
+	}
+
+	sMsg = format( pRecord->level, pRecord->sClassName, pRecord->sFunction,
+				   sFormatted, "", timestamp );
+
+	// Mark the record as free for the next round through the buffer.
+	m_nRtReadPosition.store( nPosition + 1, std::memory_order_relaxed );
+	pRecord->sequence.store( nPosition + nRtQueueSize,
+							 std::memory_order_release );
+
+	return true;
+}
+
 void Logger::flush() const {
 
 	int nTimeout = 100;
 	for ( int ii = 0; ii < nTimeout; ++ii ) {
-		if ( __msg_queue.empty() ) {
+		if ( __msg_queue.empty() &&
+			 m_nRtWrittenPosition.load( std::memory_order_acquire ) ==
+			 m_nRtWritePosition.load( std::memory_order_relaxed ) ) {
 			break;
 		}
 
@@ -23,12 +23,16 @@
 #ifndef H2C_LOGGER_H
 #define H2C_LOGGER_H
 
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <list>
 #include <pthread.h>
 #include <memory>
 #include <QtCore/QString>
 #include <QStringList>
+#include <QDateTime>
 
 #include <core/config.h>
 
@@ -54,6 +58,13 @@ class Logger {
 		/** message queue type */
 		typedef std::list<QString> queue_t;
 
+		/** Maximum number of arguments a single realtime message can hold
+		 * (see logRt()). */
+		static constexpr int nMaxRtArgs = 6;
+		/** Number of realtime messages which can be pending at the same
+		 * time. Must be a power of two. */
+		static constexpr size_t nRtQueueSize = 256;
+
 		/**
 		 * create the logger instance if not exists, set the log level and return the instance
 		 * \param msk the logging level bitmask
@@ -103,8 +114,8 @@ class Logger {
 		static unsigned bit_mask()                  { return __bit_msk; }
 
 	/**
-	 * Waits till the logger thread poped all remaining messages from
-	 * #__msg_queue.
+	 * Waits till the logger thread wrote all remaining messages of
+	 * #__msg_queue and #m_rtRecords.
 	 *
 	 * Note that this function will neither lock #__msg_queue nor
 	 * prevent routines from adding new messages to the queue.
@@ -128,6 +139,39 @@ class Logger {
 		void log( unsigned level, const QString& sClassName,
 				  const char* func_name, const QString& sMsg,
 				  const QString& sColor = "" );
+
+		/**
+		 * Realtime-safe counterpart of log() to be used within the audio
+		 * thread.
+		 *
+		 * Neither allocates memory nor acquires a lock. Instead, a
+		 * fixed-size record is written into a lock-free ring buffer and
+		 * the logger thread does all the formatting later on. Therefore,
+		 * all provided strings must have static storage duration (string
+		 * literals or the result of `_class_name()`) and only up to
+		 * #nMaxRtArgs arguments are supported. Arguments are either numbers
+		 * or strings with static storage duration themselves. They replace
+		 * the placeholders `%1`, `%2`, ... in @a sFormat.
+		 *
+		 * In case the ring buffer is full, the message is dropped and the
+		 * logger thread reports the number of lost messages once there is
+		 * room again.
+		 *
+		 * \param level used to output the corresponding level string
+		 * \param sClassName the name of the calling class
+		 * \param func_name the name of the calling function/method
+		 * \param sFormat format string of the message
+		 * \param args numbers or string literals of the message
+		 */
+		template<typename... Args>
+		void logRt( unsigned level, const char* sClassName,
+					const char* func_name, const char* sFormat,
+					Args... args );
+
+		/** @return Number of realtime messages dropped since startup
+		 * because the ring buffer of logRt() was full. */
+		long long getRtDropped() const;
+
 		/**
 		 * needed for being able to access logger internal
 		 * \param param is a pointer to the logger instance
@@ -146,6 +190,7 @@ class Logger {
 		/** @} */
 
 		bool getLogColors() const;
+		const QString& getLogFilePath() const;
 
 		/** Helper class to preserve and restore recursive crash context strings using an RAAI pattern */
 		class CrashContext {
@@ -158,6 +203,72 @@ class Logger {
 		};
 
 	private:
+		/** Argument of a realtime message. */
+		struct RtArg {
+			double fValue;
+			/** Used instead of #fValue if not `nullptr`. */
+			const char* sText;
+		};
+		static RtArg toRtArg( const char* sText ) {
+			return { 0, sText };
+		}
+		template<typename T>
+		static RtArg toRtArg( T value ) {
+			return { static_cast<double>( value ), nullptr };
+		}
+
+		/** Preallocated storage of a single realtime message. */
+		struct RtRecord {
+			/** Equals the position of the record within the ring buffer in
+			 * case it is ready to be written and position + 1 when ready to
+			 * be read. */
+			std::atomic<size_t> sequence;
+			unsigned level;
+			const char* sClassName;
+			const char* sFunction;
+			const char* sFormat;
+			int nArgs;
+			RtArg args[ nMaxRtArgs ];
+			std::chrono::system_clock::time_point timestamp;
+		};
+
+		/** Writes a realtime message into #m_rtRecords.
+		 *
+		 * \return `false` in case the ring buffer is full. */
+		bool pushRt( unsigned level, const char* sClassName,
+					 const char* func_name, const char* sFormat,
+					 const RtArg* pArgs, int nArgs );
+		/** Reads the oldest realtime message and formats it. Must only be
+		 * called by the logger thread.
+		 *
+		 * \return `false` in case no message is pending. */
+		bool popRt( QString& sMsg );
+
+		/** Assembles the final line written to the log. */
+		QString format( unsigned level, const QString& sClassName,
+						const char* func_name, const QString& sMsg,
+						const QString& sColor, const QDateTime& timestamp ) const;
+
+		/** Maps a #log_levels value onto an index in #m_prefixList and
+		 * #m_colorList. */
+		static int levelIndex( unsigned level );
+
+		static constexpr size_t nRtQueueMask = nRtQueueSize - 1;
+
+		std::array<RtRecord, nRtQueueSize> m_rtRecords;
+		/** Position the next realtime message will be written to. */
+		alignas( 64 ) std::atomic<size_t> m_nRtWritePosition;
+		/** Position the next realtime message will be read from. */
+		alignas( 64 ) std::atomic<size_t> m_nRtReadPosition;
+		/** Number of realtime messages the logger thread did already
+		 * write. Used by flush(). */
+		std::atomic<size_t> m_nRtWrittenPosition;
+		/** Number of realtime messages dropped since startup. */
+		std::atomic<long long> m_nRtDropped;
+		/** Value of #m_nRtDropped already reported by the logger
+		 * thread. */
+		long long m_nRtReportedDropped;
+
 		/**
 		 * Object holding the current H2Core::Logger
 		 * singleton. It is initialized with NULL, set with
@@ -201,6 +312,27 @@ class Logger {
 inline bool Logger::getLogColors() const {
 	return m_bLogColors;
 }
+inline const QString& Logger::getLogFilePath() const {
+	return m_sLogFilePath;
+}
+
+inline long long Logger::getRtDropped() const {
+	return m_nRtDropped.load( std::memory_order_relaxed );
+}
+
+template<typename... Args>
+inline void Logger::logRt( unsigned level, const char* sClassName,
+						   const char* func_name, const char* sFormat,
+						   Args... args ) {
+	static_assert( sizeof...( args ) <= nMaxRtArgs,
+				   "Too many arguments for a realtime log message" );
+	// Leading dummy element to support messages without arguments.
+	const RtArg values[] = { { 0, nullptr }, toRtArg( args )... };
+	if ( ! pushRt( level, sClassName, func_name, sFormat, &values[ 1 ],
+				   static_cast<int>( sizeof...( args ) ) ) ) {
+		m_nRtDropped.fetch_add( 1, std::memory_order_relaxed );
+	}
+}
 
 };
 
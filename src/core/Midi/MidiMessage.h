@@ -107,6 +107,9 @@ class MidiMessage
 		static MidiMessage from( const NoteOff& noteOff );
 
 		const TimePoint& getTimePoint() const;
+		/** Drivers providing precise time stamps for incoming messages
+		 * overwrite the time of construction with them. */
+		void setTimePoint( const TimePoint& timePoint );
 
 		Type getType() const;
 		void setType( Type type );
@@ -163,6 +166,9 @@ class MidiMessage
 inline const TimePoint& MidiMessage::getTimePoint() const {
 	return m_timePoint;
 }
+inline void MidiMessage::setTimePoint( const TimePoint& timePoint ) {
+	m_timePoint = timePoint;
+}
 inline MidiMessage::Type MidiMessage::getType() const {
 	return m_type;
 }
@@ -32,6 +32,7 @@
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
 #include <core/Basics/Song.h>
+#include <core/Helpers/Random.h>
 #include <core/Midi/MidiInstrumentMap.h>
 #include <core/Preferences/Preferences.h>
 #include <core/Timeline.h>
@@ -489,6 +490,9 @@ void SMFWriter::save( const QString& sFileName, std::shared_ptr<Song> pSong,
 	// here writers must prepare to receive pattern events
 	prepareEvents( pSong );
 
+	// Seeded the same way as the audio export to render identical files.
+	Random random( pSong->getRandomSeed() );
+
 	// Initial the tempo information.
 	const auto pTimeline = pSong->getTimeline();
 	const bool bUseTimeline = pSong->getIsTimelineActivated();
@@ -589,8 +593,7 @@ void SMFWriter::save( const QString& sFileName, std::shared_ptr<Song> pSong,
 
 			for ( const auto& [ nnNote, ppNote ] : *ppPattern->getNotes() ) {
 				if ( ppNote == nullptr || ppNote->getInstrument() == nullptr ||
-					 ppNote->getProbability() <
-					 static_cast<float>(rand()) / static_cast<float>(RAND_MAX) ) {
+					 ppNote->getProbability() < random.getUniform() ) {
                     continue;
 				}
 
@@ -609,7 +612,7 @@ void SMFWriter::save( const QString& sFileName, std::shared_ptr<Song> pSong,
 							static_cast<float>(nLeadLagFactor) ));
 
 					pCopiedNote->setPosition( static_cast<int>(fNoteTick) );
-					pCopiedNote->humanize();
+					pCopiedNote->humanize( random );
 
 					// delay the upbeat 16th-notes by a constant (manual)
 					// offset. This must done _after_ setting the position of
@@ -20,12 +20,11 @@
  *
  */
 
-#include <QRegularExpression>
-
 #include "Midi/Midi.h"
 #include "core/Helpers/Filesystem.h"
 #include "core/Preferences/Preferences.h"
 
+#include <chrono>
 #include <pthread.h>
 #include <unistd.h>
 
@@ -161,6 +160,10 @@ int OscServer::incomingMessageLogging(const char *	path,
 									  lo_message	data,
 									  void *		user_data) {
 
+	if ( ! __logger->should_log( H2Core::Logger::Info ) ) {
+		return 1;
+	}
+
 	QString sSummary = QString( "Incoming OSC Message for path [%1]" ).arg( path );
 	for ( int ii = 0; ii < argc; ii++) {
 		QString formattedArgument = qPrettyPrint( (lo_type)types[ii], argv[ii] );
@@ -173,208 +176,119 @@ int OscServer::incomingMessageLogging(const char *	path,
 	return 1;
 }
 
-int OscServer::generic_handler(const char *	path,
-							   const char *	types,
-							   lo_arg **	argv,
-							   int			argc,
-							   lo_message	data,
-							   void *		user_data)
+const std::unordered_map<std::string_view, OscServer::StripRoute>& OscServer::stripRoutes()
 {
-	auto pHydrogen = H2Core::Hydrogen::get_instance();
-	auto pMidiActionManager = pHydrogen->getMidiActionManager();
-	auto pSong = pHydrogen->getSong();
-
-	if ( pSong == nullptr ) {
-		ERRORLOG( "No song set yet" );
-		return 1;
-	}
-
-	bool bMessageProcessed = false;
-	
-	const int nNumberOfStrips = pSong->getDrumkit()->getInstruments()->size();
-
-	//First we're trying to map TouchOSC messages from multi-fader widgets
-	const QString oscPath( path );
-
-	QRegularExpression rxStripVol(
-		QRegularExpression::anchoredPattern(
-			"/Hydrogen/STRIP_VOLUME_ABSOLUTE/(\\d+)" ) );
-	rxStripVol.setPatternOptions(
-		QRegularExpression::UseUnicodePropertiesOption );
-	const auto rxStripVolMatch = rxStripVol.match( oscPath );
-	if ( rxStripVolMatch.hasMatch() && argc == 1 ) {
-		const int nStrip = rxStripVolMatch.captured( 1 ).toInt() -1;
-		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+	static const std::unordered_map<std::string_view, StripRoute> routes = {
+		{ "STRIP_VOLUME_ABSOLUTE", { false, []( int nStrip, lo_arg** argv, int ) {
 			STRIP_VOLUME_ABSOLUTE_Handler( nStrip , argv[0]->f );
-			bMessageProcessed = true;
-		}
-		else {
-			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-					  .arg( nStrip + 1 ).arg( 1 )
-					  .arg( nNumberOfStrips  ) );
-		}
-	}
-
-	QRegularExpression rxStripVolRel(
-		QRegularExpression::anchoredPattern(
-			"/Hydrogen/STRIP_VOLUME_RELATIVE/(\\d+)" ) );
-	rxStripVolRel.setPatternOptions(
-		QRegularExpression::UseUnicodePropertiesOption );
-	const auto rxStripVolRelMatch = rxStripVolRel.match( oscPath );
-	if ( rxStripVolRelMatch.hasMatch() && argc == 1 ) {
-		const int nStrip = rxStripVolRelMatch.captured( 1 ).toInt() - 1;
-		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+		} } },
+		{ "STRIP_VOLUME_RELATIVE", { false, []( int nStrip, lo_arg** argv, int ) {
 			STRIP_VOLUME_RELATIVE_Handler(
 				static_cast<int>( argv[0]->f ), nStrip
 			);
-			bMessageProcessed = true;
-		}
-		else {
-			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-					  .arg( nStrip + 1 ).arg( 1 )
-					  .arg( nNumberOfStrips ) );
-		}
-	}
-	
-	QRegularExpression rxStripPanAbs(
-		QRegularExpression::anchoredPattern(
-			"/Hydrogen/PAN_ABSOLUTE/(\\d+)" ) );
-	rxStripPanAbs.setPatternOptions(
-		QRegularExpression::UseUnicodePropertiesOption );
-	const auto rxStripPanAbsMatch = rxStripPanAbs.match( oscPath );
-	if ( rxStripPanAbsMatch.hasMatch() && argc == 1 ) {
-		const int nStrip = rxStripPanAbsMatch.captured( 1 ).toInt() - 1;
-		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+		} } },
+		{ "PAN_ABSOLUTE", { false, []( int nStrip, lo_arg** argv, int ) {
 			INFOLOG( QString( "processing message as changing pan of strip [%1] in absolute numbers" )
 					 .arg( nStrip ) );
 			H2Core::CoreActionController::setStripPan(
 				nStrip, argv[0]->f, false );
-			bMessageProcessed = true;
-		}
-		else {
-			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-					  .arg( nStrip + 1 ).arg( 1 )
-					  .arg( nNumberOfStrips ) );
-		}
-	}
-
-	QRegularExpression rxStripPanAbsSym(
-		QRegularExpression::anchoredPattern(
-			"/Hydrogen/PAN_ABSOLUTE_SYM/(\\d+)" ) );
-	rxStripPanAbsSym.setPatternOptions(
-		QRegularExpression::UseUnicodePropertiesOption );
-	const auto rxStripPanAbsSymMatch = rxStripPanAbsSym.match( oscPath );
-	if ( rxStripPanAbsSymMatch.hasMatch() && argc == 1 ) {
-		const int nStrip = rxStripPanAbsSymMatch.captured( 1 ).toInt() - 1;
-		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+		} } },
+		{ "PAN_ABSOLUTE_SYM", { false, []( int nStrip, lo_arg** argv, int ) {
 			INFOLOG( QString( "processing message as changing pan of strip [%1] in symmetric, absolute numbers" )
 					 .arg( nStrip ) );
 			H2Core::CoreActionController::setStripPanSym(
 				nStrip, argv[0]->f, false );
-			bMessageProcessed = true;
-		}
-		else {
-			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-					  .arg( nStrip + 1 ).arg( 1 )
-					  .arg( nNumberOfStrips ) );
-		}
-	}
-	
-	QRegularExpression rxStripPanRel(
-		QRegularExpression::anchoredPattern(
-			"/Hydrogen/PAN_RELATIVE/(\\d+)" ) );
-	rxStripPanRel.setPatternOptions(
-		QRegularExpression::UseUnicodePropertiesOption );
-	const auto rxStripPanRelMatch = rxStripPanRel.match( oscPath );
-	if ( rxStripPanRelMatch.hasMatch() && argc == 1 ) {
-		const int nStrip = rxStripPanRelMatch.captured( 1 ).toInt() - 1;
-		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+		} } },
+		{ "PAN_RELATIVE", { false, []( int nStrip, lo_arg** argv, int ) {
 			INFOLOG( QString( "processing message as changing pan of strip [%1] in relative numbers" )
 					 .arg( nStrip ) );
 			auto pAction = std::make_shared<MidiAction>(
 				MidiAction::Type::PanRelative );
 			pAction->setInstrument( nStrip );
 			pAction->setValue( static_cast<int>( argv[0]->f ) );
-			pMidiActionManager->handleMidiActionAsync( pAction );
-			bMessageProcessed = true;
-		}
-		else {
-			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-					  .arg( nStrip + 1 ).arg( 1 )
-					  .arg( nNumberOfStrips ) );
-		}
-	}
-
-	QRegularExpression rxStripFilterCutoffAbs(
-		QRegularExpression::anchoredPattern(
-			"/Hydrogen/FILTER_CUTOFF_LEVEL_ABSOLUTE/(\\d+)" ) );
-	rxStripFilterCutoffAbs.setPatternOptions(
-		QRegularExpression::UseUnicodePropertiesOption );
-	const auto rxStripFilterCutoffAbsMatch =
-		rxStripFilterCutoffAbs.match( oscPath );
-	if ( rxStripFilterCutoffAbsMatch.hasMatch() && argc == 1 ) {
-		const int nStrip = rxStripFilterCutoffAbsMatch.captured( 1 ).toInt() - 1;
-		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+			H2Core::Hydrogen::get_instance()->getMidiActionManager()
+				->handleMidiActionAsync( pAction );
+		} } },
+		{ "FILTER_CUTOFF_LEVEL_ABSOLUTE", { false, []( int nStrip, lo_arg** argv, int ) {
 			FILTER_CUTOFF_LEVEL_ABSOLUTE_Handler(
 				static_cast<int>( argv[0]->f ), nStrip
 			);
-			bMessageProcessed = true;
-		}
-		else {
-			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-					  .arg( nStrip + 1 ).arg( 1 )
-					  .arg( nNumberOfStrips ) );
-		}
-	}
-	
-	QRegularExpression rxStripMute(
-		QRegularExpression::anchoredPattern(
-			"/Hydrogen/STRIP_MUTE_TOGGLE/(\\d+)" ) );
-	rxStripMute.setPatternOptions(
-		QRegularExpression::UseUnicodePropertiesOption );
-	const auto rxStripMuteMatch = rxStripMute.match( oscPath );
-	if ( rxStripMuteMatch.hasMatch() && argc <= 1 ) {
-		const int nStrip = rxStripMuteMatch.captured( 1 ).toInt() - 1;
-		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+		} } },
+		{ "STRIP_MUTE_TOGGLE", { true, []( int nStrip, lo_arg**, int ) {
 			INFOLOG( QString( "processing message as toggling mute of strip [%1]" )
 					 .arg( nStrip ) );
 			H2Core::CoreActionController::toggleStripIsMuted( nStrip );
-			bMessageProcessed = true;
-		}
-		else {
-			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-					  .arg( nStrip + 1 ).arg( 1 )
-					  .arg( nNumberOfStrips ) );
-		}
-	}
-	
-	QRegularExpression rxStripSolo(
-		QRegularExpression::anchoredPattern(
-			"/Hydrogen/STRIP_SOLO_TOGGLE/(\\d+)" ) );
-	rxStripSolo.setPatternOptions(
-		QRegularExpression::UseUnicodePropertiesOption );
-	const auto rxStripSoloMatch = rxStripSolo.match( oscPath );
-	if ( rxStripSoloMatch.hasMatch() && argc <= 1 ) {
-		const int nStrip = rxStripSoloMatch.captured( 1 ).toInt() - 1;
-		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+		} } },
+		{ "STRIP_SOLO_TOGGLE", { true, []( int nStrip, lo_arg**, int ) {
 			INFOLOG( QString( "processing message as toggling solo of strip [%1]" )
 					 .arg( nStrip ) );
 			H2Core::CoreActionController::toggleStripIsSoloed( nStrip );
-			bMessageProcessed = true;
-		}
-		else {
-			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-					  .arg( nStrip + 1 ).arg( 1 )
-					  .arg( nNumberOfStrips ) );
-		}
-	}
+		} } },
+	};
 
-	if ( ! bMessageProcessed ) {
-		ERRORLOG( "No matching handler found" );
+	return routes;
+}
+
+int OscServer::generic_handler(const char *	path,
+							   const char *	types,
+							   lo_arg **	argv,
+							   int			argc,
+							   lo_message	data,
+							   void *		user_data)
+{
+	auto pHydrogen = H2Core::Hydrogen::get_instance();
+	auto pSong = pHydrogen->getSong();
+
+	if ( pSong == nullptr ) {
+		ERRORLOG( "No song set yet" );
+		return 1;
 	}
-	
+
 	// Returning 1 means that the message has not been fully handled
 	// and the server should try other methods.
+
+	// Strip paths, mostly sent by TouchOSC multi-fader widgets, are of the
+	// form /Hydrogen/<NAME>/<strip number>.
+	constexpr std::string_view sPrefix( "/Hydrogen/" );
+	const std::string_view sPath( path );
+	const auto nSeparator = sPath.rfind( '/' );
+	if ( sPath.substr( 0, sPrefix.size() ) != sPrefix ||
+		 nSeparator < sPrefix.size() || nSeparator + 1 >= sPath.size() ) {
+		ERRORLOG( "No matching handler found" );
+		return 1;
+	}
+
+	const auto route = stripRoutes().find(
+		sPath.substr( sPrefix.size(), nSeparator - sPrefix.size() ) );
+	if ( route == stripRoutes().end() ||
+		 ! ( argc == 1 || ( argc == 0 && route->second.bArgumentOptional ) ) ) {
+		ERRORLOG( "No matching handler found" );
+		return 1;
+	}
+
+	// Capture the strip number. Overly long numbers are out of bound
+	// anyway.
+	const auto sNumber = sPath.substr( nSeparator + 1 );
+	int nNumber = 0;
+	for ( const char cDigit : sNumber ) {
+		if ( cDigit < '0' || cDigit > '9' || nNumber > 99999 ) {
+			ERRORLOG( "No matching handler found" );
+			return 1;
+		}
+		nNumber = nNumber * 10 + ( cDigit - '0' );
+	}
+
+	const int nNumberOfStrips = pSong->getDrumkit()->getInstruments()->size();
+	const int nStrip = nNumber - 1;
+	if ( nStrip < 0 || nStrip >= nNumberOfStrips ) {
+		ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
+				  .arg( nStrip + 1 ).arg( 1 )
+				  .arg( nNumberOfStrips ) );
+		return 1;
+	}
+
+	route->second.handler( nStrip, argv, argc );
+
 	return 1;
 }
 
@@ -382,6 +296,8 @@ int OscServer::generic_handler(const char *	path,
 
 OscServer::OscServer( int nOscPort ) : m_bInitialized( false )
 									 , m_nTemporaryPort( nOscPort )
+									 , m_bFeedbackThreadRunning( false )
+									 , m_bStopFeedbackThread( false )
 {
 	auto pPref = H2Core::Preferences::get_instance();
 	
@@ -423,11 +339,13 @@ OscServer::OscServer( int nOscPort ) : m_bInitialized( false )
 
 OscServer::~OscServer(){
 
+	stopFeedbackThread();
+
+	delete m_pServerThread;
+
 	for (std::list<lo_address>::iterator it=m_pClientRegistry.begin(); it != m_pClientRegistry.end(); ++it){
 		lo_address_free( *it );
 	}
-
-	delete m_pServerThread;
 	
 	__instance = nullptr;
 }
@@ -1241,139 +1159,203 @@ void OscServer::PLAYLIST_REMOVE_SONG_Handler(lo_arg **argv, int argc) {
 // -------------------------------------------------------------------
 // Helper functions
 
-bool IsLoAddressEqual( const lo_address& first, const lo_address& second )
+std::string LoAddressKey( const lo_address& address )
 {
-	bool portEqual = ( strcmp( lo_address_get_port( first ), lo_address_get_port( second ) ) == 0);
-	bool hostEqual = ( strcmp( lo_address_get_hostname( first ), lo_address_get_hostname( second ) ) == 0);
-	bool protoEqual = ( lo_address_get_protocol( first ) == lo_address_get_protocol( second ) );
-	
-	return portEqual && hostEqual && protoEqual;
+	return std::to_string( lo_address_get_protocol( address ) ) + ":" +
+		lo_address_get_hostname( address ) + ":" +
+		lo_address_get_port( address );
 }
 
-void OscServer::broadcastMessage( const char* msgText, const lo_message& message ) {
-	for ( const auto& clientAddress: m_pClientRegistry ){
-		
-		INFOLOG( QString( "Outgoing OSC broadcast message %1" ).arg( msgText ));
-		
-		int i;
-		for (i = 0; i < lo_message_get_argc( message ); i++) {
-			QString formattedArgument = qPrettyPrint( (lo_type)lo_message_get_types(message)[i], lo_message_get_argv(message)[i] );
-			INFOLOG(QString("Argument %1: %2 %3").arg(i).arg(lo_message_get_types(message)[i]).arg(formattedArgument));
-		}
-		
-		lo_send_message(clientAddress, msgText, message);
+QByteArray OscServer::feedbackPath( MidiAction::Type type, int nInstrumentIndex )
+{
+	switch ( type ) {
+	case MidiAction::Type::MasterVolumeAbsolute:
+		return QByteArray( "/Hydrogen/MASTER_VOLUME_ABSOLUTE" );
+	case MidiAction::Type::ToggleMetronome:
+		return QByteArray( "/Hydrogen/TOGGLE_METRONOME" );
+	case MidiAction::Type::MuteToggle:
+		return QByteArray( "/Hydrogen/MUTE_TOGGLE" );
+	case MidiAction::Type::StripVolumeAbsolute:
+		return QString( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/%1" )
+			.arg( nInstrumentIndex ).toLatin1();
+	case MidiAction::Type::StripMuteToggle:
+		return QString( "/Hydrogen/STRIP_MUTE_TOGGLE/%1" )
+			.arg( nInstrumentIndex ).toLatin1();
+	case MidiAction::Type::StripSoloToggle:
+		return QString( "/Hydrogen/STRIP_SOLO_TOGGLE/%1" )
+			.arg( nInstrumentIndex ).toLatin1();
+	case MidiAction::Type::PanAbsolute:
+		return QString( "/Hydrogen/PAN_ABSOLUTE/%1" )
+			.arg( nInstrumentIndex ).toLatin1();
+	case MidiAction::Type::PanAbsoluteSym:
+		return QString( "/Hydrogen/PAN_ABSOLUTE_SYM/%1" )
+			.arg( nInstrumentIndex ).toLatin1();
+	default:
+		return QByteArray();
 	}
 }
 
-// -------------------------------------------------------------------
-// Main Midiaction handler
+void OscServer::broadcastBundle(
+	const std::map<std::pair<MidiAction::Type, int>, float>& pending ) {
 
-void OscServer::sendFeedbackMessage(
-	MidiAction::Type type,
-	float fValue,
-	int nInstrumentIndex
-)
-{
-	if ( !H2Core::Preferences::get_instance()->getOscFeedbackEnabled() ) {
-		return;
-	}
+	// The paths have to outlive the bundle.
+	std::vector<QByteArray> paths;
+	paths.reserve( pending.size() );
 
-	if ( type == MidiAction::Type::MasterVolumeAbsolute ) {
-		lo_message reply = lo_message_new();
-		lo_message_add_float( reply, fValue );
+	lo_bundle bundle = lo_bundle_new( LO_TT_IMMEDIATE );
+	for ( const auto& [ kkey, ffValue ] : pending ) {
+		const auto path = feedbackPath( kkey.first, kkey.second );
+		if ( path.isEmpty() ) {
+			continue;
+		}
+		paths.push_back( path );
 
-		broadcastMessage( "/Hydrogen/MASTER_VOLUME_ABSOLUTE", reply );
+		lo_message message = lo_message_new();
+		lo_message_add_float( message, ffValue );
+		lo_bundle_add_message( bundle, paths.back().constData(), message );
 
-		lo_message_free( reply );
+		INFOLOG( QString( "Outgoing OSC broadcast message %1, value: %2" )
+				 .arg( paths.back().constData() ).arg( ffValue ) );
 	}
 
-	if ( type == MidiAction::Type::StripVolumeAbsolute ) {
-		lo_message reply = lo_message_new();
-		lo_message_add_float( reply, fValue );
-
-		QByteArray ba = QString( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/%1" )
-							.arg( nInstrumentIndex )
-							.toLatin1();
-		const char* c_str2 = ba.data();
+	if ( ! paths.empty() ) {
+		std::lock_guard<std::mutex> lock( m_clientRegistryMutex );
+		for ( const auto& clientAddress: m_pClientRegistry ) {
+			lo_send_bundle( clientAddress, bundle );
+		}
+	}
 
-		broadcastMessage( c_str2, reply );
+	lo_bundle_free_recursive( bundle );
+}
 
-		lo_message_free( reply );
-	}
+void OscServer::sendProfilingStatistics( lo_address address ) {
+	const auto pAudioEngine = H2Core::Hydrogen::get_instance()->getAudioEngine();
+	const auto pProfiler = pAudioEngine->getProfiler();
+	const auto statistics = pProfiler->getStatistics();
 
-	if ( type == MidiAction::Type::ToggleMetronome ) {
-		lo_message reply = lo_message_new();
-		lo_message_add_float( reply, fValue );
+	// The names have to outlive the bundle.
+	std::vector<QByteArray> names;
+	names.reserve( statistics.size() );
 
-		broadcastMessage( "/Hydrogen/TOGGLE_METRONOME", reply );
+	lo_bundle bundle = lo_bundle_new( LO_TT_IMMEDIATE );
+	for ( const auto& sstatistics : statistics ) {
+		names.push_back( sstatistics.sName.toUtf8() );
 
-		lo_message_free( reply );
+		lo_message message = lo_message_new();
+		lo_message_add_string( message, names.back().constData() );
+		lo_message_add_float( message, sstatistics.fP50 );
+		lo_message_add_float( message, sstatistics.fP99 );
+		lo_message_add_float( message, sstatistics.fMax );
+		lo_message_add_float( message, sstatistics.fPeak );
+		lo_message_add_int64( message, sstatistics.nCount );
+		lo_bundle_add_message( bundle, "/Hydrogen/PROFILING_STATS", message );
 	}
 
-	if ( type == MidiAction::Type::MuteToggle ) {
-		lo_message reply = lo_message_new();
-		lo_message_add_float( reply, fValue );
+	const auto pAudioDriver = pAudioEngine->getAudioDriver();
+	lo_message message = lo_message_new();
+	lo_message_add_int64( message, pProfiler->getOverruns() );
+	lo_message_add_float( message, pProfiler->getBudget() );
+	lo_message_add_int32( message, pAudioDriver != nullptr ?
+						  pAudioDriver->getXRuns() : 0 );
+	lo_bundle_add_message( bundle, "/Hydrogen/PROFILING_OVERRUNS", message );
 
-		broadcastMessage( "/Hydrogen/MUTE_TOGGLE", reply );
+	lo_send_bundle( address, bundle );
+	lo_bundle_free_recursive( bundle );
+}
 
-		lo_message_free( reply );
-	}
+void OscServer::feedbackLoop() {
+	std::unique_lock<std::mutex> lock( m_feedbackMutex );
+	while ( true ) {
+		m_feedbackCV.wait( lock, [&]() {
+			return m_bStopFeedbackThread || ! m_pendingFeedback.empty(); } );
+		if ( m_bStopFeedbackThread ) {
+			break;
+		}
 
-	if ( type == MidiAction::Type::StripMuteToggle ) {
-		lo_message reply = lo_message_new();
-		lo_message_add_float( reply, fValue );
+		std::map<std::pair<MidiAction::Type, int>, float> pending;
+		pending.swap( m_pendingFeedback );
 
-		QByteArray ba = QString( "/Hydrogen/STRIP_MUTE_TOGGLE/%1" )
-							.arg( nInstrumentIndex )
-							.toLatin1();
-		const char* c_str2 = ba.data();
+		lock.unlock();
+		broadcastBundle( pending );
+		lock.lock();
 
-		broadcastMessage( c_str2, reply );
+		// Changes arriving in the meantime are collected and sent as part
+		// of the next bundle.
+		m_feedbackCV.wait_for(
+			lock, std::chrono::milliseconds( nFeedbackIntervalMs ),
+			[&]() { return m_bStopFeedbackThread; } );
+	}
+}
 
-		lo_message_free( reply );
+void OscServer::startFeedbackThread() {
+	std::lock_guard<std::mutex> lock( m_feedbackMutex );
+	if ( m_bFeedbackThreadRunning ) {
+		return;
 	}
 
-	if ( type == MidiAction::Type::StripSoloToggle ) {
-		lo_message reply = lo_message_new();
-		lo_message_add_float( reply, fValue );
+	m_bStopFeedbackThread = false;
+	m_bFeedbackThreadRunning = true;
+	m_feedbackThread = std::thread( &OscServer::feedbackLoop, this );
+}
 
-		QByteArray ba = QString( "/Hydrogen/STRIP_SOLO_TOGGLE/%1" )
-							.arg( nInstrumentIndex )
-							.toLatin1();
-		const char* c_str2 = ba.data();
+void OscServer::stopFeedbackThread() {
+	{
+		std::lock_guard<std::mutex> lock( m_feedbackMutex );
+		if ( ! m_bFeedbackThreadRunning ) {
+			return;
+		}
+		m_bStopFeedbackThread = true;
+		m_bFeedbackThreadRunning = false;
+		m_pendingFeedback.clear();
+	}
+	m_feedbackCV.notify_one();
 
-		broadcastMessage( c_str2, reply );
+	if ( m_feedbackThread.joinable() ) {
+		m_feedbackThread.join();
+	}
+}
 
-		lo_message_free( reply );
+bool OscServer::registerClient( lo_address address ) {
+	{
+		std::lock_guard<std::mutex> lock( m_clientRegistryMutex );
+		if ( ! m_clientKeys.insert( LoAddressKey( address ) ).second ) {
+			return false;
+		}
+		m_pClientRegistry.push_back(
+			lo_address_new_with_proto( lo_address_get_protocol( address ),
+									   lo_address_get_hostname( address ),
+									   lo_address_get_port( address ) ) );
 	}
 
-	if ( type == MidiAction::Type::PanAbsolute ) {
-		lo_message reply = lo_message_new();
-		lo_message_add_float( reply, fValue );
+	INFOLOG( QString( "New OSC client registered. Hostname: %1, port: %2, protocol: %3" )
+			 .arg( lo_address_get_hostname( address ) )
+			 .arg( lo_address_get_port( address ) )
+			 .arg( lo_address_get_protocol( address ) ) );
 
-		QByteArray ba = QString( "/Hydrogen/PAN_ABSOLUTE/%1" )
-							.arg( nInstrumentIndex )
-							.toLatin1();
-		const char* c_str2 = ba.data();
+	return true;
+}
 
-		broadcastMessage( c_str2, reply );
+// -------------------------------------------------------------------
+// Main Midiaction handler
 
-		lo_message_free( reply );
+void OscServer::sendFeedbackMessage(
+	MidiAction::Type type,
+	float fValue,
+	int nInstrumentIndex
+)
+{
+	if ( !H2Core::Preferences::get_instance()->getOscFeedbackEnabled() ) {
+		return;
 	}
 
-	if ( type == MidiAction::Type::PanAbsoluteSym ) {
-		lo_message reply = lo_message_new();
-		lo_message_add_float( reply, fValue );
-
-		QByteArray ba = QString( "/Hydrogen/PAN_ABSOLUTE_SYM/%1" )
-							.arg( nInstrumentIndex )
-							.toLatin1();
-		const char* c_str2 = ba.data();
-
-		broadcastMessage( c_str2, reply );
-
-		lo_message_free( reply );
+	{
+		std::lock_guard<std::mutex> lock( m_feedbackMutex );
+		if ( ! m_bFeedbackThreadRunning ) {
+			return;
+		}
+		m_pendingFeedback[ { type, nInstrumentIndex } ] = fValue;
 	}
+	m_feedbackCV.notify_one();
 }
 
 bool OscServer::init()
@@ -1387,29 +1369,12 @@ bool OscServer::init()
 	 *  Register all handler functions
 	 */
 
+	// Build the dispatch table of generic_handler().
+	stripRoutes();
+
 	//This handler is responsible for registering clients
 	m_pServerThread->add_method(nullptr, nullptr, [&](lo_message msg) {
-		lo_address address = lo_message_get_source(msg);
-
-		bool AddressRegistered = false;
-		for ( const auto& cclientAddress : m_pClientRegistry ) {
-			if ( IsLoAddressEqual( address, cclientAddress ) ) {
-				AddressRegistered = true;
-				break;
-			}
-		}
-
-		if ( ! AddressRegistered ) {
-			lo_address newAddress =
-				lo_address_new_with_proto( lo_address_get_protocol( address ),
-										   lo_address_get_hostname( address ),
-										   lo_address_get_port( address ) );
-			m_pClientRegistry.push_back( newAddress );
-			INFOLOG( QString( "New OSC client registered. Hostname: %1, port: %2, protocol: %3" )
-					 .arg( lo_address_get_hostname( address ) )
-					 .arg( lo_address_get_port( address ) )
-					 .arg( lo_address_get_protocol( address ) ) );
-										
+		if ( registerClient( lo_message_get_source( msg ) ) ) {
 			H2Core::CoreActionController::initExternalControlInterfaces();
 		}
 									
@@ -1589,6 +1554,12 @@ bool OscServer::init()
 	m_pServerThread->add_method("/Hydrogen/PLAYLIST_REMOVE_SONG", "f",
 								PLAYLIST_REMOVE_SONG_Handler);
 
+	m_pServerThread->add_method(
+		"/Hydrogen/PROFILING_STATS", "", [&]( lo_message msg ) {
+			sendProfilingStatistics( lo_message_get_source( msg ) );
+			return 0;
+		});
+
 	m_pServerThread->add_method(nullptr, nullptr, generic_handler, nullptr);
 
 	m_bInitialized = true;
@@ -1609,6 +1580,7 @@ bool OscServer::start() {
 	}
 
 	m_pServerThread->start();
+	startFeedbackThread();
 
 	int nOscPortUsed;
 	const auto pPref = H2Core::Preferences::get_instance();
@@ -1631,6 +1603,7 @@ bool OscServer::stop() {
 	}
 
 	m_pServerThread->stop();
+	stopFeedbackThread();
 	INFOLOG(QString("Osc server stopped" ));
 
 	return true;
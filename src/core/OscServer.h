@@ -31,7 +31,16 @@
 #include <core/Object.h>
 
 #include <cassert>
+#include <condition_variable>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace lo
 {
@@ -203,6 +212,11 @@ class OscServer : public H2Core::Object<OscServer>
 		 * [x] The last part of the URI is determined by @a nInstrumentIndex and
 		 * specifies an individual instrument.
 		 *
+		 * Messages are not sent right away. Instead, only the latest value
+		 * per path is kept and all pending values are sent as a single OSC
+		 * bundle at most every #nFeedbackIntervalMs milliseconds. This way
+		 * moving a fader does not flood the clients.
+		 *
 		 * Only called if H2Core::Preferences::m_bOscServerEnabled is
 		 * true.
 		 */
@@ -212,6 +226,12 @@ class OscServer : public H2Core::Object<OscServer>
 			int nInstrumentIndex
 		);
 
+		/** Adds @a address to #m_pClientRegistry unless it is already
+		 * present. All feedback messages will be sent to it from now on.
+		 *
+		 * \return `true` in case the client was not registered before. */
+		bool registerClient( lo_address address );
+
 		/** Should be only used within the integration tests! */
 	lo::ServerThread* getServerThread() const;
 
@@ -910,6 +930,9 @@ class OscServer : public H2Core::Object<OscServer>
 		 *
 		 * [x] Digit specifying a particular instrument.
 		 *
+		 * Paths are resolved using a table built once in init() and the
+		 * strip number is parsed directly from the path.
+		 *
 		 * \param path The OSC path to register the method to. If NULL
 		 * is passed the method will match all paths.
 		 * \param types The typespec the method accepts. In Hydrogen
@@ -929,10 +952,42 @@ class OscServer : public H2Core::Object<OscServer>
 
 	private:
 		OscServer( int nOscPort );
-		
-		/** Helper function which sends a message with msgText to all 
-		 * connected clients. **/
-		void broadcastMessage( const char* msgText, const lo_message& message);
+
+		/** Handler of a path carrying a strip number as its last part. */
+		struct StripRoute {
+			/** Whether the message may omit its single argument. */
+			bool bArgumentOptional;
+			void (*handler)( int nStrip, lo_arg** argv, int argc );
+		};
+		/** Maps the second segment of all strip paths - like
+		 * `STRIP_VOLUME_ABSOLUTE` in `/Hydrogen/STRIP_VOLUME_ABSOLUTE/2` - to
+		 * its handler. */
+		static const std::unordered_map<std::string_view, StripRoute>& stripRoutes();
+
+		/** \return OSC path of a feedback message or an empty array in case
+		 * @a type is not sent to the clients. */
+		static QByteArray feedbackPath( MidiAction::Type type,
+										int nInstrumentIndex );
+		/** Sends all values in @a pending as a single bundle to all
+		 * connected clients. */
+		void broadcastBundle(
+			const std::map<std::pair<MidiAction::Type, int>, float>& pending );
+		/** Answers a message sent to \e /Hydrogen/PROFILING_STATS by
+		 * sending a bundle to @a address containing a \e
+		 * /Hydrogen/PROFILING_STATS message - name, p50, p99, and maximum
+		 * of the rolling window, peak in microseconds, and number of
+		 * recorded cycles - for each stage of the #AudioEngineProfiler and
+		 * a single \e /Hydrogen/PROFILING_OVERRUNS message - overruns,
+		 * buffer duration in microseconds, and xruns reported by the audio
+		 * driver. */
+		void sendProfilingStatistics( lo_address address );
+		/** Body of #m_feedbackThread. */
+		void feedbackLoop();
+		void startFeedbackThread();
+		void stopFeedbackThread();
+
+		/** Lower bound of the time in between two feedback bundles. */
+		static constexpr int nFeedbackIntervalMs = 20;
 
 		/**
 		 * Used to determine whether the callback methods were already
@@ -952,12 +1007,25 @@ class OscServer : public H2Core::Object<OscServer>
 		 *
 		 * Whenever an OSC client sends a message to the started OSC
 		 * server of Hydrogen, a lambda handler registered in start()
-		 * will check whether the address of this client is already
-		 * present in #m_pClientRegistry. If this is not the case it
-		 * will be added to it and the current state Hydrogen will be
-		 * propagated to all registered clients.
+		 * will pass its address to registerClient(). If the client was
+		 * not known yet, it will be added to it and the current state of
+		 * Hydrogen will be propagated to all registered clients.
 		 */
 		std::list<lo_address> m_pClientRegistry;
+		/** Protocol, hostname, and port of all addresses in
+		 * #m_pClientRegistry for constant time lookup. */
+		std::unordered_set<std::string> m_clientKeys;
+		/** Protects #m_pClientRegistry and #m_clientKeys. */
+		std::mutex m_clientRegistryMutex;
+
+		/** Latest value of each feedback message not sent yet. Keyed by
+		 * type and instrument index. */
+		std::map<std::pair<MidiAction::Type, int>, float> m_pendingFeedback;
+		std::mutex m_feedbackMutex;
+		std::condition_variable m_feedbackCV;
+		std::thread m_feedbackThread;
+		bool m_bFeedbackThreadRunning;
+		bool m_bStopFeedbackThread;
 
 		/**
 		 * In case #Preferences::m_nOscServerPort is already occupied by another
@@ -114,6 +114,7 @@ Preferences::Preferences()
 	  m_bOscServerEnabled( false ),
 	  m_bOscFeedbackEnabled( true ),
 	  m_nOscServerPort( 9000 ),
+	  m_bAlsaDither( false ),
 	  m_sPortAudioDevice( "" ),
 	  m_sPortAudioHostAPI( "" ),
 	  m_nLatencyTarget( 0 ),
@@ -303,6 +304,7 @@ Preferences::Preferences( std::shared_ptr<Preferences> pOther )
 	  m_bOscFeedbackEnabled( pOther->m_bOscFeedbackEnabled ),
 	  m_nOscServerPort( pOther->m_nOscServerPort ),
 	  m_sAlsaAudioDevice( pOther->m_sAlsaAudioDevice ),
+	  m_bAlsaDither( pOther->m_bAlsaDither ),
 	  m_sPortAudioDevice( pOther->m_sPortAudioDevice ),
 	  m_sPortAudioHostAPI( pOther->m_sPortAudioHostAPI ),
 	  m_nLatencyTarget( pOther->m_nLatencyTarget ),
@@ -769,6 +771,9 @@ Preferences::load( const QString& sPath, const bool bSilent )
 				"alsa_audio_device", pPref->m_sAlsaAudioDevice, false, false,
 				bSilent
 			);
+			pPref->m_bAlsaDither = alsaAudioDriverNode.read_bool(
+				"alsa_dither", pPref->m_bAlsaDither, true, false, bSilent
+			);
 		}
 		else {
 			WARNINGLOG( "<alsa_audio_driver> node not found" );
@@ -1585,6 +1590,7 @@ bool Preferences::saveTo( const QString& sPath, const bool bSilent ) const
 			alsaAudioDriverNode.write_string(
 				"alsa_audio_device", m_sAlsaAudioDevice
 			);
+			alsaAudioDriverNode.write_bool( "alsa_dither", m_bAlsaDither );
 		}
 
 		/// MIDI DRIVER ///
@@ -2312,6 +2318,10 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const
 							 .arg( sPrefix )
 							 .arg( s )
 							 .arg( m_sAlsaAudioDevice ) )
+				.append( QString( "%1%2m_bAlsaDither: %3\n" )
+							 .arg( sPrefix )
+							 .arg( s )
+							 .arg( m_bAlsaDither ) )
 				.append( QString( "%1%2m_sPortAudioDevice: %3\n" )
 							 .arg( sPrefix )
 							 .arg( s )
@@ -2752,6 +2762,8 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const
 				)
 				.append( QString( ", m_sAlsaAudioDevice: %1" )
 							 .arg( m_sAlsaAudioDevice ) )
+				.append( QString( ", m_bAlsaDither: %1" )
+							 .arg( m_bAlsaDither ) )
 				.append( QString( ", m_sPortAudioDevice: %1" )
 							 .arg( m_sPortAudioDevice ) )
 				.append( QString( ", m_sPortAudioHostAPI: %1" )
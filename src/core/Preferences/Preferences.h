@@ -323,6 +323,9 @@ class Preferences : public H2Core::Object<Preferences> {
 
 	//	alsa audio driver properties ___
 	QString m_sAlsaAudioDevice;
+	/** Whether the ALSA audio driver applies TPDF dither when writing 16 or
+	 * 24 bit integer samples. */
+	bool m_bAlsaDither;
 
 	// PortAudio properties
 	QString m_sPortAudioDevice;
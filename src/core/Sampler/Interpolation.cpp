@@ -0,0 +1,205 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Sampler/Interpolation.h>
+#include <core/Sampler/InterpolationKernels.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || \
+	( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+  #define H2CORE_INTERPOLATION_SSE2
+  #include <emmintrin.h>
+#endif
+
+#if defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+  #define H2CORE_INTERPOLATION_NEON
+  #include <arm_neon.h>
+#endif
+
+namespace H2Core
+{
+
+namespace Interpolation
+{
+
+namespace {
+
+#ifdef H2CORE_INTERPOLATION_SSE2
+	/** SSE2 is part of the x86_64 baseline. No additional compiler flags or
+	 * runtime checks are required. */
+	struct Sse2Ops {
+		typedef __m128 V;
+		static constexpr int nWidth = 4;
+
+		static inline V set1( float f ) { return _mm_set1_ps( f ); }
+		static inline V add( V a, V b ) { return _mm_add_ps( a, b ); }
+		static inline V sub( V a, V b ) { return _mm_sub_ps( a, b ); }
+		static inline V mul( V a, V b ) { return _mm_mul_ps( a, b ); }
+		static inline V load( const float* p ) { return _mm_load_ps( p ); }
+		static inline void store( float* p, V v ) { _mm_storeu_ps( p, v ); }
+
+		/** The four input frames of each output frame are adjacent in
+		 * memory. We load them as rows and transpose them into one vector
+		 * per input frame offset. */
+		static inline void gather( const float* __restrict__ pData,
+								   const long long* pIndices,
+								   V& y0, V& y1, V& y2, V& y3 ) {
+			y0 = _mm_loadu_ps( &pData[ pIndices[ 0 ] - 1 ] );
+			y1 = _mm_loadu_ps( &pData[ pIndices[ 1 ] - 1 ] );
+			y2 = _mm_loadu_ps( &pData[ pIndices[ 2 ] - 1 ] );
+			y3 = _mm_loadu_ps( &pData[ pIndices[ 3 ] - 1 ] );
+			_MM_TRANSPOSE4_PS( y0, y1, y2, y3 );
+		}
+	};
+#endif
+
+#ifdef H2CORE_INTERPOLATION_NEON
+	struct NeonOps {
+		typedef float32x4_t V;
+		static constexpr int nWidth = 4;
+
+		static inline V set1( float f ) { return vdupq_n_f32( f ); }
+		static inline V add( V a, V b ) { return vaddq_f32( a, b ); }
+		static inline V sub( V a, V b ) { return vsubq_f32( a, b ); }
+		static inline V mul( V a, V b ) { return vmulq_f32( a, b ); }
+		static inline V load( const float* p ) { return vld1q_f32( p ); }
+		static inline void store( float* p, V v ) { vst1q_f32( p, v ); }
+
+		/** Same approach as for SSE2: load rows and transpose them. */
+		static inline void gather( const float* __restrict__ pData,
+								   const long long* pIndices,
+								   V& y0, V& y1, V& y2, V& y3 ) {
+			const V r0 = vld1q_f32( &pData[ pIndices[ 0 ] - 1 ] );
+			const V r1 = vld1q_f32( &pData[ pIndices[ 1 ] - 1 ] );
+			const V r2 = vld1q_f32( &pData[ pIndices[ 2 ] - 1 ] );
+			const V r3 = vld1q_f32( &pData[ pIndices[ 3 ] - 1 ] );
+			const float32x4x2_t t01 = vtrnq_f32( r0, r1 );
+			const float32x4x2_t t23 = vtrnq_f32( r2, r3 );
+			y0 = vcombine_f32( vget_low_f32( t01.val[ 0 ] ),
+							   vget_low_f32( t23.val[ 0 ] ) );
+			y1 = vcombine_f32( vget_low_f32( t01.val[ 1 ] ),
+							   vget_low_f32( t23.val[ 1 ] ) );
+			y2 = vcombine_f32( vget_high_f32( t01.val[ 0 ] ),
+							   vget_high_f32( t23.val[ 0 ] ) );
+			y3 = vcombine_f32( vget_high_f32( t01.val[ 1 ] ),
+							   vget_high_f32( t23.val[ 1 ] ) );
+		}
+	};
+#endif
+
+	Simd querySimd() {
+#ifdef H2CORE_INTERPOLATION_SSE2
+  #if ( defined( __GNUC__ ) || defined( __clang__ ) ) && \
+	  ( defined( __x86_64__ ) || defined( __i386__ ) )
+		if ( getAvx2BlockKernel( InterpolateMode::Linear ) != nullptr ) {
+			__builtin_cpu_init();
+			if ( __builtin_cpu_supports( "avx2" ) ) {
+				return Simd::AVX2;
+			}
+		}
+  #endif
+		return Simd::SSE2;
+#elif defined( H2CORE_INTERPOLATION_NEON )
+		return Simd::NEON;
+#else
+		return Simd::None;
+#endif
+	}
+
+	/** Kernels of the best instruction set available indexed by
+	 * #InterpolateMode. Resolved once on first use so the audio thread does
+	 * only have to perform a lookup afterwards. */
+	struct KernelTable {
+		KernelTable() {
+			const Simd simd = detectSimd();
+			for ( int ii = 0; ii < nModes; ++ii ) {
+				kernels[ ii ] =
+					getBlockKernel( static_cast<InterpolateMode>( ii ), simd );
+			}
+		}
+
+		static constexpr int nModes =
+			static_cast<int>( InterpolateMode::Hermite ) + 1;
+		BlockKernel kernels[ nModes ];
+	};
+
+} // anonymous namespace
+
+Simd detectSimd()
+{
+	static const Simd simd = querySimd();
+	return simd;
+}
+
+bool isSimdSupported( Simd simd )
+{
+	switch ( simd ) {
+	case Simd::None:
+		return true;
+	case Simd::SSE2:
+#ifdef H2CORE_INTERPOLATION_SSE2
+		return true;
+#else
+		return false;
+#endif
+	case Simd::AVX2:
+		return detectSimd() == Simd::AVX2;
+	case Simd::NEON:
+#ifdef H2CORE_INTERPOLATION_NEON
+		return true;
+#else
+		return false;
+#endif
+	default:
+		return false;
+	}
+}
+
+BlockKernel getBlockKernel( InterpolateMode mode, Simd simd )
+{
+	if ( ! isSimdSupported( simd ) ) {
+		simd = Simd::None;
+	}
+
+	switch ( simd ) {
+#ifdef H2CORE_INTERPOLATION_SSE2
+	case Simd::SSE2:
+		return blockKernelFor<Sse2Ops>( mode );
+	case Simd::AVX2:
+		return getAvx2BlockKernel( mode );
+#endif
+#ifdef H2CORE_INTERPOLATION_NEON
+	case Simd::NEON:
+		return blockKernelFor<NeonOps>( mode );
+#endif
+	default:
+		return blockKernelFor<ScalarOps>( mode );
+	}
+}
+
+BlockKernel getBlockKernel( InterpolateMode mode )
+{
+	static const KernelTable table;
+	return table.kernels[ static_cast<int>( mode ) ];
+}
+
+};
+
+}
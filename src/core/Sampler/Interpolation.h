@@ -23,6 +23,7 @@
 #ifndef INTERPOLATION_H
 #define INTERPOLATION_H
 
+#include <cassert>
 #include <cmath>
 #include <QString>
 
@@ -137,6 +138,66 @@ namespace Interpolation
 			return( a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3 );
 	};
 
+	/** Instruction sets available for the block kernels used by the
+	 * Sampler to resample the main body of a sample.
+	 *
+	 * Which one is used is decided at runtime using detectSimd(). */
+	enum class Simd { None = 0,
+					  SSE2 = 1,
+					  AVX2 = 2,
+					  NEON = 3 };
+
+	static const QString SimdToQString( const Simd& simd )
+	{
+		switch ( simd ) {
+		case Simd::None:
+			return "None";
+		case Simd::SSE2:
+			return "SSE2";
+		case Simd::AVX2:
+			return "AVX2";
+		case Simd::NEON:
+			return "NEON";
+		default:
+			return "<unknown>";
+		}
+	}
+
+	/** Interpolates @a nFrames output frames of both channels at once.
+	 *
+	 * The read position of output frame `n` is `fSamplePos + n * fStep`.
+	 * All input frames required to interpolate the read positions - from
+	 * one frame before to two frames after - must lie within the sample
+	 * data. The caller is responsible to handle the beginning and end of
+	 * the sample.
+	 *
+	 * In contrast to interpolate() all computations are done in single
+	 * precision and several output frames are processed per iteration. */
+	typedef void (*BlockKernel)( const float* __restrict__ pSample_data_L,
+								 const float* __restrict__ pSample_data_R,
+								 float* __restrict__ pBuffer_L,
+								 float* __restrict__ pBuffer_R,
+								 int nFrames,
+								 double fSamplePos,
+								 double fStep );
+
+	/** @return the most capable instruction set supported by both the build
+	 * and the CPU Hydrogen is running on. The CPU is only queried once. */
+	Simd detectSimd();
+
+	/** @return whether kernels for @a simd can be used on this machine. */
+	bool isSimdSupported( Simd simd );
+
+	/** @return block kernel of @a mode using instruction set @a simd. In case
+	 * @a simd is not supported, the portable #Simd::None kernel is
+	 * returned. */
+	BlockKernel getBlockKernel( InterpolateMode mode, Simd simd );
+
+	/** @return block kernel of @a mode using the instruction set determined
+	 * by detectSimd(). The kernels are resolved only once and this function
+	 * is safe to be called from the audio thread. */
+	BlockKernel getBlockKernel( InterpolateMode mode );
+
 	template < InterpolateMode mode >
 	inline static float interpolate( float y0, float y1, float y2, float y3, double mu )
 	{
@@ -0,0 +1,93 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+// This translation unit is compiled with AVX2 enabled (see
+// src/core/CMakeLists.txt). Its kernels must only be called after
+// Interpolation::detectSimd() confirmed the CPU does support AVX2. Keep it
+// free of anything not strictly required by the kernels.
+
+#include <core/Sampler/InterpolationKernels.h>
+
+#ifdef __AVX2__
+  #include <immintrin.h>
+#endif
+
+namespace H2Core
+{
+
+namespace Interpolation
+{
+
+#ifdef __AVX2__
+namespace {
+
+	struct Avx2Ops {
+		typedef __m256 V;
+		static constexpr int nWidth = 8;
+
+		static inline V set1( float f ) { return _mm256_set1_ps( f ); }
+		static inline V add( V a, V b ) { return _mm256_add_ps( a, b ); }
+		static inline V sub( V a, V b ) { return _mm256_sub_ps( a, b ); }
+		static inline V mul( V a, V b ) { return _mm256_mul_ps( a, b ); }
+		static inline V load( const float* p ) { return _mm256_load_ps( p ); }
+		static inline void store( float* p, V v ) { _mm256_storeu_ps( p, v ); }
+
+		/** Gathers relative to the read position of the first lane. This way
+		 * 32 bit offsets suffice regardless of the length of the sample. */
+		static inline void gather( const float* __restrict__ pData,
+								   const long long* pIndices,
+								   V& y0, V& y1, V& y2, V& y3 ) {
+			const __m256i offsets = _mm256_setr_epi32(
+				0,
+				static_cast<int>( pIndices[ 1 ] - pIndices[ 0 ] ),
+				static_cast<int>( pIndices[ 2 ] - pIndices[ 0 ] ),
+				static_cast<int>( pIndices[ 3 ] - pIndices[ 0 ] ),
+				static_cast<int>( pIndices[ 4 ] - pIndices[ 0 ] ),
+				static_cast<int>( pIndices[ 5 ] - pIndices[ 0 ] ),
+				static_cast<int>( pIndices[ 6 ] - pIndices[ 0 ] ),
+				static_cast<int>( pIndices[ 7 ] - pIndices[ 0 ] ) );
+			const float* pBase = &pData[ pIndices[ 0 ] ];
+			y0 = _mm256_i32gather_ps( pBase - 1, offsets, 4 );
+			y1 = _mm256_i32gather_ps( pBase, offsets, 4 );
+			y2 = _mm256_i32gather_ps( pBase + 1, offsets, 4 );
+			y3 = _mm256_i32gather_ps( pBase + 2, offsets, 4 );
+		}
+	};
+
+} // anonymous namespace
+
+BlockKernel getAvx2BlockKernel( InterpolateMode mode )
+{
+	return blockKernelFor<Avx2Ops>( mode );
+}
+
+#else
+
+BlockKernel getAvx2BlockKernel( InterpolateMode mode )
+{
+	return nullptr;
+}
+
+#endif
+
+};
+
+}
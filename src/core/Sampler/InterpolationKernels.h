@@ -0,0 +1,242 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef INTERPOLATION_KERNELS_H
+#define INTERPOLATION_KERNELS_H
+
+#include <core/Sampler/Interpolation.h>
+
+/** Internal header shared by the translation units implementing the block
+ * kernels of #H2Core::Interpolation. It must not be included anywhere else.
+ *
+ * The kernels are written once as templates over an "operations" struct
+ * wrapping the intrinsics of a particular instruction set. Since some of the
+ * translation units are compiled with additional instruction sets enabled
+ * (e.g. AVX2), everything in here lives in an anonymous namespace. Else the
+ * linker would be free to merge instantiations of e.g. the scalar tail loop
+ * compiled with and without AVX2 and we might end up executing AVX2
+ * instructions on a CPU not supporting them. */
+
+namespace H2Core
+{
+
+namespace Interpolation
+{
+
+	/** Kernels of #Simd::AVX2. Defined in InterpolationAvx2.cpp, which is
+	 * compiled with AVX2 enabled.
+	 *
+	 * @return `nullptr` in case the build does not support AVX2. */
+	BlockKernel getAvx2BlockKernel( InterpolateMode mode );
+
+namespace {
+
+	/** Operations on a single float. Used as portable fallback and to handle
+	 * the frames remaining after the last full vector. */
+	struct ScalarOps {
+		typedef float V;
+		static constexpr int nWidth = 1;
+
+		static inline V set1( float f ) { return f; }
+		static inline V add( V a, V b ) { return a + b; }
+		static inline V sub( V a, V b ) { return a - b; }
+		static inline V mul( V a, V b ) { return a * b; }
+		static inline V load( const float* p ) { return *p; }
+		static inline void store( float* p, V v ) { *p = v; }
+		static inline void gather( const float* __restrict__ pData,
+								   const long long* pIndices,
+								   V& y0, V& y1, V& y2, V& y3 ) {
+			const float* p = &pData[ pIndices[ 0 ] - 1 ];
+			y0 = p[ 0 ];
+			y1 = p[ 1 ];
+			y2 = p[ 2 ];
+			y3 = p[ 3 ];
+		}
+	};
+
+	/** Computes `( 1 - cos( mu * pi ) ) / 2` for @a mu in [0,1).
+	 *
+	 * Using the identity `( 1 - cos( mu * pi ) ) / 2 = ( 1 + sin( x ) ) / 2`
+	 * with `x = ( mu - 0.5 ) * pi` in [-pi/2,pi/2), the sine can be
+	 * approximated by its Taylor series. Truncated after the x^11 term the
+	 * error is below the resolution of a float. */
+	template < class Ops >
+	inline typename Ops::V cosineWeight( typename Ops::V mu ) {
+		typedef typename Ops::V V;
+		const V x = Ops::mul( Ops::sub( mu, Ops::set1( 0.5f ) ),
+							  Ops::set1( 3.14159265f ) );
+		const V x2 = Ops::mul( x, x );
+		V p = Ops::set1( -1.0f / 39916800.0f );
+		p = Ops::add( Ops::mul( p, x2 ), Ops::set1( 1.0f / 362880.0f ) );
+		p = Ops::add( Ops::mul( p, x2 ), Ops::set1( -1.0f / 5040.0f ) );
+		p = Ops::add( Ops::mul( p, x2 ), Ops::set1( 1.0f / 120.0f ) );
+		p = Ops::add( Ops::mul( p, x2 ), Ops::set1( -1.0f / 6.0f ) );
+		p = Ops::add( Ops::mul( p, x2 ), Ops::set1( 1.0f ) );
+		const V fSin = Ops::mul( p, x );
+		return Ops::mul( Ops::add( Ops::set1( 1.0f ), fSin ),
+						 Ops::set1( 0.5f ) );
+	}
+
+	/** Vectorized counterpart of interpolate(). Each lane of the arguments
+	 * holds a separate output frame. */
+	template < class Ops, InterpolateMode mode >
+	inline typename Ops::V interpolateLanes( typename Ops::V y0,
+											 typename Ops::V y1,
+											 typename Ops::V y2,
+											 typename Ops::V y3,
+											 typename Ops::V mu ) {
+		typedef typename Ops::V V;
+		const V fHalf = Ops::set1( 0.5f );
+
+		switch ( mode ) {
+		case InterpolateMode::Linear:
+			return Ops::add( Ops::mul( y1, Ops::sub( Ops::set1( 1.0f ), mu ) ),
+							 Ops::mul( y2, mu ) );
+
+		case InterpolateMode::Cosine: {
+			const V mu2 = cosineWeight<Ops>( mu );
+			return Ops::add( Ops::mul( y1, Ops::sub( Ops::set1( 1.0f ), mu2 ) ),
+							 Ops::mul( y2, mu2 ) );
+		}
+
+		case InterpolateMode::Third: {
+			const V c0 = y1;
+			const V c1 = Ops::mul( fHalf, Ops::sub( y2, y0 ) );
+			const V c3 = Ops::add( Ops::mul( Ops::set1( 1.5f ), Ops::sub( y1, y2 ) ),
+								   Ops::mul( fHalf, Ops::sub( y3, y0 ) ) );
+			const V c2 = Ops::sub( Ops::add( Ops::sub( y0, y1 ), c1 ), c3 );
+			V res = Ops::add( Ops::mul( c3, mu ), c2 );
+			res = Ops::add( Ops::mul( res, mu ), c1 );
+			return Ops::add( Ops::mul( res, mu ), c0 );
+		}
+
+		case InterpolateMode::Cubic: {
+			const V a0 = Ops::add( Ops::sub( Ops::sub( y3, y2 ), y0 ), y1 );
+			const V a1 = Ops::sub( Ops::sub( y0, y1 ), a0 );
+			const V a2 = Ops::sub( y2, y0 );
+			const V a3 = y1;
+			V res = Ops::add( Ops::mul( a0, mu ), a1 );
+			res = Ops::add( Ops::mul( res, mu ), a2 );
+			return Ops::add( Ops::mul( res, mu ), a3 );
+		}
+
+		case InterpolateMode::Hermite:
+		default: {
+			const V fOneAndHalf = Ops::set1( 1.5f );
+			const V a0 = Ops::add(
+				Ops::sub( Ops::mul( fOneAndHalf, Ops::sub( y1, y2 ) ),
+						  Ops::mul( fHalf, y0 ) ),
+				Ops::mul( fHalf, y3 ) );
+			const V a1 = Ops::sub(
+				Ops::add( Ops::sub( y0, Ops::mul( Ops::set1( 2.5f ), y1 ) ),
+						  Ops::mul( Ops::set1( 2.0f ), y2 ) ),
+				Ops::mul( fHalf, y3 ) );
+			const V a2 = Ops::mul( fHalf, Ops::sub( y2, y0 ) );
+			const V a3 = y1;
+			V res = Ops::add( Ops::mul( a0, mu ), a1 );
+			res = Ops::add( Ops::mul( res, mu ), a2 );
+			return Ops::add( Ops::mul( res, mu ), a3 );
+		}
+		}
+	}
+
+	/** Generic block kernel. Processes Ops::nWidth output frames per
+	 * iteration and the remainder using #ScalarOps.
+	 *
+	 * The read positions are computed in double precision - just as in the
+	 * scalar path of the Sampler - and only the fractional part is
+	 * converted to float. */
+	template < class Ops, InterpolateMode mode >
+	void blockKernel( const float* __restrict__ pSample_data_L,
+					  const float* __restrict__ pSample_data_R,
+					  float* __restrict__ pBuffer_L,
+					  float* __restrict__ pBuffer_R,
+					  int nFrames,
+					  double fSamplePos,
+					  double fStep ) {
+		constexpr int nWidth = Ops::nWidth;
+		alignas( 32 ) float mu[ nWidth ];
+		long long indices[ nWidth ];
+
+		int nFrame = 0;
+		for ( ; nFrame + nWidth <= nFrames; nFrame += nWidth ) {
+			for ( int ii = 0; ii < nWidth; ++ii ) {
+				const double fPos =
+					fSamplePos + static_cast<double>( nFrame + ii ) * fStep;
+				indices[ ii ] = static_cast<long long>( fPos );
+				mu[ ii ] = static_cast<float>(
+					fPos - static_cast<double>( indices[ ii ] ) );
+			}
+			const typename Ops::V vMu = Ops::load( mu );
+			typename Ops::V y0, y1, y2, y3;
+
+			Ops::gather( pSample_data_L, indices, y0, y1, y2, y3 );
+			Ops::store( &pBuffer_L[ nFrame ],
+						interpolateLanes<Ops, mode>( y0, y1, y2, y3, vMu ) );
+
+			Ops::gather( pSample_data_R, indices, y0, y1, y2, y3 );
+			Ops::store( &pBuffer_R[ nFrame ],
+						interpolateLanes<Ops, mode>( y0, y1, y2, y3, vMu ) );
+		}
+
+		for ( ; nFrame < nFrames; ++nFrame ) {
+			const double fPos =
+				fSamplePos + static_cast<double>( nFrame ) * fStep;
+			const long long nIndex = static_cast<long long>( fPos );
+			const float fMu =
+				static_cast<float>( fPos - static_cast<double>( nIndex ) );
+			float y0, y1, y2, y3;
+
+			ScalarOps::gather( pSample_data_L, &nIndex, y0, y1, y2, y3 );
+			pBuffer_L[ nFrame ] =
+				interpolateLanes<ScalarOps, mode>( y0, y1, y2, y3, fMu );
+
+			ScalarOps::gather( pSample_data_R, &nIndex, y0, y1, y2, y3 );
+			pBuffer_R[ nFrame ] =
+				interpolateLanes<ScalarOps, mode>( y0, y1, y2, y3, fMu );
+		}
+	}
+
+	/** @return kernel of @a mode for the instruction set wrapped by @a Ops. */
+	template < class Ops >
+	BlockKernel blockKernelFor( InterpolateMode mode ) {
+		switch ( mode ) {
+		case InterpolateMode::Linear:
+			return &blockKernel<Ops, InterpolateMode::Linear>;
+		case InterpolateMode::Cosine:
+			return &blockKernel<Ops, InterpolateMode::Cosine>;
+		case InterpolateMode::Third:
+			return &blockKernel<Ops, InterpolateMode::Third>;
+		case InterpolateMode::Cubic:
+			return &blockKernel<Ops, InterpolateMode::Cubic>;
+		case InterpolateMode::Hermite:
+		default:
+			return &blockKernel<Ops, InterpolateMode::Hermite>;
+		}
+	}
+
+} // anonymous namespace
+
+};
+
+}
+
+#endif // INTERPOLATION_KERNELS_H
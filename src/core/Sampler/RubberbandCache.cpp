@@ -0,0 +1,603 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#include <core/Sampler/RubberbandCache.h>
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Song.h>
+#include <core/Hydrogen.h>
+#include <core/Preferences/Preferences.h>
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <tuple>
+
+namespace H2Core {
+
+/** Bucket value indicating no tempo was requested yet. */
+static constexpr int nNoBucket = -1;
+
+bool RubberbandCache::Key::operator<( const Key& other ) const
+{
+	return std::tie( pSource, nBucket, fLengthInBeats, fSemitonesToShift,
+					 nCrispness ) <
+		   std::tie( other.pSource, other.nBucket, other.fLengthInBeats,
+					 other.fSemitonesToShift, other.nCrispness );
+}
+
+RubberbandCache::RubberbandCache( int nWorkers )
+	: m_bActive( true ),
+	  m_nBusyWorkers( 0 ),
+	  m_nRequestedBucket( nNoBucket ),
+	  m_nScheduledBucket( nNoBucket ),
+	  m_nAccessCount( 0 )
+{
+	if ( nWorkers <= 0 ) {
+		nWorkers = std::clamp(
+			static_cast<int>( std::thread::hardware_concurrency() ), 1,
+			nMaxWorkers );
+	}
+
+	for ( int ii = 0; ii < nWorkers; ++ii ) {
+		m_workers.push_back( std::make_shared<std::thread>(
+			&RubberbandCache::workerLoop, this ) );
+	}
+}
+
+RubberbandCache::~RubberbandCache()
+{
+	{
+		std::scoped_lock lock{ m_mutex };
+		m_bActive = false;
+		m_cv.notify_all();
+		m_idleCv.notify_all();
+	}
+
+	for ( auto& ppWorker : m_workers ) {
+		ppWorker->join();
+	}
+	m_workers.clear();
+}
+
+void RubberbandCache::requestBpm( float fBpm )
+{
+	const int nBucket = bpmToBucket( fBpm );
+	if ( m_nRequestedBucket.load() == nBucket ) {
+		return;
+	}
+
+	// The request has to be stored while holding #m_mutex. Else, it could
+	// be placed right between a worker checking its wait predicate and
+	// going to sleep and the notification would be lost.
+	{
+		std::scoped_lock lock{ m_mutex };
+		m_nRequestedBucket.store( nBucket );
+	}
+	m_cv.notify_one();
+}
+
+void RubberbandCache::prefetch( const std::vector<float>& bpms )
+{
+	std::scoped_lock lock{ m_mutex };
+	for ( const auto& ffBpm : bpms ) {
+		const int nBucket = bpmToBucket( ffBpm );
+		if ( std::find( m_prefetchBuckets.begin(), m_prefetchBuckets.end(),
+						nBucket ) == m_prefetchBuckets.end() ) {
+			m_prefetchBuckets.push_back( nBucket );
+		}
+	}
+
+	// More tempi than we can keep versions of would just evict each other.
+	while ( static_cast<int>( m_prefetchBuckets.size() ) >
+			nMaxVersionsPerSample ) {
+		m_prefetchBuckets.pop_front();
+	}
+
+	m_cv.notify_all();
+}
+
+std::shared_ptr<Sample> RubberbandCache::getStretchedSample(
+	std::shared_ptr<Sample> pSample,
+	float fBpm )
+{
+	if ( pSample == nullptr || ! pSample->getRubberband().bUse ) {
+		return pSample;
+	}
+
+	const auto rubberband = pSample->getRubberband();
+	const int nBucket = bpmToBucket( fBpm );
+
+	std::shared_ptr<Source> pSource;
+	std::shared_ptr<Sample> pOrigin;
+	Key key;
+	{
+		std::scoped_lock lock{ m_mutex };
+		pSource = getSource( pSample );
+		key = makeKey( pSource.get(), rubberband, nBucket );
+		auto pStretched = lookUp( key );
+		if ( pStretched != nullptr ) {
+			return pStretched;
+		}
+		pOrigin = pSource->pOrigin;
+	}
+
+	auto pStretched = stretch( pSource, pOrigin, rubberband, nBucket );
+	if ( pStretched == nullptr ) {
+		return nullptr;
+	}
+
+	std::scoped_lock lock{ m_mutex };
+	return insert( pSource, key, pStretched );
+}
+
+void RubberbandCache::clear()
+{
+	std::scoped_lock lock{ m_mutex };
+	purge( true );
+}
+
+void RubberbandCache::waitUntilIdle()
+{
+	std::unique_lock lock{ m_mutex };
+	m_idleCv.wait( lock, [&]() { return ! m_bActive || isIdle(); } );
+}
+
+int RubberbandCache::getSize()
+{
+	std::scoped_lock lock{ m_mutex };
+	return static_cast<int>( m_entries.size() );
+}
+
+RubberbandCache::Key RubberbandCache::makeKey(
+	const Source* pSource,
+	const Sample::Rubberband& rubberband,
+	int nBucket )
+{
+	Key key;
+	key.pSource = pSource;
+	key.nBucket = nBucket;
+	key.fLengthInBeats = rubberband.fLengthInBeats;
+	key.fSemitonesToShift = rubberband.fSemitonesToShift;
+	key.nCrispness = rubberband.nCrispness;
+
+	return key;
+}
+
+void RubberbandCache::workerLoop()
+{
+	std::unique_lock lock{ m_mutex };
+	while ( m_bActive ) {
+		const int nRequestedBucket = m_nRequestedBucket.load();
+		if ( nRequestedBucket != m_nScheduledBucket ) {
+			m_nScheduledBucket = nRequestedBucket;
+			++m_nBusyWorkers;
+			lock.unlock();
+			schedule( nRequestedBucket, true );
+			lock.lock();
+			--m_nBusyWorkers;
+			continue;
+		}
+
+		if ( ! m_prefetchBuckets.empty() ) {
+			const int nBucket = m_prefetchBuckets.front();
+			m_prefetchBuckets.pop_front();
+			++m_nBusyWorkers;
+			lock.unlock();
+			schedule( nBucket, false );
+			lock.lock();
+			--m_nBusyWorkers;
+			continue;
+		}
+
+		if ( m_jobs.empty() ) {
+			if ( isIdle() ) {
+				m_idleCv.notify_all();
+			}
+			m_cv.wait( lock, [&]() {
+				return ! m_bActive || ! m_jobs.empty() ||
+					! m_prefetchBuckets.empty() ||
+					m_nRequestedBucket.load() != m_nScheduledBucket;
+			} );
+			continue;
+		}
+
+		auto job = std::move( m_jobs.front() );
+		m_jobs.pop_front();
+		++m_nBusyWorkers;
+		lock.unlock();
+		process( job );
+		lock.lock();
+		--m_nBusyWorkers;
+	}
+}
+
+void RubberbandCache::schedule( int nBucket, bool bHandOver )
+{
+	if ( ! Preferences::get_instance()->getRubberBandBatchMode() ) {
+		return;
+	}
+
+	// Samples of the layers have to be accessed while the audio engine is
+	// locked since the audio thread might swap them.
+	std::vector<std::pair<std::shared_ptr<InstrumentLayer>,
+						  std::shared_ptr<Sample>>> layers;
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	pAudioEngine->lock( RIGHT_HERE );
+	const auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong != nullptr && pSong->getDrumkit() != nullptr ) {
+		for ( const auto& ppInstrument :
+				  *pSong->getDrumkit()->getInstruments() ) {
+			if ( ppInstrument == nullptr ) {
+				continue;
+			}
+			for ( const auto& ppComponent : *ppInstrument ) {
+				if ( ppComponent == nullptr ) {
+					continue;
+				}
+				for ( const auto& ppLayer : *ppComponent ) {
+					if ( ppLayer == nullptr ) {
+						continue;
+					}
+					auto pSample = ppLayer->getSample();
+					if ( pSample != nullptr && pSample->getRubberband().bUse ) {
+						layers.push_back( { ppLayer, pSample } );
+					}
+				}
+			}
+		}
+	}
+	pAudioEngine->unlock();
+
+	std::scoped_lock lock{ m_mutex };
+
+	if ( bHandOver ) {
+		// Samples for previous tempi are not required anymore. Prefetched
+		// ones, which are not handed to any layer, are kept.
+		m_jobs.erase(
+			std::remove_if( m_jobs.begin(), m_jobs.end(),
+							[&]( const Job& job ) {
+								return job.nBucket != nBucket &&
+									   ! job.layers.empty();
+							} ),
+			m_jobs.end() );
+
+		for ( auto& [_, ppSource] : m_sources ) {
+			ppSource->bUsed = false;
+		}
+	}
+
+	std::deque<Job> newJobs;
+	for ( const auto& [ppLayer, ppSample] : layers ) {
+		auto pSource = getSource( ppSample );
+		pSource->bUsed = true;
+		if ( pSource->bFailed ) {
+			continue;
+		}
+
+		const auto rubberband = ppSample->getRubberband();
+		const auto key = makeKey( pSource.get(), rubberband, nBucket );
+
+		auto pStretched = lookUp( key );
+		if ( pStretched != nullptr ) {
+			if ( bHandOver ) {
+				// Also discards samples of previous tempi still pending.
+				ppLayer->setPendingSample(
+					pStretched != ppSample ? pStretched : nullptr );
+			}
+			continue;
+		}
+
+		auto matchesKey = [&]( const Job& job ) {
+			return job.nBucket == nBucket &&
+				   ! ( makeKey( job.pSource.get(), job.rubberband,
+								job.nBucket ) < key ) &&
+				   ! ( key < makeKey( job.pSource.get(), job.rubberband,
+									  job.nBucket ) );
+		};
+		auto it = std::find_if( newJobs.begin(), newJobs.end(), matchesKey );
+		if ( it == newJobs.end() ) {
+			it = std::find_if( m_jobs.begin(), m_jobs.end(), matchesKey );
+			if ( it == m_jobs.end() ) {
+				Job job;
+				job.pSource = pSource;
+				job.pOrigin = pSource->pOrigin;
+				job.rubberband = rubberband;
+				job.nBucket = nBucket;
+				newJobs.push_back( std::move( job ) );
+				it = newJobs.end() - 1;
+			}
+		}
+		if ( bHandOver ) {
+			it->layers.push_back( ppLayer );
+		}
+	}
+
+	if ( bHandOver ) {
+		m_jobs.insert( m_jobs.begin(), newJobs.begin(), newJobs.end() );
+		purge( false );
+	}
+	else {
+		m_jobs.insert( m_jobs.end(), newJobs.begin(), newJobs.end() );
+	}
+
+	m_cv.notify_all();
+}
+
+void RubberbandCache::process( Job& job )
+{
+	const auto key = makeKey( job.pSource.get(), job.rubberband, job.nBucket );
+
+	std::shared_ptr<Sample> pStretched;
+	{
+		std::scoped_lock lock{ m_mutex };
+		pStretched = lookUp( key );
+	}
+
+	if ( pStretched == nullptr ) {
+		pStretched =
+			stretch( job.pSource, job.pOrigin, job.rubberband, job.nBucket );
+		if ( pStretched == nullptr ) {
+			return;
+		}
+	}
+
+	std::scoped_lock lock{ m_mutex };
+	pStretched = insert( job.pSource, key, pStretched );
+
+	// In case the tempo changed in the meantime, the sample is just kept in
+	// the cache.
+	if ( job.nBucket == m_nScheduledBucket ) {
+		for ( const auto& ppLayer : job.layers ) {
+			ppLayer->setPendingSample( pStretched );
+		}
+	}
+}
+
+std::shared_ptr<Sample> RubberbandCache::stretch(
+	std::shared_ptr<Source> pSource,
+	std::shared_ptr<Sample> pOrigin,
+	const Sample::Rubberband& rubberband,
+	int nBucket )
+{
+	{
+		std::scoped_lock lock{ pSource->mutex };
+		if ( pSource->bFailed ) {
+			return nullptr;
+		}
+
+		if ( pSource->pUnstretched == nullptr ) {
+			if ( pOrigin == nullptr ) {
+				ERRORLOG( "Origin of source already released" );
+				return nullptr;
+			}
+
+			// The origin itself was already stretched when loaded. We
+			// read it once more from disk - including loops and envelopes
+			// - but without applying Rubber Band.
+			auto pUnstretched = std::make_shared<Sample>( pOrigin );
+			auto unstretchedRubberband = pUnstretched->getRubberband();
+			unstretchedRubberband.bUse = false;
+			pUnstretched->setRubberband( unstretchedRubberband );
+			if ( ! pUnstretched->load() ) {
+				ERRORLOG( QString( "Unable to decode [%1]" )
+						  .arg( pOrigin->getFilePath() ) );
+				pSource->bFailed = true;
+				return nullptr;
+			}
+			pSource->pUnstretched = pUnstretched;
+		}
+	}
+
+	// Once set, the unstretched sample is not altered anymore.
+	auto pStretched = std::make_shared<Sample>( pSource->pUnstretched );
+	pStretched->setRubberband( rubberband );
+	if ( ! pStretched->stretch( bucketToBpm( nBucket ) ) ) {
+		ERRORLOG( QString( "Unable to stretch [%1] to [%2] bpm" )
+				  .arg( pStretched->getFilePath() )
+				  .arg( bucketToBpm( nBucket ) ) );
+		return nullptr;
+	}
+
+	return pStretched;
+}
+
+std::shared_ptr<RubberbandCache::Source> RubberbandCache::getSource(
+	std::shared_ptr<Sample> pSample )
+{
+	const auto it = m_sources.find( pSample.get() );
+	if ( it != m_sources.end() ) {
+		return it->second;
+	}
+
+	auto pSource = std::make_shared<Source>();
+	pSource->pOrigin = pSample;
+	m_sources[ pSample.get() ] = pSource;
+
+	return pSource;
+}
+
+std::shared_ptr<Sample> RubberbandCache::lookUp( const Key& key )
+{
+	auto it = m_entries.find( key );
+	if ( it == m_entries.end() ) {
+		return nullptr;
+	}
+
+	it->second.nLastUsed = ++m_nAccessCount;
+	return it->second.pSample;
+}
+
+std::shared_ptr<Sample> RubberbandCache::insert(
+	std::shared_ptr<Source> pSource,
+	const Key& key,
+	std::shared_ptr<Sample> pSample )
+{
+	auto it = m_entries.find( key );
+	if ( it != m_entries.end() ) {
+		// Stretched by another thread in the meantime.
+		it->second.nLastUsed = ++m_nAccessCount;
+		return it->second.pSample;
+	}
+
+	m_entries[ key ] = Entry{ pSample, ++m_nAccessCount };
+	m_sources[ pSample.get() ] = pSource;
+	evict( pSource.get() );
+
+	return pSample;
+}
+
+void RubberbandCache::evict( const Source* pSource )
+{
+	std::vector<std::map<Key, Entry>::iterator> versions;
+	for ( auto it = m_entries.begin(); it != m_entries.end(); ++it ) {
+		if ( it->first.pSource == pSource ) {
+			versions.push_back( it );
+		}
+	}
+
+	if ( static_cast<int>( versions.size() ) <= nMaxVersionsPerSample ) {
+		return;
+	}
+
+	std::sort( versions.begin(), versions.end(),
+			   []( const auto& a, const auto& b ) {
+				   return a->second.nLastUsed < b->second.nLastUsed;
+			   } );
+
+	int nExcess = static_cast<int>( versions.size() ) - nMaxVersionsPerSample;
+	for ( auto& iit : versions ) {
+		if ( nExcess <= 0 ) {
+			break;
+		}
+		// Versions still used by a layer are kept.
+		if ( iit->second.pSample.use_count() == 1 ) {
+			m_sources.erase( iit->second.pSample.get() );
+			m_entries.erase( iit );
+			--nExcess;
+		}
+	}
+}
+
+bool RubberbandCache::isIdle() const
+{
+	return m_nBusyWorkers == 0 && m_jobs.empty() &&
+		m_prefetchBuckets.empty() &&
+		m_nRequestedBucket.load() == m_nScheduledBucket;
+}
+
+void RubberbandCache::purge( bool bAll )
+{
+	for ( auto it = m_entries.begin(); it != m_entries.end(); ) {
+		const auto pSource = it->first.pSource;
+		if ( ( bAll || ! pSource->bUsed ) &&
+			 it->second.pSample.use_count() == 1 ) {
+			m_sources.erase( it->second.pSample.get() );
+			it = m_entries.erase( it );
+		}
+		else {
+			++it;
+		}
+	}
+
+	// Origins are only required till their unstretched counterpart was
+	// decoded. Their address must not be used as key anymore once they are
+	// released since it might be reused by another sample.
+	std::set<std::shared_ptr<Source>> sources;
+	for ( const auto& [_, ppSource] : m_sources ) {
+		sources.insert( ppSource );
+	}
+	for ( const auto& ppSource : sources ) {
+		if ( ppSource->pOrigin == nullptr ||
+			 ppSource->pOrigin.use_count() > 1 ) {
+			continue;
+		}
+
+		// Sources currently decoded are skipped.
+		std::unique_lock lock{ ppSource->mutex, std::try_to_lock };
+		if ( ! lock.owns_lock() ) {
+			continue;
+		}
+		if ( ppSource->pUnstretched != nullptr || ppSource->bFailed ||
+			 bAll || ! ppSource->bUsed ) {
+			m_sources.erase( ppSource->pOrigin.get() );
+			ppSource->pOrigin = nullptr;
+		}
+	}
+}
+
+QString RubberbandCache::toQString( const QString& sPrefix, bool bShort ) const
+{
+	std::scoped_lock lock{ m_mutex };
+
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( !bShort ) {
+		sOutput = QString( "%1[RubberbandCache]\n" )
+					  .arg( sPrefix )
+					  .append( QString( "%1%2m_workers: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_workers.size() ) )
+					  .append( QString( "%1%2m_nRequestedBucket: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_nRequestedBucket.load() ) )
+					  .append( QString( "%1%2m_nScheduledBucket: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_nScheduledBucket ) )
+					  .append( QString( "%1%2m_jobs: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_jobs.size() ) )
+					  .append( QString( "%1%2m_sources: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_sources.size() ) )
+					  .append( QString( "%1%2m_entries: %3\n" )
+								   .arg( sPrefix )
+								   .arg( s )
+								   .arg( m_entries.size() ) );
+	}
+	else {
+		sOutput = QString( "[RubberbandCache] " )
+					  .append( QString( "m_workers: %1" )
+								   .arg( m_workers.size() ) )
+					  .append( QString( ", m_nRequestedBucket: %1" )
+								   .arg( m_nRequestedBucket.load() ) )
+					  .append( QString( ", m_nScheduledBucket: %1" )
+								   .arg( m_nScheduledBucket ) )
+					  .append( QString( ", m_jobs: %1" ).arg( m_jobs.size() ) )
+					  .append( QString( ", m_sources: %1" )
+								   .arg( m_sources.size() ) )
+					  .append( QString( ", m_entries: %1" )
+								   .arg( m_entries.size() ) );
+	}
+
+	return sOutput;
+}
+
+};	// namespace H2Core
@@ -0,0 +1,239 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef RUBBERBAND_CACHE_H
+#define RUBBERBAND_CACHE_H
+
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <core/Basics/Sample.h>
+#include <core/Object.h>
+
+namespace H2Core {
+
+class InstrumentLayer;
+
+/**
+ * Versions of the samples of the current drumkit stretched by Rubber Band
+ * while #Preferences::getRubberBandBatchMode() is enabled.
+ *
+ * Stretched samples are keyed by their unstretched source, the tempo
+ * rounded to #fBpmResolution, and the #Sample::Rubberband settings. Each
+ * source is decoded from disk only once. All stretching is done by a pool
+ * of worker threads.
+ *
+ * A tempo change in the audio thread only records the new tempo via
+ * requestBpm(). The workers pick it up, look up or create the stretched
+ * samples, and hand them to the layers using
+ * InstrumentLayer::setPendingSample(). The #Sampler swaps them in at the
+ * next note onset. Tempi of the tempo markers of the #Timeline can be
+ * stretched in advance using prefetch().
+ *
+ * The cache keeps a reference to each sample it handed out (and to the one
+ * it replaced). It only drops samples it holds the last reference to. This
+ * way, no sample is ever deallocated within the audio thread.
+ */
+/** \ingroup docCore docAudioEngine */
+class RubberbandCache : public H2Core::Object<RubberbandCache> {
+	H2_OBJECT( RubberbandCache )
+   public:
+	/** Tempi are rounded to multiples of this value before stretching. At
+	 * 120 bpm a difference of 0.05 bpm changes the length of a sample
+	 * spanning one beat by about 0.2 ms. */
+	static constexpr float fBpmResolution = 0.1;
+	/** Maximum number of stretched versions kept per sample. */
+	static constexpr int nMaxVersionsPerSample = 16;
+	/** Maximum number of worker threads used by default. */
+	static constexpr int nMaxWorkers = 4;
+
+	/** @param nWorkers Number of worker threads. `0` uses one thread per
+	 * CPU core but not more than #nMaxWorkers. */
+	RubberbandCache( int nWorkers = 0 );
+	~RubberbandCache();
+
+	/** Asks the workers to provide all layers of the current drumkit with
+	 * samples stretched to @a fBpm.
+	 *
+	 * Does not allocate memory. #m_mutex is only acquired in case @a fBpm
+	 * falls into another bucket than the previous request. The workers
+	 * hold it just for bookkeeping and never while decoding or
+	 * stretching. */
+	void requestBpm( float fBpm );
+	/** Stretches the samples of the current drumkit to all of @a bpms in
+	 * the background without handing them to the layers. Requests made
+	 * via requestBpm() take precedence. */
+	void prefetch( const std::vector<float>& bpms );
+
+	/** Blocking lookup used by Drumkit::recalculateRubberband().
+	 *
+	 * \return version of @a pSample stretched to @a fBpm. @a pSample
+	 *   itself in case it does not use Rubber Band and `nullptr` in case
+	 *   stretching failed. */
+	std::shared_ptr<Sample> getStretchedSample( std::shared_ptr<Sample> pSample,
+												float fBpm );
+
+	/** Blocks till the workers processed all requests and prefetched
+	 * tempi. */
+	void waitUntilIdle();
+
+	/** Drops all samples only referenced by the cache itself. */
+	void clear();
+
+	/** \return number of stretched samples currently held. */
+	int getSize();
+
+	static int bpmToBucket( float fBpm );
+	static float bucketToBpm( int nBucket );
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true )
+		const override;
+
+   private:
+	/** Unstretched counterpart of the samples found in the layers. */
+	struct Source {
+		/** Sample the source was created for. It is kept alive until
+		 * #pUnstretched is available and no one else references it. */
+		std::shared_ptr<Sample> pOrigin;
+		/** Content of #pOrigin read from disk without applying Rubber
+		 * Band. */
+		std::shared_ptr<Sample> pUnstretched;
+		/** Serializes the decoding of #pUnstretched. */
+		std::mutex mutex;
+		/** Set in case the sample could not be decoded. No further
+		 * attempts will be made. */
+		std::atomic<bool> bFailed{ false };
+		/** Whether a layer of the current drumkit uses the source. */
+		bool bUsed = true;
+	};
+
+	struct Key {
+		const Source* pSource;
+		int nBucket;
+		float fLengthInBeats;
+		float fSemitonesToShift;
+		int nCrispness;
+
+		bool operator<( const Key& other ) const;
+	};
+
+	struct Entry {
+		std::shared_ptr<Sample> pSample;
+		long long nLastUsed;
+	};
+
+	struct Job {
+		std::shared_ptr<Source> pSource;
+		/** Keeps the origin alive while the job is pending. */
+		std::shared_ptr<Sample> pOrigin;
+		Sample::Rubberband rubberband;
+		int nBucket;
+		/** Layers the result will be handed to. Empty for prefetched
+		 * tempi. */
+		std::vector<std::shared_ptr<InstrumentLayer>> layers;
+	};
+
+	static Key makeKey( const Source* pSource,
+						const Sample::Rubberband& rubberband, int nBucket );
+
+	void workerLoop();
+	/** Enqueues jobs for all layers of the current drumkit not already
+	 * present in the cache for @a nBucket.
+	 *
+	 * \param bHandOver Whether the results should be handed to the layers
+	 *   (requestBpm()) or just be cached (prefetch()). */
+	void schedule( int nBucket, bool bHandOver );
+	void process( Job& job );
+	/** Decodes the source (if not done yet) and stretches it. Must be
+	 * called without holding #m_mutex. */
+	std::shared_ptr<Sample> stretch( std::shared_ptr<Source> pSource,
+									 std::shared_ptr<Sample> pOrigin,
+									 const Sample::Rubberband& rubberband,
+									 int nBucket );
+
+	/** The following functions must be called while holding #m_mutex. @{ */
+	std::shared_ptr<Source> getSource( std::shared_ptr<Sample> pSample );
+	std::shared_ptr<Sample> lookUp( const Key& key );
+	/** \return @a pSample or the version already cached for @a key. */
+	std::shared_ptr<Sample> insert( std::shared_ptr<Source> pSource,
+									const Key& key,
+									std::shared_ptr<Sample> pSample );
+	/** Drops the least recently used versions of @a pSource exceeding
+	 * #nMaxVersionsPerSample. */
+	void evict( const Source* pSource );
+	/** Drops versions of unused sources and origins not required
+	 * anymore. */
+	void purge( bool bAll );
+	bool isIdle() const;
+	/** @} */
+
+	std::vector<std::shared_ptr<std::thread>> m_workers;
+	mutable std::mutex m_mutex;
+	/** Wakes up the workers. */
+	std::condition_variable m_cv;
+	/** Notified by the workers once there is nothing left to do. */
+	std::condition_variable m_idleCv;
+	bool m_bActive;
+	/** Number of workers currently processing a job or scheduling
+	 * new ones. */
+	int m_nBusyWorkers;
+
+	/** Written by requestBpm() while holding #m_mutex. Atomic in order to
+	 * allow for checking it without locking. */
+	std::atomic<int> m_nRequestedBucket;
+	/** Bucket the latest jobs handing over samples were scheduled for. */
+	int m_nScheduledBucket;
+	std::deque<int> m_prefetchBuckets;
+	std::deque<Job> m_jobs;
+
+	/** Maps the origins and all stretched versions to their source. */
+	std::map<const Sample*, std::shared_ptr<Source>> m_sources;
+	std::map<Key, Entry> m_entries;
+	long long m_nAccessCount;
+};
+
+inline int RubberbandCache::bpmToBucket( float fBpm )
+{
+	return static_cast<int>( std::round( fBpm / fBpmResolution ) );
+}
+
+inline float RubberbandCache::bucketToBpm( int nBucket )
+{
+	return static_cast<float>( nBucket ) * fBpmResolution;
+}
+
+};	// namespace H2Core
+
+#endif
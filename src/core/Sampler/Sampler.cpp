@@ -47,6 +47,7 @@
 #include <core/Helpers/Time.h>
 #include <core/Hydrogen.h>
 #include <core/IO/AudioDriver.h>
+#include <core/IO/DiskWriterDriver.h>
 #include <core/IO/JackDriver.h>
 #include <core/IO/MidiBaseDriver.h>
 #include <core/Midi/Midi.h>
@@ -61,7 +62,13 @@ Sampler::Sampler()
 	: m_pMainOut_L( nullptr ),
 	  m_pMainOut_R( nullptr ),
 	  m_pPreviewInstrument( nullptr ),
-	  m_interpolateMode( Interpolation::InterpolateMode::Linear )
+	  m_interpolateMode( Interpolation::InterpolateMode::Linear ),
+	  m_pTrackOutDriver( nullptr ),
+	  m_pStemDriver( nullptr ),
+	  m_nAudibilityRevision( -1 ),
+	  m_nAudibilityLayerRevision( -1 ),
+	  m_bAudibilityExportSession( false ),
+	  m_pAudibilityDrumkit( nullptr )
 {
 	m_pMainOut_L = new float[MAX_BUFFER_SIZE];
 	m_pMainOut_R = new float[MAX_BUFFER_SIZE];
@@ -92,13 +99,32 @@ void Sampler::process( uint32_t nFrames )
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
 	if ( pSong == nullptr ) {
-		ERRORLOG( "no song" );
+		RT_ERRORLOG( "no song" );
 		return;
 	}
 
 	memset( m_pMainOut_L, 0, nFrames * sizeof( float ) );
 	memset( m_pMainOut_R, 0, nFrames * sizeof( float ) );
 
+	updateAudibility( pSong );
+
+	m_pTrackOutDriver = nullptr;
+#ifdef H2CORE_HAVE_JACK
+	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
+		m_pTrackOutDriver =
+			dynamic_cast<JackDriver*>( pHydrogen->getAudioDriver().get() );
+	}
+#endif
+
+	m_pStemDriver = nullptr;
+	if ( pHydrogen->getIsExportSessionActive() ) {
+		auto pDiskWriterDriver =
+			dynamic_cast<DiskWriterDriver*>( pHydrogen->getAudioDriver().get() );
+		if ( pDiskWriterDriver != nullptr && pDiskWriterDriver->hasStems() ) {
+			m_pStemDriver = pDiskWriterDriver;
+		}
+	}
+
 	// Max notes limit
 	int nMaxNotes = Preferences::get_instance()->m_nMaxNotes;
 	while ( (int) m_playingNotesQueue.size() > nMaxNotes ) {
@@ -106,15 +132,15 @@ void Sampler::process( uint32_t nFrames )
 		m_playingNotesQueue.erase( m_playingNotesQueue.begin() );
 		if ( pOldNote->getInstrument() != nullptr ) {
 			pOldNote->getInstrument()->dequeue( pOldNote );
-			WARNINGLOG( QString( "Number of playing notes [%1] exceeds maximum "
-								 "[%2]. Dropping note [%3]" )
-							.arg( m_playingNotesQueue.size() )
-							.arg( nMaxNotes )
-							.arg( pOldNote->toQString() ) );
+			RT_WARNINGLOG( "Number of playing notes [%1] exceeds maximum "
+						   "[%2]. Dropping note of instrument [%3] at position [%4]",
+						   m_playingNotesQueue.size(), nMaxNotes,
+						   static_cast<int>( pOldNote->getInstrumentId() ),
+						   pOldNote->getPosition() );
 		}
 		else {
-			ERRORLOG( QString( "Old note in Sampler has no instrument! [%1]" )
-						  .arg( pOldNote->toQString() ) );
+			RT_ERRORLOG( "Old note in Sampler has no instrument! Position: [%1]",
+						 pOldNote->getPosition() );
 		}
 	}
 
@@ -140,11 +166,10 @@ void Sampler::process( uint32_t nFrames )
 				pNote->getInstrument()->dequeue( pNote );
 			}
 			else {
-				ERRORLOG(
-					QString(
-						"Playing note in sampler does not have instrument! [%1]"
-					)
-						.arg( pNote->prettyName() )
+				RT_ERRORLOG(
+					"Playing note in sampler does not have instrument! "
+					"Position: [%1]",
+					pNote->getPosition()
 				);
 			}
 
@@ -770,12 +795,61 @@ void Sampler::handleSongSizeChange()
 
 //------------------------------------------------------------------
 
+void Sampler::updateAudibility( std::shared_ptr<Song> pSong )
+{
+	const auto pDrumkit = pSong->getDrumkit();
+	const int nRevision = Instrument::getAudibilityRevision();
+	const int nLayerRevision = InstrumentLayer::getRevision();
+	const bool bExportSession =
+		Hydrogen::get_instance()->getIsExportSessionActive();
+	if ( nRevision == m_nAudibilityRevision &&
+		 nLayerRevision == m_nAudibilityLayerRevision &&
+		 bExportSession == m_bAudibilityExportSession &&
+		 pDrumkit.get() == m_pAudibilityDrumkit ) {
+		return;
+	}
+
+	m_nAudibilityRevision = nRevision;
+	m_nAudibilityLayerRevision = nLayerRevision;
+	m_bAudibilityExportSession = bExportSession;
+	m_pAudibilityDrumkit = pDrumkit.get();
+
+	if ( pDrumkit == nullptr ) {
+		return;
+	}
+
+	const auto pInstrumentList = pDrumkit->getInstruments();
+	const bool bAnyInstrumentIsSoloed = pInstrumentList->isAnyInstrumentSoloed();
+	for ( const auto& ppInstrument : *pInstrumentList ) {
+		if ( ppInstrument == nullptr ) {
+			continue;
+		}
+
+		ppInstrument->m_bAudible =
+			!ppInstrument->isMuted() &&
+			!( bAnyInstrumentIsSoloed && !ppInstrument->isSoloed() ) &&
+			!( bExportSession && !ppInstrument->isCurrentlyExported() );
+
+		const bool bAnyComponentIsSoloed = ppInstrument->isAnyComponentSoloed();
+		for ( const auto& ppComponent : *ppInstrument->getComponents() ) {
+			if ( ppComponent == nullptr ) {
+				continue;
+			}
+
+			ppComponent->m_bAudible =
+				!ppComponent->getIsMuted() &&
+				!( bAnyComponentIsSoloed && !ppComponent->getIsSoloed() );
+			ppComponent->m_bAnyLayerSoloed = ppComponent->isAnyLayerSoloed();
+		}
+	}
+}
+
 bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
 	if ( pSong == nullptr ) {
-		ERRORLOG( "no song" );
+		RT_ERRORLOG( "no song" );
 		return true;
 	}
 
@@ -785,7 +859,7 @@ bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 
 	auto pInstr = pNote->getInstrument();
 	if ( pInstr == nullptr ) {
-		ERRORLOG( "NULL instrument" );
+		RT_ERRORLOG( "NULL instrument" );
 		return true;
 	}
 
@@ -808,13 +882,11 @@ bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 			if ( nBufferSize < nInitialBufferPos ) {
 				// this note is not valid. it's in the future...let's skip
 				// it....
-				ERRORLOG(
-					QString( "Note pos in the future?? nCurrentFrame: %1, note start: "
-							 "%2, nInitialBufferPos: %3, nBufferSize: %4" )
-						.arg( nCurrentFrame )
-						.arg( pNote->getNoteStart() )
-						.arg( nInitialBufferPos )
-						.arg( nBufferSize )
+				RT_ERRORLOG(
+					"Note pos in the future?? nCurrentFrame: %1, note start: "
+					"%2, nInitialBufferPos: %3, nBufferSize: %4",
+					nCurrentFrame, pNote->getNoteStart(), nInitialBufferPos,
+					nBufferSize
 				);
 
 				return true;
@@ -873,53 +945,27 @@ bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 	// SampleEditor - we use those. If not, we will select them right here
 	// according to the sample selected algorithms.
 	if ( !pNote->layersAlreadySelected() ) {
-		pNote->selectLayers( m_lastUsedLayersMap );
-
-		// Note that manually selected layers bypassing this if clause are not
-		// incorporated into the round robin layer selection on purpose.
-		for ( const auto& [ppComponent, ppSelectedLayerInfo] :
-			  pNote->getAllSelectedLayerInfos() ) {
-			if ( ppComponent != nullptr ) {
-				if ( ppSelectedLayerInfo != nullptr &&
-					 ppSelectedLayerInfo->pLayer != nullptr ) {
-					m_lastUsedLayersMap[ppComponent] =
-						ppSelectedLayerInfo->pLayer;
-				}
-				else if ( m_lastUsedLayersMap.find( ppComponent ) !=
-						  m_lastUsedLayersMap.end() ) {
-					// No layer selected and the component is already present in
-					// the map. We will delete its entry.
-					m_lastUsedLayersMap.erase(
-						m_lastUsedLayersMap.find( ppComponent )
-					);
-				}
-			}
-		}
+		pNote->selectLayers( *pHydrogen->getAudioEngine()->getRandom() );
 	}
 
 	/** We have to ensure to only send a single MIDI Note-On event. Even for
 	 * instruments with more than one component. */
 	bool bSendMidiNoteOn = false;
 
-	auto pComponents = pInstr->getComponents();
-	auto returnValues = std::vector<bool>( pComponents->size() );
-
-	for ( int ii = 0; ii < pComponents->size(); ++ii ) {
-		returnValues[ii] = false;
-	}
+	// Whether rendering of all components has finished.
+	bool bNoteEnded = true;
 
+	auto pComponents = pInstr->getComponents();
 	for ( int ii = 0; ii < pComponents->size(); ++ii ) {
 		auto pCompo = pComponents->at( ii );
 		if ( pCompo == nullptr ) {
-			ERRORLOG( QString( "Component [%1] is invalid" ).arg( ii ) );
-			returnValues[ii] = true;
+			RT_ERRORLOG( "Component [%1] is invalid", ii );
 			continue;
 		}
 
 		auto pSelectedLayerInfo = pNote->getSelecterLayerInfo( pCompo );
 		if ( pSelectedLayerInfo == nullptr ) {
 			// Component skipped
-			returnValues[ii] = true;
 			continue;
 		}
 
@@ -927,11 +973,16 @@ bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 		// support using Hydrogen with MIDI-only output.
 		auto pLayer = pSelectedLayerInfo->pLayer;
 
+		// Samples stretched by the RubberbandCache in the background are
+		// swapped in at the onset of a note.
+		if ( pLayer != nullptr && !pNote->isPartiallyRendered() ) {
+			pLayer->commitPendingSample();
+		}
+
 		// But we do check whether this component was already handled
 		if ( pLayer != nullptr && pLayer->getSample() != nullptr &&
 			 pSelectedLayerInfo->fSamplePosition >=
 				 pLayer->getSample()->getFrames() ) {
-			returnValues[ii] = true;
 			continue;
 		}
 
@@ -944,31 +995,15 @@ bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 		 *     exports but this instrument is not currently being exported.
 		 *   - if another instrument  or component/layer of the same
 		 *     instrument is soloed.
+		 *
+		 *  All but the layer related parts are covered by the snapshot
+		 *  created in updateAudibility(). If there is no layer, we can still
+		 *  trigger a Note-On MIDI message corresponding to the note.
 		 */
-		const bool bIsMutedForExport =
-			( pHydrogen->getIsExportSessionActive() &&
-			  !pInstr->isCurrentlyExported() );
-		const bool bAnyInstrumentIsSoloed =
-			pSong->getDrumkit()->getInstruments()->isAnyInstrumentSoloed();
-		const bool bAnyComponentIsSoloed = pInstr->isAnyComponentSoloed();
-		bool bAnyLayerIsSoloed = false;
-		bool bIsMutedBecauseOfSolo = false;
-		if ( pLayer != nullptr ) {
-			bAnyLayerIsSoloed = pCompo->isAnyLayerSoloed();
-			bIsMutedBecauseOfSolo =
-				( bAnyInstrumentIsSoloed && !pInstr->isSoloed() ||
-				  bAnyComponentIsSoloed && !pCompo->getIsSoloed() ||
-				  bAnyLayerIsSoloed && !pLayer->getIsSoloed() );
-		}
-		else {
-			// This component has no valid sample. But can we still trigger a
-			// Note-On MIDI message corresponding to the note.
-			bIsMutedBecauseOfSolo =
-				( bAnyInstrumentIsSoloed && !pInstr->isSoloed() ||
-				  bAnyComponentIsSoloed && !pCompo->getIsSoloed() );
-		}
 		const bool bLayerMuted =
-			pLayer != nullptr ? pLayer->getIsMuted() : false;
+			pLayer != nullptr &&
+			( pLayer->getIsMuted() ||
+			  ( pCompo->m_bAnyLayerSoloed && !pLayer->getIsSoloed() ) );
 
 		bool bIsMuted = false;
 		if ( pInstr->isPreviewInstrument() ||
@@ -980,9 +1015,8 @@ bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 			// button.
 			bIsMuted = pSong->getIsMuted();
 		}
-		else if ( bIsMutedForExport || pInstr->isMuted() ||
-				  pSong->getIsMuted() || pCompo->getIsMuted() || bLayerMuted ||
-				  bIsMutedBecauseOfSolo ) {
+		else if ( pSong->getIsMuted() || !pInstr->m_bAudible ||
+				  !pCompo->m_bAudible || bLayerMuted ) {
 			// Regular instruments/notes.
 			bIsMuted = true;
 		}
@@ -1006,16 +1040,17 @@ bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 				pNote->setMidiNoteOffOffsetFrame( nCurrentFrame + 1 );
 			}
 
-			returnValues[ii] = true;
 			continue;
 		}
 
 		// Actual rendering.
-		returnValues[ii] = renderNote(
-			pNote, pSelectedLayerInfo, nBufferSize, nInitialBufferPos,
-			nCurrentFrame, pCompo->getGain(), fPan_L, fPan_R, fNotePan_L,
-			fNotePan_R, bIsMuted
-		);
+		if ( !renderNote(
+				 pNote, pSelectedLayerInfo, nBufferSize, nInitialBufferPos,
+				 nCurrentFrame, pCompo->getGain(), fPan_L, fPan_R, fNotePan_L,
+				 fNotePan_R, bIsMuted
+			 ) ) {
+			bNoteEnded = false;
+		}
 	}
 
 	if ( bSendMidiNoteOn && pHydrogen->getMidiDriver() != nullptr ) {
@@ -1103,12 +1138,7 @@ bool Sampler::handleNote( std::shared_ptr<Note> pNote, unsigned nBufferSize )
 		}
 	}
 
-	for ( const auto& bReturnValue : returnValues ) {
-		if ( !bReturnValue ) {
-			return false;
-		}
-	}
-	return true;
+	return bNoteEnded;
 }
 
 /// Copy sample data to buffer, filling buffer with trailing silence at end of
@@ -1171,6 +1201,10 @@ void copySample(
 /// checking where it's not needed, without having to hand-write
 /// specialisations for each.
 ///
+/// The "middle" range is handed over to a vectorized block kernel (see
+/// Interpolation::getBlockKernel()) selected at runtime according to the
+/// instruction sets supported by the CPU.
+///
 template <Interpolation::InterpolateMode mode>
 void resample(
 	float* __restrict__ pBuffer_L,
@@ -1228,27 +1262,19 @@ void resample(
 		fSamplePos += fStep;
 	}
 
-	// Fast iterations for main body of sample, with unconditional sample lookup
+	// Fast iterations for main body of sample, with unconditional sample
+	// lookup. These are handled by a block kernel processing several frames
+	// at once using the best instruction set supported by the CPU.
 	const int nFastFrames = std::min(
 		nFrames, static_cast<int>( ( nSampleFrames - 2 - fSamplePos ) / fStep )
 	);
-	for ( ; nFrame < nFastFrames; nFrame++ ) {
-		const long long nSamplePos = static_cast<long long>( fSamplePos );
-		const double fDiff = fSamplePos - nSamplePos;
-		// Gather frame samples
-		l0 = pSample_data_L[nSamplePos - 1];
-		l1 = pSample_data_L[nSamplePos];
-		l2 = pSample_data_L[nSamplePos + 1];
-		l3 = pSample_data_L[nSamplePos + 2];
-		r0 = pSample_data_R[nSamplePos - 1];
-		r1 = pSample_data_R[nSamplePos];
-		r2 = pSample_data_R[nSamplePos + 1];
-		r3 = pSample_data_R[nSamplePos + 2];
-		fVal_L = Interpolation::interpolate<mode>( l0, l1, l2, l3, fDiff );
-		fVal_R = Interpolation::interpolate<mode>( r0, r1, r2, r3, fDiff );
-		pBuffer_L[nFrame] = fVal_L;
-		pBuffer_R[nFrame] = fVal_R;
-		fSamplePos += fStep;
+	if ( nFastFrames > nFrame ) {
+		Interpolation::getBlockKernel( mode )(
+			pSample_data_L, pSample_data_R, &pBuffer_L[nFrame],
+			&pBuffer_R[nFrame], nFastFrames - nFrame, fSamplePos, fStep
+		);
+		fSamplePos += static_cast<double>( nFastFrames - nFrame ) * fStep;
+		nFrame = nFastFrames;
 	}
 
 	for ( ; nFrame < nFrames; nFrame++ ) {
@@ -1445,16 +1471,13 @@ bool Sampler::processPlaybackTrack( int nBufferSize )
 	float* pTrackOutL = nullptr;
 	float* pTrackOutR = nullptr;
 
-	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
-		auto pJackDriver = std::dynamic_pointer_cast<JackDriver>( pAudioDriver );
-		if ( pJackDriver != nullptr ) {
-			pTrackOutL = pJackDriver->getTrackBuffer(
-				Instrument::PlaybackTrackId, JackDriver::Channel::Left
-			);
-			pTrackOutR = pJackDriver->getTrackBuffer(
-				Instrument::PlaybackTrackId, JackDriver::Channel::Right
-			);
-		}
+	if ( m_pTrackOutDriver != nullptr ) {
+		pTrackOutL = m_pTrackOutDriver->getTrackBuffer(
+			Instrument::PlaybackTrackId, JackDriver::Channel::Left
+		);
+		pTrackOutR = m_pTrackOutDriver->getTrackBuffer(
+			Instrument::PlaybackTrackId, JackDriver::Channel::Right
+		);
 	}
 #endif
 
@@ -1519,17 +1542,17 @@ bool Sampler::renderNote(
 )
 {
 	if ( pSelectedLayerInfo == nullptr ) {
-		ERRORLOG( "Invalid input" );
+		RT_ERRORLOG( "Invalid input" );
 		return true;
 	}
 	const auto pLayer = pSelectedLayerInfo->pLayer;
 	if ( pLayer == nullptr ) {
-		ERRORLOG( "Invalid input layer" );
+		RT_ERRORLOG( "Invalid input layer" );
         return true;
 	}
 	const auto pSample = pLayer->getSample();
 	if ( pSample == nullptr ) {
-		ERRORLOG( "Invalid input sample" );
+		RT_ERRORLOG( "Invalid input sample" );
 		return true;
     }
 
@@ -1542,13 +1565,12 @@ bool Sampler::renderNote(
 
 	auto pInstrument = pNote->getInstrument();
 	if ( pInstrument == nullptr || pNote->getAdsr() == nullptr ) {
-		ERRORLOG( "Invalid note instrument" );
+		RT_ERRORLOG( "Invalid note instrument" );
 		return true;
 	}
 	if ( !pSample->isLoaded() ) {
-		WARNINGLOG( QString( "Sample [%1] of instrument [%2] was not loaded." )
-						.arg( pSample->getFilePath() )
-						.arg( pInstrument->getName() ) );
+		RT_WARNINGLOG( "Sample of instrument [%1] was not loaded.",
+					   static_cast<int>( pInstrument->getId() ) );
 		return true;
 	}
 
@@ -1695,15 +1717,13 @@ bool Sampler::renderNote(
 				// In case resonance filtering is active the sampler stops
 				// rendering of the sample at the custom note length but lets
 				// the filter itself ring on.
-				ERRORLOG( QString( "Note end located within the previous "
-								   "processing cycle. nNoteEnd: %1, "
-								   "nNoteLength: %2, fSamplePosition: %3, "
-								   "nFinalBufferPos: %4, fFrequencyRatio: %5" )
-							  .arg( nNoteEnd )
-							  .arg( pSelectedLayerInfo->nNoteLength )
-							  .arg( pSelectedLayerInfo->fSamplePosition )
-							  .arg( nFinalBufferPos )
-							  .arg( fFrequencyRatio ) );
+				RT_ERRORLOG( "Note end located within the previous "
+							 "processing cycle. nNoteEnd: %1, "
+							 "nNoteLength: %2, fSamplePosition: %3, "
+							 "fFrequencyRatio: %4",
+							 nNoteEnd, pSelectedLayerInfo->nNoteLength,
+							 pSelectedLayerInfo->fSamplePosition,
+							 fFrequencyRatio );
 			}
 			nNoteEnd = 0;
 		}
@@ -1723,19 +1743,28 @@ bool Sampler::renderNote(
 	float* pTrackOutL = nullptr;
 	float* pTrackOutR = nullptr;
 
-	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
-		auto pJackDriver = std::dynamic_pointer_cast<JackDriver>( pAudioDriver );
-		if ( pJackDriver != nullptr ) {
-			pTrackOutL = pJackDriver->getTrackBuffer(
-				pInstrument->getId(), JackDriver::Channel::Left
-			);
-			pTrackOutR = pJackDriver->getTrackBuffer(
-				pInstrument->getId(), JackDriver::Channel::Right
-			);
-		}
+	if ( m_pTrackOutDriver != nullptr ) {
+		pTrackOutL = m_pTrackOutDriver->getTrackBuffer(
+			pInstrument->getId(), JackDriver::Channel::Left
+		);
+		pTrackOutR = m_pTrackOutDriver->getTrackBuffer(
+			pInstrument->getId(), JackDriver::Channel::Right
+		);
 	}
 #endif
 
+	// Per-instrument stems written alongside the main mix during export.
+	float* pStemOutL = nullptr;
+	float* pStemOutR = nullptr;
+	if ( m_pStemDriver != nullptr ) {
+		pStemOutL = m_pStemDriver->getTrackBuffer(
+			pInstrument->getId(), DiskWriterDriver::Channel::Left
+		);
+		pStemOutR = m_pStemDriver->getTrackBuffer(
+			pInstrument->getId(), DiskWriterDriver::Channel::Right
+		);
+	}
+
 	float buffer_L[nBufferSize];
 	float buffer_R[nBufferSize];
 
@@ -1806,6 +1835,15 @@ bool Sampler::renderNote(
 			fVal_L *= fMainVolume;
 			fVal_R *= fMainVolume;
 
+			// Stems are exported just the way the instrument contributes to
+			// the main mix.
+			if ( pStemOutL != nullptr ) {
+				pStemOutL[nBufferPos] += fVal_L;
+			}
+			if ( pStemOutR != nullptr ) {
+				pStemOutR[nBufferPos] += fVal_R;
+			}
+
 			// to main mix
 			m_pMainOut_L[nBufferPos] += fVal_L;
 			m_pMainOut_R[nBufferPos] += fVal_R;
@@ -36,9 +36,12 @@
 
 namespace H2Core {
 
+class Drumkit;
 class Instrument;
 class InstrumentComponent;
 class InstrumentLayer;
+class DiskWriterDriver;
+class JackDriver;
 class Sample;
 struct SelectedLayerInfo;
 class Song;
@@ -239,10 +242,17 @@ class Sampler : public H2Core::Object<Sampler> {
 	 */
 	void handleSongSizeChange();
 
-	void clearLastUsedLayers();
-
 	const std::vector<std::shared_ptr<Note>>& getPlayingNotesQueue() const;
 
+	/** Refreshes the audibility snapshot stored in the instruments and
+	 * components of the drumkit of @a pSong in case their mute, solo, or
+	 * export state changed since the last call.
+	 *
+	 * This way handleNote() does not have to scan all instruments, components,
+	 * and layers for each playing note. Called at the beginning of each
+	 * process() cycle. */
+	void updateAudibility( std::shared_ptr<Song> pSong );
+
 	QString toQString( const QString& sPrefix = "", bool bShort = true )
 		const override;
 
@@ -327,14 +337,21 @@ class Sampler : public H2Core::Object<Sampler> {
 
 	Interpolation::InterpolateMode m_interpolateMode;
 
-	/** In order to allow for all layers in an #H2Core::InstrumentComponent
-	 * to be selected in a round robin scheme consistently, we keep track of
-	 * which layer was last used by which component. It's important to flush
-	 * this map when switching drumkits in order to avoid memory leaks! */
-	std::map<
-		std::shared_ptr<InstrumentComponent>,
-		std::shared_ptr<InstrumentLayer>>
-		m_lastUsedLayersMap;
+	/** JACK driver providing per-track output ports. Resolved once at the
+	 * beginning of each cycle and `nullptr` if there are none. */
+	JackDriver* m_pTrackOutDriver;
+	/** Driver of the current export session in case stems are rendered
+	 * alongside the main mix. Resolved once at the beginning of each cycle
+	 * and `nullptr` otherwise. */
+	DiskWriterDriver* m_pStemDriver;
+
+	/** State the audibility snapshot was computed for. Only used for
+	 * comparison in updateAudibility(). @{ */
+	int m_nAudibilityRevision;
+	int m_nAudibilityLayerRevision;
+	bool m_bAudibilityExportSession;
+	const Drumkit* m_pAudibilityDrumkit;
+	/** @} */
 };
 
 inline const std::vector<std::shared_ptr<Note>>& Sampler::getPlayingNotesQueue(
@@ -343,11 +360,6 @@ inline const std::vector<std::shared_ptr<Note>>& Sampler::getPlayingNotesQueue(
 	return m_playingNotesQueue;
 }
 
-inline void Sampler::clearLastUsedLayers()
-{
-	m_lastUsedLayersMap.clear();
-}
-
 }  // namespace H2Core
 
 #endif
@@ -31,6 +31,7 @@
 #include <core/Helpers/Filesystem.h>
 #include <core/Helpers/Xml.h>
 #include <core/Hydrogen.h>
+#include <core/SoundLibrary/SoundLibraryIndex.h>
 
 namespace H2Core
 {
@@ -39,6 +40,10 @@ QString SoundLibraryDatabase::m_sPatternBaseCategory = "not_categorized";
 
 SoundLibraryDatabase::SoundLibraryDatabase()
 {
+	m_pIndex = std::make_shared<SoundLibraryIndex>(
+		Filesystem::cache_dir() + "sound_library_index.xml" );
+	m_pIndex->load();
+
 	update();
 }
 
@@ -79,6 +84,7 @@ void SoundLibraryDatabase::update()
 void SoundLibraryDatabase::updateDrumkits( bool bTriggerEvent ) {
 
 	m_drumkitDatabase.clear();
+	m_metadataOnlyDrumkits.clear();
 
 	QStringList drumkitPaths;
 	// system drumkits
@@ -130,27 +136,40 @@ void SoundLibraryDatabase::updateDrumkits( bool bTriggerEvent ) {
 		}
 	}
 
+	std::set<QString> indexedPaths;
 	for ( const auto& sDrumkitPath : drumkitPaths ) {
-		auto pDrumkit = Drumkit::load( sDrumkitPath );
+		if ( m_drumkitDatabase.find( sDrumkitPath ) !=
+			 m_drumkitDatabase.end() ) {
+			ERRORLOG( QString( "A drumkit was already loaded from [%1]. Something went wrong." )
+					  .arg( sDrumkitPath ) );
+			continue;
+		}
+
+		// Only kits which changed since the index was written are parsed.
+		auto pDrumkit = m_pIndex->getDrumkit( sDrumkitPath );
 		if ( pDrumkit != nullptr ) {
-			if ( m_drumkitDatabase.find( sDrumkitPath ) !=
-				 m_drumkitDatabase.end() ) {
-				ERRORLOG( QString( "A drumkit was already loaded from [%1]. Something went wrong." )
-						  .arg( sDrumkitPath ) );
+			m_metadataOnlyDrumkits.insert( sDrumkitPath );
+		}
+		else {
+			pDrumkit = Drumkit::load( sDrumkitPath );
+			if ( pDrumkit == nullptr ) {
+				ERRORLOG( QString( "Unable to load drumkit at [%1]" ).arg( sDrumkitPath ) );
 				continue;
 			}
 
 			INFOLOG( QString( "Drumkit [%1] loaded from [%2]" )
 					 .arg( pDrumkit->getName() ).arg( sDrumkitPath ) );
-
-			m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
-			registerUniqueLabel( sDrumkitPath, pDrumkit );
-		}
-		else {
-			ERRORLOG( QString( "Unable to load drumkit at [%1]" ).arg( sDrumkitPath ) );
+			m_pIndex->setDrumkit( sDrumkitPath, pDrumkit );
 		}
+
+		m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+		registerUniqueLabel( sDrumkitPath, pDrumkit );
+		indexedPaths.insert( sDrumkitPath );
 	}
 
+	m_pIndex->retainDrumkits( indexedPaths );
+	m_pIndex->save();
+
 	if ( bTriggerEvent ) {
 		EventQueue::get_instance()->pushEvent( Event::Type::SoundLibraryChanged, 0 );
 	}
@@ -161,7 +180,10 @@ void SoundLibraryDatabase::updateDrumkit( const QString& sDrumkitPath, bool bTri
 	auto pDrumkit = Drumkit::load( sDrumkitPath );
 	if ( pDrumkit != nullptr ) {
 		m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+		m_metadataOnlyDrumkits.erase( sDrumkitPath );
 		registerUniqueLabel( sDrumkitPath, pDrumkit );
+		m_pIndex->setDrumkit( sDrumkitPath, pDrumkit );
+		m_pIndex->save();
 	}
 	else {
 		ERRORLOG( QString( "Unable to load drumkit at [%1]" ).arg( sDrumkitPath ) );
@@ -225,11 +247,35 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getDrumkit( const QString& sDrumk
 		
 		return pDrumkit;
 	}
+
+	if ( m_metadataOnlyDrumkits.find( sDrumkitPath ) !=
+		 m_metadataOnlyDrumkits.end() ) {
+		// Only the metadata of the kit was read from the index so far.
+		auto pDrumkit = Drumkit::load( sDrumkitPath, bUpgrade );
+		if ( pDrumkit == nullptr ) {
+			ERRORLOG( QString( "Unable to load drumkit at [%1]" ).arg( sDrumkitPath ) );
+			return nullptr;
+		}
+
+		m_metadataOnlyDrumkits.erase( sDrumkitPath );
+		m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+
+		// Loading might have upgraded the drumkit.xml file.
+		m_pIndex->setDrumkit( sDrumkitPath, pDrumkit );
+		m_pIndex->save();
+
+		return pDrumkit;
+	}
 	
 	return m_drumkitDatabase.at( sDrumkitPath );
 }
 
-std::shared_ptr<Drumkit> SoundLibraryDatabase::getPreviousDrumkit() const {
+bool SoundLibraryDatabase::isMetadataOnly( const QString& sDrumkitPath ) const {
+	return m_metadataOnlyDrumkits.find( sDrumkitPath ) !=
+		m_metadataOnlyDrumkits.end();
+}
+
+std::shared_ptr<Drumkit> SoundLibraryDatabase::getPreviousDrumkit() {
 
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
@@ -243,18 +289,18 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getPreviousDrumkit() const {
 
 	if ( sLastLoadedDrumkitPath.isEmpty() || search == m_drumkitDatabase.end() ) {
 		// In case we do not find the last loaded kit, we start at the top.
-		return m_drumkitDatabase.begin()->second;
+		return getDrumkit( m_drumkitDatabase.begin()->first );
 	}
 	else if ( search == m_drumkitDatabase.begin() ) {
 		// Periodic boundary conditions. The previous with respect to the first
 		// one is the last.
-		return std::prev( m_drumkitDatabase.end(), 1 )->second;
+		return getDrumkit( std::prev( m_drumkitDatabase.end(), 1 )->first );
 	}
 
-	return std::prev( search, 1 )->second;
+	return getDrumkit( std::prev( search, 1 )->first );
 }
 
-std::shared_ptr<Drumkit> SoundLibraryDatabase::getNextDrumkit() const {
+std::shared_ptr<Drumkit> SoundLibraryDatabase::getNextDrumkit() {
 
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
@@ -271,10 +317,10 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getNextDrumkit() const {
 		 m_drumkitDatabase.end() ) {
 		// In case we do not find the last loaded kit or it is located at the
 		// very bottom, we start at the top.
-		return m_drumkitDatabase.begin()->second;
+		return getDrumkit( m_drumkitDatabase.begin()->first );
 	}
 
-	return std::next( search, 1 )->second;
+	return getDrumkit( std::next( search, 1 )->first );
 }
 
 void SoundLibraryDatabase::registerUniqueLabel( const QString& sDrumkitPath,
@@ -374,6 +420,7 @@ void SoundLibraryDatabase::updatePatterns( bool bTriggerEvent )
 {
 	m_patternInfoVector.clear();
 	m_patternCategories = QStringList();
+	m_patternPaths.clear();
 
 	// search drumkit subdirectories within patterns user directory
 	foreach ( const QString& sDrumkit, Filesystem::pattern_drumkits() ) {
@@ -382,6 +429,9 @@ void SoundLibraryDatabase::updatePatterns( bool bTriggerEvent )
 	// search patterns user directory
 	loadPatternFromDirectory( Filesystem::patterns_dir() );
 
+	m_pIndex->retainPatterns( m_patternPaths );
+	m_pIndex->save();
+
 	if ( bTriggerEvent ) {
 		EventQueue::get_instance()->pushEvent( Event::Type::SoundLibraryChanged, 0 );
 	}
@@ -391,19 +441,24 @@ void SoundLibraryDatabase::loadPatternFromDirectory( const QString& sPatternDir
 {
 	foreach ( const QString& sName, Filesystem::pattern_list( sPatternDir ) ) {
 		QString sFile = sPatternDir + sName;
-		std::shared_ptr<SoundLibraryInfo> pInfo =
-			std::make_shared<SoundLibraryInfo>();
+		auto pInfo = m_pIndex->getPattern( sFile );
+		if ( pInfo == nullptr ) {
+			pInfo = std::make_shared<SoundLibraryInfo>();
+			if ( ! pInfo->load( sFile ) ) {
+				continue;
+			}
 
-		if ( pInfo->load( sFile ) ) {
 			INFOLOG( QString( "Pattern [%1] of category [%2] loaded from [%3]" )
 					 .arg( pInfo->getName() ).arg( pInfo->getCategory() )
 					 .arg( sFile ) );
-			
-			m_patternInfoVector.push_back( pInfo );
-		
-			if ( ! m_patternCategories.contains( pInfo->getCategory() ) ) {
-				m_patternCategories << pInfo->getCategory();
-			}
+			m_pIndex->setPattern( sFile, pInfo );
+		}
+		m_patternPaths.insert( sFile );
+
+		m_patternInfoVector.push_back( pInfo );
+
+		if ( ! m_patternCategories.contains( pInfo->getCategory() ) ) {
+			m_patternCategories << pInfo->getCategory();
 		}
 	}
 }
@@ -30,10 +30,14 @@
 #include <QStringList>
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 namespace H2Core
 {
+
+class SoundLibraryIndex;
+
 /**
 * @class SoundLibraryDatabase
 *
@@ -41,6 +45,11 @@ namespace H2Core
 *
 * This class organizes the metadata of all locally installed soundlibrary items.
 *
+* To keep startup fast, the metadata is cached in a #SoundLibraryIndex.
+* Drumkits with an up-to-date entry in the index are only represented by
+* their metadata - name, licenses, and the id, name, and type of their
+* instruments - and fully loaded on the first call to getDrumkit().
+*
 * @author Sebastian Moors
 *
 */
@@ -70,7 +79,8 @@ class SoundLibraryDatabase :    public H2Core::Object<SoundLibraryDatabase>
 	/**
 	 * Retrieve a drumkit from the database.
 	 *
-	 * If the kit is not already present, it will be loaded from disk.
+	 * If the kit is not already present or only its metadata was read from
+	 * the #SoundLibraryIndex, it will be loaded from disk.
 	 *
 	 * @param sDrumkitPath Absolute path to the drumkit directory
 	 *   (containing a drumkit.xml) file as unique identifier.
@@ -83,15 +93,21 @@ class SoundLibraryDatabase :    public H2Core::Object<SoundLibraryDatabase>
 		/** Based on #Song::m_sLastLoadedDrumkitPath get the previous drumkit in
 		 * the data base (the one shown above the last loaded one in the Sound
 		 * Library widget) */
-		std::shared_ptr<Drumkit> getPreviousDrumkit() const;
+		std::shared_ptr<Drumkit> getPreviousDrumkit();
 		/** Based on #Song::m_sLastLoadedDrumkitPath get the next drumkit in the
 		 * data base (the one shown below the last loaded one in the Sound
 		 * Library widget) */
-		std::shared_ptr<Drumkit> getNextDrumkit() const;
+		std::shared_ptr<Drumkit> getNextDrumkit();
 
+	/** All drumkits of the database. Some of them might only consist of
+	 * metadata (see isMetadataOnly()). Use getDrumkit() to retrieve the full
+	 * kit. */
 	const std::map<QString, std::shared_ptr<Drumkit>>& getDrumkitDatabase() const {
 		return m_drumkitDatabase;
 	}
+		/** Whether the kit in @a sDrumkitPath was created from the
+		 * #SoundLibraryIndex and not loaded from disk yet. */
+		bool isMetadataOnly( const QString& sDrumkitPath ) const;
 		/** Retrieves an unique label for the kit associated with @a
 		 * sDrumkitPath. This may serve as a more accessible alternative to the
 		 * absolute path of the kit in the GUI. */
@@ -131,6 +147,12 @@ private:
 								  std::shared_ptr<Drumkit> pDrumkit );
 
 	std::map<QString, std::shared_ptr<Drumkit>> m_drumkitDatabase;
+		/** Paths of all kits in #m_drumkitDatabase which were created from
+		 * #m_pIndex and are not fully loaded yet. */
+		std::set<QString> m_metadataOnlyDrumkits;
+		std::shared_ptr<SoundLibraryIndex> m_pIndex;
+		/** Pattern files encountered during the current updatePatterns(). */
+		std::set<QString> m_patternPaths;
 		/** The absolute path to a drumkit folder is not the most accessible way
 		 * to refer to a kit in the GUI. Instead, each kit will also have an
 		 * unique label. It is derived from the name of the drumkit. But as
@@ -0,0 +1,371 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/SoundLibrary/SoundLibraryIndex.h>
+
+#include <QFileInfo>
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Xml.h>
+#include <core/SoundLibrary/SoundLibraryInfo.h>
+
+namespace H2Core
+{
+
+bool SoundLibraryIndex::Stamp::operator==( const Stamp& other ) const {
+	return nModified == other.nModified && nSize == other.nSize;
+}
+
+bool SoundLibraryIndex::Stamp::operator!=( const Stamp& other ) const {
+	return ! ( *this == other );
+}
+
+SoundLibraryIndex::SoundLibraryIndex( const QString& sPath )
+	: m_sPath( sPath )
+	, m_bModified( false )
+{
+}
+
+SoundLibraryIndex::~SoundLibraryIndex() {
+}
+
+SoundLibraryIndex::Stamp SoundLibraryIndex::stampOf( const QString& sFilePath ) {
+	Stamp stamp;
+	const QFileInfo info( sFilePath );
+	if ( info.exists() ) {
+		stamp.nModified = info.lastModified().toMSecsSinceEpoch();
+		stamp.nSize = info.size();
+	}
+
+	return stamp;
+}
+
+void SoundLibraryIndex::load() {
+	m_drumkits.clear();
+	m_patterns.clear();
+	m_bModified = false;
+
+	if ( ! Filesystem::file_exists( m_sPath, true ) ) {
+		return;
+	}
+
+	XMLDoc doc;
+	if ( ! doc.read( m_sPath, true ) ) {
+		WARNINGLOG( QString( "Unable to read sound library index [%1]. It will be rebuilt." )
+					.arg( m_sPath ) );
+		m_bModified = true;
+		return;
+	}
+
+	const XMLNode rootNode = doc.firstChildElement( "sound_library_index" );
+	if ( rootNode.isNull() ||
+		 rootNode.read_int( "formatVersion", -1, false, false, true ) !=
+		 nFormatVersion ) {
+		INFOLOG( QString( "Discarding outdated sound library index [%1]" )
+				 .arg( m_sPath ) );
+		m_bModified = true;
+		return;
+	}
+
+	auto readStamp = []( const XMLNode& node ) {
+		Stamp stamp;
+		stamp.nModified = node.read_string( "modified", "-1", false, false, true )
+			.toLongLong();
+		stamp.nSize = node.read_string( "size", "-1", false, false, true )
+			.toLongLong();
+		return stamp;
+	};
+
+	XMLNode drumkitNode = rootNode.firstChildElement( "drumkitList" )
+		.firstChildElement( "drumkit" );
+	while ( ! drumkitNode.isNull() ) {
+		const QString sDrumkitPath =
+			drumkitNode.read_string( "path", "", false, false, true );
+		if ( ! sDrumkitPath.isEmpty() ) {
+			DrumkitEntry entry;
+			entry.stamp = readStamp( drumkitNode );
+			entry.sName = drumkitNode.read_string( "name", "", false, false, true );
+			entry.sAuthor = drumkitNode.read_string( "author", "", true, true, true );
+			entry.sInfo = drumkitNode.read_string( "info", "", true, true, true );
+			entry.license = License(
+				drumkitNode.read_string( "license", "", true, true, true ),
+				entry.sAuthor );
+			entry.sImage = drumkitNode.read_string( "image", "", true, true, true );
+			entry.imageLicense = License(
+				drumkitNode.read_string( "imageLicense", "", true, true, true ),
+				entry.sAuthor );
+
+			XMLNode instrumentNode = drumkitNode.firstChildElement( "instrument" );
+			while ( ! instrumentNode.isNull() ) {
+				InstrumentEntry instrumentEntry;
+				instrumentEntry.id = static_cast<Instrument::Id>(
+					instrumentNode.read_int( "id", static_cast<int>(Instrument::EmptyId),
+											 false, false, true ) );
+				instrumentEntry.sName =
+					instrumentNode.read_string( "name", "", true, true, true );
+				instrumentEntry.sType =
+					instrumentNode.read_string( "type", "", true, true, true );
+				entry.instruments.push_back( instrumentEntry );
+
+				instrumentNode = instrumentNode.nextSiblingElement( "instrument" );
+			}
+
+			m_drumkits[ sDrumkitPath ] = entry;
+		}
+
+		drumkitNode = drumkitNode.nextSiblingElement( "drumkit" );
+	}
+
+	XMLNode patternNode = rootNode.firstChildElement( "patternList" )
+		.firstChildElement( "pattern" );
+	while ( ! patternNode.isNull() ) {
+		const QString sPatternPath =
+			patternNode.read_string( "path", "", false, false, true );
+		if ( ! sPatternPath.isEmpty() ) {
+			PatternEntry entry;
+			entry.stamp = readStamp( patternNode );
+
+			const QString sAuthor =
+				patternNode.read_string( "author", "", true, true, true );
+			entry.pInfo = std::make_shared<SoundLibraryInfo>(
+				patternNode.read_string( "name", "", true, true, true ),
+				"", // URL
+				patternNode.read_string( "info", "", true, true, true ),
+				sAuthor,
+				patternNode.read_string( "category", "", true, true, true ),
+				"pattern",
+				License( patternNode.read_string( "license", "", true, true, true ),
+						 sAuthor ),
+				"", // image
+				License(),
+				sPatternPath );
+			entry.pInfo->setDrumkitName(
+				patternNode.read_string( "drumkitName", "", true, true, true ) );
+
+			m_patterns[ sPatternPath ] = entry;
+		}
+
+		patternNode = patternNode.nextSiblingElement( "pattern" );
+	}
+
+	INFOLOG( QString( "Sound library index [%1] contains [%2] drumkits and [%3] patterns" )
+			 .arg( m_sPath ).arg( m_drumkits.size() ).arg( m_patterns.size() ) );
+}
+
+bool SoundLibraryIndex::save() {
+	if ( ! m_bModified ) {
+		return true;
+	}
+
+	XMLDoc doc;
+	XMLNode rootNode = doc.set_root( "sound_library_index" );
+	rootNode.write_int( "formatVersion", nFormatVersion );
+
+	auto writeStamp = []( XMLNode& node, const Stamp& stamp ) {
+		node.write_string( "modified", QString::number( stamp.nModified ) );
+		node.write_string( "size", QString::number( stamp.nSize ) );
+	};
+
+	XMLNode drumkitListNode = rootNode.createNode( "drumkitList" );
+	for ( const auto& [ ssPath, eentry ] : m_drumkits ) {
+		XMLNode drumkitNode = drumkitListNode.createNode( "drumkit" );
+		drumkitNode.write_string( "path", ssPath );
+		writeStamp( drumkitNode, eentry.stamp );
+		drumkitNode.write_string( "name", eentry.sName );
+		drumkitNode.write_string( "author", eentry.sAuthor );
+		drumkitNode.write_string( "info", eentry.sInfo );
+		drumkitNode.write_string( "license", eentry.license.getLicenseString() );
+		drumkitNode.write_string( "image", eentry.sImage );
+		drumkitNode.write_string( "imageLicense",
+								  eentry.imageLicense.getLicenseString() );
+
+		for ( const auto& iinstrument : eentry.instruments ) {
+			XMLNode instrumentNode = drumkitNode.createNode( "instrument" );
+			instrumentNode.write_int( "id", static_cast<int>(iinstrument.id) );
+			instrumentNode.write_string( "name", iinstrument.sName );
+			instrumentNode.write_string( "type", iinstrument.sType );
+		}
+	}
+
+	XMLNode patternListNode = rootNode.createNode( "patternList" );
+	for ( const auto& [ ssPath, eentry ] : m_patterns ) {
+		XMLNode patternNode = patternListNode.createNode( "pattern" );
+		patternNode.write_string( "path", ssPath );
+		writeStamp( patternNode, eentry.stamp );
+		patternNode.write_string( "name", eentry.pInfo->getName() );
+		patternNode.write_string( "author", eentry.pInfo->getAuthor() );
+		patternNode.write_string( "info", eentry.pInfo->getInfo() );
+		patternNode.write_string( "category", eentry.pInfo->getCategory() );
+		patternNode.write_string( "license",
+								  eentry.pInfo->getLicense().getLicenseString() );
+		patternNode.write_string( "drumkitName", eentry.pInfo->getDrumkitName() );
+	}
+
+	if ( ! doc.write( m_sPath ) ) {
+		ERRORLOG( QString( "Unable to write sound library index [%1]" )
+				  .arg( m_sPath ) );
+		return false;
+	}
+
+	m_bModified = false;
+	return true;
+}
+
+std::shared_ptr<Drumkit> SoundLibraryIndex::getDrumkit( const QString& sDrumkitPath ) const {
+	const auto it = m_drumkits.find( sDrumkitPath );
+	if ( it == m_drumkits.end() ||
+		 it->second.stamp != stampOf( Filesystem::drumkit_file( sDrumkitPath ) ) ) {
+		return nullptr;
+	}
+	const auto& entry = it->second;
+
+	auto pDrumkit = std::make_shared<Drumkit>();
+	pDrumkit->setPath( sDrumkitPath );
+	pDrumkit->setName( entry.sName );
+	pDrumkit->setAuthor( entry.sAuthor );
+	pDrumkit->setInfo( entry.sInfo );
+	pDrumkit->setLicense( entry.license );
+	pDrumkit->setImage( entry.sImage );
+	pDrumkit->setImageLicense( entry.imageLicense );
+	pDrumkit->setContext( Drumkit::DetermineContext( sDrumkitPath ) );
+
+	auto pInstrumentList = std::make_shared<InstrumentList>();
+	for ( const auto& iinstrument : entry.instruments ) {
+		auto pInstrument = std::make_shared<Instrument>(
+			iinstrument.id, iinstrument.sName );
+		pInstrument->setType( iinstrument.sType );
+		pInstrumentList->add( pInstrument );
+	}
+	pDrumkit->setInstruments( pInstrumentList );
+
+	return pDrumkit;
+}
+
+void SoundLibraryIndex::setDrumkit( const QString& sDrumkitPath,
+									std::shared_ptr<Drumkit> pDrumkit ) {
+	if ( pDrumkit == nullptr ) {
+		return;
+	}
+
+	DrumkitEntry entry;
+	entry.stamp = stampOf( Filesystem::drumkit_file( sDrumkitPath ) );
+	entry.sName = pDrumkit->getName();
+	entry.sAuthor = pDrumkit->getAuthor();
+	entry.sInfo = pDrumkit->getInfo();
+	entry.license = pDrumkit->getLicense();
+	entry.sImage = pDrumkit->getImage();
+	entry.imageLicense = pDrumkit->getImageLicense();
+	for ( const auto& ppInstrument : *pDrumkit->getInstruments() ) {
+		if ( ppInstrument != nullptr ) {
+			entry.instruments.push_back( { ppInstrument->getId(),
+										   ppInstrument->getName(),
+										   ppInstrument->getType() } );
+		}
+	}
+
+	m_drumkits[ sDrumkitPath ] = entry;
+	m_bModified = true;
+}
+
+std::shared_ptr<SoundLibraryInfo> SoundLibraryIndex::getPattern(
+	const QString& sPatternPath ) const {
+	const auto it = m_patterns.find( sPatternPath );
+	if ( it == m_patterns.end() ||
+		 it->second.stamp != stampOf( sPatternPath ) ) {
+		return nullptr;
+	}
+
+	return it->second.pInfo;
+}
+
+void SoundLibraryIndex::setPattern( const QString& sPatternPath,
+									std::shared_ptr<SoundLibraryInfo> pInfo ) {
+	if ( pInfo == nullptr ) {
+		return;
+	}
+
+	m_patterns[ sPatternPath ] = { stampOf( sPatternPath ), pInfo };
+	m_bModified = true;
+}
+
+void SoundLibraryIndex::retainDrumkits( const std::set<QString>& drumkitPaths ) {
+	for ( auto it = m_drumkits.begin(); it != m_drumkits.end(); ) {
+		if ( drumkitPaths.find( it->first ) == drumkitPaths.end() ) {
+			it = m_drumkits.erase( it );
+			m_bModified = true;
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+void SoundLibraryIndex::retainPatterns( const std::set<QString>& patternPaths ) {
+	for ( auto it = m_patterns.begin(); it != m_patterns.end(); ) {
+		if ( patternPaths.find( it->first ) == patternPaths.end() ) {
+			it = m_patterns.erase( it );
+			m_bModified = true;
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+QString SoundLibraryIndex::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[SoundLibraryIndex]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_sPath: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_sPath ) )
+			.append( QString( "%1%2m_drumkits:\n" ).arg( sPrefix ).arg( s ) );
+		for ( const auto& [ ssPath, eentry ] : m_drumkits ) {
+			sOutput.append( QString( "%1%2%2%3: %4 [modified: %5, size: %6]\n" )
+							.arg( sPrefix ).arg( s ).arg( ssPath )
+							.arg( eentry.sName ).arg( eentry.stamp.nModified )
+							.arg( eentry.stamp.nSize ) );
+		}
+		sOutput.append( QString( "%1%2m_patterns:\n" ).arg( sPrefix ).arg( s ) );
+		for ( const auto& [ ssPath, eentry ] : m_patterns ) {
+			sOutput.append( QString( "%1%2%2%3: %4 [modified: %5, size: %6]\n" )
+							.arg( sPrefix ).arg( s ).arg( ssPath )
+							.arg( eentry.pInfo->getName() )
+							.arg( eentry.stamp.nModified )
+							.arg( eentry.stamp.nSize ) );
+		}
+		sOutput.append( QString( "%1%2m_bModified: %3\n" ).arg( sPrefix ).arg( s )
+						.arg( m_bModified ) );
+	}
+	else {
+		sOutput = QString( "[SoundLibraryIndex] " )
+			.append( QString( "m_sPath: %1" ).arg( m_sPath ) )
+			.append( QString( ", m_drumkits: %1" ).arg( m_drumkits.size() ) )
+			.append( QString( ", m_patterns: %1" ).arg( m_patterns.size() ) )
+			.append( QString( ", m_bModified: %1" ).arg( m_bModified ) );
+	}
+
+	return sOutput;
+}
+
+}; // namespace H2Core
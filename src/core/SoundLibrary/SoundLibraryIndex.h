@@ -0,0 +1,157 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef SOUND_LIBRARY_INDEX_H
+#define SOUND_LIBRARY_INDEX_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <core/Basics/Instrument.h>
+#include <core/License.h>
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+class Drumkit;
+class SoundLibraryInfo;
+
+/**
+ * On-disk cache of the metadata of all drumkits and patterns known to the
+ * #SoundLibraryDatabase.
+ *
+ * Each entry is keyed by the path of the drumkit.xml or .h2pattern file
+ * and stores its modification time and size. As long as both did not
+ * change, the metadata can be used instead of parsing the file again. This
+ * allows for fast startups even with hundreds of drumkits installed.
+ *
+ * For drumkits only the information required by the sound library browser
+ * is stored: name, author, info, licenses, image, and id, name, and type of
+ * all instruments. Kits created from the index do not contain any
+ * components, layers, or samples.
+ */
+/** \ingroup docCore docDataStructure */
+class SoundLibraryIndex : public H2Core::Object<SoundLibraryIndex>
+{
+	H2_OBJECT(SoundLibraryIndex)
+	public:
+		/** @param sPath Absolute path of the index file. */
+		SoundLibraryIndex( const QString& sPath );
+		~SoundLibraryIndex();
+
+		/** Reads the index file. A missing or malformed file results in an
+		 * empty index. */
+		void load();
+		/** Writes the index file in case an entry was added, replaced, or
+		 * dropped since the last load() or save(). */
+		bool save();
+
+		/** \return drumkit consisting of metadata only if the index contains
+		 *   an up-to-date entry for the kit in @a sDrumkitPath and `nullptr`
+		 *   otherwise. */
+		std::shared_ptr<Drumkit> getDrumkit( const QString& sDrumkitPath ) const;
+		/** Stores the metadata of the fully loaded @a pDrumkit along with the
+		 * current modification time and size of its drumkit.xml. */
+		void setDrumkit( const QString& sDrumkitPath,
+						 std::shared_ptr<Drumkit> pDrumkit );
+
+		/** \return info of the pattern in @a sPatternPath if the index
+		 *   contains an up-to-date entry for it and `nullptr` otherwise. */
+		std::shared_ptr<SoundLibraryInfo> getPattern(
+			const QString& sPatternPath ) const;
+		void setPattern( const QString& sPatternPath,
+						 std::shared_ptr<SoundLibraryInfo> pInfo );
+
+		/** Drops all drumkit entries not contained in @a drumkitPaths. */
+		void retainDrumkits( const std::set<QString>& drumkitPaths );
+		/** Drops all pattern entries not contained in @a patternPaths. */
+		void retainPatterns( const std::set<QString>& patternPaths );
+
+		const QString& getPath() const;
+
+		/** Formatted string version for debugging purposes.
+		 * \param sPrefix String prefix which will be added in front of
+		 * every new line
+		 * \param bShort Instead of the whole content of all classes
+		 * stored as members just a single unique identifier will be
+		 * displayed without line breaks.
+		 *
+		 * \return String presentation of current object.*/
+		QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+	private:
+		/** Modification time in milliseconds since epoch and size of a
+		 * file. */
+		struct Stamp {
+			qint64 nModified = -1;
+			qint64 nSize = -1;
+
+			bool operator==( const Stamp& other ) const;
+			bool operator!=( const Stamp& other ) const;
+		};
+
+		struct InstrumentEntry {
+			Instrument::Id id;
+			QString sName;
+			Instrument::Type sType;
+		};
+
+		struct DrumkitEntry {
+			Stamp stamp;
+			QString sName;
+			QString sAuthor;
+			QString sInfo;
+			License license;
+			QString sImage;
+			License imageLicense;
+			std::vector<InstrumentEntry> instruments;
+		};
+
+		struct PatternEntry {
+			Stamp stamp;
+			std::shared_ptr<SoundLibraryInfo> pInfo;
+		};
+
+		static Stamp stampOf( const QString& sFilePath );
+
+		QString m_sPath;
+		/** Keyed by the absolute path of the drumkit folder. */
+		std::map<QString, DrumkitEntry> m_drumkits;
+		/** Keyed by the absolute path of the .h2pattern file. */
+		std::map<QString, PatternEntry> m_patterns;
+		/** Whether the index differs from the content of #m_sPath. */
+		bool m_bModified;
+
+		/** Bumped whenever the layout of the index file changes. Files of
+		 * other versions are discarded. */
+		static constexpr int nFormatVersion = 1;
+};
+
+inline const QString& SoundLibraryIndex::getPath() const {
+	return m_sPath;
+}
+
+}; // namespace H2Core
+
+#endif // SOUND_LIBRARY_INDEX_H
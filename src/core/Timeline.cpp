@@ -26,11 +26,18 @@
 #include <core/Hydrogen.h>
 #include <core/Basics/Song.h>
 
+#include <atomic>
+
 namespace H2Core
 {
 
+namespace {
+	std::atomic<int> nRevisionCounter( 0 );
+}
+
 Timeline::Timeline() : Object( )
-					 , m_fDefaultBpm( 120 ) {
+					 , m_fDefaultBpm( 120 )
+					 , m_nRevision( 0 ) {
 	updateTempoMarkers();
 }
 
@@ -191,6 +198,10 @@ std::shared_ptr<const Timeline::TempoMarker> Timeline::getTempoMarkerAtColumn( i
 }
 
 void Timeline::updateTempoMarkers() {
+	// Sort first. Else #m_allTempoMarkers would be unordered in case markers
+	// were not added in order.
+	sortTempoMarkers();
+
 	if ( isFirstTempoMarkerSpecial() ) {
 
 		std::shared_ptr<TempoMarker> pTempoMarker =
@@ -214,7 +225,7 @@ void Timeline::updateTempoMarkers() {
 		m_allTempoMarkers = m_tempoMarkers;
 	}
 
-	sortTempoMarkers();
+	m_nRevision = ++nRevisionCounter;
 }
 		
 void Timeline::sortTempoMarkers() {
@@ -168,6 +168,12 @@ public:
 		by "special tempo marker".*/
 	bool isFirstTempoMarkerSpecial() const;
 
+	/** Incremented whenever the tempo markers (including the special one)
+	 * do change. Revisions are unique across all #Timeline instances and
+	 * allow caches like #H2Core::TempoMap to detect whether they are
+	 * outdated. */
+	int getRevision() const;
+
 	/** Adds a Tag to the Timeline.
 	 *
 	 * Fails if there is already a #Tag present at @a nColumn.
@@ -232,6 +238,8 @@ private:
 	 * the last Song::m_fBpm when activating the Timeline.
 	 */
 	float m_fDefaultBpm;
+
+	int m_nRevision;
 	
 	struct TempoMarkerComparator
 	{
@@ -255,5 +263,8 @@ inline const std::vector<std::shared_ptr<const Timeline::TempoMarker>>& Timeline
 inline const std::vector<std::shared_ptr<const Timeline::Tag>>& Timeline::getAllTags() const {
 	return m_tags;
 }
+inline int Timeline::getRevision() const {
+	return m_nRevision;
+}
 };
 #endif // TIMELINE_H
@@ -45,6 +45,14 @@ AudioEngineInfoForm::AudioEngineInfoForm(QWidget* parent)
  , Object()
 {
 	setupUi( this );
+
+	// The table of the profiler has to be filled before the size of the
+	// dialog is fixed.
+	m_pProfilingLbl->setFont(
+		QFontDatabase::systemFont( QFontDatabase::FixedFont ) );
+	m_pProfilingLbl->setText( Hydrogen::get_instance()->getAudioEngine()
+							  ->getProfiler()->formatStatistics() +
+							  "\nDriver XRuns: 0" );
 	adjustSize();
 	setFixedSize( width(), height() );	// not resizable
 
@@ -114,6 +122,14 @@ void AudioEngineInfoForm::updateInfo()
 	sprintf(tmp, "%#.2f / %#.2f  (%d%%)", pAudioEngine->getProcessTime(), pAudioEngine->getMaxProcessTime(), perc );
 	processTimeLbl->setText(tmp);
 
+	// Per-stage timing of the audio callback
+	auto sProfiling = pAudioEngine->getProfiler()->formatStatistics();
+	if ( pHydrogen->getAudioDriver() != nullptr ) {
+		sProfiling.append( QString( "\nDriver XRuns: %1" )
+						   .arg( pHydrogen->getAudioDriver()->getXRuns() ) );
+	}
+	m_pProfilingLbl->setText( sProfiling );
+
 	// Song state
 	if (pSong == nullptr) {
 		songStateLbl->setText( "NULL song" );
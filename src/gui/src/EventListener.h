@@ -38,7 +38,7 @@ class EventListener
 		virtual void drumkitLoadedEvent(){}
 		virtual void effectChangedEvent(){}
 		virtual void errorEvent( int nErrorCode ) { UNUSED( nErrorCode ); }
-    	virtual void gridCellToggledEvent(){}
+		virtual void gridCellToggledEvent( int nColumn ) { UNUSED( nColumn ); }
 		virtual void instrumentLayerChangedEvent( int nInstrumentId ) {
 			UNUSED( nInstrumentId );
 		}
@@ -120,8 +120,6 @@ ExportSongDialog::ExportSongDialog(QWidget* parent)
 	m_pProgressBar->setValue( 0 );
 	
 	m_bQfileDialog = false;
-	m_bExportTrackouts = false;
-	m_nInstrument = 0;
 	m_sExtension = Filesystem::AudioFormatToSuffix( Filesystem::AudioFormat::Flac );
 	m_bOverwriteFiles = false;
 	m_bOldRubberbandBatchMode = pPref->getRubberBandBatchMode();
@@ -537,15 +535,17 @@ void ExportSongDialog::on_okBtn_clicked()
 
 	m_bOverwriteFiles = false;
 
-	if( exportTypeCombo->currentIndex() == EXPORT_TO_SINGLE_TRACK ||
-		exportTypeCombo->currentIndex() == EXPORT_TO_BOTH ){
-		m_bExportTrackouts = false;
+	const int nExportType = exportTypeCombo->currentIndex();
 
-		QString sFileName = exportNameTxt->text();
+	// File the main mix will be written to. Left empty in case only the
+	// individual tracks are requested.
+	QString sMainFileName;
+	if ( nExportType == EXPORT_TO_SINGLE_TRACK ||
+		 nExportType == EXPORT_TO_BOTH ) {
 		if ( fileInfo.exists() == true && m_bQfileDialog == false ) {
 
 			int res;
-			if( exportTypeCombo->currentIndex() == EXPORT_TO_SINGLE_TRACK ){
+			if( nExportType == EXPORT_TO_SINGLE_TRACK ){
 				res = QMessageBox::information( this, "Hydrogen", tr( "The file %1 exists. \nOverwrite the existing file?").arg(sFileName), QMessageBox::Yes | QMessageBox::No );
 			} else {
 				res = QMessageBox::information( this, "Hydrogen", tr( "The file %1 exists. \nOverwrite the existing file?").arg(sFileName), QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll);
@@ -559,182 +559,52 @@ void ExportSongDialog::on_okBtn_clicked()
 				return;
 			}
 		}
-
-		if( exportTypeCombo->currentIndex() == EXPORT_TO_BOTH ){
-			m_bExportTrackouts = true;
-		}
-		
-		/* arm all tracks for export */
-		for (auto i = 0; i < pInstrumentList->size(); i++) {
-			pInstrumentList->get(i)->setCurrentlyExported( true );
+		sMainFileName = sFileName;
+	}
+
+	// All tracks are rendered alongside the main mix in a single pass. Since
+	// there is no way to skip a single one once the export started, we have
+	// to ask about existing files upfront.
+	std::map<Instrument::Id, QString> stems;
+	if ( nExportType == EXPORT_TO_SEPARATE_TRACKS ||
+		 nExportType == EXPORT_TO_BOTH ) {
+		stems = DiskWriterDriver::createStemFileNames( sFileName, pSong );
+		for ( const auto& [ _, ssStemFileName ] : stems ) {
+			if ( QFile( ssStemFileName ).exists() == true &&
+				 m_bQfileDialog == false && ! m_bOverwriteFiles ) {
+				const int nRes = QMessageBox::information(
+					this, "Hydrogen", tr( "The file %1 exists. \nOverwrite the existing file?")
+					.arg( ssStemFileName ),
+					QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll );
+				if ( nRes == QMessageBox::No ) {
+					return;
+				}
+				if ( nRes == QMessageBox::YesToAll ) {
+					m_bOverwriteFiles = true;
+				}
+			}
 		}
 
-		if ( ! pHydrogen->startExportSession(
-				 nSampleRate, nSampleDepth, fCompressionLevel ) ) {
+		if ( stems.empty() && sMainFileName.isEmpty() ) {
+			// None of the instruments is used within the song.
 			QMessageBox::critical( this, "Hydrogen",
 								   pCommonStrings->getExportSongFailure() );
 			return;
 		}
-		pHydrogen->startExportSong( sFileName );
-		return;
-	}
-
-	if ( exportTypeCombo->currentIndex() == EXPORT_TO_SEPARATE_TRACKS ){
-		m_bExportTrackouts = true;
-		if ( ! pHydrogen->startExportSession(
-				 nSampleRate, nSampleDepth, fCompressionLevel ) ) {
-			QMessageBox::critical( this, "Hydrogen",
-								   pCommonStrings->getExportSongFailure() );
-			return;
-		}
-		exportTracks();
-		return;
-	}
-
-}
-
-bool ExportSongDialog::instrumentHasNotes( int nInstrumentIndex )
-{
-	const auto pSong = Hydrogen::get_instance()->getSong();
-	if ( pSong == nullptr && pSong->getDrumkit() == nullptr ) {
-		return false;
-	}
-	const auto pInstrument =
-		pSong->getDrumkit()->getInstruments()->get( nInstrumentIndex );
-	if ( pInstrument == nullptr ) {
-		ERRORLOG( QString( "Could not retrieve instrument of id [%1]" )
-				  .arg( nInstrumentIndex ) );
-		return false;
-	}
-
-	// Check all notes for the provided instrument id. It's a little inefficient
-	// because patterns are likely to be present multiple times. But this way we
-	// do not have to check whether a pattern is actually played back over the
-	// course of a song.
-	for ( const auto& ppNote : pSong->getAllNotes() ) {
-		if ( ppNote != nullptr &&
-			 ppNote->getInstrumentId() == pInstrument->getId() ) {
-			return true;
-		}
 	}
 
-	return false;
-}
-
-QString ExportSongDialog::findUniqueExportFileNameForInstrument( std::shared_ptr<Instrument> pInstrument )
-{
-	const auto pSong = Hydrogen::get_instance()->getSong();
-	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
-		return "";
-	}
-	QString uniqueInstrumentName;
-
-	const auto pInstrumentList = pSong->getDrumkit()->getInstruments();
-	
-	int instrumentOccurence = 0;
-	for(int i=0; i  < pInstrumentList->size(); i++ ){
-		if( pInstrumentList->get(m_nInstrument)->getName() == pInstrument->getName()){
-			instrumentOccurence++;
-		}
-	}
-
-	if ( instrumentOccurence >= 2 ) {
-		uniqueInstrumentName =
-			pInstrument->getName() + QString( "_" ) +
-			QString::number( static_cast<int>( pInstrument->getId() ) );
-	}
-	else {
-		uniqueInstrumentName = pInstrument->getName();
+	/* arm all tracks for export */
+	for (auto i = 0; i < pInstrumentList->size(); i++) {
+		pInstrumentList->get(i)->setCurrentlyExported( true );
 	}
 
-	return uniqueInstrumentName;
-}
-
-void ExportSongDialog::exportTracks()
-{
-	auto pHydrogen = Hydrogen::get_instance();
-	const auto pSong = pHydrogen->getSong();
-	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+	if ( ! pHydrogen->startExportSession(
+			 nSampleRate, nSampleDepth, fCompressionLevel ) ) {
+		QMessageBox::critical( this, "Hydrogen",
+							   pCommonStrings->getExportSongFailure() );
 		return;
 	}
-	const auto pInstrumentList = pSong->getDrumkit()->getInstruments();
-	
-	if( m_nInstrument < pInstrumentList->size() ){
-		
-		//if a instrument contains no notes we jump to the next instrument
-		bool bInstrumentHasNotes = instrumentHasNotes( m_nInstrument );
-
-		if ( !bInstrumentHasNotes ) {
-			if ( m_nInstrument >= pInstrumentList->size() - 1 ) {
-				m_bExportTrackouts = false;
-				m_nInstrument = 0;
-				return;
-			}
-			else {
-				m_nInstrument++;
-				exportTracks();
-				return;
-			}
-		}
-
-		// Ensure we use the right extension.
-		const QString sSuffix = QString( ".%1" ).arg( m_sExtension );
-		const QString sTemplateName = exportNameTxt->text();
-		QString sBaseName = sTemplateName;
-		if ( sTemplateName.endsWith( sSuffix, Qt::CaseInsensitive ) ) {
-			sBaseName.chop( sSuffix.size() );
-		}
-
-		const QString sInstrumentName = findUniqueExportFileNameForInstrument(
-			pInstrumentList->get( m_nInstrument ) );
-		QString sExportName;
-		if ( sBaseName.isEmpty() || sBaseName.endsWith( "/" ) ||
-			 sBaseName.endsWith( "\\" ) ) {
-			// Allow to use just the instrument names when leaving the song name
-			// blank.
-			sExportName = QString( "%1%2" ).arg( sBaseName )
-				.arg( sInstrumentName );
-		}
-		else {
-			sExportName = QString( "%1-%2" ).arg( sBaseName )
-				.arg( sInstrumentName );
-		}
-
-		const QString sFileName = QString( "%1%2" ).arg( sExportName )
-			.arg( sSuffix );
-
-		if ( QFile( sFileName ).exists() == true && m_bQfileDialog == false &&
-			 ! m_bOverwriteFiles ) {
-			const int nRes = QMessageBox::information(
-				this, "Hydrogen", tr( "The file %1 exists. \nOverwrite the existing file?")
-				.arg( sFileName ),
-				QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll );
-			if ( nRes == QMessageBox::No ) {
-				return;
-			}
-			if ( nRes == QMessageBox::YesToAll ) {
-				m_bOverwriteFiles = true;
-			}
-		}
-		
-		if( m_nInstrument > 0 ){
-			pHydrogen->stopExportSong();
-			m_bExporting = false;
-		}
-		
-		for (auto i = 0; i < pInstrumentList->size(); i++) {
-			pInstrumentList->get(i)->setCurrentlyExported( false );
-		}
-		
-		pInstrumentList->get(m_nInstrument)->setCurrentlyExported( true );
-		
-		pHydrogen->startExportSong( sFileName );
-
-		if(! (m_nInstrument == pInstrumentList->size()) ){
-			m_nInstrument++;
-		}
-	}
-    
+	pHydrogen->startExportSong( sMainFileName, stems );
 }
 
 void ExportSongDialog::closeEvent( QCloseEvent *event ) {
@@ -875,30 +745,16 @@ void ExportSongDialog::progressEvent( int nValue )
 
 		m_bExporting = false;
 
-		const auto pSong = Hydrogen::get_instance()->getSong();
 		// Check whether an error occured during export.
 		const auto pDriver = std::dynamic_pointer_cast<DiskWriterDriver>(
 			Hydrogen::get_instance()->getAudioEngine()->getAudioDriver()
 		);
 		if ( pDriver != nullptr && pDriver->m_bWritingFailed ) {
-			m_nInstrument = 0;
-			m_bExportTrackouts = false;
 			QMessageBox::critical( this, "Hydrogen",
 								   pCommonStrings->getExportSongFailure(),
 								   QMessageBox::Ok );
 			m_pProgressBar->setValue( 0 );
 		}
-		else {
-			if ( pSong == nullptr || pSong->getDrumkit() == nullptr ||
-				 m_nInstrument == pSong->getDrumkit()->getInstruments()->size() ) {
-				m_nInstrument = 0;
-				m_bExportTrackouts = false;
-			}
-
-			if ( m_bExportTrackouts ) {
-				exportTracks();
-			}
-		}
 	}
 	else if ( nValue == -1 ) {
 		m_bExporting = false;
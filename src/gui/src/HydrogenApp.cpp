@@ -1022,7 +1022,7 @@ void HydrogenApp::onEventQueueTimer()
 				break;
 
 			case Event::Type::GridCellToggled:
-				ppEventListener->gridCellToggledEvent();
+				ppEventListener->gridCellToggledEvent( pEvent->getValue() );
 				break;
 
 			case Event::Type::InstrumentLayerChanged:
@@ -1866,19 +1866,24 @@ void NotePropertiesRuler::createBackground()
 	}
 }
 
-void NotePropertiesRuler::drawPattern()
+void NotePropertiesRuler::drawPattern( const QRect& rect )
 {
-	m_offsetMap.clear();
+	if ( m_drawnContentRegion.isEmpty() ) {
+		// Content was invalidated. Offsets will be recalculated for all notes
+		// drawn from now on.
+		m_offsetMap.clear();
+	}
 
 	const qreal pixelRatio = devicePixelRatio();
 
 	QPainter p( m_pContentPixmap );
+	p.setClipRect( rect );
 	// copy the background image
 	p.drawPixmap(
-		rect(), *m_pBackgroundPixmap,
+		rect, *m_pBackgroundPixmap,
 		QRectF(
-			pixelRatio * rect().x(), pixelRatio * rect().y(),
-			pixelRatio * rect().width(), pixelRatio * rect().height()
+			pixelRatio * rect.x(), pixelRatio * rect.y(),
+			pixelRatio * rect.width(), pixelRatio * rect.height()
 		)
 	);
 
@@ -1895,12 +1900,20 @@ void NotePropertiesRuler::drawPattern()
 
 	std::vector<std::shared_ptr<Note> > notes;
 
+	// Superimposed notes are shifted to the right by one pixel each.
+	const int nNoteMargin = 16;
+	const auto [nFirstTick, nLastTick] =
+		rectToTickRange( rect, nNoteMargin, nNoteMargin );
+
 	for ( const auto& ppPattern : m_pPatternEditorPanel->getPatternsToShow() ) {
 		const auto baseStyle = ppPattern == pPattern ? NoteStyle::Foreground
 													 : NoteStyle::Background;
 
 		int nLastPos = -1;
-		for ( const auto& [nnPos, ppNote] : *ppPattern->getNotes() ) {
+		const auto pNotes = ppPattern->getNotes();
+		const auto itEnd = pNotes->upper_bound( nLastTick );
+		for ( auto it = pNotes->lower_bound( nFirstTick ); it != itEnd; ++it ) {
+			const auto& [nnPos, ppNote] = *it;
 			if ( ppNote == nullptr ) {
 				continue;
 			}
@@ -155,7 +155,7 @@ class NotePropertiesRuler : public PatternEditor,
 		int nHeight = 0,
 		int nIncrement = 0
 	);
-	void drawPattern() override;
+	void drawPattern( const QRect& rect ) override;
 	void drawNote(
 		QPainter& painter,
 		std::shared_ptr<H2Core::Note> pNote,
@@ -968,14 +968,24 @@ void PatternEditor::paintEvent( QPaintEvent* ev ) {
 	if ( pixelRatio != m_pBackgroundPixmap->devicePixelRatio() ||
 		 m_update == Editor::Update::Background ) {
 		createBackground();
+		m_drawnContentRegion = QRegion();
 	}
 
 	if ( m_update == Editor::Update::Background ||
 		 m_update == Editor::Update::Content ) {
-		drawPattern();
+		m_drawnContentRegion = QRegion();
 		m_update = Editor::Update::Transient;
 	}
 
+	// Within a scroll area the event only covers the visible part of the
+	// editor. Everything else is drawn once it becomes exposed.
+	const QRect dirtyRect =
+		QRegion( ev->rect() ).subtracted( m_drawnContentRegion ).boundingRect();
+	if ( ! dirtyRect.isEmpty() ) {
+		drawPattern( dirtyRect );
+		m_drawnContentRegion += dirtyRect;
+	}
+
 	QPainter painter( this );
 	painter.drawPixmap( ev->rect(), *m_pContentPixmap,
 						QRectF( pixelRatio * ev->rect().x(),
@@ -3577,16 +3587,19 @@ void PatternEditor::drawNote( QPainter &p, std::shared_ptr<H2Core::Note> pNote,
 	}
 }
 
-void PatternEditor::drawPattern() {
+void PatternEditor::drawPattern( const QRect& rect ) {
 	const qreal pixelRatio = devicePixelRatio();
 
 	QPainter p( m_pContentPixmap );
+	// Notes outside of rect must not be painted twice onto the parts already
+	// drawn.
+	p.setClipRect( rect );
 	// copy the background image
-	p.drawPixmap( rect(), *m_pBackgroundPixmap,
-						QRectF( pixelRatio * rect().x(),
-								pixelRatio * rect().y(),
-								pixelRatio * rect().width(),
-								pixelRatio * rect().height() ) );
+	p.drawPixmap( rect, *m_pBackgroundPixmap,
+						QRectF( pixelRatio * rect.x(),
+								pixelRatio * rect.y(),
+								pixelRatio * rect.width(),
+								pixelRatio * rect.height() ) );
 
 	auto pPattern = m_pPatternEditorPanel->getPattern();
 	if ( pPattern == nullptr ) {
@@ -3605,6 +3618,17 @@ void PatternEditor::drawPattern() {
 	const auto selectedRow = m_pPatternEditorPanel->getRowDB(
 		m_pPatternEditorPanel->getSelectedRowDB() );
 
+	// Width of the box the number of superimposed notes is drawn in left of
+	// them.
+	const int nBoxWidth = 128;
+	// Highlights of a note symbol extend a couple of pixels beyond its
+	// position.
+	const int nNoteMargin = 12;
+	const auto [ nFirstTick, nLastTick ] =
+		rectToTickRange( rect, nBoxWidth + nNoteMargin, nNoteMargin );
+	const int nFirstRow = rect.top() / static_cast<int>(m_nGridHeight) - 1;
+	const int nLastRow = rect.bottom() / static_cast<int>(m_nGridHeight) + 1;
+
 	// We count notes in each position so we can display markers for rows which
 	// have more than one note in the same position (a chord or genuine
 	// duplicates).
@@ -3625,7 +3649,11 @@ void PatternEditor::drawPattern() {
 		const auto fontColor = ppPattern == pPattern ?
 			textColor : textBackgroundColor;
 
-		for ( const auto& [ nnColumn, ppNote ] : *ppPattern->getNotes() ) {
+		// Notes located right of rect can not be visible within it.
+		const auto pNotes = ppPattern->getNotes();
+		const auto itEnd = pNotes->upper_bound( nLastTick );
+		for ( auto it = pNotes->begin(); it != itEnd; ++it ) {
+			const auto& [ nnColumn, ppNote ] = *it;
 			if ( nnColumn >= ppPattern->getLength() ) {
 				// Notes are located beyond the active length of the BaseEditor::editor and
 				// aren't visible even when drawn.
@@ -3636,6 +3664,11 @@ void PatternEditor::drawPattern() {
 				   ! selectedRow.contains( ppNote ) ) ) {
 				continue;
 			}
+			if ( nnColumn < nFirstTick &&
+				 nnColumn + calculateMaxTailLength( ppNote ) < nFirstTick ) {
+				// Neither the note nor its tail reach into rect.
+				continue;
+			}
 
 			int nRow = -1;
 			nRow = m_pPatternEditorPanel->findRowDB( ppNote );
@@ -3652,6 +3685,10 @@ void PatternEditor::drawPattern() {
 				nRow = ppNote->toPitch().toLine();
 			}
 
+			if ( nRow < nFirstRow || nRow > nLastRow ) {
+				continue;
+			}
+
 			// Check for duplicates
 			if ( nnColumn != nLastColumn ) {
 				// New column
@@ -3694,13 +3731,12 @@ void PatternEditor::drawPattern() {
 			// Draw "2x" text to the left of the note
 			const int x = PatternEditor::nMargin + ( nnColumn * m_fGridWidth );
 			const int y = nnRow * m_nGridHeight;
-			const int boxWidth = 128;
 
 			p.setFont( font );
 			p.setPen( fontColor );
 
 			p.drawText(
-				QRect( x - boxWidth - 6, y, boxWidth, m_nGridHeight ),
+				QRect( x - nBoxWidth - 6, y, nBoxWidth, m_nGridHeight ),
 				Qt::AlignRight | Qt::AlignVCenter,
 				( QString( "%1" ) + QChar( 0x00d7 )).arg( nnNotes ) );
 		}
@@ -3811,6 +3847,47 @@ int PatternEditor::calculateEffectiveNoteLength(
 	return pNote->getLength();
 }
 
+int PatternEditor::calculateMaxTailLength(
+	std::shared_ptr<H2Core::Note> pNote ) const
+{
+	if ( pNote == nullptr || pNote->getNoteOff() ) {
+		return 0;
+	}
+
+	int nLength = std::max( pNote->getLength(), 0 );
+
+	// An effective length is only shown in case it is shorter than the
+	// longest sample of the instrument (see calculateEffectiveNoteLength()).
+	if ( Preferences::get_instance()->
+		 getInterfaceTheme()->m_bIndicateEffectiveNoteLength &&
+		 pNote->getInstrument() != nullptr ) {
+		const double fSampleTicks = Transport::computeTick(
+			pNote->getInstrument()->getLongestSampleFrames(),
+			Hydrogen::get_instance()
+				->getAudioEngine()
+				->getPlayhead()
+				->getTickSize() );
+		nLength = std::max(
+			nLength, static_cast<int>( std::ceil( fSampleTicks ) ) + 1 );
+	}
+
+	return nLength;
+}
+
+std::pair<int, int> PatternEditor::rectToTickRange( const QRect& rect,
+													 int nMarginLeft,
+													 int nMarginRight ) const
+{
+	const int nFirstTick = static_cast<int>( std::floor(
+		static_cast<float>( rect.left() - nMarginRight -
+							PatternEditor::nMargin ) / m_fGridWidth ) );
+	const int nLastTick = static_cast<int>( std::ceil(
+		static_cast<float>( rect.right() + nMarginLeft -
+							PatternEditor::nMargin ) / m_fGridWidth ) );
+
+	return std::make_pair( nFirstTick, nLastTick );
+}
+
 bool PatternEditor::checkNotePlayback( std::shared_ptr<H2Core::Note> pNote ) const {
 	if ( ! Preferences::get_instance()->
 		 getInterfaceTheme()->m_bIndicateNotePlayback ) {
@@ -35,6 +35,7 @@
 #include <core/Preferences/Preferences.h>
 
 #include <memory>
+#include <utility>
 
 #include <QtGui>
 #include <QtWidgets>
@@ -298,8 +299,11 @@ public slots:
 		void drawNote( QPainter &p, std::shared_ptr<H2Core::Note> pNote,
 					   NoteStyle noteStyle ) const;
 		/** Update #m_pContentPixmap based on #m_pBackgroundPixmap to show the
-		 * latest content of all active pattern. */
-		virtual void drawPattern();
+		 * latest content of all active pattern.
+		 *
+		 * Only the area covered by @a rect is redrawn. Notes not reaching
+		 * into it are skipped without being looked up or rendered. */
+		virtual void drawPattern( const QRect& rect );
 		/** If there are multiple notes at the same position and column, the one
 		 * with lowest pitch (bottom-most one in PianoRollEditor) will be
 		 * rendered up front. If a subset of notes at this point is selected,
@@ -314,6 +318,22 @@ public slots:
 		 * that next note is encountered. We will indicate this behavior by
 		 * drawing an effective (more dim) tail of the note. */
 		int calculateEffectiveNoteLength( std::shared_ptr<H2Core::Note> pNote ) const;
+		/** Upper bound of the number of ticks the tail of @a pNote - as
+		 * rendered by drawNote() - can span. In contrast to
+		 * calculateEffectiveNoteLength() it does not have to look at any
+		 * other note. */
+		int calculateMaxTailLength( std::shared_ptr<H2Core::Note> pNote ) const;
+
+		/** Range of ticks [first, second] in which notes are located that
+		 * are drawn at least partially within @a rect.
+		 *
+		 * \param rect Area of the widget.
+		 * \param nMarginLeft Number of pixels a note can extend to the left
+		 *   of its position.
+		 * \param nMarginRight Number of pixels a note can extend to the right
+		 *   of its position. */
+		std::pair<int, int> rectToTickRange( const QRect& rect, int nMarginLeft,
+											 int nMarginRight ) const;
 
 		/** Checks whether the note would be played back when picked up by the
 		 * audio engine. */
@@ -353,6 +373,12 @@ public slots:
 		// #DrumPatternEditor #PatternEditorPanel::m_nSelectedRowDB is used
 		// instead and #NotePropertiesPanel does only contain a single row.
 		H2Core::Note::Pitch m_cursorPitch;
+
+		/** Area of #m_pContentPixmap already drawn since the content was
+		 * invalidated the last time. Only the parts of the widget becoming
+		 * visible - e.g. while scrolling - are drawn in subsequent paint
+		 * events. */
+		QRegion m_drawnContentRegion;
 };
 
 inline float PatternEditor::getGridWidth() const {
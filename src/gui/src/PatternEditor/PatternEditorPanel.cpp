@@ -2181,9 +2181,22 @@ int PatternEditorPanel::findRowDB( std::shared_ptr<Note> pNote, bool bSilent )
 	const
 {
 	if ( pNote != nullptr ) {
-		for ( int ii = 0; ii < m_db.size(); ++ii ) {
-			if ( m_db[ii].contains( pNote ) ) {
-				return ii;
+		if ( pNote->getInstrument() != nullptr ) {
+			const auto it = m_rowByMappedId.find( pNote->getInstrumentId() );
+			if ( it != m_rowByMappedId.end() ) {
+				return it->second;
+			}
+		}
+		else if ( pNote->getType().isEmpty() ) {
+			const auto it = m_rowByUntypedId.find( pNote->getInstrumentId() );
+			if ( it != m_rowByUntypedId.end() ) {
+				return it->second;
+			}
+		}
+		else {
+			const auto it = m_rowByType.constFind( pNote->getType() );
+			if ( it != m_rowByType.constEnd() ) {
+				return it.value();
 			}
 		}
 
@@ -2200,6 +2213,9 @@ int PatternEditorPanel::findRowDB( std::shared_ptr<Note> pNote, bool bSilent )
 void PatternEditorPanel::updateDB()
 {
 	m_db.clear();
+	m_rowByMappedId.clear();
+	m_rowByUntypedId.clear();
+	m_rowByType.clear();
 
 	auto pSong = Hydrogen::get_instance()->getSong();
 	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
@@ -2291,6 +2307,21 @@ void PatternEditorPanel::updateDB()
 		++nnRow;
 	}
 
+	// Only the first row matching a note is indexed. This way findRowDB()
+	// is consistent with a linear search using DrumPatternRow::contains().
+	for ( int ii = 0; ii < m_db.size(); ++ii ) {
+		const auto& row = m_db[ ii ];
+		if ( row.bMappedToDrumkit ) {
+			m_rowByMappedId.emplace( row.id, ii );
+		}
+		if ( row.sType.isEmpty() ) {
+			m_rowByUntypedId.emplace( row.id, ii );
+		}
+		else if ( ! m_rowByType.contains( row.sType ) ) {
+			m_rowByType.insert( row.sType, ii );
+		}
+	}
+
 	const int nSelectedInstrument =
 		Hydrogen::get_instance()->getSelectedInstrumentNumber();
 	if ( nSelectedInstrument != -1 ) {
@@ -25,6 +25,7 @@
 #define PATTERN_EDITOR_PANEL_H
 
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -253,7 +254,11 @@ class PatternEditorPanel : public QWidget,
 	 *
 	 * This is especially helpful for order-based instrument operations. */
 	int getRowIndexDB( const DrumPatternRow& row );
-	/** Retrieves the row number @a pNote is located in. */
+	/** Retrieves the row number @a pNote is located in.
+	 *
+	 * Yields the same result as checking all rows using
+	 * DrumPatternRow::contains() but uses the indices built in updateDB()
+	 * and takes constant time. */
 	int findRowDB( std::shared_ptr<H2Core::Note> pNote, bool bSilent = false )
 		const;
 	int getRowNumberDB() const;
@@ -470,6 +475,20 @@ class PatternEditorPanel : public QWidget,
 	/** Single source of truth for which #H2Core::Note to display (in which
 	 * row) for all parts of the pattern editor.*/
 	std::vector<DrumPatternRow> m_db;
+	/** Indices mirroring the three cases handled in
+	 * DrumPatternRow::contains(). They map the instrument ID or type of a
+	 * #H2Core::Note onto the first row of #m_db it is contained in and are
+	 * rebuilt along with #m_db in updateDB().
+	 *
+	 * Rows associated with an instrument of the current drumkit. Used for
+	 * notes with an instrument assigned. */
+	std::unordered_map<H2Core::Instrument::Id, int> m_rowByMappedId;
+	/** Rows without an instrument type. Used for notes with neither an
+	 * instrument nor a type. */
+	std::unordered_map<H2Core::Instrument::Id, int> m_rowByUntypedId;
+	/** Rows with an instrument type. Used for notes without instrument but
+	 * with a type. */
+	QHash<H2Core::Instrument::Type, int> m_rowByType;
 	/** Currently activate row of #m_db.
 	 *
 	 * `-1` indicates no row is selected/available. */
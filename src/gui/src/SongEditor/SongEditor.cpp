@@ -24,6 +24,7 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <limits>
 
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/GridPoint.h>
@@ -142,9 +143,9 @@ void SongEditor::addOrRemovePatternCellAction( const GridPoint& gridPoint,
 		 ( ( action == Editor::Action::Add ) && ! bGridPointActive ) ||
 		 ( ( action == Editor::Action::Delete ) && bGridPointActive ) ) {
 		CoreActionController::toggleGridCell( gridPoint );
-		// Immediate update of all grid cells to allow retrieving the added one
-		// to the selection and to get the hovered cells straight.
-		updateGridCells();
+		// Immediate update of the affected grid cells to allow retrieving the
+		// added one to the selection and to get the hovered cells straight.
+		updateGridCells( gridPoint.getColumn() );
 	}
 
 	if ( static_cast<char>(modifier) &
@@ -961,6 +962,9 @@ void SongEditor::paintEvent( QPaintEvent *ev ) {
 		drawSequence();
 		m_update = Editor::Update::Transient;
 	}
+	else if ( m_dirtyColumns.size() > 0 ) {
+		drawColumns();
+	}
 
 	const auto pPref = Preferences::get_instance();
 
@@ -1126,83 +1130,212 @@ void SongEditor::updateGridCells() {
 	}
 	m_gridCells.clear();
 
+	for ( int nColumn = 0; nColumn < pSong->getPatternGroupVector()->size();
+		  nColumn++ ) {
+		createGridCells( nColumn, oldGridCells );
+	}
+
+	updatePatternStates();
+	m_dirtyColumns.clear();
+}
+
+void SongEditor::updateGridCells( int nColumn ) {
+	auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr || nColumn < 0 ) {
+		return;
+	}
+
+	// Cells are sorted by column first.
+	std::map<GridPoint, std::shared_ptr<GridCell>> oldGridCells;
+	const int nMinRow = std::numeric_limits<int>::min();
+	const auto itBegin = m_gridCells.lower_bound( GridPoint( nColumn, nMinRow ) );
+	const auto itEnd =
+		m_gridCells.lower_bound( GridPoint( nColumn + 1, nMinRow ) );
+	for ( auto it = itBegin; it != itEnd; ++it ) {
+		if ( it->second != nullptr ) {
+			oldGridCells[ it->first ] = it->second;
+		}
+	}
+	m_gridCells.erase( itBegin, itEnd );
+
+	// The column might have been removed from the end of the song.
+	if ( nColumn < pSong->getPatternGroupVector()->size() ) {
+		createGridCells( nColumn, oldGridCells );
+	}
+}
+
+void SongEditor::createGridCells(
+	int nColumn,
+	std::map<GridPoint, std::shared_ptr<GridCell>>& oldGridCells )
+{
+	auto pSong = Hydrogen::get_instance()->getSong();
 	auto pPatternList = pSong->getPatternList();
-	auto pColumns = pSong->getPatternGroupVector();
+	auto pColumn = ( *pSong->getPatternGroupVector() )[ nColumn ];
+	const int nMaxLength = pColumn->longestPatternLength();
 
 	std::shared_ptr<GridCell> pCell;
-	for ( int nColumn = 0; nColumn < pColumns->size(); nColumn++ ) {
-		auto pColumn = (*pColumns)[nColumn];
-		const int nMaxLength = pColumn->longestPatternLength();
+	for ( int nPat = 0; nPat < pColumn->size(); nPat++ ) {
+		auto pPattern = (*pColumn)[ nPat ];
+		if ( pPattern == nullptr ) {
+			continue;
+		}
+		const int y = pPatternList->index( pPattern );
+		assert( y != -1 );
+		const float fWidth = static_cast<float>(pPattern->getLength()) /
+			static_cast<float>(nMaxLength);
+
+		const GridPoint gridPoint( nColumn, y );
+
+		// Check whether the cell was already created - either during the
+		// last update or as part of a virtual pattern.
+		pCell = nullptr;
+		if ( oldGridCells.find( gridPoint ) != oldGridCells.end() ) {
+			pCell = oldGridCells.at( gridPoint );
+		}
+		else if ( m_gridCells.find( gridPoint ) != m_gridCells.end() ) {
+			pCell = m_gridCells.at( gridPoint );
+		}
 
-		for ( int nPat = 0; nPat < pColumn->size(); nPat++ ) {
-			auto pPattern = (*pColumn)[ nPat ];
-			if ( pPattern == nullptr ) {
-				continue;
+		if ( pCell != nullptr ) {
+			pCell->setWidth( fWidth );
+			pCell->setActive( true );
+			pCell->setDrawnVirtual( false );
+			if ( m_gridCells.find( gridPoint ) == m_gridCells.end() ) {
+				m_gridCells.insert( { gridPoint, pCell } );
 			}
-			const int y = pPatternList->index( pPattern );
-			assert( y != -1 );
-			const float fWidth = static_cast<float>(pPattern->getLength()) /
-				static_cast<float>(nMaxLength);
-
-			const GridPoint gridPoint( nColumn, y );
-
-			// Check whether the cell was already created - either during the
-			// last update or as part of a virtual pattern.
-			pCell = nullptr;
 			if ( oldGridCells.find( gridPoint ) != oldGridCells.end() ) {
-				pCell = oldGridCells.at( gridPoint );
+				oldGridCells.erase( oldGridCells.find( gridPoint ) );
 			}
-			else if ( m_gridCells.find( gridPoint ) != m_gridCells.end() ) {
-				pCell = m_gridCells.at( gridPoint );
+		}
+		else {
+			const auto pCell = std::make_shared<GridCell>(
+				gridPoint, true, fWidth, false );
+			m_gridCells.insert( { gridPoint, pCell } );
+		}
+
+		for ( const auto& pVPattern : *( pPattern->getFlattenedVirtualPatterns() ) ) {
+			if ( pVPattern == nullptr ) {
+				continue;
+			}
+			const float fWidthVirtual = static_cast<float>(
+					pVPattern->getLength()) / static_cast<float>(nMaxLength);
+			const GridPoint gridPointVirtual(
+				nColumn, pPatternList->index( pVPattern ) );
+			if ( m_gridCells.find( gridPointVirtual ) != m_gridCells.end() ) {
+				// In case the pattern is already present, we do not add it
+				// as virtual one again.
+				continue;
 			}
 
-			if ( pCell != nullptr ) {
-				pCell->setWidth( fWidth );
-				pCell->setActive( true );
-				pCell->setDrawnVirtual( false );
-				if ( m_gridCells.find( gridPoint ) == m_gridCells.end() ) {
-					m_gridCells.insert( { gridPoint, pCell } );
-				}
-				if ( oldGridCells.find( gridPoint ) != oldGridCells.end() ) {
-					oldGridCells.erase( oldGridCells.find( gridPoint ) );
-				}
+			if ( oldGridCells.find( gridPointVirtual ) != oldGridCells.end() ) {
+				pCell = oldGridCells.at( gridPointVirtual );
+				pCell->setWidth( fWidthVirtual );
+				pCell->setActive( false );
+				pCell->setDrawnVirtual( true );
+				m_gridCells.insert( { gridPointVirtual, pCell } );
+				oldGridCells.erase( oldGridCells.find( gridPointVirtual ) );
 			}
 			else {
 				const auto pCell = std::make_shared<GridCell>(
-					gridPoint, true, fWidth, false );
-				m_gridCells.insert( { gridPoint, pCell } );
+					gridPointVirtual, false, fWidthVirtual, true );
+				m_gridCells.insert( { gridPointVirtual, pCell } );
 			}
+		}
+	}
+}
 
-			for ( const auto& pVPattern : *( pPattern->getFlattenedVirtualPatterns() ) ) {
-				if ( pVPattern == nullptr ) {
-					continue;
-				}
-				const float fWidthVirtual = static_cast<float>(
-						pVPattern->getLength()) / static_cast<float>(nMaxLength);
-				const GridPoint gridPointVirtual(
-					nColumn, pPatternList->index( pVPattern ) );
-				if ( m_gridCells.find( gridPointVirtual ) != m_gridCells.end() ) {
-					// In case the pattern is already present, we do not add it
-					// as virtual one again.
-					continue;
-				}
+void SongEditor::updatePatternStates() {
+	m_patternStates.clear();
 
-				if ( oldGridCells.find( gridPointVirtual ) != oldGridCells.end() ) {
-					pCell = oldGridCells.at( gridPointVirtual );
-					pCell->setWidth( fWidthVirtual );
-					pCell->setActive( false );
-					pCell->setDrawnVirtual( true );
-					m_gridCells.insert( { gridPointVirtual, pCell } );
-					oldGridCells.erase( oldGridCells.find( gridPointVirtual ) );
-				}
-				else {
-					const auto pCell = std::make_shared<GridCell>(
-						gridPointVirtual, false, fWidthVirtual, true );
-					m_gridCells.insert( { gridPointVirtual, pCell } );
-				}
+	auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr ) {
+		return;
+	}
+
+	for ( const auto& ppPattern : *pSong->getPatternList() ) {
+		PatternState state;
+		state.pPattern = ppPattern;
+		state.nLength = ppPattern != nullptr ? ppPattern->getLength() : 0;
+		if ( ppPattern != nullptr ) {
+			state.flattenedVirtualPatterns =
+				*ppPattern->getFlattenedVirtualPatterns();
+		}
+		m_patternStates.push_back( state );
+	}
+}
+
+void SongEditor::gridCellToggled( int nColumn ) {
+	if ( nColumn < 0 ) {
+		updateEditor( Editor::Update::Content );
+		return;
+	}
+
+	m_dirtyColumns.insert( nColumn );
+	update();
+}
+
+void SongEditor::patternModified() {
+	auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr ) {
+		return;
+	}
+	auto pPatternList = pSong->getPatternList();
+
+	if ( pPatternList->size() != m_patternStates.size() ) {
+		// Patterns were added or removed.
+		updateEditor( Editor::Update::Content );
+		return;
+	}
+
+	std::set<std::shared_ptr<Pattern>> changedPatterns;
+	for ( int ii = 0; ii < pPatternList->size(); ++ii ) {
+		const auto pPattern = pPatternList->get( ii );
+		const auto& state = m_patternStates[ ii ];
+		if ( pPattern != state.pPattern ) {
+			// Patterns were reordered or replaced.
+			updateEditor( Editor::Update::Content );
+			return;
+		}
+
+		if ( pPattern != nullptr &&
+			 ( pPattern->getLength() != state.nLength ||
+			   *pPattern->getFlattenedVirtualPatterns() !=
+			   state.flattenedVirtualPatterns ) ) {
+			changedPatterns.insert( pPattern );
+		}
+	}
+
+	if ( changedPatterns.size() == 0 ) {
+		return;
+	}
+
+	// Patterns containing a changed one as virtual pattern are affected too.
+	for ( const auto& ppPattern : *pPatternList ) {
+		if ( ppPattern == nullptr ) {
+			continue;
+		}
+		for ( const auto& ppVirtualPattern :
+				  *ppPattern->getFlattenedVirtualPatterns() ) {
+			if ( changedPatterns.find( ppVirtualPattern ) !=
+				 changedPatterns.end() ) {
+				changedPatterns.insert( ppPattern );
+				break;
 			}
 		}
 	}
+
+	auto pColumns = pSong->getPatternGroupVector();
+	for ( int nnColumn = 0; nnColumn < pColumns->size(); ++nnColumn ) {
+		for ( const auto& ppPattern : *( *pColumns )[ nnColumn ] ) {
+			if ( changedPatterns.find( ppPattern ) != changedPatterns.end() ) {
+				m_dirtyColumns.insert( nnColumn );
+				break;
+			}
+		}
+	}
+
+	updatePatternStates();
+	update();
 }
 
 bool SongEditor::updateHoveredCells(
@@ -1276,18 +1409,56 @@ void SongEditor::drawSequence() {
 
 	updateGridCells();
 
+	if ( m_gridCells.size() > 0 ) {
+		drawCells( p, 0, m_gridCells.rbegin()->first.getColumn() );
+	}
+}
+
+void SongEditor::drawColumns() {
+	const qreal pixelRatio = devicePixelRatio();
+	QPainter p( m_pContentPixmap );
+
+	for ( const auto nnColumn : m_dirtyColumns ) {
+		updateGridCells( nnColumn );
+
+		// The outline of a cell extends one pixel into the next column. We
+		// redraw the cells of the adjacent columns as well but restrict all
+		// painting to the column itself.
+		const QRect columnRect(
+			gridPointToPoint( GridPoint( nnColumn, 0 ) ).x(), 0,
+			m_nGridWidth + 1, height() );
+		p.setClipRect( columnRect );
+		p.drawPixmap( columnRect, *m_pBackgroundPixmap,
+					  QRectF( pixelRatio * columnRect.x(),
+							  pixelRatio * columnRect.y(),
+							  pixelRatio * columnRect.width(),
+							  pixelRatio * columnRect.height() ) );
+		drawCells( p, std::max( nnColumn - 1, 0 ), nnColumn + 1 );
+	}
+
+	m_dirtyColumns.clear();
+}
+
+void SongEditor::drawCells( QPainter& p, int nFirstColumn, int nLastColumn ) {
+	// Cells are sorted by column first.
+	const int nMinRow = std::numeric_limits<int>::min();
+	const auto itBegin =
+		m_gridCells.lower_bound( GridPoint( nFirstColumn, nMinRow ) );
+	const auto itEnd =
+		m_gridCells.lower_bound( GridPoint( nLastColumn + 1, nMinRow ) );
+
 	// Draw using GridCells representation
-	for ( const auto& [ _, ppCell ] : m_gridCells ) {
-		if ( ppCell != nullptr && ! m_selection.isSelected( ppCell ) ) {
-			drawPattern( p, ppCell, CellStyle::Default );
+	for ( auto it = itBegin; it != itEnd; ++it ) {
+		if ( it->second != nullptr && ! m_selection.isSelected( it->second ) ) {
+			drawPattern( p, it->second, CellStyle::Default );
 		}
 	}
 	// We draw all selected patterns in a second run to ensure their
 	// border does have the proper color (else the bottom and left one
 	// could be overwritten by an adjecent, unselected pattern).
-	for ( const auto& [ _, ppCell ] : m_gridCells ) {
-		if ( ppCell != nullptr && m_selection.isSelected( ppCell ) ) {
-			drawPattern( p, ppCell, CellStyle::Selected );
+	for ( auto it = itBegin; it != itEnd; ++it ) {
+		if ( it->second != nullptr && m_selection.isSelected( it->second ) ) {
+			drawPattern( p, it->second, CellStyle::Selected );
 		}
 	}
 }
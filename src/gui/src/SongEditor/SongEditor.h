@@ -31,6 +31,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <QtGui>
@@ -84,6 +85,17 @@ class SongEditor : public Editor::Base<std::shared_ptr<GridCell>>
 
 		void selectAllCellsInRow( int nRow );
 
+		/** Recomputes and redraws the cells of @a nColumn only.
+		 *
+		 * \param nColumn Column a cell was toggled in. A negative value
+		 *   causes all cells to be updated. */
+		void gridCellToggled( int nColumn );
+		/** Checks whether the length or the virtual patterns of any pattern
+		 * changed since the cells were computed and updates only the columns
+		 * containing them. Edits not affecting the grid - like adding notes -
+		 * do not cause any update. */
+		void patternModified();
+
 		int yScrollTarget( QScrollArea *pScrollArea, int *pnPatternInView );
 
 		//! @name Selection interfaces
@@ -181,6 +193,12 @@ class SongEditor : public Editor::Base<std::shared_ptr<GridCell>>
 		virtual void paintEvent(QPaintEvent *ev) override;
 
 		void drawSequence();
+		/** Redraws all columns in #m_dirtyColumns on top of the existing
+		 * content. */
+		void drawColumns();
+		/** Draws all cells located in columns within [@a nFirstColumn, @a
+		 * nLastColumn]. */
+		void drawCells( QPainter& painter, int nFirstColumn, int nLastColumn );
   
 		void drawPattern( QPainter& painter, std::shared_ptr<GridCell> pCell,
 						  CellStyle cellStyle );
@@ -188,6 +206,29 @@ class SongEditor : public Editor::Base<std::shared_ptr<GridCell>>
 
 		std::map<H2Core::GridPoint, std::shared_ptr<GridCell> > m_gridCells;
 		void updateGridCells();
+		/** Only updates the cells of @a nColumn. */
+		void updateGridCells( int nColumn );
+		/** Creates or updates the cells of @a nColumn. Cells already present
+		 * in @a oldGridCells are reused (and removed from it) in order to not
+		 * invalidate the current selection. */
+		void createGridCells(
+			int nColumn,
+			std::map<H2Core::GridPoint, std::shared_ptr<GridCell>>& oldGridCells );
+		/** Caches #m_patternStates for all patterns of the current song. */
+		void updatePatternStates();
+
+		/** Properties of a pattern the grid cells depend on. */
+		struct PatternState {
+			std::shared_ptr<H2Core::Pattern> pPattern;
+			int nLength;
+			std::set<std::shared_ptr<H2Core::Pattern>> flattenedVirtualPatterns;
+		};
+		/** State of all patterns - indexed by row - at the time the cells were
+		 * computed. */
+		std::vector<PatternState> m_patternStates;
+		/** Columns whose cells have to be recomputed and redrawn in the next
+		 * paint event. */
+		std::set<int> m_dirtyColumns;
 
 		bool updateHoveredCells(
 			std::vector< std::shared_ptr<GridCell> > hoveredCells,
@@ -945,8 +945,14 @@ bool SongEditorPanel::hasSongEditorFocus() const{
 		m_pPlaybackTrackWaveDisplay->hasFocus();
 }
 
-void SongEditorPanel::gridCellToggledEvent() {
-	updateEditors( Editor::Update::Content );
+void SongEditorPanel::gridCellToggledEvent( int nColumn ) {
+	m_pPatternList->updateEditor();
+	m_pSongEditor->gridCellToggled( nColumn );
+	m_pPositionRuler->updateEditor();
+	m_pAutomationPathView->updateAutomationPath();
+	updatePlaybackTrack();
+
+	resyncExternalScrollBar();
 }
 
 void SongEditorPanel::jackTimebaseStateChangedEvent( int ) {
@@ -971,7 +977,13 @@ void SongEditorPanel::patternEditorLockedEvent() {
 }
 
 void SongEditorPanel::patternModifiedEvent() {
-	updateEditors( Editor::Update::Content );
+	m_pPatternList->updateEditor();
+	m_pSongEditor->patternModified();
+	m_pPositionRuler->updateEditor();
+	m_pAutomationPathView->updateAutomationPath();
+	updatePlaybackTrack();
+
+	resyncExternalScrollBar();
 }
 
 void SongEditorPanel::playbackTrackChangedEvent() {
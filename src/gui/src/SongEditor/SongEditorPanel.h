@@ -97,7 +97,7 @@ class SongEditorPanel : public QWidget,
 		 *
 		 * \param nValue 0 - select mode and 1 - draw mode.
 		 */
-		virtual void gridCellToggledEvent() override;
+		virtual void gridCellToggledEvent( int nColumn ) override;
 		virtual void jackTimebaseStateChangedEvent( int nState ) override;
 		virtual void midiClockActivationEvent() override;
 		virtual void nextPatternsChangedEvent() override;
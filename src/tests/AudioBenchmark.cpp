@@ -32,11 +32,15 @@
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/InstrumentComponent.h>
 #include <core/Basics/PatternList.h>
+#include <core/IO/DiskWriterDriver.h>
 #include "TestHelper.h"
 #include "AudioBenchmark.h"
 
-#include <memory>
+#include <chrono>
+#include <cmath>
 #include <ctime>
+#include <memory>
+#include <vector>
 
 using namespace H2Core;
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
@@ -47,7 +51,8 @@ namespace Qt {
 
 bool AudioBenchmark::bEnabled = false;
 
-static long long exportCurrentSong( const QString &sFileName, int nSampleRate )
+static long long exportCurrentSong( const QString &sFileName, int nSampleRate,
+							   int nBlockCount = DiskWriterDriver::nDefaultBlockCount )
 {
 	Hydrogen *pHydrogen = Hydrogen::get_instance();
 	EventQueue *pQueue = EventQueue::get_instance();
@@ -58,6 +63,10 @@ static long long exportCurrentSong( const QString &sFileName, int nSampleRate )
 	}
 
 	pHydrogen->startExportSession( nSampleRate, 16 );
+	auto pDriver = std::dynamic_pointer_cast<DiskWriterDriver>(
+		pHydrogen->getAudioDriver() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+	pDriver->setBlockCount( nBlockCount );
 	pHydrogen->startExportSong( sFileName );
 
 	long long nStartFrame = pHydrogen->getAudioEngine()->getPlayhead()->getFrame();
@@ -149,6 +158,106 @@ void AudioBenchmark::timeADSR() {
 	out << "ADSR time: " << showTimes( times, nFrames ) << Qt::endl;
 }
 
+template < Interpolation::InterpolateMode mode >
+static void resampleScalar( const float* pData_L, const float* pData_R,
+							float* pBuffer_L, float* pBuffer_R, int nFrames,
+							double fSamplePos, double fStep )
+{
+	for ( int nFrame = 0; nFrame < nFrames; ++nFrame ) {
+		const long long nPos = static_cast<long long>( fSamplePos );
+		const double fDiff = fSamplePos - nPos;
+		pBuffer_L[ nFrame ] = Interpolation::interpolate<mode>(
+			pData_L[ nPos - 1 ], pData_L[ nPos ], pData_L[ nPos + 1 ],
+			pData_L[ nPos + 2 ], fDiff );
+		pBuffer_R[ nFrame ] = Interpolation::interpolate<mode>(
+			pData_R[ nPos - 1 ], pData_R[ nPos ], pData_R[ nPos + 1 ],
+			pData_R[ nPos + 2 ], fDiff );
+		fSamplePos += fStep;
+	}
+}
+
+static Interpolation::BlockKernel scalarKernel(
+	Interpolation::InterpolateMode mode )
+{
+	switch ( mode ) {
+	case Interpolation::InterpolateMode::Linear:
+		return &resampleScalar<Interpolation::InterpolateMode::Linear>;
+	case Interpolation::InterpolateMode::Cosine:
+		return &resampleScalar<Interpolation::InterpolateMode::Cosine>;
+	case Interpolation::InterpolateMode::Third:
+		return &resampleScalar<Interpolation::InterpolateMode::Third>;
+	case Interpolation::InterpolateMode::Cubic:
+		return &resampleScalar<Interpolation::InterpolateMode::Cubic>;
+	case Interpolation::InterpolateMode::Hermite:
+	default:
+		return &resampleScalar<Interpolation::InterpolateMode::Hermite>;
+	}
+}
+
+void AudioBenchmark::timeResample() {
+	const int nSampleFrames = 1 << 18;
+	const int nFrames = 4096;
+	const float fStep = 1.0001f;
+	const int nIterations = 100;
+	std::vector<float> data_L( nSampleFrames ), data_R( nSampleFrames );
+	std::vector<float> buffer_L( nFrames ), buffer_R( nFrames );
+	for ( int ii = 0; ii < nSampleFrames; ++ii ) {
+		data_L[ ii ] = std::sin( ii * 0.01 );
+		data_R[ ii ] = std::cos( ii * 0.013 );
+	}
+
+	auto timeKernel = [&]( Interpolation::BlockKernel kernel ) {
+		std::vector< clock_t > times;
+		for ( int i = 0; i < nIterations; i++ ) {
+			std::clock_t start = std::clock();
+			// Walk through the whole sample to not just measure the cache.
+			for ( double fPos = 1;
+				  fPos + nFrames * fStep + 3 < nSampleFrames;
+				  fPos += nFrames * fStep ) {
+				kernel( data_L.data(), data_R.data(), buffer_L.data(),
+						buffer_R.data(), nFrames, fPos, fStep );
+			}
+			std::clock_t end = std::clock();
+			times.push_back( end - start );
+		}
+		double fMean;
+		const QString sTimes = showTimes( times, nSampleFrames, &fMean );
+		return std::make_pair( sTimes, fMean );
+	};
+
+	const std::vector<Interpolation::InterpolateMode> modes = {
+		Interpolation::InterpolateMode::Linear,
+		Interpolation::InterpolateMode::Cosine,
+		Interpolation::InterpolateMode::Third,
+		Interpolation::InterpolateMode::Cubic,
+		Interpolation::InterpolateMode::Hermite };
+	const std::vector<Interpolation::Simd> simds = {
+		Interpolation::Simd::None, Interpolation::Simd::SSE2,
+		Interpolation::Simd::AVX2, Interpolation::Simd::NEON };
+
+	out << "Detected instruction set: "
+		<< Interpolation::SimdToQString( Interpolation::detectSimd() )
+		<< Qt::endl;
+
+	for ( const auto& mode : modes ) {
+		const auto [ sRef, fRef ] = timeKernel( scalarKernel( mode ) );
+		out << Interpolation::ModeToQString( mode ) << " scalar reference: "
+			<< sRef << Qt::endl;
+
+		for ( const auto& simd : simds ) {
+			if ( ! Interpolation::isSimdSupported( simd ) ) {
+				continue;
+			}
+			const auto [ sTimes, fMean ] =
+				timeKernel( Interpolation::getBlockKernel( mode, simd ) );
+			out << Interpolation::ModeToQString( mode ) << " "
+				<< Interpolation::SimdToQString( simd ) << ": " << sTimes
+				<< QString( " (speedup x%1)" ).arg( fRef / fMean, 0, 'f', 2 )
+				<< Qt::endl;
+		}
+	}
+}
+
 double AudioBenchmark::timeExport( int nSampleRate,
 								   Interpolation::InterpolateMode interpolateMode,
 								   double fReference,
@@ -205,6 +314,39 @@ double AudioBenchmark::timeExport( int nSampleRate,
 	return fMean;
 }
 
+void AudioBenchmark::timeExportBlocks( const QString& sSuffix ) {
+	const auto sOutFile = Filesystem::tmp_file_path(
+		QString( "test-blocks.%1" ).arg( sSuffix ) );
+	const int nIterations = 8;
+
+	// Since rendering and encoding are done in different threads, we have to
+	// measure wall-clock time instead of the CPU time used by the other
+	// benchmarks.
+	auto timeBlocks = [&]( int nBlockCount ) {
+		// Run through once to warm caches etc.
+		exportCurrentSong( sOutFile, 44100, nBlockCount );
+
+		double fTotal = 0;
+		for ( int ii = 0; ii < nIterations; ++ii ) {
+			const auto start = std::chrono::steady_clock::now();
+			exportCurrentSong( sOutFile, 44100, nBlockCount );
+			const auto end = std::chrono::steady_clock::now();
+			fTotal += std::chrono::duration<double>( end - start ).count();
+		}
+		return fTotal / nIterations;
+	};
+
+	const double fSequential = timeBlocks( 0 );
+	const double fPipelined = timeBlocks( DiskWriterDriver::nDefaultBlockCount );
+	out << sSuffix << " export wall-clock: sequential " << showNumber( fSequential )
+		<< "s, " << DiskWriterDriver::nDefaultBlockCount << " blocks "
+		<< showNumber( fPipelined ) << "s"
+		<< QString( " (speedup x%1)" ).arg( fSequential / fPipelined, 0, 'f', 2 )
+		<< Qt::endl;
+
+	Filesystem::rm( sOutFile );
+}
+
 void AudioBenchmark::audioBenchmark(void)
 {
 	if ( !bEnabled ) {
@@ -217,6 +359,9 @@ void AudioBenchmark::audioBenchmark(void)
 	out << "Benchmark ADSR method:" << Qt::endl;
 	timeADSR();
 
+	out << "\n=== Resampling kernels ===" << Qt::endl;
+	timeResample();
+
 	auto songFile = H2TEST_FILE("functional/test.h2song");
 	auto songADSRFile = H2TEST_FILE("functional/test_adsr.h2song");
 
@@ -240,6 +385,11 @@ void AudioBenchmark::audioBenchmark(void)
 	timeExport( 44101, Interpolation::InterpolateMode::Cubic, fRef );
 	timeExport( 44101, Interpolation::InterpolateMode::Hermite, fRef );
 
+	out << "\n=== Rendering and encoding in parallel ===" << Qt::endl;
+	timeExportBlocks( "wav" );
+	timeExportBlocks( "flac" );
+	timeExportBlocks( "ogg" );
+
 	out << "Now with ADSR" << Qt::endl;
 	pSong = Song::load( songADSRFile );
 	ASSERT_SONG( pSong );
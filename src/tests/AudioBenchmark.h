@@ -37,6 +37,14 @@ class AudioBenchmark : public CppUnit::TestCase {
 	QTextStream out;
 
 	void timeADSR();
+	/** Times the resampling block kernels of all interpolation modes for
+	 * all instruction sets supported by the current machine and compares
+	 * them to the scalar per-frame loop. */
+	void timeResample();
+	/** Compares the wall-clock time of exporting into a file of type @a
+	 * sSuffix with rendering and encoding done sequentially and in
+	 * parallel. */
+	void timeExportBlocks( const QString& sSuffix );
 	double timeExport( int nSampleRate,
 					   H2Core::Interpolation::InterpolateMode interpolateMode,
 					   double fReference = 0.0,
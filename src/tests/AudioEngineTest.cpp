@@ -23,7 +23,16 @@
 #include "AudioEngineTest.h"
 
 #include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/AudioEngineProfiler.h>
+#include <core/AudioEngine/AudioEngineTests.h>
+#include <core/AudioEngine/LiveNoteQueue.h>
 #include <core/AudioEngine/Transport.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Sample.h>
 #include <core/CoreActionController.h>
 #include <core/Hydrogen.h>
 #include <core/IO/FakeAudioDriver.h>
@@ -33,6 +42,11 @@
 #include <core/Preferences/Preferences.h>
 
 #include "TestHelper.h"
+#include "utils/AllocationCounter.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
 
 using namespace H2Core;
 
@@ -290,3 +304,274 @@ void AudioEngineTest::testNotePickup()
 
 	___INFOLOG( "passed" );
 }
+
+void AudioEngineTest::testSongSwitchSamples()
+{
+	___INFOLOG( "" );
+
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pOldSong = pHydrogen->getSong();
+
+	auto pSongA = Song::load( H2TEST_FILE( "song/AE_loopMode.h2song" ) );
+	auto pSongB = Song::load( H2TEST_FILE( "song/AE_noteOff.h2song" ) );
+	CPPUNIT_ASSERT( pSongA != nullptr && pSongA->getDrumkit() != nullptr );
+	CPPUNIT_ASSERT( pSongB != nullptr && pSongB->getDrumkit() != nullptr );
+
+	pHydrogen->setSong( pSongA );
+	CPPUNIT_ASSERT( pSongA->getDrumkit()->areSamplesLoaded() );
+	CPPUNIT_ASSERT( ! pSongB->getDrumkit()->areSamplesLoaded() );
+
+	pHydrogen->setSong( pSongB );
+	CPPUNIT_ASSERT( pHydrogen->getSong() == pSongB );
+	CPPUNIT_ASSERT( pSongB->getDrumkit()->areSamplesLoaded() );
+	CPPUNIT_ASSERT( ! pSongA->getDrumkit()->areSamplesLoaded() );
+
+	// Switching to a song using the very same drumkit must not unload it.
+	auto pSongShared = Song::load( H2TEST_FILE( "song/AE_loopMode.h2song" ) );
+	CPPUNIT_ASSERT( pSongShared != nullptr );
+	pSongShared->setDrumkit( pSongB->getDrumkit() );
+	pHydrogen->setSong( pSongShared );
+	CPPUNIT_ASSERT( pSongShared->getDrumkit()->areSamplesLoaded() );
+
+	// Instruments shared with the current drumkit are still rendered. Their
+	// samples must neither be reloaded nor unloaded.
+	auto pSharedInstrument = pSongB->getDrumkit()->getInstruments()->get( 0 );
+	CPPUNIT_ASSERT( pSharedInstrument != nullptr );
+	auto pSharedSample = pSharedInstrument->getComponent( 0 )->getLayer( 0 )
+		->getSample();
+	CPPUNIT_ASSERT( pSharedSample != nullptr && pSharedSample->isLoaded() );
+	const auto pSharedData = pSharedSample->getData_L();
+
+	auto pSongMixed = Song::load( H2TEST_FILE( "song/AE_loopMode.h2song" ) );
+	CPPUNIT_ASSERT( pSongMixed != nullptr &&
+					pSongMixed->getDrumkit() != nullptr );
+	pSongMixed->getDrumkit()->addInstrument( pSharedInstrument );
+	pHydrogen->setSong( pSongMixed );
+	CPPUNIT_ASSERT( pSongMixed->getDrumkit()->getInstruments()->get( 0 )
+					->getComponent( 0 )->getLayer( 0 )->getSample()->isLoaded() );
+	CPPUNIT_ASSERT( pSharedSample->isLoaded() );
+	CPPUNIT_ASSERT( pSharedSample->getData_L() == pSharedData );
+
+	pHydrogen->setSong( pOldSong );
+
+	___INFOLOG( "passed" );
+}
+
+void AudioEngineTest::testProfilerStatistics()
+{
+	___INFOLOG( "" );
+
+	AudioEngineProfiler profiler;
+	using Stage = AudioEngineProfiler::Stage;
+
+	const auto empty = profiler.getStatistics( Stage::Sampler );
+	CPPUNIT_ASSERT( empty.nCount == 0 );
+	CPPUNIT_ASSERT( empty.fMax == 0 );
+
+	for ( int ii = 1; ii <= 100; ++ii ) {
+		profiler.record( Stage::Sampler, static_cast<float>( ii ) );
+	}
+	auto statistics = profiler.getStatistics( Stage::Sampler );
+	CPPUNIT_ASSERT( statistics.nCount == 100 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 50.0, statistics.fP50, 1e-6 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 99.0, statistics.fP99, 1e-6 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 100.0, statistics.fMax, 1e-6 );
+
+	// Older durations drop out of the window but are still part of the peak.
+	for ( int ii = 0; ii < AudioEngineProfiler::nWindowSize; ++ii ) {
+		profiler.record( Stage::Sampler, 10 );
+	}
+	statistics = profiler.getStatistics( Stage::Sampler );
+	CPPUNIT_ASSERT( statistics.nCount == 100 + AudioEngineProfiler::nWindowSize );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 10.0, statistics.fMax, 1e-6 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 100.0, statistics.fPeak, 1e-6 );
+
+	// LADSPA slots are timed individually.
+	profiler.record( Stage::LadspaFX, 5, 1 );
+	CPPUNIT_ASSERT( profiler.getStatistics( Stage::LadspaFX, 0 ).nCount == 0 );
+	CPPUNIT_ASSERT( profiler.getStatistics( Stage::LadspaFX, 1 ).nCount == 1 );
+
+	profiler.recordCycle( 500, 1000 );
+	profiler.recordCycle( 1500, 1000 );
+	CPPUNIT_ASSERT( profiler.getOverruns() == 1 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 1000.0, profiler.getBudget(), 1e-6 );
+
+	// Dropped buffers count as overrun regardless of their duration.
+	const auto nCycles = profiler.getStatistics( Stage::Cycle ).nCount;
+	profiler.recordMissedCycle( 200, 1000 );
+	CPPUNIT_ASSERT( profiler.getOverruns() == 2 );
+	CPPUNIT_ASSERT( profiler.getMissedCycles() == 1 );
+	CPPUNIT_ASSERT( profiler.getStatistics( Stage::Cycle ).nCount ==
+					nCycles + 1 );
+
+	profiler.reset();
+	CPPUNIT_ASSERT( profiler.getOverruns() == 0 );
+	CPPUNIT_ASSERT( profiler.getMissedCycles() == 0 );
+	CPPUNIT_ASSERT( profiler.getStatistics( Stage::Sampler ).nCount == 0 );
+
+	// The profiler of the running audio engine is fed by the thread of the
+	// fake driver.
+	auto pProfiler = Hydrogen::get_instance()->getAudioEngine()->getProfiler();
+	for ( int ii = 0; ii < 100 &&
+			  pProfiler->getStatistics( Stage::Cycle ).nCount == 0; ++ii ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+	}
+	const auto cycle = pProfiler->getStatistics( Stage::Cycle );
+	CPPUNIT_ASSERT( cycle.nCount > 0 );
+	CPPUNIT_ASSERT( cycle.fMax > 0 );
+
+	___INFOLOG( "passed" );
+}
+
+void AudioEngineTest::testLiveNoteQueue()
+{
+	___INFOLOG( "" );
+
+	LiveNoteQueue queue;
+	LiveNoteQueue::LiveNote liveNote;
+	CPPUNIT_ASSERT( ! queue.pop( liveNote ) );
+
+	// Notes exceeding the capacity are dropped.
+	for ( int ii = 0; ii < static_cast<int>( LiveNoteQueue::nCapacity ) + 3;
+		  ++ii ) {
+		liveNote.nInstrument = ii;
+		queue.push( liveNote );
+	}
+	CPPUNIT_ASSERT( queue.getDropped() == 3 );
+	for ( int ii = 0; ii < static_cast<int>( LiveNoteQueue::nCapacity ); ++ii ) {
+		CPPUNIT_ASSERT( queue.pop( liveNote ) );
+		CPPUNIT_ASSERT( liveNote.nInstrument == ii );
+	}
+	CPPUNIT_ASSERT( ! queue.pop( liveNote ) );
+
+	// Several producers at once while the consumer is draining the queue.
+	const int nProducers = 4;
+	const int nNotesPerProducer = 2000;
+	std::vector<std::thread> producers;
+	for ( int nn = 0; nn < nProducers; ++nn ) {
+		producers.emplace_back( [&queue, nn, nNotesPerProducer]() {
+			LiveNoteQueue::LiveNote note;
+			note.nInstrument = nn;
+			for ( int ii = 0; ii < nNotesPerProducer; ++ii ) {
+				note.fVelocity = static_cast<float>( ii );
+				while ( ! queue.push( note ) ) {
+					std::this_thread::yield();
+				}
+			}
+		} );
+	}
+
+	// Failures are only recorded while the producers are running. Throwing
+	// an assertion would leave them unjoined or blocked on a full queue.
+	std::vector<int> received( nProducers, 0 );
+	bool bUnknownProducer = false;
+	bool bOutOfOrder = false;
+	int nTotal = 0;
+	while ( nTotal < nProducers * nNotesPerProducer ) {
+		if ( ! queue.pop( liveNote ) ) {
+			std::this_thread::yield();
+			continue;
+		}
+		++nTotal;
+		if ( liveNote.nInstrument < 0 || liveNote.nInstrument >= nProducers ) {
+			bUnknownProducer = true;
+			continue;
+		}
+		if ( static_cast<float>( received[ liveNote.nInstrument ] ) !=
+			 liveNote.fVelocity ) {
+			bOutOfOrder = true;
+		}
+		++received[ liveNote.nInstrument ];
+	}
+	for ( auto& pproducer : producers ) {
+		pproducer.join();
+	}
+	CPPUNIT_ASSERT( ! bUnknownProducer );
+	CPPUNIT_ASSERT( ! bOutOfOrder );
+	for ( const auto nnReceived : received ) {
+		CPPUNIT_ASSERT_EQUAL( nNotesPerProducer, nnReceived );
+	}
+	CPPUNIT_ASSERT( ! queue.pop( liveNote ) );
+
+	// Placement within the buffer.
+	const auto cycleStart = Clock::now();
+	const int nSampleRate = 48000;
+	const int nFrames = 1024;
+	CPPUNIT_ASSERT_EQUAL( 480, LiveNoteQueue::computeFrameOffset(
+		cycleStart + std::chrono::milliseconds( 10 ), cycleStart,
+		nSampleRate, nFrames ) );
+	CPPUNIT_ASSERT_EQUAL( 0, LiveNoteQueue::computeFrameOffset(
+		cycleStart - std::chrono::milliseconds( 10 ), cycleStart,
+		nSampleRate, nFrames ) );
+	CPPUNIT_ASSERT_EQUAL( nFrames - 1, LiveNoteQueue::computeFrameOffset(
+		cycleStart + std::chrono::milliseconds( 100 ), cycleStart,
+		nSampleRate, nFrames ) );
+
+	___INFOLOG( "passed" );
+}
+
+void AudioEngineTest::testSteadyStateAllocations()
+{
+	___INFOLOG( "" );
+
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+	auto pNotePool = pAudioEngine->getNotePool();
+
+	auto pSong = Song::load( H2TEST_FILE( "song/AE_noteEnqueuing.h2song" ) );
+	CPPUNIT_ASSERT( pSong != nullptr && pSong->getDrumkit() != nullptr );
+	CPPUNIT_ASSERT( CoreActionController::setSong( pSong ) );
+
+	const auto bOldSongMode = pSong->getMode();
+	const auto bOldLoopMode = pSong->getLoopMode();
+	CPPUNIT_ASSERT( CoreActionController::activateSongMode( true ) );
+	CPPUNIT_ASSERT( CoreActionController::activateLoopMode( true ) );
+
+	AudioEngineTests::benchmarkSetUp();
+
+	const uint32_t nFrames = 512;
+	const int nCyclesPerLoop = static_cast<int>( std::ceil(
+		pAudioEngine->getSongSizeInTicks() *
+		static_cast<double>( pAudioEngine->getPlayhead()->getTickSize() ) /
+		static_cast<double>( nFrames ) ) );
+
+	// During the first loops the queues of audio engine and sampler grow to
+	// their final size.
+	for ( int ii = 0; ii < 2 * nCyclesPerLoop; ++ii ) {
+		AudioEngineTests::processCycle( nFrames );
+	}
+
+	const auto nDropped = pNotePool->getDropped();
+	AllocationCounter::start();
+	for ( int ii = 0; ii < 2 * nCyclesPerLoop; ++ii ) {
+		AudioEngineTests::processCycle( nFrames );
+	}
+	const auto nAllocations = AllocationCounter::stop();
+
+	AudioEngineTests::benchmarkTearDown();
+
+	CPPUNIT_ASSERT( nCyclesPerLoop > 0 );
+	CPPUNIT_ASSERT_EQUAL( 0LL, nAllocations );
+	CPPUNIT_ASSERT_EQUAL( nDropped, pNotePool->getDropped() );
+
+	CPPUNIT_ASSERT( CoreActionController::activateSongMode( bOldSongMode == Song::Mode::Song ) );
+	CPPUNIT_ASSERT( CoreActionController::activateLoopMode( bOldLoopMode == Song::LoopMode::Enabled ) );
+
+	___INFOLOG( "passed" );
+}
+
+#ifdef H2CORE_HAVE_JACK
+void AudioEngineTest::testJackPortCleanUp() {
+	___INFOLOG( "" );
+
+	try {
+		AudioEngineTests::testPerTrackPortCleanUp();
+	}
+	catch ( std::exception& err ) {
+		CppUnit::Message msg( err.what() );
+		throw CppUnit::Exception( msg );
+	}
+
+	___INFOLOG( "passed" );
+}
+#endif
@@ -22,6 +22,8 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <core/config.h>
+
 /** While #TransportTest focus on individual parts of the #H2Core::AudioEngine
  * and #H2Core::Sampler, this test suite is meant to tackle both classes as
  * integration tests with both functional audio and MIDI driver. */
@@ -29,6 +31,13 @@ class AudioEngineTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE( AudioEngineTest );
 	CPPUNIT_TEST( testMidiNoteOrdering );
 	CPPUNIT_TEST( testNotePickup );
+	CPPUNIT_TEST( testSongSwitchSamples );
+	CPPUNIT_TEST( testProfilerStatistics );
+	CPPUNIT_TEST( testLiveNoteQueue );
+	CPPUNIT_TEST( testSteadyStateAllocations );
+#ifdef H2CORE_HAVE_JACK
+	CPPUNIT_TEST( testJackPortCleanUp );
+#endif
 	CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -40,4 +49,29 @@ class AudioEngineTest : public CppUnit::TestFixture {
 	/** Ensure when playing a song in song mode without looping enabled, the
 	 * note at position zero is not picked up twice. */
 	void testNotePickup();
+
+	/** Samples of a new song are loaded before it is set in the audio engine
+	 * and the ones of the previous song released afterwards - unless both
+	 * songs share the same drumkit or instruments. */
+	void testSongSwitchSamples();
+
+	/** Percentiles, rolling window, and overruns of the
+	 * #H2Core::AudioEngineProfiler as well as the timing of a running audio
+	 * engine. */
+	void testProfilerStatistics();
+
+	/** Notes pushed into the #H2Core::LiveNoteQueue by several threads are
+	 * all received in order per thread and placed within the buffer
+	 * according to their time stamps. */
+	void testLiveNoteQueue();
+
+	/** Once the #H2Core::NotePool and all queues are warmed up, rendering a
+	 * looped song must not allocate any memory. */
+	void testSteadyStateAllocations();
+
+#ifdef H2CORE_HAVE_JACK
+	/** Per-track JACK output ports of removed instruments are not
+	 * unregistered while the audio thread might still be using them. */
+	void testJackPortCleanUp();
+#endif
 };
@@ -26,19 +26,52 @@
 #include <QTemporaryDir>
 
 #include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Hydrogen.h>
+#include <core/IO/DiskWriterDriver.h>
 #include <core/Sampler/Interpolation.h>
 #include <core/Sampler/Sampler.h>
 
 #include "TestHelper.h"
 #include "assertions/AudioFile.h"
+#include "assertions/File.h"
 
 #include <memory>
+#include <set>
+#include <sndfile.h>
+#include <unistd.h>
 #include <vector>
 
 using namespace H2Core;
 
+namespace {
+/** \return All interleaved samples of @a sFileName or an empty vector in case
+ * it could not be read. */
+std::vector<float> readAudioFile( const QString& sFileName ) {
+	const auto sFileNameLocal8Bit = sFileName.toLocal8Bit();
+	SF_INFO info = {0};
+	std::unique_ptr<SNDFILE, decltype(&sf_close)> pFile{
+		sf_open( sFileNameLocal8Bit.data(), SFM_READ, &info ), sf_close };
+	if ( pFile == nullptr ) {
+		return {};
+	}
+
+	std::vector<float> samples( info.frames * info.channels );
+	if ( sf_readf_float( pFile.get(), samples.data(), info.frames ) !=
+		 info.frames ) {
+		return {};
+	}
+
+	return samples;
+}
+}
+
 void AudioExportTest::testExportAudio() {
 	___INFOLOG( "" );
 	const auto sSongFile = H2TEST_FILE("functional/test_adsr.h2song");
@@ -87,6 +120,137 @@ void AudioExportTest::testExportVelocityAutomationAudio() {
 	___INFOLOG( "passed" );
 }
 
+void AudioExportTest::testExportStems() {
+	___INFOLOG( "" );
+	auto pHydrogen = Hydrogen::get_instance();
+	const auto sSongFile = H2TEST_FILE("functional/test_adsr.h2song");
+	const auto sOutFile = Filesystem::tmp_file_path("test-stems.wav");
+	const auto sRefFile = H2TEST_FILE("functional/test-44100-16.ref.flac");
+
+	auto pSong = Song::load( sSongFile );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	pHydrogen->setSong( pSong );
+
+	const auto stems = DiskWriterDriver::createStemFileNames( sOutFile, pSong );
+	CPPUNIT_ASSERT( ! stems.empty() );
+	for ( const auto& [ _, ssStemFile ] : stems ) {
+		CPPUNIT_ASSERT( ssStemFile.endsWith( ".wav" ) );
+		CPPUNIT_ASSERT( ssStemFile != sOutFile );
+	}
+
+	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+	for ( const auto& ppInstrument : *pInstrumentList ) {
+		ppInstrument->setCurrentlyExported( true );
+	}
+
+	pHydrogen->startExportSession( 44100, 16 );
+	pHydrogen->startExportSong( sOutFile, stems );
+
+	auto pDriver = std::dynamic_pointer_cast<DiskWriterDriver>(
+		pHydrogen->getAudioDriver() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	const int nMaxSleeps = 3000;
+	int nSleeps = 0;
+	while ( ! pDriver->isDoneWriting() ) {
+		usleep( 100 * 1000 );
+		CPPUNIT_ASSERT( nSleeps < nMaxSleeps );
+		nSleeps++;
+	}
+	CPPUNIT_ASSERT( ! pDriver->writingFailed() );
+	pHydrogen->stopExportSession();
+
+	// Rendering the stems must not alter the main mix.
+	H2TEST_ASSERT_AUDIO_FILES_EQUAL( sRefFile, sOutFile );
+
+	// There is one stem for each instrument used in the song.
+	std::set<Instrument::Id> usedInstruments;
+	for ( const auto& ppPattern : *pSong->getPatternList() ) {
+		for ( const auto& [ _, ppNote ] : *ppPattern->getNotes() ) {
+			if ( pInstrumentList->find( ppNote->getInstrumentId() ) != nullptr ) {
+				usedInstruments.insert( ppNote->getInstrumentId() );
+			}
+		}
+	}
+	CPPUNIT_ASSERT( ! usedInstruments.empty() );
+	CPPUNIT_ASSERT_EQUAL( usedInstruments.size(), stems.size() );
+
+	// The stems have to add up to the main mix. Each file is quantized to 16
+	// bit on its own.
+	const auto mainMix = readAudioFile( sOutFile );
+	CPPUNIT_ASSERT( ! mainMix.empty() );
+	std::vector<float> sum( mainMix.size(), 0 );
+	for ( const auto& [ iid, ssStemFile ] : stems ) {
+		CPPUNIT_ASSERT( usedInstruments.count( iid ) > 0 );
+		CPPUNIT_ASSERT( Filesystem::file_exists( ssStemFile, true ) );
+		const auto stem = readAudioFile( ssStemFile );
+		CPPUNIT_ASSERT_EQUAL( mainMix.size(), stem.size() );
+		for ( size_t ii = 0; ii < stem.size(); ++ii ) {
+			sum[ ii ] += stem[ ii ];
+		}
+		Filesystem::rm( ssStemFile );
+	}
+	const float fTolerance = ( stems.size() + 1 ) / 32768.0;
+	for ( size_t ii = 0; ii < mainMix.size(); ++ii ) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( mainMix[ ii ], sum[ ii ], fTolerance );
+	}
+	Filesystem::rm( sOutFile );
+	___INFOLOG( "passed" );
+}
+
+void AudioExportTest::testExportBlockCounts() {
+	___INFOLOG( "" );
+	const auto sSongFile = H2TEST_FILE("functional/test_adsr.h2song");
+	const auto sRefFile = H2TEST_FILE("functional/test-44100-16.ref.flac");
+
+	for ( const int nnBlockCount : { 0, 1, DiskWriterDriver::nDefaultBlockCount } ) {
+		const auto sOutFile = Filesystem::tmp_file_path(
+			QString( "test-blocks-%1.wav" ).arg( nnBlockCount ) );
+		TestHelper::exportSong( sSongFile, sOutFile, 44100, 16, 0.0,
+								nnBlockCount );
+
+		H2TEST_ASSERT_AUDIO_FILES_EQUAL( sRefFile, sOutFile );
+		Filesystem::rm( sOutFile );
+	}
+	___INFOLOG( "passed" );
+}
+
+void AudioExportTest::testExportReproducible() {
+	___INFOLOG( "" );
+	const auto sSongFile = Filesystem::tmp_file_path( "test-seed.h2song" );
+	const auto sOutFile = Filesystem::tmp_file_path( "test-seed.wav" );
+	const auto sOutFile2 = Filesystem::tmp_file_path( "test-seed2.wav" );
+	const auto sOutFileOtherSeed = Filesystem::tmp_file_path(
+		"test-seed-other.wav" );
+
+	// Enable all random contributions to the rendered audio.
+	auto pSong = Song::load( H2TEST_FILE("functional/test_adsr.h2song") );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	pSong->setHumanizeTimeValue( 1.0 );
+	pSong->setHumanizeVelocityValue( 1.0 );
+	for ( const auto& ppInstrument : *pSong->getDrumkit()->getInstruments() ) {
+		ppInstrument->setRandomPitchFactor( 1.0 );
+	}
+	pSong->setRandomSeed( 1234 );
+	CPPUNIT_ASSERT( pSong->save( sSongFile, false, true ) );
+
+	TestHelper::exportSong( sSongFile, sOutFile );
+	TestHelper::exportSong( sSongFile, sOutFile2 );
+	H2TEST_ASSERT_AUDIO_FILES_EQUAL( sOutFile, sOutFile2 );
+
+	// The seed must actually matter.
+	pSong->setRandomSeed( 4321 );
+	CPPUNIT_ASSERT( pSong->save( sSongFile, false, true ) );
+	TestHelper::exportSong( sSongFile, sOutFileOtherSeed );
+	H2TEST_ASSERT_FILES_UNEQUAL( sOutFile, sOutFileOtherSeed );
+
+	Filesystem::rm( sSongFile );
+	Filesystem::rm( sOutFile );
+	Filesystem::rm( sOutFile2 );
+	Filesystem::rm( sOutFileOtherSeed );
+	___INFOLOG( "passed" );
+}
+
 void AudioExportTest::testFormats() {
 	___INFOLOG( "" );
 	auto pHydrogen = Hydrogen::get_instance();
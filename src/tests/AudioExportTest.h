@@ -29,6 +29,9 @@ class AudioExportTest : public CppUnit::TestCase {
 	CPPUNIT_TEST_SUITE( AudioExportTest );
 	CPPUNIT_TEST( testExportAudio );
 	CPPUNIT_TEST( testExportVelocityAutomationAudio );
+	CPPUNIT_TEST( testExportStems );
+	CPPUNIT_TEST( testExportBlockCounts );
+	CPPUNIT_TEST( testExportReproducible );
 #ifdef H2CORE_HAVE_LIBARCHIVE
 	CPPUNIT_TEST( testFormats );
 #endif
@@ -37,6 +40,15 @@ class AudioExportTest : public CppUnit::TestCase {
 	public:
 		void testExportAudio();
 		void testExportVelocityAutomationAudio();
+		/** Exports the main mix and the stems of all instruments in a single
+		 * pass. */
+		void testExportStems();
+		/** Rendering and encoding audio sequentially or in parallel must
+		 * yield identical files. */
+		void testExportBlockCounts();
+		/** Exporting a humanized song twice using the same `random_seed`
+		 * must yield identical files. */
+		void testExportReproducible();
 		/** Exports a song in all supported format, sample rate and sample depth
 		 * configurations. */
 		void testFormats();
@@ -0,0 +1,123 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "BenchmarkTest.h"
+
+#include <bench/Benchmark.h>
+
+#include <core/Object.h>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+void BenchmarkTest::testComputeStatistics() {
+	___INFOLOG( "" );
+
+	// Unsorted input with an odd number of entries.
+	auto result = Benchmark::computeStatistics(
+		"odd", { 5, 1, 4, 2, 3 }, 7 );
+	CPPUNIT_ASSERT( result.sName == "odd" );
+	CPPUNIT_ASSERT_EQUAL( 5, result.nIterations );
+	CPPUNIT_ASSERT_EQUAL( 7, result.nWarmUp );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, result.fMin, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 5.0, result.fMax, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0, result.fMedian, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0, result.fMean, 1e-9 );
+	// ceil( 0.9 * 5 ) = 5th smallest value
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 5.0, result.fP90, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( std::sqrt( 2.0 ), result.fStdDev, 1e-9 );
+
+	// Even number of entries
+	std::vector<double> times;
+	for ( int ii = 10; ii > 0; --ii ) {
+		times.push_back( ii * 10 );
+	}
+	result = Benchmark::computeStatistics( "even", times, 0 );
+	CPPUNIT_ASSERT_EQUAL( 10, result.nIterations );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 10.0, result.fMin, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 100.0, result.fMax, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 55.0, result.fMedian, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 55.0, result.fMean, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 90.0, result.fP90, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( std::sqrt( 825.0 ), result.fStdDev, 1e-9 );
+
+	// A single entry
+	result = Benchmark::computeStatistics( "single", { 42 }, 0 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 42.0, result.fMin, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 42.0, result.fMedian, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 42.0, result.fP90, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, result.fStdDev, 1e-9 );
+
+	// No iterations at all
+	result = Benchmark::computeStatistics( "empty", {}, 3 );
+	CPPUNIT_ASSERT_EQUAL( 0, result.nIterations );
+	CPPUNIT_ASSERT_EQUAL( 3, result.nWarmUp );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, result.fMedian, 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, result.fMax, 1e-9 );
+
+	// Survives a round trip through JSON.
+	const auto restored = BenchmarkResult::fromJson(
+		Benchmark::computeStatistics( "json", { 3, 1, 2 }, 1 ).toJson() );
+	CPPUNIT_ASSERT( restored.sName == "json" );
+	CPPUNIT_ASSERT_EQUAL( 3, restored.nIterations );
+	CPPUNIT_ASSERT_EQUAL( 1, restored.nWarmUp );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0, restored.fMedian, 1e-9 );
+
+	___INFOLOG( "passed" );
+}
+
+void BenchmarkTest::testCompare() {
+	___INFOLOG( "" );
+
+	std::map<QString, BenchmarkResult> baseline;
+	for ( const auto& sName : { "faster", "slightly slower", "slower",
+								"zero baseline" } ) {
+		baseline.insert( { sName, Benchmark::computeStatistics(
+					sName, { 100 }, 0 ) } );
+	}
+	baseline[ "zero baseline" ].fMedian = 0;
+
+	std::vector<BenchmarkResult> results;
+	results.push_back( Benchmark::computeStatistics( "faster", { 50 }, 0 ) );
+	results.push_back( Benchmark::computeStatistics( "slightly slower", { 104 }, 0 ) );
+	results.push_back( Benchmark::computeStatistics( "slower", { 150 }, 0 ) );
+	results.push_back( Benchmark::computeStatistics( "zero baseline", { 150 }, 0 ) );
+	results.push_back( Benchmark::computeStatistics( "new", { 500 }, 0 ) );
+
+	QString sReport;
+	QTextStream out( &sReport );
+	CPPUNIT_ASSERT_EQUAL( 1, Benchmark::compare( results, baseline, 5, out ) );
+	out.flush();
+	CPPUNIT_ASSERT( sReport.contains( "slower: median 150 ns, baseline 100 ns (+50.00%) REGRESSION" ) );
+	CPPUNIT_ASSERT( sReport.contains( "faster: median 50 ns, baseline 100 ns (-50.00%)\n" ) );
+	CPPUNIT_ASSERT( sReport.contains( "new: not in baseline" ) );
+	CPPUNIT_ASSERT( sReport.contains( "zero baseline: invalid baseline entry (median 0 ns)" ) );
+	CPPUNIT_ASSERT( ! sReport.contains( "zero baseline: not in baseline" ) );
+	CPPUNIT_ASSERT_EQUAL( 1, sReport.count( "REGRESSION" ) );
+
+	// The threshold is exclusive.
+	CPPUNIT_ASSERT_EQUAL( 0, Benchmark::compare( results, baseline, 50, out ) );
+	CPPUNIT_ASSERT_EQUAL( 2, Benchmark::compare( results, baseline, 3, out ) );
+
+	___INFOLOG( "passed" );
+}
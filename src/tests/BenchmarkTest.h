@@ -0,0 +1,45 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef BENCHMARK_TEST_H
+#define BENCHMARK_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+/** Covers the evaluation part of h2bench. The kernels themselves are not
+ * run. */
+class BenchmarkTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( BenchmarkTest );
+	CPPUNIT_TEST( testComputeStatistics );
+	CPPUNIT_TEST( testCompare );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	/** Checks min, median, mean, 90th percentile, max, and standard
+	 * deviation for odd, even, unsorted, and empty inputs. */
+	void testComputeStatistics();
+	/** Checks that only medians exceeding the threshold are counted as
+	 * regressions and that benchmarks missing in the baseline or having an
+	 * invalid entry in it are skipped. */
+	void testCompare();
+};
+#endif
@@ -24,14 +24,21 @@
 
 #include "TestHelper.h"
 
+#include <core/Basics/Drumkit.h>
 #include <core/Basics/Event.h>
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentComponent.h>
 #include <core/Basics/InstrumentLayer.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/Sample.h>
+#include <core/Helpers/Filesystem.h>
 #include <core/Midi/Midi.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
 using namespace H2Core;
 
 void DrumkitTest::testDefaultMidiOutNotes()
@@ -450,3 +457,82 @@ void DrumkitTest::testInstrumentMove()
 
 	___INFOLOG( "passed" );
 }
+
+void DrumkitTest::testLoadSamplesConcurrently()
+{
+	___INFOLOG( "" );
+
+	const QString sDrumkitPath = Filesystem::drumkit_path_search(
+		"GMRockKit", Filesystem::Lookup::system, true );
+	auto pDrumkitSingle = Drumkit::load( sDrumkitPath, false, nullptr, true );
+	auto pDrumkitMulti = Drumkit::load( sDrumkitPath, false, nullptr, true );
+	CPPUNIT_ASSERT( pDrumkitSingle != nullptr );
+	CPPUNIT_ASSERT( pDrumkitMulti != nullptr );
+
+	const int nThreads =
+		std::max( static_cast<int>( std::thread::hardware_concurrency() ), 2 );
+	const int nIterations = 5;
+
+	auto timeLoading = [&]( std::shared_ptr<Drumkit> pDrumkit, int nnThreads ) {
+		double fTotal = 0;
+		for ( int ii = 0; ii < nIterations; ++ii ) {
+			pDrumkit->unloadSamples();
+			const auto start = std::chrono::steady_clock::now();
+			pDrumkit->loadSamples( 120, nnThreads );
+			const auto end = std::chrono::steady_clock::now();
+			fTotal += std::chrono::duration<double>( end - start ).count();
+		}
+		return fTotal / nIterations;
+	};
+
+	const double fSingle = timeLoading( pDrumkitSingle, 1 );
+	const double fMulti = timeLoading( pDrumkitMulti, nThreads );
+	___INFOLOG( QString( "Loading [%1] took [%2]s using 1 thread and [%3]s using [%4] threads (speedup x%5)" )
+				.arg( sDrumkitPath ).arg( fSingle ).arg( fMulti )
+				.arg( nThreads ).arg( fSingle / fMulti, 0, 'f', 2 ) );
+
+	CPPUNIT_ASSERT( pDrumkitSingle->areSamplesLoaded() );
+	CPPUNIT_ASSERT( pDrumkitMulti->areSamplesLoaded() );
+
+	const auto pInstrumentsSingle = pDrumkitSingle->getInstruments();
+	const auto pInstrumentsMulti = pDrumkitMulti->getInstruments();
+	CPPUNIT_ASSERT( pInstrumentsSingle->size() == pInstrumentsMulti->size() );
+	for ( int ii = 0; ii < pInstrumentsSingle->size(); ++ii ) {
+		const auto pComponentsSingle =
+			pInstrumentsSingle->get( ii )->getComponents();
+		const auto pComponentsMulti =
+			pInstrumentsMulti->get( ii )->getComponents();
+		CPPUNIT_ASSERT( pComponentsSingle->size() == pComponentsMulti->size() );
+		for ( int cc = 0; cc < pComponentsSingle->size(); ++cc ) {
+			const auto layersSingle = pComponentsSingle->at( cc )->getLayers();
+			const auto layersMulti = pComponentsMulti->at( cc )->getLayers();
+			CPPUNIT_ASSERT( layersSingle.size() == layersMulti.size() );
+			for ( int ll = 0; ll < layersSingle.size(); ++ll ) {
+				const auto pLayerSingle = layersSingle[ ll ];
+				const auto pLayerMulti = layersMulti[ ll ];
+				CPPUNIT_ASSERT( ( pLayerSingle == nullptr ) ==
+								( pLayerMulti == nullptr ) );
+				if ( pLayerSingle == nullptr ||
+					 pLayerSingle->getSample() == nullptr ) {
+					continue;
+				}
+				const auto pSampleSingle = pLayerSingle->getSample();
+				const auto pSampleMulti = pLayerMulti->getSample();
+				CPPUNIT_ASSERT( pSampleMulti != nullptr );
+				CPPUNIT_ASSERT( pSampleMulti->isLoaded() );
+				CPPUNIT_ASSERT( pSampleSingle->getFrames() ==
+								pSampleMulti->getFrames() );
+				CPPUNIT_ASSERT( std::memcmp(
+									pSampleSingle->getData_L(),
+									pSampleMulti->getData_L(),
+									pSampleSingle->getFrames() * sizeof( float ) ) == 0 );
+				CPPUNIT_ASSERT( std::memcmp(
+									pSampleSingle->getData_R(),
+									pSampleMulti->getData_R(),
+									pSampleSingle->getFrames() * sizeof( float ) ) == 0 );
+			}
+		}
+	}
+
+	___INFOLOG( "passed" );
+}
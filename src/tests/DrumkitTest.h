@@ -32,6 +32,7 @@ class DrumkitTest : public CppUnit::TestCase {
 	CPPUNIT_TEST( testIsValidIndex );
 	CPPUNIT_TEST( testLayerHandling );
 	CPPUNIT_TEST( testInstrumentMove );
+	CPPUNIT_TEST( testLoadSamplesConcurrently );
 	CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -40,6 +41,9 @@ class DrumkitTest : public CppUnit::TestCase {
 	void testIsValidIndex();
 	void testLayerHandling();
 	void testInstrumentMove();
+	/** Loading samples using multiple threads must yield the same result as
+	 * using a single one. Also prints the time required for both. */
+	void testLoadSamplesConcurrently();
 };
 
 #endif
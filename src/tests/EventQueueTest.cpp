@@ -79,10 +79,13 @@ void EventQueueTest::testOverflow() {
 	auto pEventQueue = EventQueue::get_instance();
 	std::unique_ptr<Event> pEvent;
 
+	const auto nDroppedEvents = pEventQueue->getDroppedEvents();
+
 	// Overfill queue
 	for ( int i = 0; i < EventQueue::nMaxEvents + 100; i++) {
 		pEventQueue->pushEvent( Event::Type::Progress, i );
 	}
+	CPPUNIT_ASSERT( pEventQueue->getDroppedEvents() == nDroppedEvents + 100 );
 	// Check that the queue contains the most recent EventQueue::nMaxEvents
 	// events
 	for ( int i = 0; i < EventQueue::nMaxEvents; i++) {
@@ -172,3 +175,41 @@ void EventQueueTest::testEventDrop() {
 
 	___INFOLOG( "passed" );
 }
+
+void EventQueueTest::testNoteRenderCoalescing() {
+	___INFOLOG( "" );
+	auto pEventQueue = EventQueue::get_instance();
+	std::unique_ptr<Event> pEvent;
+
+	// Several events for the same instrument are pending only once.
+	const auto nId = pEventQueue->pushEvent( Event::Type::NoteRender, 3 );
+	CPPUNIT_ASSERT( nId != Event::nInvalidId );
+	for ( int ii = 0; ii < 10; ii++ ) {
+		CPPUNIT_ASSERT( pEventQueue->pushEvent( Event::Type::NoteRender, 3 ) ==
+						nId );
+		pEventQueue->pushEvent( Event::Type::NoteRender, 4 );
+	}
+
+	pEvent = pEventQueue->popEvent();
+	CPPUNIT_ASSERT( pEvent != nullptr );
+	CPPUNIT_ASSERT( pEvent->getType() == Event::Type::NoteRender &&
+					pEvent->getValue() == 3 && pEvent->getId() == nId );
+	pEvent = pEventQueue->popEvent();
+	CPPUNIT_ASSERT( pEvent != nullptr );
+	CPPUNIT_ASSERT( pEvent->getType() == Event::Type::NoteRender &&
+					pEvent->getValue() == 4 );
+	pEvent = pEventQueue->popEvent();
+	CPPUNIT_ASSERT( pEvent == nullptr );
+
+	// Once handled, new events can be queued again.
+	CPPUNIT_ASSERT( pEventQueue->pushEvent( Event::Type::NoteRender, 3 ) !=
+					nId );
+	pEvent = pEventQueue->popEvent();
+	CPPUNIT_ASSERT( pEvent != nullptr );
+	CPPUNIT_ASSERT( pEvent->getType() == Event::Type::NoteRender &&
+					pEvent->getValue() == 3 );
+	pEvent = pEventQueue->popEvent();
+	CPPUNIT_ASSERT( pEvent == nullptr );
+
+	___INFOLOG( "passed" );
+}
@@ -31,6 +31,7 @@ class EventQueueTest : public CppUnit::TestCase {
 	CPPUNIT_TEST( testOverflow );
 	CPPUNIT_TEST( testThreadedAccess );
 	CPPUNIT_TEST( testEventDrop );
+	CPPUNIT_TEST( testNoteRenderCoalescing );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -45,6 +46,7 @@ public:
 	void testOverflow();
 	void testThreadedAccess();
 	void testEventDrop();
+	void testNoteRenderCoalescing();
 
 };
 
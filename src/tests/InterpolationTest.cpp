@@ -0,0 +1,116 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "InterpolationTest.h"
+
+#include <core/Object.h>
+#include <core/Sampler/Interpolation.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace H2Core;
+
+// Block kernels compute in single precision while the scalar path uses
+// doubles for some of the modes.
+const double fTolerance = 1e-5;
+
+template < Interpolation::InterpolateMode mode >
+static void checkKernel( Interpolation::Simd simd,
+						 const std::vector<float>& data_L,
+						 const std::vector<float>& data_R,
+						 double fSamplePos, float fStep, int nFrames )
+{
+	std::vector<float> buffer_L( nFrames ), buffer_R( nFrames );
+	Interpolation::getBlockKernel( mode, simd )(
+		data_L.data(), data_R.data(), buffer_L.data(), buffer_R.data(),
+		nFrames, fSamplePos, fStep );
+
+	// Reference is the per-frame loop the Sampler used prior to the
+	// introduction of the block kernels.
+	double fPos = fSamplePos;
+	for ( int nFrame = 0; nFrame < nFrames; ++nFrame ) {
+		const long long nPos = static_cast<long long>( fPos );
+		const double fDiff = fPos - nPos;
+		const float fRef_L = Interpolation::interpolate<mode>(
+			data_L[ nPos - 1 ], data_L[ nPos ], data_L[ nPos + 1 ],
+			data_L[ nPos + 2 ], fDiff );
+		const float fRef_R = Interpolation::interpolate<mode>(
+			data_R[ nPos - 1 ], data_R[ nPos ], data_R[ nPos + 1 ],
+			data_R[ nPos + 2 ], fDiff );
+
+		const std::string sMsg = QString( "[%1] using [%2] at frame [%3]" )
+			.arg( Interpolation::ModeToQString( mode ) )
+			.arg( Interpolation::SimdToQString( simd ) )
+			.arg( nFrame ).toStdString();
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			sMsg, fRef_L, buffer_L[ nFrame ], fTolerance );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			sMsg, fRef_R, buffer_R[ nFrame ], fTolerance );
+
+		fPos += fStep;
+	}
+}
+
+void InterpolationTest::testBlockKernels()
+{
+	___INFOLOG( "" );
+
+	const int nSampleFrames = 8192;
+	std::vector<float> data_L( nSampleFrames ), data_R( nSampleFrames );
+	for ( int ii = 0; ii < nSampleFrames; ++ii ) {
+		data_L[ ii ] = std::sin( ii * 0.01 ) * 0.8 + std::sin( ii * 1.3 ) * 0.2;
+		data_R[ ii ] = std::cos( ii * 0.013 ) * 0.7 - std::sin( ii * 2.1 ) * 0.3;
+	}
+
+	const std::vector<Interpolation::Simd> simds = {
+		Interpolation::Simd::None, Interpolation::Simd::SSE2,
+		Interpolation::Simd::AVX2, Interpolation::Simd::NEON };
+
+	// Pitch up and down with an odd number of frames to cover the scalar
+	// tail of the kernels as well.
+	const std::vector<float> steps = { 0.31f, 0.9977f, 1.0001f, 1.7f, 3.3f };
+	const int nFrames = 1027;
+
+	for ( const auto& simd : simds ) {
+		if ( ! Interpolation::isSimdSupported( simd ) ) {
+			___INFOLOG( QString( "Skipping unsupported [%1]" )
+						.arg( Interpolation::SimdToQString( simd ) ) );
+			continue;
+		}
+
+		for ( const auto& fStep : steps ) {
+			const double fSamplePos = 1.37;
+			checkKernel<Interpolation::InterpolateMode::Linear>(
+				simd, data_L, data_R, fSamplePos, fStep, nFrames );
+			checkKernel<Interpolation::InterpolateMode::Cosine>(
+				simd, data_L, data_R, fSamplePos, fStep, nFrames );
+			checkKernel<Interpolation::InterpolateMode::Third>(
+				simd, data_L, data_R, fSamplePos, fStep, nFrames );
+			checkKernel<Interpolation::InterpolateMode::Cubic>(
+				simd, data_L, data_R, fSamplePos, fStep, nFrames );
+			checkKernel<Interpolation::InterpolateMode::Hermite>(
+				simd, data_L, data_R, fSamplePos, fStep, nFrames );
+		}
+	}
+
+	___INFOLOG( "passed" );
+}
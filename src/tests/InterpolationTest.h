@@ -0,0 +1,39 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef INTERPOLATION_TEST_H
+#define INTERPOLATION_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class InterpolationTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE( InterpolationTest );
+	CPPUNIT_TEST( testBlockKernels );
+	CPPUNIT_TEST_SUITE_END();
+
+	public:
+	/** Checks the output of the block kernels of all interpolation modes
+	 * and all instruction sets supported by the current machine against
+	 * the scalar reference implementation Interpolation::interpolate(). */
+	void testBlockKernels();
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/config.h>
+
+#ifdef H2CORE_HAVE_LADSPA
+
+#include "LadspaTest.h"
+#include "TestHelper.h"
+
+#include <core/FX/LadspaCatalogue.h>
+#include <core/Helpers/Filesystem.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+using namespace H2Core;
+
+void LadspaTest::testCatalogue() {
+	___INFOLOG( "" );
+
+	QTemporaryDir tmpDir( Filesystem::tmp_dir() + "testLadspa-XXXXXX" );
+	CPPUNIT_ASSERT( tmpDir.isValid() );
+	const QString sPluginDir = tmpDir.filePath( "plugins" );
+	const QString sCataloguePath = tmpDir.filePath( "ladspa_catalogue.xml" );
+	CPPUNIT_ASSERT( QDir().mkpath( sPluginDir ) );
+
+	// A file which is not a proper library. It does not provide any plugins
+	// but must be recorded nevertheless.
+#ifdef WIN32
+	const QString sLibraryPath = sPluginDir + "/fake.dll";
+#else
+#ifdef Q_OS_MACX
+	const QString sLibraryPath = sPluginDir + "/fake.dylib";
+#else
+	const QString sLibraryPath = sPluginDir + "/fake.so";
+#endif
+#endif
+	QFile library( sLibraryPath );
+	CPPUNIT_ASSERT( library.open( QIODevice::WriteOnly ) );
+	library.write( "no LADSPA plugin" );
+	library.close();
+
+	// Write
+	LadspaCatalogue catalogue( sCataloguePath );
+	CPPUNIT_ASSERT( ! catalogue.load() );
+	CPPUNIT_ASSERT( catalogue.update( { sPluginDir } ) );
+	CPPUNIT_ASSERT( catalogue.getEntries().size() == 1 );
+	CPPUNIT_ASSERT( catalogue.getPlugins().size() == 0 );
+	CPPUNIT_ASSERT( ! catalogue.update( { sPluginDir } ) );
+	CPPUNIT_ASSERT( catalogue.save() );
+
+	// Read back
+	LadspaCatalogue loadedCatalogue( sCataloguePath );
+	CPPUNIT_ASSERT( loadedCatalogue.load() );
+	CPPUNIT_ASSERT( loadedCatalogue.getEntries().size() == 1 );
+	const auto it = loadedCatalogue.getEntries().find( sLibraryPath );
+	CPPUNIT_ASSERT( it != loadedCatalogue.getEntries().end() );
+	const auto entry = catalogue.getEntries().at( sLibraryPath );
+	CPPUNIT_ASSERT( it->second.nModified == entry.nModified );
+	CPPUNIT_ASSERT( it->second.nSize == entry.nSize );
+	CPPUNIT_ASSERT( it->second.plugins.size() == 0 );
+	CPPUNIT_ASSERT( ! loadedCatalogue.update( { sPluginDir } ) );
+
+	// Invalidation by modification time
+	const auto modified = QFileInfo( sLibraryPath ).lastModified().addSecs( 60 );
+	CPPUNIT_ASSERT( library.open( QIODevice::ReadWrite ) );
+	CPPUNIT_ASSERT( library.setFileTime(
+		modified, QFileDevice::FileModificationTime ) );
+	library.close();
+	CPPUNIT_ASSERT( loadedCatalogue.update( { sPluginDir } ) );
+	CPPUNIT_ASSERT( loadedCatalogue.getEntries().at( sLibraryPath ).nModified ==
+					modified.toMSecsSinceEpoch() );
+	CPPUNIT_ASSERT( ! loadedCatalogue.update( { sPluginDir } ) );
+
+	// Removal
+	CPPUNIT_ASSERT( library.remove() );
+	CPPUNIT_ASSERT( loadedCatalogue.update( { sPluginDir } ) );
+	CPPUNIT_ASSERT( loadedCatalogue.getEntries().size() == 0 );
+
+	___INFOLOG( "passed" );
+}
+
+#endif
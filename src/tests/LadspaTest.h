@@ -0,0 +1,40 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef LADSPA_TEST_H
+#define LADSPA_TEST_H
+
+#include <core/config.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LadspaTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( LadspaTest );
+	CPPUNIT_TEST( testCatalogue );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	/** The #H2Core::LadspaCatalogue is written to and read back from disk
+	 * and only rescans libraries which were added, removed, or modified. */
+	void testCatalogue();
+};
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "LoggerTest.h"
+
+#include <core/Logger.h>
+#include <core/Object.h>
+
+#include <QFile>
+#include <QTextStream>
+
+using namespace H2Core;
+
+namespace {
+/** @return everything the logger thread wrote to the log file so far. */
+QString readLogFile() {
+	Logger::get_instance()->flush();
+	QFile file( Logger::get_instance()->getLogFilePath() );
+	CPPUNIT_ASSERT( file.open( QIODevice::ReadOnly | QIODevice::Text ) );
+	return QTextStream( &file ).readAll();
+}
+}
+
+void LoggerTest::testRealtimeLogging() {
+	___INFOLOG( "" );
+	auto pLogger = Logger::get_instance();
+	pLogger->flush();
+
+	const auto nDropped = pLogger->getRtDropped();
+
+	// As long as the ring buffer is not exceeded, no message must be lost
+	// regardless of how fast the logger thread is.
+	for ( int ii = 0; ii < static_cast<int>( Logger::nRtQueueSize ); ++ii ) {
+		pLogger->logRt( Logger::Debug, "LoggerTest", __FUNCTION__,
+						"message [%1] of [%2], value: [%3], id: [%4]", ii,
+						Logger::nRtQueueSize, 0.5 * ii, -1 );
+	}
+	// The ring buffer might be full by now.
+	pLogger->flush();
+	pLogger->logRt( Logger::Debug, "LoggerTest", __FUNCTION__,
+					"message without arguments" );
+	pLogger->flush();
+	pLogger->logRt( Logger::Debug, "LoggerTest", __FUNCTION__,
+					"last message" );
+	// String literals can be passed as well.
+	pLogger->logRt( Logger::Warning, "LoggerTest", __FUNCTION__,
+					"[%1|%2] XRUN of %3 msec (%4 > %5)", "JACK", "ALSA", 1.5,
+					11.5, 10 );
+	pLogger->flush();
+
+	CPPUNIT_ASSERT( pLogger->getRtDropped() == nDropped );
+
+	// All messages have to be formatted by the logger thread.
+	const QString sLog = readLogFile();
+	const QString sPrefix( "[LoggerTest::testRealtimeLogging] " );
+	for ( int ii = 0; ii < static_cast<int>( Logger::nRtQueueSize ); ++ii ) {
+		CPPUNIT_ASSERT( sLog.contains(
+			QString( "%1message [%2] of [%3], value: [%4], id: [-1]" )
+			.arg( sPrefix ).arg( ii ).arg( Logger::nRtQueueSize )
+			.arg( 0.5 * ii ) ) );
+	}
+	CPPUNIT_ASSERT( sLog.contains( sPrefix + "message without arguments" ) );
+	CPPUNIT_ASSERT( sLog.contains( sPrefix + "last message" ) );
+	CPPUNIT_ASSERT( sLog.contains(
+						sPrefix + "[JACK|ALSA] XRUN of 1.5 msec (11.5 > 10)" ) );
+	___INFOLOG( "passed" );
+}
+
+void LoggerTest::testRealtimeOverflow() {
+	___INFOLOG( "" );
+	auto pLogger = Logger::get_instance();
+	pLogger->flush();
+
+	const auto nDropped = pLogger->getRtDropped();
+	const int nExcess = 100;
+
+	// The logger thread might pick up some messages while we are still
+	// writing. But at most the excess can be dropped.
+	for ( int ii = 0; ii < static_cast<int>( Logger::nRtQueueSize ) + nExcess;
+		  ++ii ) {
+		___RT_DEBUGLOG( "overflow message [%1]", ii );
+	}
+	pLogger->flush();
+
+	CPPUNIT_ASSERT( pLogger->getRtDropped() - nDropped <= nExcess );
+
+	// Logger must recover once the buffer was drained.
+	const auto nDroppedAfterOverflow = pLogger->getRtDropped();
+	for ( int ii = 0; ii < static_cast<int>( Logger::nRtQueueSize ); ++ii ) {
+		pLogger->logRt( Logger::Debug, "LoggerTest", __FUNCTION__,
+						"recovery message [%1]", ii );
+	}
+	pLogger->flush();
+	CPPUNIT_ASSERT( pLogger->getRtDropped() == nDroppedAfterOverflow );
+
+	const QString sLog = readLogFile();
+	for ( int ii = 0; ii < static_cast<int>( Logger::nRtQueueSize ); ++ii ) {
+		CPPUNIT_ASSERT( sLog.contains(
+			QString( "[LoggerTest::testRealtimeOverflow] recovery message "
+					 "[%1]" ).arg( ii ) ) );
+	}
+	___INFOLOG( "passed" );
+}
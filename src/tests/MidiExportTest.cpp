@@ -25,6 +25,7 @@
 #include <QString>
 
 #include <core/Basics/Pattern.h>
+#include <core/Basics/Song.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Midi/SMF.h>
 
@@ -156,10 +157,18 @@ void MidiExportTest::testHumanization() {
 	TestHelper::exportMIDI( sSongFile, sOutFile2, pWriter, false );
 	H2TEST_ASSERT_FILES_EQUAL( sOutFile, sOutFile2 );
 
-	// Export with humanization must not.
+	// Export with humanization is reproducible as well since the random
+	// contributions are seeded by the song.
 	TestHelper::exportMIDI( sSongFile, sOutFileHumanized, pWriter, true );
 	TestHelper::exportMIDI( sSongFile, sOutFileHumanized2, pWriter, true );
 	H2TEST_ASSERT_FILES_UNEQUAL( sOutFile, sOutFileHumanized );
+	H2TEST_ASSERT_FILES_EQUAL( sOutFileHumanized, sOutFileHumanized2 );
+
+	// But differs for another seed.
+	auto pSong = H2Core::Song::load( sSongFile );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	pSong->setRandomSeed( pSong->getRandomSeed() + 1 );
+	pWriter->save( sOutFileHumanized2, pSong, true );
 	H2TEST_ASSERT_FILES_UNEQUAL( sOutFileHumanized, sOutFileHumanized2 );
 	Filesystem::rm( sOutFile );
 	Filesystem::rm( sOutFile2 );
@@ -24,13 +24,17 @@
 
 #include "TestHelper.h"
 
+#include <core/AudioEngine/NotePool.h>
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/Note.h>
 #include <core/Basics/Pattern.h>
 #include <core/Basics/Song.h>
 #include <core/CoreActionController.h>
+#include <core/Helpers/Random.h>
 #include <core/Helpers/Xml.h>
 #include <core/Hydrogen.h>
 #include <core/Midi/Midi.h>
@@ -41,6 +45,8 @@
 #include <QDomDocument>
 
 #include <algorithm>
+#include <cmath>
+#include <vector>
 
 using namespace H2Core;
 
@@ -103,6 +109,71 @@ void NoteTest::testComparison() {
 	___INFOLOG( "passed" );
 }
 
+void NoteTest::testLayerSelection() {
+	___INFOLOG( "" );
+
+	auto pInstrument = std::make_shared<Instrument>();
+	auto pComponent = pInstrument->getComponent( 0 );
+	CPPUNIT_ASSERT( pComponent != nullptr );
+
+	// Two overlapping layers, a hole between 0.5 and 0.7, and a third one
+	// on top.
+	std::vector<std::shared_ptr<InstrumentLayer>> layers;
+	for ( const auto& [ fStart, fEnd ] : std::vector<std::pair<float, float>>{
+			  { 0.0, 0.4 }, { 0.3, 0.5 }, { 0.7, 1.0 } } ) {
+		auto pLayer = std::make_shared<InstrumentLayer>( nullptr );
+		pLayer->setStartVelocity( fStart );
+		pLayer->setEndVelocity( fEnd );
+		pInstrument->addLayer(
+			pComponent, pLayer, -1, Event::Trigger::Suppress );
+		layers.push_back( pLayer );
+	}
+
+	Random random( 0 );
+	pComponent->setSelection( InstrumentComponent::Selection::Velocity );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.1, random ) == layers[ 0 ] );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.35, random ) == layers[ 0 ] );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.45, random ) == layers[ 1 ] );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 1.0, random ) == layers[ 2 ] );
+
+	// Velocities within the hole resolve to the nearest layer.
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.55, random ) == layers[ 1 ] );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.65, random ) == layers[ 2 ] );
+
+	pComponent->setSelection( InstrumentComponent::Selection::RoundRobin );
+	const auto pFirst = pComponent->selectLayer( 0.35, random );
+	const auto pSecond = pComponent->selectLayer( 0.35, random );
+	CPPUNIT_ASSERT( pFirst != pSecond );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.35, random ) == pFirst );
+
+	pComponent->setSelection( InstrumentComponent::Selection::Random );
+	for ( int ii = 0; ii < 50; ++ii ) {
+		const auto pLayer = pComponent->selectLayer( 0.35, random );
+		CPPUNIT_ASSERT( pLayer == layers[ 0 ] || pLayer == layers[ 1 ] );
+	}
+
+	// Changes to the layers are picked up by the lookup table.
+	layers[ 0 ]->setIsMuted( true );
+	pComponent->setSelection( InstrumentComponent::Selection::Velocity );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.35, random ) == layers[ 1 ] );
+	layers[ 2 ]->setStartVelocity( 0.2 );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.25, random ) == layers[ 2 ] );
+
+	// Copies keep track of their own layers only.
+	auto pCopy = std::make_shared<InstrumentComponent>( pComponent );
+	CPPUNIT_ASSERT( pCopy->selectLayer( 0.25, random ) ==
+					pCopy->getLayer( 2 ) );
+	layers[ 2 ]->setIsMuted( true );
+	CPPUNIT_ASSERT( pComponent->selectLayer( 0.25, random ) == layers[ 1 ] );
+	CPPUNIT_ASSERT( pCopy->selectLayer( 0.25, random ) ==
+					pCopy->getLayer( 2 ) );
+	pCopy->getLayer( 2 )->setStartVelocity( 0.3 );
+	CPPUNIT_ASSERT( pCopy->selectLayer( 0.25, random ) ==
+					pCopy->getLayer( 1 ) );
+
+	___INFOLOG( "passed" );
+}
+
 void NoteTest::testMappingLegacyDrumkit() {
 	___INFOLOG( "" );
 
@@ -393,6 +464,122 @@ void NoteTest::testMidiDefaultOffset()
 	___INFOLOG( "passed" );
 }
 
+void NoteTest::testNotePool() {
+	___INFOLOG( "" );
+
+	auto pSnare = std::make_shared<Instrument>(
+		static_cast<Instrument::Id>( 1 ), "Snare", nullptr
+	);
+	auto pKick = std::make_shared<Instrument>(
+		static_cast<Instrument::Id>( 2 ), "Kick", nullptr
+	);
+
+	const int nCapacity = 4;
+	NotePool pool( nCapacity );
+	CPPUNIT_ASSERT( pool.getCapacity() == nCapacity );
+	CPPUNIT_ASSERT( pool.getUsed() == 0 );
+
+	// Recycled notes must be indistinguishable from fresh ones.
+	auto pPatternNote = std::make_shared<Note>( pSnare, 12, 0.5f, 0.3f, 7 );
+	pPatternNote->setProbability( 0.75f );
+	pPatternNote->setLeadLag( -0.2f );
+	pPatternNote->setKey( Note::Key::E );
+	pPatternNote->setOctave( Note::Octave::P8A );
+
+	std::vector< std::shared_ptr<Note> > notes;
+	for ( int ii = 0; ii < nCapacity; ++ii ) {
+		notes.push_back( pool.acquire( pPatternNote ) );
+	}
+	CPPUNIT_ASSERT( pool.getUsed() == nCapacity );
+	CPPUNIT_ASSERT( pool.getDropped() == 0 );
+
+	const auto pReference = std::make_shared<Note>( pPatternNote );
+	for ( const auto& ppNote : notes ) {
+		CPPUNIT_ASSERT( ppNote != pPatternNote );
+		CPPUNIT_ASSERT( ppNote->getInstrument() == pReference->getInstrument() );
+		CPPUNIT_ASSERT( ppNote->getInstrumentId() ==
+						pReference->getInstrumentId() );
+		CPPUNIT_ASSERT( ppNote->getPosition() == pReference->getPosition() );
+		CPPUNIT_ASSERT( ppNote->getVelocity() == pReference->getVelocity() );
+		CPPUNIT_ASSERT( ppNote->getPan() == pReference->getPan() );
+		CPPUNIT_ASSERT( ppNote->getLength() == pReference->getLength() );
+		CPPUNIT_ASSERT( ppNote->getProbability() ==
+						pReference->getProbability() );
+		CPPUNIT_ASSERT( ppNote->getLeadLag() == pReference->getLeadLag() );
+		CPPUNIT_ASSERT( ppNote->getKey() == pReference->getKey() );
+		CPPUNIT_ASSERT( ppNote->getOctave() == pReference->getOctave() );
+		CPPUNIT_ASSERT( ppNote->getAdsr() != nullptr );
+		CPPUNIT_ASSERT( ppNote->getAdsr() != pSnare->getAdsr() );
+	}
+
+	// Exhausted pool. The note is dropped instead of allocated.
+	auto pExtraNote = pool.acquire( pKick, 3 );
+	CPPUNIT_ASSERT( pExtraNote == nullptr );
+	CPPUNIT_ASSERT( pool.getDropped() == 1 );
+	CPPUNIT_ASSERT( pool.getCapacity() == nCapacity );
+
+	// Notes are recycled once they are not referenced anymore.
+	std::vector<Note*> rawNotes;
+	for ( const auto& ppNote : notes ) {
+		rawNotes.push_back( ppNote.get() );
+	}
+	notes.clear();
+	CPPUNIT_ASSERT( pool.getUsed() == 0 );
+
+	for ( int ii = 0; ii < nCapacity; ++ii ) {
+		auto pNote = pool.acquire( pKick, ii, 0.9f );
+		CPPUNIT_ASSERT( pNote->getInstrument() == pKick );
+		CPPUNIT_ASSERT( pNote->getPosition() == ii );
+		CPPUNIT_ASSERT( pNote->getVelocity() == 0.9f );
+		CPPUNIT_ASSERT( pNote->getKey() == Note::KeyDefault );
+		CPPUNIT_ASSERT( pNote->getOctave() == Note::OctaveDefault );
+		CPPUNIT_ASSERT( pNote->getProbability() == PROBABILITY_DEFAULT );
+		notes.push_back( pNote );
+	}
+	CPPUNIT_ASSERT( pool.getDropped() == 1 );
+	CPPUNIT_ASSERT(
+		std::find( rawNotes.begin(), rawNotes.end(), notes[ 0 ].get() ) !=
+		rawNotes.end() );
+
+	// Free notes beyond the capacity are dropped. Used ones are kept.
+	pool.setCapacity( 2, 1 );
+	CPPUNIT_ASSERT( pool.getCapacity() == nCapacity );
+	notes.clear();
+	pool.setCapacity( 2, 1 );
+	CPPUNIT_ASSERT( pool.getCapacity() == 2 );
+	CPPUNIT_ASSERT( pool.getUsed() == 0 );
+
+	// Layer infos are preallocated per component. Additional components are
+	// not rendered rather than allocating memory.
+	CPPUNIT_ASSERT( NotePool::countComponents( nullptr ) == 1 );
+	CPPUNIT_ASSERT( pSnare->getComponents()->size() == 1 );
+	auto pComponent = std::make_shared<InstrumentComponent>( "second" );
+	pSnare->addComponent( pComponent );
+	Random random( 1 );
+
+	auto pNote = pool.acquire( pSnare );
+	CPPUNIT_ASSERT( pNote != nullptr );
+	pNote->selectLayers( random );
+	CPPUNIT_ASSERT( pNote->getAllSelectedLayerInfos().size() == 1 );
+	CPPUNIT_ASSERT( pNote->getSelecterLayerInfo( pComponent ) == nullptr );
+	pNote = nullptr;
+
+	pool.setCapacity( 2, 2 );
+	CPPUNIT_ASSERT( pool.getComponents() == 2 );
+	pNote = pool.acquire( pSnare );
+	CPPUNIT_ASSERT( pNote != nullptr );
+	pNote->selectLayers( random );
+	CPPUNIT_ASSERT( pNote->getAllSelectedLayerInfos().size() == 2 );
+	CPPUNIT_ASSERT( pNote->getSelecterLayerInfo( pComponent ) != nullptr );
+
+	// Recycled layer infos do not keep the components alive.
+	pNote = nullptr;
+	pool.setCapacity( 2, 2 );
+	CPPUNIT_ASSERT( pComponent.use_count() == 2 );
+
+	___INFOLOG( "passed" );
+}
+
 void NoteTest::testPitchConversions()
 {
 	___INFOLOG( "" );
@@ -483,6 +670,70 @@ void NoteTest::testProbability() {
 	___INFOLOG( "passed" );
 }
 
+void NoteTest::testRandom() {
+	___INFOLOG( "" );
+
+	// Identical seeds yield identical sequences.
+	Random random( 42 );
+	Random other( 42 );
+	for ( int ii = 0; ii < 100; ++ii ) {
+		CPPUNIT_ASSERT_EQUAL( random.next(), other.next() );
+	}
+	other.seed( 43 );
+	CPPUNIT_ASSERT( random.next() != other.next() );
+
+	const int nValues = 100000;
+	double fSum = 0;
+	int nHistogram[ 4 ] = { 0, 0, 0, 0 };
+	for ( int ii = 0; ii < nValues; ++ii ) {
+		const float fValue = random.getUniform();
+		CPPUNIT_ASSERT( fValue >= 0 && fValue < 1 );
+		fSum += fValue;
+
+		const int nValue = random.getInt( 4 );
+		CPPUNIT_ASSERT( nValue >= 0 && nValue < 4 );
+		++nHistogram[ nValue ];
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, fSum / nValues, 0.01 );
+	for ( const auto nnCount : nHistogram ) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.25, nnCount / (double) nValues, 0.01 );
+	}
+
+	// Both the scalar and the batched Gaussian variates have the requested
+	// standard deviation.
+	const float fSD = 0.3;
+	std::vector<float> values( nValues );
+	random.fillGaussian( values.data(), nValues - 1, fSD );
+	values[ nValues - 1 ] = random.getGaussian( fSD );
+	double fMean = 0, fVariance = 0;
+	for ( const auto ffValue : values ) {
+		fMean += ffValue;
+		fVariance += ffValue * ffValue;
+	}
+	fMean /= nValues;
+	fVariance = fVariance / nValues - fMean * fMean;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, fMean, 0.01 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( fSD, std::sqrt( fVariance ), 0.01 );
+
+	// Humanization is reproducible.
+	auto pInstrument = std::make_shared<Instrument>();
+	pInstrument->setRandomPitchFactor( 1.0 );
+	auto pNote = std::make_shared<Note>( pInstrument, 0, 1.0f, 0.f, 1 );
+	auto pOther = std::make_shared<Note>( pNote );
+	random.seed( 7 );
+	pNote->humanize( random );
+	random.seed( 7 );
+	pOther->humanize( random );
+	CPPUNIT_ASSERT( pNote->getPitchHumanization() != 0 );
+	CPPUNIT_ASSERT_EQUAL( pNote->getPitchHumanization(),
+						  pOther->getPitchHumanization() );
+	CPPUNIT_ASSERT_EQUAL( pNote->getVelocity(), pOther->getVelocity() );
+	CPPUNIT_ASSERT_EQUAL( pNote->getHumanizeDelay(),
+						  pOther->getHumanizeDelay() );
+
+	___INFOLOG( "passed" );
+}
+
 void NoteTest::testSerializeProbability() {
 	___INFOLOG( "" );
 	QDomDocument doc;
@@ -28,11 +28,14 @@
 class NoteTest : public CppUnit::TestCase {
 		CPPUNIT_TEST_SUITE( NoteTest );
 		CPPUNIT_TEST( testComparison );
+		CPPUNIT_TEST( testLayerSelection );
 		CPPUNIT_TEST( testMappingLegacyDrumkit );
 		CPPUNIT_TEST( testMappingValidDrumkits );
 		CPPUNIT_TEST( testMidiDefaultOffset );
+		CPPUNIT_TEST( testNotePool );
 		CPPUNIT_TEST( testPitchConversions );
 		CPPUNIT_TEST( testProbability );
+		CPPUNIT_TEST( testRandom );
 		CPPUNIT_TEST( testSerializeProbability );
 		CPPUNIT_TEST( testStrongTypedPitch );
 		CPPUNIT_TEST( testVirtualKeyboard );
@@ -40,14 +43,21 @@ class NoteTest : public CppUnit::TestCase {
 
 	public:
 		void testComparison();
+		/** Layers are selected according to the velocity and selection mode
+		 * of their component. */
+		void testLayerSelection();
 		/** Notes will be mapped back and forth between a valid/new drumkit and
 		 * one created prior to version 2.0. */
 		void testMappingLegacyDrumkit();
 		/** Notes will be mapped back and forth between two valid drumkits. */
 		void testMappingValidDrumkits();
 		void testMidiDefaultOffset();
+		void testNotePool();
 		void testPitchConversions();
 		void testProbability();
+		/** Random contributions depend on the seed of the generator only and
+		 * follow the requested distributions. */
+		void testRandom();
 		void testSerializeProbability();
         void testStrongTypedPitch();
 		/** Check whether notes entered via the virtual keyboard can be handled
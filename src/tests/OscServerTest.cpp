@@ -25,10 +25,24 @@
 #ifdef H2CORE_HAVE_OSC
 
 #include "OscServerTest.h"
+#include "TestHelper.h"
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
 #include <core/OscServer.h>
+#include <core/Preferences/Preferences.h>
 
 #include <QTest>
 
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
 using namespace H2Core;
 
 
@@ -120,4 +134,177 @@ void OscServerTest::testSessionManagement(){
 	___INFOLOG( "passed" );
 }
 
+void OscServerTest::testStripDispatch() {
+	___INFOLOG( "" );
+
+	auto pSong = CoreActionController::loadSong(
+		H2TEST_FILE( "functional/test.h2song" ) );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	CoreActionController::setSong( pSong );
+
+	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+	CPPUNIT_ASSERT( pInstrumentList->size() >= 2 );
+	auto pFirst = pInstrumentList->get( 0 );
+	auto pSecond = pInstrumentList->get( 1 );
+	const bool bSecondMuted = pSecond->isMuted();
+
+	lo_arg arg;
+	arg.f = 0.3;
+	lo_arg* argv[] = { &arg };
+
+	// Strip numbers in OSC paths start at 1.
+	OscServer::generic_handler( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/1", "f",
+								argv, 1, nullptr, nullptr );
+	CPPUNIT_ASSERT( pFirst->getVolume() == 0.3f );
+
+	// The argument of toggle messages is optional.
+	OscServer::generic_handler( "/Hydrogen/STRIP_MUTE_TOGGLE/2", "",
+								nullptr, 0, nullptr, nullptr );
+	CPPUNIT_ASSERT( pSecond->isMuted() != bSecondMuted );
+	OscServer::generic_handler( "/Hydrogen/STRIP_MUTE_TOGGLE/2", "f",
+								argv, 1, nullptr, nullptr );
+	CPPUNIT_ASSERT( pSecond->isMuted() == bSecondMuted );
+
+	// None of the following messages must reach an instrument.
+	arg.f = 0.7;
+	const auto sOutOfBound = QString( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/%1" )
+		.arg( pInstrumentList->size() + 1 ).toLatin1();
+	const std::vector<const char*> invalidPaths = {
+		"/Hydrogen/STRIP_VOLUME_ABSOLUTE/0",
+		sOutOfBound.constData(),
+		"/Hydrogen/STRIP_VOLUME_ABSOLUTE/99999999999",
+		"/Hydrogen/STRIP_VOLUME_ABSOLUTE/-1",
+		"/Hydrogen/STRIP_VOLUME_ABSOLUTE/1a",
+		"/Hydrogen/STRIP_VOLUME_ABSOLUTE/",
+		"/Hydrogen/STRIP_VOLUME_ABSOLUTE/1/1",
+		"/Hydrogen/STRIP_VOLUME/1",
+		"/Hydrogen/1",
+		"/Other/STRIP_VOLUME_ABSOLUTE/1" };
+	for ( const auto& ssPath : invalidPaths ) {
+		OscServer::generic_handler( ssPath, "f", argv, 1, nullptr, nullptr );
+		CPPUNIT_ASSERT_MESSAGE( ssPath, pFirst->getVolume() == 0.3f );
+	}
+
+	// Only toggle messages may omit their argument.
+	OscServer::generic_handler( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/1", "",
+								nullptr, 0, nullptr, nullptr );
+	CPPUNIT_ASSERT( pFirst->getVolume() == 0.3f );
+
+	// Discard all changes to the test song.
+	CoreActionController::setSong( CoreActionController::loadSong(
+		H2TEST_FILE( "functional/test.h2song" ) ) );
+	___INFOLOG( "passed" );
+}
+
+namespace {
+/** Records the feedback received by the dummy client of
+ * OscServerTest::testFeedbackBundling(). */
+struct FeedbackRecord {
+	std::mutex mutex;
+	int nBundles = 0;
+	int nMessages = 0;
+	/** Whether a path was contained more than once in a bundle. */
+	bool bDuplicates = false;
+	std::set<std::string> currentBundle;
+	std::map<std::string, float> latestValues;
+};
+
+int feedbackBundleStart( lo_timetag, void* pData ) {
+	auto pRecord = static_cast<FeedbackRecord*>( pData );
+	std::lock_guard<std::mutex> lock( pRecord->mutex );
+	++pRecord->nBundles;
+	pRecord->currentBundle.clear();
+	return 0;
+}
+
+int feedbackBundleEnd( void* ) {
+	return 0;
+}
+
+int feedbackMessage( const char* path, const char* types, lo_arg** argv,
+					 int argc, lo_message, void* pData ) {
+	auto pRecord = static_cast<FeedbackRecord*>( pData );
+	std::lock_guard<std::mutex> lock( pRecord->mutex );
+	++pRecord->nMessages;
+	if ( ! pRecord->currentBundle.insert( path ).second ) {
+		pRecord->bDuplicates = true;
+	}
+	if ( argc == 1 && types[ 0 ] == 'f' ) {
+		pRecord->latestValues[ path ] = argv[ 0 ]->f;
+	}
+	return 0;
+}
+}
+
+void OscServerTest::testFeedbackBundling() {
+	___INFOLOG( "" );
+
+	FeedbackRecord record;
+	lo_server_thread client = lo_server_thread_new( "7365", nullptr );
+	CPPUNIT_ASSERT( client != nullptr );
+	lo_server_thread_add_method( client, nullptr, nullptr,
+								 feedbackMessage, &record );
+	lo_server_add_bundle_handlers( lo_server_thread_get_server( client ),
+								   feedbackBundleStart, feedbackBundleEnd,
+								   &record );
+	lo_server_thread_start( client );
+
+	auto pPref = Preferences::get_instance();
+	const bool bOldServerEnabled = pPref->getOscServerEnabled();
+	const bool bOldFeedbackEnabled = pPref->getOscFeedbackEnabled();
+	const int nOldPort = pPref->getOscServerPort();
+
+	// Start a fresh OSC server - including its feedback thread - on a port
+	// not occupied by the dummy server of setUp().
+	pPref->setOscServerEnabled( true );
+	pPref->setOscFeedbackEnabled( true );
+	pPref->setOscServerPort( 7364 );
+	m_pHydrogen->recreateOscServer();
+	auto pOscServer = OscServer::get_instance();
+
+	lo_address clientAddress = lo_address_new( "localhost", "7365" );
+	const bool bRegistered = pOscServer->registerClient( clientAddress );
+	const bool bRegisteredTwice = pOscServer->registerClient( clientAddress );
+	lo_address_free( clientAddress );
+
+	// Emulates a fader being moved while another strip is changed once.
+	const int nUpdates = 200;
+	for ( int ii = 1; ii <= nUpdates; ++ii ) {
+		pOscServer->sendFeedbackMessage( MidiAction::Type::StripVolumeAbsolute,
+										 static_cast<float>( ii ) / nUpdates, 0 );
+	}
+	pOscServer->sendFeedbackMessage( MidiAction::Type::StripVolumeAbsolute,
+									 0.5, 1 );
+
+	const std::string sPath( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/0" );
+	const std::string sOtherPath( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/1" );
+	auto received = [&]() {
+		std::lock_guard<std::mutex> lock( record.mutex );
+		return record.latestValues.count( sPath ) > 0 &&
+			record.latestValues[ sPath ] == 1.0f &&
+			record.latestValues.count( sOtherPath ) > 0;
+	};
+	WAIT( received() );
+
+	// Stop the feedback thread before checking so no bundle is sent while
+	// asserting.
+	pOscServer->stop();
+	lo_server_thread_free( client );
+
+	pPref->setOscServerEnabled( bOldServerEnabled );
+	pPref->setOscFeedbackEnabled( bOldFeedbackEnabled );
+	pPref->setOscServerPort( nOldPort );
+	m_pHydrogen->recreateOscServer();
+
+	CPPUNIT_ASSERT( bRegistered );
+	CPPUNIT_ASSERT( ! bRegisteredTwice );
+	CPPUNIT_ASSERT( received() );
+	CPPUNIT_ASSERT( record.latestValues[ sOtherPath ] == 0.5f );
+	CPPUNIT_ASSERT( ! record.bDuplicates );
+	CPPUNIT_ASSERT( record.nBundles >= 1 );
+	CPPUNIT_ASSERT( record.nBundles < nUpdates / 10 );
+	CPPUNIT_ASSERT( record.nMessages < nUpdates / 10 );
+	___INFOLOG( "passed" );
+}
+
 #endif
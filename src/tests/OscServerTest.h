@@ -33,6 +33,8 @@
 class OscServerTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE( OscServerTest );
 	CPPUNIT_TEST( testSessionManagement );
+	CPPUNIT_TEST( testStripDispatch );
+	CPPUNIT_TEST( testFeedbackBundling );
 	CPPUNIT_TEST_SUITE_END();
 	
 private:
@@ -73,6 +75,21 @@ public:
 	 * current song does match the expected result.
 	 */
 	void testSessionManagement();
+
+	/**
+	 * Calls OscServer::generic_handler() directly with valid and
+	 * malformed paths of the form \e /Hydrogen/<NAME>/<strip number>
+	 * and checks that only the former alter the addressed instrument.
+	 */
+	void testStripDispatch();
+
+	/**
+	 * Starts a fresh OscServer with feedback enabled, registers a
+	 * dummy client, and checks that a burst of updates of the same
+	 * strip arrives in a few bundles only, each carrying a path at
+	 * most once, and ends with the latest value.
+	 */
+	void testFeedbackBundling();
 };
 
 #endif
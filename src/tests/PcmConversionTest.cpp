@@ -0,0 +1,128 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "PcmConversionTest.h"
+
+#include <core/IO/PcmConversion.h>
+#include <core/Object.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace H2Core;
+
+void PcmConversionTest::testInterleave() {
+	___INFOLOG( "" );
+
+	// Includes values out of range on both sides.
+	const std::vector<float> in_L = { 0.0, 0.5, -0.5, 1.5, -1.5, 1.0, -1.0,
+									  0.25, 1e-6, -0.999 };
+	const std::vector<float> in_R = { 0.25, -0.25, 0.999, -1.0, 2.0, 0.1,
+									  0.0, -3.0, 0.75, 0.5 };
+	const int nFrames = in_L.size();
+
+	auto expected = []( float fValue, double fScale, double fMax ) {
+		return static_cast<long>( std::lrint( std::min(
+			std::max( static_cast<double>( fValue ) * fScale, -fScale ), fMax ) ) );
+	};
+
+	std::vector<int16_t> s16( 2 * nFrames );
+	PcmConversion::interleave( PcmConversion::Format::S16, in_L.data(),
+							   in_R.data(), nullptr, nullptr, s16.data(),
+							   nFrames );
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		CPPUNIT_ASSERT_EQUAL( expected( in_L[ ii ], 32768, 32767 ),
+							  static_cast<long>( s16[ 2 * ii ] ) );
+		CPPUNIT_ASSERT_EQUAL( expected( in_R[ ii ], 32768, 32767 ),
+							  static_cast<long>( s16[ 2 * ii + 1 ] ) );
+	}
+
+	std::vector<uint8_t> s24( 6 * nFrames );
+	PcmConversion::interleave( PcmConversion::Format::S24_3LE, in_L.data(),
+							   in_R.data(), nullptr, nullptr, s24.data(),
+							   nFrames );
+	auto readS24 = [&]( int nSample ) {
+		const uint8_t* p = &s24[ 3 * nSample ];
+		return static_cast<long>( static_cast<int32_t>(
+			( p[ 0 ] << 8 ) | ( p[ 1 ] << 16 ) | ( p[ 2 ] << 24 ) ) >> 8 );
+	};
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		CPPUNIT_ASSERT_EQUAL( expected( in_L[ ii ], 8388608, 8388607 ),
+							  readS24( 2 * ii ) );
+		CPPUNIT_ASSERT_EQUAL( expected( in_R[ ii ], 8388608, 8388607 ),
+							  readS24( 2 * ii + 1 ) );
+	}
+
+	std::vector<int32_t> s32( 2 * nFrames );
+	PcmConversion::interleave( PcmConversion::Format::S32, in_L.data(),
+							   in_R.data(), nullptr, nullptr, s32.data(),
+							   nFrames );
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		// Single precision can not represent all 32 bit values.
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(
+			static_cast<double>( expected( in_L[ ii ], 2147483648.0, 2147483520.0 ) ),
+			static_cast<double>( s32[ 2 * ii ] ), 256 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(
+			static_cast<double>( expected( in_R[ ii ], 2147483648.0, 2147483520.0 ) ),
+			static_cast<double>( s32[ 2 * ii + 1 ] ), 256 );
+	}
+
+	std::vector<float> f32( 2 * nFrames );
+	PcmConversion::interleave( PcmConversion::Format::Float, in_L.data(),
+							   in_R.data(), nullptr, nullptr, f32.data(),
+							   nFrames );
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		CPPUNIT_ASSERT_EQUAL( std::min( std::max( in_L[ ii ], -1.0f ), 1.0f ),
+							  f32[ 2 * ii ] );
+		CPPUNIT_ASSERT_EQUAL( std::min( std::max( in_R[ ii ], -1.0f ), 1.0f ),
+							  f32[ 2 * ii + 1 ] );
+	}
+
+	___INFOLOG( "passed" );
+}
+
+void PcmConversionTest::testTpdfNoise() {
+	___INFOLOG( "" );
+
+	const int nSamples = 100000;
+	std::vector<float> noise( nSamples );
+	uint32_t nState = 1;
+	PcmConversion::generateTpdfNoise( noise.data(), nSamples, nState );
+
+	double fSum = 0;
+	for ( const auto& ffNoise : noise ) {
+		CPPUNIT_ASSERT( ffNoise > -1.0 && ffNoise < 1.0 );
+		fSum += ffNoise;
+	}
+	CPPUNIT_ASSERT( std::abs( fSum / nSamples ) < 0.01 );
+
+	// Dither of a silent signal toggles the least significant bit only.
+	const std::vector<float> silence( nSamples, 0.0 );
+	std::vector<int16_t> s16( 2 * nSamples );
+	PcmConversion::interleave( PcmConversion::Format::S16, silence.data(),
+							   silence.data(), noise.data(), noise.data(),
+							   s16.data(), nSamples );
+	for ( const auto& nnValue : s16 ) {
+		CPPUNIT_ASSERT( nnValue >= -1 && nnValue <= 1 );
+	}
+
+	___INFOLOG( "passed" );
+}
@@ -31,11 +31,16 @@
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/Sample.h>
 #include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Hydrogen.h>
+#include <core/Preferences/Preferences.h>
+#include <core/Sampler/RubberbandCache.h>
 #include <core/SoundLibrary/SoundLibraryDatabase.h>
 #include <cppunit/TestAssert.h>
 
+#include <cmath>
+
 using namespace H2Core;
 
 void SampleTest::testLoadInvalidSample()
@@ -167,3 +172,136 @@ void SampleTest::testStoringSamplesInCurrentDrumkit()
 
 	___INFOLOG( "passed" );
 }
+
+void SampleTest::testRubberbandCache()
+{
+	___INFOLOG( "" );
+#ifdef H2CORE_HAVE_RUBBERBAND
+	// Requests are only issued by the audio engine. The workers will stay
+	// idle.
+	RubberbandCache cache( 1 );
+
+	auto pSample = Sample::load( H2TEST_FILE( "drumkits/baseKit/kick.wav" ) );
+	CPPUNIT_ASSERT( pSample != nullptr );
+
+	// Samples not using Rubber Band are passed through.
+	CPPUNIT_ASSERT( cache.getStretchedSample( pSample, 120 ) == pSample );
+	CPPUNIT_ASSERT( cache.getSize() == 0 );
+
+	auto rubberband = pSample->getRubberband();
+	rubberband.bUse = true;
+	rubberband.fLengthInBeats = 1;
+	pSample->setRubberband( rubberband );
+
+	auto pStretched120 = cache.getStretchedSample( pSample, 120.02 );
+	CPPUNIT_ASSERT( pStretched120 != nullptr );
+	CPPUNIT_ASSERT( pStretched120 != pSample );
+	CPPUNIT_ASSERT( cache.getSize() == 1 );
+
+	// One beat at 120 bpm.
+	const double fExpectedFrames = pSample->getSampleRate() * 0.5;
+	CPPUNIT_ASSERT( std::abs( pStretched120->getFrames() - fExpectedFrames ) <
+					0.05 * fExpectedFrames );
+
+	// Same bucket
+	CPPUNIT_ASSERT( cache.getStretchedSample( pSample, 119.98 ) ==
+					pStretched120 );
+	// Stretched versions are resolved to the same source.
+	CPPUNIT_ASSERT( cache.getStretchedSample( pStretched120, 120 ) ==
+					pStretched120 );
+	CPPUNIT_ASSERT( cache.getSize() == 1 );
+
+	auto pStretched60 = cache.getStretchedSample( pStretched120, 60 );
+	CPPUNIT_ASSERT( pStretched60 != nullptr );
+	CPPUNIT_ASSERT( pStretched60 != pStretched120 );
+	CPPUNIT_ASSERT( std::abs( pStretched60->getFrames() -
+							  2 * fExpectedFrames ) < 0.1 * fExpectedFrames );
+	CPPUNIT_ASSERT( cache.getSize() == 2 );
+
+	// Different Rubber Band settings result in different versions.
+	auto pOtherSample = std::make_shared<Sample>( pSample );
+	rubberband.fLengthInBeats = 2;
+	pOtherSample->setRubberband( rubberband );
+	auto pOtherStretched = cache.getStretchedSample( pOtherSample, 120 );
+	CPPUNIT_ASSERT( pOtherStretched != nullptr );
+	CPPUNIT_ASSERT( pOtherStretched != pStretched120 );
+	CPPUNIT_ASSERT( cache.getSize() == 3 );
+
+	// Versions still referenced are kept.
+	pStretched60 = nullptr;
+	cache.clear();
+	CPPUNIT_ASSERT( cache.getSize() == 2 );
+
+	// Only the most recently used versions of a sample are kept. But those
+	// still referenced are never evicted.
+	for ( int ii = 0; ii < RubberbandCache::nMaxVersionsPerSample + 2; ++ii ) {
+		CPPUNIT_ASSERT( cache.getStretchedSample(
+							pSample, 200 + 5 * ii ) != nullptr );
+	}
+	CPPUNIT_ASSERT( cache.getSize() == RubberbandCache::nMaxVersionsPerSample + 1 );
+	CPPUNIT_ASSERT( cache.getStretchedSample( pSample, 120 ) == pStretched120 );
+	CPPUNIT_ASSERT( cache.getStretchedSample( pOtherSample, 120 ) ==
+					pOtherStretched );
+#endif
+	___INFOLOG( "passed" );
+}
+
+void SampleTest::testRubberbandCacheTempoChange()
+{
+	___INFOLOG( "" );
+#ifdef H2CORE_HAVE_RUBBERBAND
+	auto pPref = Preferences::get_instance();
+	const auto nOldBatchMode = pPref->getRubberBandBatchMode();
+
+	auto pSong = Song::load( H2TEST_FILE( "song/AE_noteOff.h2song" ) );
+	CPPUNIT_ASSERT( pSong != nullptr && pSong->getDrumkit() != nullptr );
+	CPPUNIT_ASSERT( CoreActionController::setSong( pSong ) );
+
+	auto pLayer = pSong->getDrumkit()->getInstruments()->get( 0 )
+		->getComponent( 0 )->getLayer( 0 );
+	CPPUNIT_ASSERT( pLayer != nullptr && pLayer->getSample() != nullptr );
+	auto pSample = pLayer->getSample();
+	auto rubberband = pSample->getRubberband();
+	rubberband.bUse = true;
+	rubberband.fLengthInBeats = 1;
+	pSample->setRubberband( rubberband );
+
+	// Requests of the audio engine's own cache are only scheduled once batch
+	// mode is enabled. It will stay idle.
+	pPref->setRubberBandBatchMode( true );
+
+	RubberbandCache cache( 1 );
+
+	// Swaps in the sample handed over by the workers - just as the Sampler
+	// does at note onset.
+	auto waitForSample = [&]() {
+		cache.waitUntilIdle();
+		pLayer->commitPendingSample();
+		return pLayer->getSample();
+	};
+
+	const double fBeatFrames = pSample->getSampleRate() * 0.5;
+
+	cache.requestBpm( 120 );
+	auto pStretched120 = waitForSample();
+	CPPUNIT_ASSERT( pStretched120 != pSample );
+	CPPUNIT_ASSERT( std::abs( pStretched120->getFrames() - fBeatFrames ) <
+					0.05 * fBeatFrames );
+
+	// The request for 90 bpm is superseded before the workers are done. Its
+	// result must not be handed to the layer.
+	cache.requestBpm( 90 );
+	cache.requestBpm( 60 );
+	auto pStretched60 = waitForSample();
+	CPPUNIT_ASSERT( pStretched60 != pStretched120 );
+	CPPUNIT_ASSERT( std::abs( pStretched60->getFrames() - 2 * fBeatFrames ) <
+					0.1 * fBeatFrames );
+
+	// Nothing is pending anymore.
+	pLayer->commitPendingSample();
+	CPPUNIT_ASSERT( pLayer->getSample() == pStretched60 );
+
+	pPref->setRubberBandBatchMode( nOldBatchMode );
+#endif
+	___INFOLOG( "passed" );
+}
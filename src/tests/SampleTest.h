@@ -29,6 +29,8 @@ class SampleTest : public CppUnit::TestCase {
 	CPPUNIT_TEST_SUITE( SampleTest );
 	CPPUNIT_TEST( testLoadInvalidSample );
 	CPPUNIT_TEST( testStoringSamplesInCurrentDrumkit );
+	CPPUNIT_TEST( testRubberbandCache );
+	CPPUNIT_TEST( testRubberbandCacheTempoChange );
 	CPPUNIT_TEST_SUITE_END();
 
 	void testLoadInvalidSample();
@@ -40,6 +42,13 @@ class SampleTest : public CppUnit::TestCase {
 	 * corresponding drumkit folder. Priorly they can very well be scattered all
 	 * over the place. */
 	void testStoringSamplesInCurrentDrumkit();
+	/** Stretched samples are reused for tempi within the same bucket and
+	 * match the length requested by their Rubber Band settings. Least
+	 * recently used versions are evicted. */
+	void testRubberbandCache();
+	/** Layers of the current drumkit are handed the version stretched to the
+	 * latest requested tempo. Requests for previous tempi are discarded. */
+	void testRubberbandCacheTempoChange();
 };
 
 #endif
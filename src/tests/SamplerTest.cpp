@@ -0,0 +1,111 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "SamplerTest.h"
+#include "TestHelper.h"
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Song.h>
+#include <core/Sampler/Sampler.h>
+
+#include <memory>
+
+using namespace H2Core;
+
+void SamplerTest::testUpdateAudibility() {
+	___INFOLOG( "" );
+
+	// Two instruments with the first one holding two components. We use a
+	// dedicated Sampler to not interfere with the audio thread.
+	auto pDrumkit = std::make_shared<Drumkit>();
+	auto pFirst = std::make_shared<Instrument>();
+	pFirst->addComponent( std::make_shared<InstrumentComponent>( "second" ) );
+	auto pSecond = std::make_shared<Instrument>();
+	pDrumkit->getInstruments()->add( pFirst );
+	pDrumkit->getInstruments()->add( pSecond );
+
+	auto pSong = std::make_shared<Song>();
+	pSong->setDrumkit( pDrumkit );
+
+	Sampler sampler;
+
+	auto checkAudibility = [&]( bool bFirst, bool bSecond,
+								bool bFirstComponent, bool bSecondComponent ) {
+		sampler.updateAudibility( pSong );
+		CPPUNIT_ASSERT( pFirst->isAudible() == bFirst );
+		CPPUNIT_ASSERT( pSecond->isAudible() == bSecond );
+		CPPUNIT_ASSERT( pFirst->getComponent( 0 )->getIsAudible() ==
+						bFirstComponent );
+		CPPUNIT_ASSERT( pFirst->getComponent( 1 )->getIsAudible() ==
+						bSecondComponent );
+		// Components of other instruments are not affected.
+		CPPUNIT_ASSERT( pSecond->getComponent( 0 )->getIsAudible() );
+	};
+
+	checkAudibility( true, true, true, true );
+
+	// Mute
+	pFirst->setMuted( true );
+	checkAudibility( false, true, true, true );
+	pFirst->setMuted( false );
+	checkAudibility( true, true, true, true );
+
+	// Solo
+	pSecond->setSoloed( true );
+	checkAudibility( false, true, true, true );
+	pFirst->setSoloed( true );
+	checkAudibility( true, true, true, true );
+	pSecond->setSoloed( false );
+	checkAudibility( true, false, true, true );
+	pFirst->setSoloed( false );
+	checkAudibility( true, true, true, true );
+
+	// Component mute
+	pFirst->getComponent( 0 )->setIsMuted( true );
+	checkAudibility( true, true, false, true );
+	pFirst->getComponent( 0 )->setIsMuted( false );
+	checkAudibility( true, true, true, true );
+
+	// Component solo
+	pFirst->getComponent( 1 )->setIsSoloed( true );
+	checkAudibility( true, true, false, true );
+	pFirst->getComponent( 0 )->setIsSoloed( true );
+	checkAudibility( true, true, true, true );
+	pFirst->getComponent( 1 )->setIsSoloed( false );
+	checkAudibility( true, true, true, false );
+	pFirst->getComponent( 0 )->setIsSoloed( false );
+	checkAudibility( true, true, true, true );
+
+	// Replacing the drumkit has to be picked up as well.
+	auto pOtherDrumkit = std::make_shared<Drumkit>();
+	auto pMuted = std::make_shared<Instrument>();
+	pMuted->setMuted( true );
+	pOtherDrumkit->getInstruments()->add( pMuted );
+	pSong->setDrumkit( pOtherDrumkit );
+	sampler.updateAudibility( pSong );
+	CPPUNIT_ASSERT( ! pMuted->isAudible() );
+
+	___INFOLOG( "passed" );
+}
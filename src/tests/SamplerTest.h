@@ -0,0 +1,38 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef SAMPLER_TEST_H
+#define SAMPLER_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SamplerTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( SamplerTest );
+	CPPUNIT_TEST( testUpdateAudibility );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	/** Checks whether the audibility snapshot of the #H2Core::Sampler picks
+	 * up changes to the mute and solo state of instruments and components. */
+	void testUpdateAudibility();
+};
+#endif
@@ -25,8 +25,14 @@
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentList.h>
+#include <core/Helpers/Filesystem.h>
 #include <core/Hydrogen.h>
 #include <core/SoundLibrary/SoundLibraryDatabase.h>
+#include <core/SoundLibrary/SoundLibraryIndex.h>
+
+#include "TestHelper.h"
+
+#include <QFile>
 
 void SoundLibraryTest::testContextValidity() {
 	___INFOLOG( "" );
@@ -84,3 +90,63 @@ void SoundLibraryTest::testKitRetrievalDirect() {
 
 	___INFOLOG( "passed" );
 }
+
+void SoundLibraryTest::testIndexRoundTrip() {
+	___INFOLOG( "" );
+
+	const auto sKitDir = H2Core::Filesystem::tmp_dir() + "/index-kit";
+	const auto sIndexPath =
+		H2Core::Filesystem::tmp_file_path( "sound_library_index.xml" );
+	if ( H2Core::Filesystem::dir_exists( sKitDir, true ) ) {
+		H2Core::Filesystem::rm( sKitDir, true );
+	}
+	CPPUNIT_ASSERT( H2Core::Filesystem::mkdir( sKitDir ) );
+	CPPUNIT_ASSERT( QFile::copy( H2TEST_FILE( "/drumkits/baseKit/drumkit.xml" ),
+								 H2Core::Filesystem::drumkit_file( sKitDir ) ) );
+
+	// The copy lacks the samples. Metadata is taken from the original.
+	auto pKit = H2Core::Drumkit::load( H2TEST_FILE( "/drumkits/baseKit" ) );
+	CPPUNIT_ASSERT( pKit != nullptr );
+
+	{
+		H2Core::SoundLibraryIndex index( sIndexPath );
+		index.setDrumkit( sKitDir, pKit );
+		CPPUNIT_ASSERT( index.save() );
+	}
+
+	H2Core::SoundLibraryIndex index( sIndexPath );
+	index.load();
+	auto pStub = index.getDrumkit( sKitDir );
+	CPPUNIT_ASSERT( pStub != nullptr );
+	CPPUNIT_ASSERT( pStub->getName() == pKit->getName() );
+	CPPUNIT_ASSERT( pStub->getAuthor() == pKit->getAuthor() );
+	CPPUNIT_ASSERT( pStub->getLicense() == pKit->getLicense() );
+	CPPUNIT_ASSERT( pStub->getInstruments()->size() ==
+					pKit->getInstruments()->size() );
+	for ( int ii = 0; ii < pKit->getInstruments()->size(); ++ii ) {
+		auto pInstr = pKit->getInstruments()->get( ii );
+		auto pStubInstr = pStub->getInstruments()->get( ii );
+		CPPUNIT_ASSERT( pStubInstr->getId() == pInstr->getId() );
+		CPPUNIT_ASSERT( pStubInstr->getName() == pInstr->getName() );
+		CPPUNIT_ASSERT( pStubInstr->getType() == pInstr->getType() );
+	}
+
+	// Changing the drumkit.xml invalidates the entry.
+	QFile file( H2Core::Filesystem::drumkit_file( sKitDir ) );
+	CPPUNIT_ASSERT( file.open( QIODevice::Append ) );
+	file.write( "\n" );
+	file.close();
+	CPPUNIT_ASSERT( index.getDrumkit( sKitDir ) == nullptr );
+
+	// Entries of kits no longer present are dropped.
+	index.retainDrumkits( {} );
+	CPPUNIT_ASSERT( index.save() );
+	H2Core::SoundLibraryIndex emptyIndex( sIndexPath );
+	emptyIndex.load();
+	CPPUNIT_ASSERT( emptyIndex.getDrumkit( sKitDir ) == nullptr );
+
+	H2Core::Filesystem::rm( sKitDir, true );
+	H2Core::Filesystem::rm( sIndexPath );
+
+	___INFOLOG( "passed" );
+}
@@ -30,6 +30,7 @@ class SoundLibraryTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST( testContextValidity );
 	CPPUNIT_TEST( testKitRetrievalCopy );
 	CPPUNIT_TEST( testKitRetrievalDirect );
+	CPPUNIT_TEST( testIndexRoundTrip );
 	CPPUNIT_TEST_SUITE_END();
 	
 public:
@@ -37,4 +38,7 @@ public:
 		void testContextValidity();
 		void testKitRetrievalCopy();
 		void testKitRetrievalDirect();
+		/** Metadata written to the index must be restored as is and be
+		 * discarded once the drumkit.xml changed. */
+		void testIndexRoundTrip();
 };
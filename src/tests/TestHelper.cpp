@@ -161,11 +161,11 @@ void TestHelper::varyAudioDriverConfig( int nIndex ) {
 
 void TestHelper::exportSong( const QString& sSongFile, const QString& sFileName,
 							 int nSampleRate, int nSampleDepth,
-							 double fCompressionLevel )
+							 double fCompressionLevel, int nBlockCount )
 {
-	___INFOLOG( QString( "sSongFile: %1, sFileName: %2, nSampleRate: %3, nSampleDepth: %4, fCompressionLevel: %5" )
+	___INFOLOG( QString( "sSongFile: %1, sFileName: %2, nSampleRate: %3, nSampleDepth: %4, fCompressionLevel: %5, nBlockCount: %6" )
 				.arg( sSongFile ).arg( sFileName ).arg( nSampleRate )
-				.arg( nSampleDepth ).arg( fCompressionLevel ) );
+				.arg( nSampleDepth ).arg( fCompressionLevel ).arg( nBlockCount ) );
 
 	auto t0 = std::chrono::high_resolution_clock::now();
 
@@ -181,12 +181,14 @@ void TestHelper::exportSong( const QString& sSongFile, const QString& sFileName,
 	}
 
 	pHydrogen->startExportSession( nSampleRate, nSampleDepth, fCompressionLevel );
-	pHydrogen->startExportSong( sFileName );
 
 	auto pDriver = std::dynamic_pointer_cast<H2Core::DiskWriterDriver>(
 		pHydrogen->getAudioDriver()
 	);
 	CPPUNIT_ASSERT( pDriver != nullptr );
+	pDriver->setBlockCount( nBlockCount );
+
+	pHydrogen->startExportSong( sFileName );
 
 	// in 0.1 * `nMaxSleeps` ms
 	const int nMaxSleeps = 3000;
@@ -28,6 +28,7 @@
 
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/Song.h>
+#include <core/IO/DiskWriterDriver.h>
 #include <core/Midi/SMF.h>
 
 class TestHelper {
@@ -70,12 +71,15 @@ class TestHelper {
 	 * @param fCompressionLevel Trades off audio quality against compression
 	 *   rate defined between 0.0 (maximum quality) and 1.0 (maximum
 	 *   compression).
+	 * @param nBlockCount Number of buffers queued between rendering and
+	 *   encoding. 0 does both sequentially.
 	 */
 	static void exportSong( const QString& sSongFile,
 							const QString& sFileName,
 							int nSampleRate = 44100,
 							int nSampleDepth = 16,
-							double fCompressionLevel = 0.0 );
+							double fCompressionLevel = 0.0,
+							int nBlockCount = H2Core::DiskWriterDriver::nDefaultBlockCount );
 	/**
 	 * Export the current song within Hydrogen to audio file @a sFileName;
 	 *
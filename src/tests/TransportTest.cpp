@@ -24,13 +24,20 @@
 
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/AudioEngine/AudioEngineTests.h>
+#include <core/AudioEngine/TempoMap.h>
+#include <core/AudioEngine/Transport.h>
 #include <core/Basics/Drumkit.h>
+#include <core/Basics/GridPoint.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
 #include <core/CoreActionController.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Hydrogen.h>
 #include <core/IO/FakeAudioDriver.h>
 #include <core/Preferences/Preferences.h>
+#include <core/Timeline.h>
 
+#include <cmath>
 #include <iostream>
 
 #include "TestHelper.h"
@@ -74,6 +81,191 @@ void TransportTest::testFrameToTickConversion() {
 	___INFOLOG( "passed" );
 }
 
+void TransportTest::testTempoMap() {
+	___INFOLOG( "" );
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+
+	auto pSongDemo = Song::load( QString( "%1/GM_kit_demo3.h2song" )
+								   .arg( Filesystem::demos_dir() ) );
+	ASSERT_SONG( pSongDemo );
+	H2Core::CoreActionController::setSong( pSongDemo );
+
+	H2Core::CoreActionController::activateTimeline( true );
+	H2Core::CoreActionController::addTempoMarker( 0, 120 );
+	H2Core::CoreActionController::addTempoMarker( 2, 73.5 );
+	H2Core::CoreActionController::addTempoMarker( 3, 240 );
+	H2Core::CoreActionController::addTempoMarker( 7, 96.2 );
+
+	auto pTimeline = pSongDemo->getTimeline();
+	const int nSampleRate = pAudioEngine->getAudioDriver()->getSampleRate();
+	const double fSongSizeInTicks = pAudioEngine->getSongSizeInTicks();
+
+	auto pTempoMap = pAudioEngine->getTempoMap();
+	CPPUNIT_ASSERT( pTempoMap != nullptr );
+	CPPUNIT_ASSERT( ! pTempoMap->isEmpty() );
+	CPPUNIT_ASSERT( pTempoMap->getSampleRate() == nSampleRate );
+
+	// As long as nothing changes, the map is reused.
+	CPPUNIT_ASSERT( pAudioEngine->getTempoMap() == pTempoMap );
+
+	// The segments have to be contiguous and cover the whole song.
+	const auto& segments = pTempoMap->getSegments();
+	CPPUNIT_ASSERT( segments.size() == pTimeline->getAllTempoMarkers().size() );
+	CPPUNIT_ASSERT( segments.front().fStartTick == 0 );
+	CPPUNIT_ASSERT( segments.front().fStartFrame == 0 );
+	CPPUNIT_ASSERT( segments.back().fEndTick == fSongSizeInTicks );
+	for ( int ii = 1; ii < segments.size(); ++ii ) {
+		CPPUNIT_ASSERT( segments[ ii ].fStartTick ==
+						segments[ ii - 1 ].fEndTick );
+		CPPUNIT_ASSERT( segments[ ii ].fStartFrame ==
+						segments[ ii - 1 ].fStartFrame +
+						segments[ ii - 1 ].fLengthInFrames );
+	}
+
+	// Compare the conversion at the beginning of each column with the sum of
+	// all preceding columns.
+	const int nColumns = pSongDemo->getPatternGroupVector()->size();
+	double fExpectedFrame = 0;
+	double fTickMismatch;
+	for ( int nnColumn = 0; nnColumn < nColumns; ++nnColumn ) {
+		const double fTick =
+			static_cast<double>( pHydrogen->getTickForColumn( nnColumn ) );
+		const long long nFrame =
+			Transport::computeFrameFromTick( fTick, &fTickMismatch );
+		CPPUNIT_ASSERT( std::abs( nFrame - fExpectedFrame ) <= 1 );
+		CPPUNIT_ASSERT( std::abs( Transport::computeTickFromFrame( nFrame ) +
+								  fTickMismatch - fTick ) < 1e-6 );
+
+		double fNextTick = fSongSizeInTicks;
+		if ( nnColumn + 1 < nColumns ) {
+			fNextTick = static_cast<double>(
+				pHydrogen->getTickForColumn( nnColumn + 1 ) );
+		}
+		fExpectedFrame += ( fNextTick - fTick ) *
+			AudioEngine::computeDoubleTickSize(
+				nSampleRate, pTimeline->getTempoAtColumn( nnColumn ) );
+	}
+	CPPUNIT_ASSERT( std::abs( pTempoMap->getSongSizeInFrames() -
+							  fExpectedFrame ) < 1e-6 );
+
+	// Positions beyond the end of the song.
+	const long long nLoopedFrame = Transport::computeFrameFromTick(
+		3 * fSongSizeInTicks + 17, &fTickMismatch );
+	CPPUNIT_ASSERT( std::abs( nLoopedFrame -
+							  ( 3 * fExpectedFrame +
+								17 * segments.front().fTickSize ) ) <= 1 );
+	CPPUNIT_ASSERT( std::abs( Transport::computeTickFromFrame( nLoopedFrame ) +
+							  fTickMismatch - 3 * fSongSizeInTicks - 17 ) <
+					1e-6 );
+
+	// Altering the Timeline does result in a new map.
+	H2Core::CoreActionController::addTempoMarker( 5, 180 );
+	auto pNewTempoMap = pAudioEngine->getTempoMap();
+	CPPUNIT_ASSERT( pNewTempoMap != pTempoMap );
+	CPPUNIT_ASSERT( pNewTempoMap->getSegments().size() ==
+					pTimeline->getAllTempoMarkers().size() );
+
+	// Conversions for a different sample rate are done using a temporary map
+	// and leave the published one untouched.
+	const long long nOtherFrame = Transport::computeFrameFromTick(
+		fSongSizeInTicks, &fTickMismatch, 2 * nSampleRate );
+	CPPUNIT_ASSERT( std::abs( nOtherFrame -
+							  2 * pNewTempoMap->getSongSizeInFrames() ) <= 2 );
+	CPPUNIT_ASSERT( pAudioEngine->getTempoMap() == pNewTempoMap );
+
+	// Restore the original state.
+	for ( const int nnColumn : { 0, 2, 3, 5, 7 } ) {
+		H2Core::CoreActionController::deleteTempoMarker( nnColumn );
+	}
+	H2Core::CoreActionController::activateTimeline( false );
+	CPPUNIT_ASSERT( pAudioEngine->getTempoMap()->isEmpty() );
+	CPPUNIT_ASSERT( pAudioEngine->getTempoMap()->getSampleRate() ==
+					nSampleRate );
+	___INFOLOG( "passed" );
+}
+
+void TransportTest::testColumnIndex() {
+	___INFOLOG( "" );
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+
+	auto pSongDemo = Song::load( QString( "%1/GM_kit_demo3.h2song" )
+								   .arg( Filesystem::demos_dir() ) );
+	ASSERT_SONG( pSongDemo );
+	H2Core::CoreActionController::setSong( pSongDemo );
+
+	// Compare against the lengths of all columns.
+	auto checkColumns = [&]() {
+		const auto pColumns = pSongDemo->getPatternGroupVector();
+		long nPatternStartTick;
+		long nStartTick = 0;
+		for ( int ii = 0; ii < pColumns->size(); ++ii ) {
+			const auto pColumn = ( *pColumns )[ ii ];
+			long nLength = 4 * H2Core::nTicksPerQuarter;
+			if ( pColumn->size() != 0 ) {
+				nLength = pColumn->longestPatternLength();
+			}
+
+			CPPUNIT_ASSERT( pHydrogen->getTickForColumn( ii ) == nStartTick );
+			for ( const long nnTick : { nStartTick, nStartTick + nLength / 2,
+										nStartTick + nLength - 1 } ) {
+				CPPUNIT_ASSERT( pHydrogen->getColumnForTick(
+									nnTick, false, &nPatternStartTick ) == ii );
+				CPPUNIT_ASSERT( nPatternStartTick == nStartTick );
+			}
+			nStartTick += nLength;
+		}
+		CPPUNIT_ASSERT( nStartTick == pSongDemo->lengthInTicks() );
+
+		// Beyond the end of the song.
+		CPPUNIT_ASSERT( pHydrogen->getColumnForTick(
+							nStartTick, false, &nPatternStartTick ) == -1 );
+		CPPUNIT_ASSERT( pHydrogen->getColumnForTick(
+							2 * nStartTick + 1, true, &nPatternStartTick ) == 0 );
+		CPPUNIT_ASSERT( nPatternStartTick == 0 );
+	};
+	checkColumns();
+
+	// Adding and removing columns.
+	const int nColumns = pSongDemo->getPatternGroupVector()->size();
+	CPPUNIT_ASSERT( H2Core::CoreActionController::toggleGridCell(
+						GridPoint( nColumns + 1, 0 ) ) );
+	CPPUNIT_ASSERT( pSongDemo->getPatternGroupVector()->size() ==
+					nColumns + 2 );
+	checkColumns();
+
+	CPPUNIT_ASSERT( H2Core::CoreActionController::toggleGridCell(
+						GridPoint( nColumns + 1, 0 ) ) );
+	CPPUNIT_ASSERT( pSongDemo->getPatternGroupVector()->size() == nColumns );
+	checkColumns();
+
+	// Altering the length of a pattern without changing the number of
+	// columns.
+	auto pPattern = pSongDemo->getPatternList()->get( 0 );
+	CPPUNIT_ASSERT( pPattern != nullptr );
+	pAudioEngine->lock( RIGHT_HERE );
+	pPattern->setLength( pPattern->getLength() / 2 );
+	pHydrogen->updateSongSize();
+	pAudioEngine->unlock();
+	checkColumns();
+
+	// Columns added without updating the index are scanned directly.
+	pAudioEngine->lock( RIGHT_HERE );
+	pSongDemo->getPatternGroupVector()->push_back(
+		std::make_shared<PatternList>() );
+	pAudioEngine->unlock();
+	checkColumns();
+
+	pAudioEngine->lock( RIGHT_HERE );
+	pSongDemo->getPatternGroupVector()->pop_back();
+	pHydrogen->updateSongSize();
+	pAudioEngine->unlock();
+	checkColumns();
+
+	___INFOLOG( "passed" );
+}
+
 void TransportTest::testTransportProcessing() {
 	___INFOLOG( "" );
 	auto pSongDemo = Song::load( QString( "%1/GM_kit_demo3.h2song" )
@@ -30,6 +30,8 @@
 class TransportTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE( TransportTest );
 	CPPUNIT_TEST( testFrameToTickConversion );
+	CPPUNIT_TEST( testTempoMap );
+	CPPUNIT_TEST( testColumnIndex );
 	CPPUNIT_TEST( testTransportProcessing );
 	CPPUNIT_TEST( testTransportProcessingTimeline );
 	CPPUNIT_TEST( testTransportRelocation );
@@ -55,6 +57,16 @@ public:
 	void tearDown();
 	
 	void testFrameToTickConversion();
+	/**
+	 * Checks whether the #H2Core::TempoMap cached by the audio engine
+	 * covers the whole song, is reused, and gets rebuilt on changes.
+	 */
+	void testTempoMap();
+	/**
+	 * Checks whether the column start ticks cached by #H2Core::Hydrogen
+	 * match the lengths of the patterns and are updated on changes.
+	 */
+	void testColumnIndex();
 
 	void testTransportProcessing();
 	void testTransportProcessingTimeline();
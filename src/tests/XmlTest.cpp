@@ -26,13 +26,16 @@
 #include "assertions/File.h"
 
 #include <unistd.h>
+#include <vector>
 
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentComponent.h>
 #include <core/Basics/InstrumentLayer.h>
 #include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
 #include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
 #include <core/Basics/Playlist.h>
 #include <core/Basics/Sample.h>
 #include <core/CoreActionController.h>
@@ -43,6 +46,7 @@
 #include <core/License.h>
 #include <core/SoundLibrary/SoundLibraryDatabase.h>
 
+#include <QBuffer>
 #include <QDir>
 #include <QTemporaryDir>
 #include <QTime>
@@ -959,6 +963,140 @@ void XmlTest::testSongLegacy() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static void checkPatternListsEqual(
+	std::shared_ptr<H2Core::PatternList> pStreamedList,
+	std::shared_ptr<H2Core::PatternList> pDomList ) {
+	CPPUNIT_ASSERT( pStreamedList != nullptr );
+	CPPUNIT_ASSERT( pDomList != nullptr );
+	CPPUNIT_ASSERT( pStreamedList->size() == pDomList->size() );
+	for ( int ii = 0; ii < pDomList->size(); ++ii ) {
+		const auto pStreamed = pStreamedList->get( ii );
+		const auto pDom = pDomList->get( ii );
+		CPPUNIT_ASSERT( pStreamed->getName() == pDom->getName() );
+		CPPUNIT_ASSERT( pStreamed->getLength() == pDom->getLength() );
+		CPPUNIT_ASSERT( pStreamed->getNotes()->size() ==
+						pDom->getNotes()->size() );
+
+		auto itStreamed = pStreamed->getNotes()->cbegin();
+		for ( const auto& [ nnPosition, ppNote ] : *pDom->getNotes() ) {
+			CPPUNIT_ASSERT( itStreamed->first == nnPosition );
+			CPPUNIT_ASSERT( itStreamed->second->getInstrumentId() ==
+							ppNote->getInstrumentId() );
+			CPPUNIT_ASSERT( itStreamed->second->getType() == ppNote->getType() );
+			CPPUNIT_ASSERT( itStreamed->second->getVelocity() ==
+							ppNote->getVelocity() );
+			CPPUNIT_ASSERT( itStreamed->second->getKey() == ppNote->getKey() );
+			CPPUNIT_ASSERT( itStreamed->second->getOctave() ==
+							ppNote->getOctave() );
+			++itStreamed;
+		}
+	}
+}
+
+void XmlTest::testStreamedPatternLoading() {
+	___INFOLOG( "" );
+
+	// Current format
+	{
+		const QString sSongPath = H2TEST_FILE( "song/current.h2song" );
+
+		std::shared_ptr<H2Core::PatternList> pStreamedList;
+		H2Core::XMLDoc streamedDoc;
+		CPPUNIT_ASSERT( streamedDoc.read(
+			sSongPath, "song/patternList",
+			[&]( H2Core::XMLStreamReader& reader ) {
+				pStreamedList = H2Core::PatternList::loadFrom( reader, true );
+			}, true ) );
+
+		H2Core::XMLDoc domDoc;
+		CPPUNIT_ASSERT( domDoc.read( sSongPath, true ) );
+		const auto pDomList = H2Core::PatternList::loadFrom(
+			domDoc.firstChildElement( "song" ), "", nullptr, true );
+
+		CPPUNIT_ASSERT( pDomList != nullptr );
+		CPPUNIT_ASSERT( pDomList->size() > 0 );
+		checkPatternListsEqual( pStreamedList, pDomList );
+	}
+
+	// Notes of the format < 0.9.4 are only used in case there is no
+	// "noteList" element, regardless of the order of both.
+	{
+		const QString sNote( "<note><position>%1</position>"
+							 "<velocity>0.5</velocity>"
+							 "<instrument>%2</instrument></note>" );
+		const QString sSequenceList =
+			QString( "<sequenceList><sequence><noteList>%1</noteList>"
+					 "</sequence><sequence><noteList>%2</noteList>"
+					 "</sequence></sequenceList>" )
+			.arg( sNote.arg( 0 ).arg( 0 ) ).arg( sNote.arg( 24 ).arg( 1 ) );
+		const QString sNoteList = QString( "<noteList>%1</noteList>" )
+			.arg( sNote.arg( 48 ).arg( 2 ) );
+		const QString sContent = QString(
+			"<song><patternList>"
+			"<pattern><name>current</name>%1</pattern>"
+			"<pattern><name>legacy</name>%2</pattern>"
+			"<pattern><name>both</name>%2%1</pattern>"
+			"</patternList></song>" ).arg( sNoteList ).arg( sSequenceList );
+
+		QByteArray content( sContent.toUtf8() );
+		QBuffer buffer( &content );
+		CPPUNIT_ASSERT( buffer.open( QIODevice::ReadOnly ) );
+		H2Core::XMLStreamReader reader( &buffer );
+		CPPUNIT_ASSERT( reader.readNextStartElement() );
+		CPPUNIT_ASSERT( reader.readNextStartElement() );
+		const auto pStreamedList = H2Core::PatternList::loadFrom( reader, true );
+		CPPUNIT_ASSERT( ! reader.hasError() );
+
+		H2Core::XMLDoc domDoc( sContent );
+		const auto pDomList = H2Core::PatternList::loadFrom(
+			domDoc.firstChildElement( "song" ), "", nullptr, true );
+
+		checkPatternListsEqual( pStreamedList, pDomList );
+		CPPUNIT_ASSERT( pStreamedList->size() == 3 );
+		CPPUNIT_ASSERT( pStreamedList->get( 0 )->getNotes()->size() == 1 );
+		CPPUNIT_ASSERT( pStreamedList->get( 1 )->getNotes()->size() == 2 );
+		CPPUNIT_ASSERT( pStreamedList->get( 2 )->getNotes()->size() == 1 );
+		CPPUNIT_ASSERT(
+			pStreamedList->get( 2 )->getNotes()->cbegin()->first == 48 );
+	}
+
+	___INFOLOG( "passed" );
+}
+
+void XmlTest::testStreamReaderNumbers() {
+	___INFOLOG( "" );
+
+	QByteArray content( "<root><int>12</int><int>1x</int><int></int>"
+						"<float>-0.5</float><float>abc</float><float></float>"
+						"</root>" );
+	QBuffer buffer( &content );
+	CPPUNIT_ASSERT( buffer.open( QIODevice::ReadOnly ) );
+
+	H2Core::XMLStreamReader reader( &buffer );
+	CPPUNIT_ASSERT( reader.readNextStartElement() );
+
+	std::vector<int> ints;
+	std::vector<float> floats;
+	std::vector<bool> found;
+	while ( reader.readNextStartElement() ) {
+		if ( reader.name() == QLatin1String( "int" ) ) {
+			ints.push_back( reader.read_int( 7 ) );
+		}
+		else {
+			bool bFound;
+			floats.push_back( reader.read_float( 0.25, &bFound ) );
+			found.push_back( bFound );
+		}
+	}
+	CPPUNIT_ASSERT( ! reader.hasError() );
+
+	CPPUNIT_ASSERT( ints == std::vector<int>( { 12, 7, 7 } ) );
+	CPPUNIT_ASSERT( floats == std::vector<float>( { -0.5, 0.25, 0.25 } ) );
+	CPPUNIT_ASSERT( found == std::vector<bool>( { true, false, false } ) );
+
+	___INFOLOG( "passed" );
+}
+
 void XmlTest::testPreferencesFormatIntegrity() {
 	___INFOLOG( "" );
 	const QString sTestFile = H2TEST_FILE( "preferences/current.conf" );
@@ -53,6 +53,8 @@ class XmlTest : public CppUnit::TestCase {
 	CPPUNIT_TEST(testSongFormatIntegrity);
 	CPPUNIT_TEST(testSong);
 	CPPUNIT_TEST(testSongLegacy);
+	CPPUNIT_TEST(testStreamedPatternLoading);
+	CPPUNIT_TEST(testStreamReaderNumbers);
 	CPPUNIT_TEST(testPreferencesFormatIntegrity);
 	CPPUNIT_TEST(testShippedPreferences);
 	CPPUNIT_TEST(testShippedThemes);
@@ -106,6 +108,13 @@ class XmlTest : public CppUnit::TestCase {
 		// This test loads song of various versions and checks whether all
 		// samples could be loaded.
 		void testSongLegacy();
+		/** Checks whether loading the patterns of a song in a single pass
+		 * using XMLDoc's stream handler yields the same result as loading
+		 * them from the DOM. */
+		void testStreamedPatternLoading();
+		/** Checks that XMLStreamReader falls back to the default value for
+		 * elements containing no valid number. */
+		void testStreamReaderNumbers();
 
 		/** Checks whether the format of our preferences file `hydrogen.conf`
 		 * did change. */
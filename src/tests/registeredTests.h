@@ -30,13 +30,17 @@
 #include "AudioExportTest.h"
 #include "AutomationPathSerializerTest.cpp"
 #include "AutomationPathTest.cpp"
+#include "BenchmarkTest.h"
 #include "CliTest.h"
 #include "CoreActionControllerTest.h"
 #include "DrumkitExportTest.h"
 #include "EventQueueTest.h"
 #include "FilesystemTest.h"
 #include "DrumkitTest.h"
+#include "InterpolationTest.h"
+#include "LadspaTest.h"
 #include "LicenseTest.h"
+#include "LoggerTest.h"
 #include "MemoryLeakageTest.h"
 #include "MidiActionTest.h"
 #include "MidiDriverTest.h"
@@ -47,7 +51,9 @@
 #include "NoteTest.h"
 #include "OscServerTest.h"
 #include "PatternTest.h"
+#include "PcmConversionTest.h"
 #include "SampleTest.h"
+#include "SamplerTest.h"
 #include "SoundLibraryTest.h"
 #include "TimeTest.h"
 #include "Translations.cpp"
@@ -62,6 +68,7 @@ CPPUNIT_TEST_SUITE_REGISTRATION( AudioEngineTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( AudioExportTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( AutomationPathSerializerTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( AutomationPathTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( BenchmarkTest );
 #if not defined(WIN32) and not defined (__APPLE__)
   // For now h2cli is just part of our Linux package.
   CPPUNIT_TEST_SUITE_REGISTRATION( CliTest );
@@ -71,7 +78,12 @@ CPPUNIT_TEST_SUITE_REGISTRATION( DrumkitExportTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( EventQueueTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( FilesystemTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( DrumkitTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( InterpolationTest );
+#ifdef H2CORE_HAVE_LADSPA
+CPPUNIT_TEST_SUITE_REGISTRATION( LadspaTest );
+#endif
 CPPUNIT_TEST_SUITE_REGISTRATION( LicenseTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( LoggerTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( MemoryLeakageTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( MimeTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( MidiActionTest );
@@ -84,7 +96,9 @@ CPPUNIT_TEST_SUITE_REGISTRATION( NoteTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( OscServerTest );
 #endif
 CPPUNIT_TEST_SUITE_REGISTRATION( PatternTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( PcmConversionTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( SampleTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( SamplerTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( SoundLibraryTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( TimeTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( TransportTest );
@@ -0,0 +1,96 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2025 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+	thread_local bool bCounting = false;
+	thread_local long long nAllocations = 0;
+
+	void* allocate( std::size_t nSize ) {
+		if ( bCounting ) {
+			++nAllocations;
+		}
+		return std::malloc( nSize > 0 ? nSize : 1 );
+	}
+}
+
+void AllocationCounter::start() {
+	nAllocations = 0;
+	bCounting = true;
+}
+
+long long AllocationCounter::stop() {
+	bCounting = false;
+	return nAllocations;
+}
+
+void* operator new( std::size_t nSize ) {
+	void* p = allocate( nSize );
+	if ( p == nullptr ) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[]( std::size_t nSize ) {
+	void* p = allocate( nSize );
+	if ( p == nullptr ) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new( std::size_t nSize, const std::nothrow_t& ) noexcept {
+	return allocate( nSize );
+}
+
+void* operator new[]( std::size_t nSize, const std::nothrow_t& ) noexcept {
+	return allocate( nSize );
+}
+
+void operator delete( void* p ) noexcept {
+	std::free( p );
+}
+
+void operator delete[]( void* p ) noexcept {
+	std::free( p );
+}
+
+void operator delete( void* p, std::size_t ) noexcept {
+	std::free( p );
+}
+
+void operator delete[]( void* p, std::size_t ) noexcept {
+	std::free( p );
+}
+
+void operator delete( void* p, const std::nothrow_t& ) noexcept {
+	std::free( p );
+}
+
+void operator delete[]( void* p, const std::nothrow_t& ) noexcept {
+	std::free( p );
+}